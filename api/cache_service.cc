@@ -316,6 +316,45 @@ void set_cache_service(http_context& ctx, routes& r) {
         // so currently returning a 0 for entries is ok
         return make_ready_future<json::json_return_type>(0);
     });
+
+    cs::get_hot_partitions.set(r, [&ctx] (std::unique_ptr<request> req) {
+        using shard_hot_partitions = std::vector<std::pair<unsigned, replica::hot_partition_cache::hot_partition>>;
+        api::req_param<unsigned> list_size(*req, "list_size", 10);
+        return ctx.db.map_reduce0([list_size = list_size.param] (replica::database& db) {
+            shard_hot_partitions ret;
+            for (auto& p : db.hot_partitions().top(list_size)) {
+                ret.emplace_back(this_shard_id(), std::move(p));
+            }
+            return ret;
+        }, shard_hot_partitions(), [] (shard_hot_partitions a, shard_hot_partitions b) {
+            std::move(b.begin(), b.end(), std::back_inserter(a));
+            return a;
+        }).then([] (shard_hot_partitions res) {
+            std::vector<cs::hot_partition> ret;
+            ret.reserve(res.size());
+            for (auto& [shard, p] : res) {
+                cs::hot_partition hp;
+                hp.keyspace = p.keyspace;
+                hp.table = p.table;
+                hp.partition = p.partition;
+                hp.shard = shard;
+                hp.count = p.count;
+                hp.error = p.error;
+                hp.replicated = p.replicated;
+                ret.push_back(std::move(hp));
+            }
+            return make_ready_future<json::json_return_type>(ret);
+        });
+    });
+
+    cs::get_hot_partitions_hit_rate.set(r, [&ctx] (std::unique_ptr<request> req) {
+        return ctx.db.map_reduce0([] (replica::database& db) {
+            auto& stats = db.hot_partitions().get_stats();
+            return ratio_holder(stats.hits + stats.misses, stats.hits);
+        }, ratio_holder(), std::plus<ratio_holder>()).then([] (const ratio_holder& res) {
+            return make_ready_future<json::json_return_type>(res);
+        });
+    });
 }
 
 }
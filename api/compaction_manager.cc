@@ -91,6 +91,40 @@ void set_compaction_manager(http_context& ctx, routes& r) {
         });
     });
 
+    cm::get_read_amplification.set(r, [&ctx] (std::unique_ptr<request> req) {
+        using stats_map = std::unordered_map<std::pair<sstring, sstring>, compaction_manager::read_amplification_stats, utils::tuple_hash>;
+        return ctx.db.map_reduce0([] (replica::database& db) {
+            stats_map stats;
+            const compaction_manager& cm = db.get_compaction_manager();
+            for (auto& [id, t] : db.get_column_families()) {
+                stats.emplace(std::make_pair(t->schema()->ks_name(), t->schema()->cf_name()), cm.get_read_amplification(t.get()));
+            }
+            return stats;
+        }, stats_map(), [] (stats_map a, const stats_map& b) {
+            // The controller acts on each shard separately, so the worst one is reported.
+            for (auto& [name, s] : b) {
+                auto& r = a[name];
+                r.sstables_per_read = std::max(r.sstables_per_read, s.sstables_per_read);
+                r.read_latency_us = std::max(r.read_latency_us, s.read_latency_us);
+                r.exceeded = r.exceeded || s.exceeded;
+            }
+            return a;
+        }).then([] (const stats_map& stats) {
+            std::vector<cm::read_amplification> res;
+            res.reserve(stats.size());
+            for (auto& [name, s] : stats) {
+                cm::read_amplification ra;
+                ra.ks = name.first;
+                ra.cf = name.second;
+                ra.sstables_per_read = s.sstables_per_read;
+                ra.read_latency = s.read_latency_us;
+                ra.target_exceeded = s.exceeded;
+                res.push_back(std::move(ra));
+            }
+            return make_ready_future<json::json_return_type>(res);
+        });
+    });
+
     cm::force_user_defined_compaction.set(r, [] (std::unique_ptr<request> req) {
         //TBD
         // FIXME
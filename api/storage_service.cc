@@ -637,17 +637,8 @@ void set_storage_service(http_context& ctx, routes& r, sharded<service::storage_
                 auto table_ids = boost::copy_range<std::vector<utils::UUID>>(column_families | boost::adaptors::transformed([&] (auto& table_name) {
                     return db.find_uuid(keyspace, table_name);
                 }));
-                // cleanup smaller tables first, to increase chances of success if low on space.
-                std::ranges::sort(table_ids, std::less<>(), [&] (const utils::UUID& id) {
-                    return db.find_column_family(id).get_stats().live_disk_space_used;
-                });
-                auto& cm = db.get_compaction_manager();
-                // as a table can be dropped during loop below, let's find it before issuing the cleanup request.
-                for (auto& id : table_ids) {
-                    replica::table& t = db.find_column_family(id);
-                    co_await cm.perform_cleanup(db, &t);
-                }
-                co_return;
+                // The tables are cleaned up in decreasing order of their bytes to reclaim, with owned ranges computed once.
+                co_await db.get_compaction_manager().perform_keyspace_cleanup(db, keyspace, std::move(table_ids));
             }).then([]{
                 return make_ready_future<json::json_return_type>(0);
             });
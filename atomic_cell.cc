@@ -61,6 +61,15 @@ atomic_cell atomic_cell::make_live_uninitialized(const abstract_type& type, api:
     return atomic_cell_type::make_live_uninitialized(timestamp, size);
 }
 
+atomic_cell atomic_cell::make_live_value_log_pointer(api::timestamp_type timestamp, bytes_view pointer) {
+    return atomic_cell_type::make_live_value_log_pointer(timestamp, pointer, std::nullopt);
+}
+
+atomic_cell atomic_cell::make_live_value_log_pointer(api::timestamp_type timestamp, bytes_view pointer,
+        gc_clock::time_point expiry, gc_clock::duration ttl) {
+    return atomic_cell_type::make_live_value_log_pointer(timestamp, pointer, std::make_pair(expiry, ttl));
+}
+
 atomic_cell::atomic_cell(const abstract_type& type, atomic_cell_view other)
     : _data(other._view) {
     set_view(_data);
@@ -74,6 +74,7 @@ class atomic_cell_type final {
 private:
     static constexpr int8_t LIVE_FLAG = 0x01;
     static constexpr int8_t EXPIRY_FLAG = 0x02; // When present, expiry field is present. Set only for live cells
+    static constexpr int8_t VALUE_LOG_POINTER_FLAG = 0x04; // Value is a pointer into a value log. Set only for live cells
     static constexpr int8_t COUNTER_UPDATE_FLAG = 0x08; // Cell is a counter update.
     static constexpr unsigned flags_size = 1;
     static constexpr unsigned timestamp_offset = flags_size;
@@ -92,6 +93,9 @@ class atomic_cell_type final {
     static bool is_live(atomic_cell_value_view cell) {
         return cell.front() & LIVE_FLAG;
     }
+    static bool is_value_log_pointer(atomic_cell_value_view cell) {
+        return cell.front() & VALUE_LOG_POINTER_FLAG;
+    }
     static bool is_live_and_has_ttl(atomic_cell_value_view cell) {
         return cell.front() & EXPIRY_FLAG;
     }
@@ -176,6 +180,15 @@ class atomic_cell_type final {
         set_value(b, value_offset, value);
         return b;
     }
+    // Live cell whose value is a serialized sstables::value_log_pointer,
+    // rather than a value of the type of the column.
+    static managed_bytes make_live_value_log_pointer(api::timestamp_type timestamp, bytes_view pointer,
+            std::optional<std::pair<gc_clock::time_point, gc_clock::duration>> expiry_and_ttl) {
+        auto b = expiry_and_ttl ? make_live(timestamp, single_fragment_range(pointer), expiry_and_ttl->first, expiry_and_ttl->second)
+                                : make_live(timestamp, single_fragment_range(pointer));
+        b[0] |= VALUE_LOG_POINTER_FLAG;
+        return b;
+    }
     static managed_bytes make_live_uninitialized(api::timestamp_type timestamp, size_t size) {
         auto value_offset = flags_size + timestamp_size;
         managed_bytes b(managed_bytes::initialized_later(), value_offset + size);
@@ -221,6 +234,14 @@ class basic_atomic_cell_view {
     bool is_live_and_has_ttl() const {
         return atomic_cell_type::is_live_and_has_ttl(_view);
     }
+    // Whether value() is a pointer into a value log rather than the value
+    // itself, see sstables/value_log.hh. Such cells are only produced by
+    // sstable readers asked not to resolve the pointers, for compaction,
+    // and only for cells which can't tie with a cell of another input in
+    // compare_atomic_cell_for_merge(), see sstables::value_log_pointers.
+    bool is_value_log_pointer() const {
+        return atomic_cell_type::is_value_log_pointer(_view);
+    }
     bool is_dead(gc_clock::time_point now) const {
         return atomic_cell_type::is_dead(_view) || has_expired(now);
     }
@@ -371,6 +392,9 @@ class atomic_cell final : public basic_atomic_cell_view<mutable_view::yes> {
         }
     }
     static atomic_cell make_live_uninitialized(const abstract_type& type, api::timestamp_type timestamp, size_t size);
+    static atomic_cell make_live_value_log_pointer(api::timestamp_type timestamp, bytes_view pointer);
+    static atomic_cell make_live_value_log_pointer(api::timestamp_type timestamp, bytes_view pointer,
+        gc_clock::time_point expiry, gc_clock::duration ttl);
     friend class atomic_cell_or_collection;
     friend std::ostream& operator<<(std::ostream& os, const atomic_cell& ac);
 
@@ -201,6 +201,9 @@ class cache_flat_mutation_reader final : public flat_mutation_reader_v2::impl {
         return _snp->schema();
     }
     void touch_partition();
+    void touch_next_row();
+    // Links a row populated by this read into the LRU of the cache.
+    void insert_populated(rows_entry&);
 
     position_in_partition_view to_table_domain(position_in_partition_view query_domain_pos) {
         if (!_read_context.is_reversed()) [[likely]] {
@@ -316,7 +319,32 @@ future<> cache_flat_mutation_reader::process_static_row() {
 
 inline
 void cache_flat_mutation_reader::touch_partition() {
-    _snp->touch();
+    if (_read_context.admitted()) {
+        _snp->touch();
+    } else {
+        _snp->touch_probationary();
+    }
+}
+
+inline
+void cache_flat_mutation_reader::touch_next_row() {
+    // Rows of partitions which the admission policy doesn't admit aren't
+    // brought to the front of the LRU, so that they can't evict the rows of
+    // the admitted ones.
+    if (_read_context.admitted()) {
+        _next_row.touch();
+    }
+}
+
+inline
+void cache_flat_mutation_reader::insert_populated(rows_entry& e) {
+    // Rows of older versions must be evicted before the ones of newer versions,
+    // so rows can be probationary only if the snapshot has a single version.
+    if (!_read_context.admitted() && _snp->at_latest_version() && _snp->at_oldest_version()) {
+        _snp->tracker()->insert_probationary(e);
+    } else {
+        _snp->tracker()->insert(e);
+    }
 }
 
 inline
@@ -461,7 +489,7 @@ future<> cache_flat_mutation_reader::read_from_underlying() {
                                 auto insert_result = rows.insert_before_hint(_next_row.get_iterator_in_latest_version(), std::move(e), cmp);
                                 if (insert_result.second) {
                                     auto it = insert_result.first;
-                                    _snp->tracker()->insert(*it);
+                                    insert_populated(*it);
                                     auto next = std::next(it);
                                     // Also works in reverse read mode.
                                     // It preserves the continuity of the range the entry falls into.
@@ -477,7 +505,7 @@ future<> cache_flat_mutation_reader::read_from_underlying() {
                                 auto insert_result = rows.insert_before_hint(_next_row.get_iterator_in_latest_version(), std::move(e), cmp);
                                 if (insert_result.second) {
                                     clogger.trace("csm {}: inserted dummy at {}", fmt::ptr(this), _upper_bound);
-                                    _snp->tracker()->insert(*insert_result.first);
+                                    insert_populated(*insert_result.first);
                                 }
                                 if (_read_context.is_reversed()) [[unlikely]] {
                                     clogger.trace("csm {}: set_continuous({})", fmt::ptr(this), _last_row.position());
@@ -526,7 +554,7 @@ bool cache_flat_mutation_reader::ensure_population_lower_bound() {
             if (insert_result.second) {
                 auto it = insert_result.first;
                 clogger.trace("csm {}: inserted lower bound dummy at {}", fmt::ptr(this), it->position());
-                _snp->tracker()->insert(*it);
+                insert_populated(*it);
             }
             _last_row.set_latest(insert_result.first);
         });
@@ -595,7 +623,7 @@ void cache_flat_mutation_reader::maybe_add_to_cache(const clustering_row& cr) {
         auto insert_result = mp.mutable_clustered_rows().insert_before_hint(it, std::move(new_entry), cmp);
         it = insert_result.first;
         if (insert_result.second) {
-            _snp->tracker()->insert(*it);
+            insert_populated(*it);
         }
 
         rows_entry& e = *it;
@@ -627,13 +655,13 @@ inline
 void cache_flat_mutation_reader::start_reading_from_underlying() {
     clogger.trace("csm {}: start_reading_from_underlying(), range=[{}, {})", fmt::ptr(this), _lower_bound, _next_row_in_range ? _next_row.position() : _upper_bound);
     _state = state::move_to_underlying;
-    _next_row.touch();
+    touch_next_row();
 }
 
 inline
 void cache_flat_mutation_reader::copy_from_cache_to_buffer() {
     clogger.trace("csm {}: copy_from_cache, next={}, next_row_in_range={}", fmt::ptr(this), _next_row.position(), _next_row_in_range);
-    _next_row.touch();
+    touch_next_row();
     position_in_partition_view next_lower_bound = _next_row.dummy() ? _next_row.position() : position_in_partition_view::after_key(_next_row.key());
     auto upper_bound = _next_row_in_range ? next_lower_bound : _upper_bound;
     if (_snp->range_tombstones(_lower_bound, upper_bound, [&] (range_tombstone rts) {
@@ -705,7 +733,7 @@ void cache_flat_mutation_reader::move_to_range(query::clustering_row_ranges::con
                 });
                 auto it = insert_result.first;
                 if (insert_result.second) {
-                    _snp->tracker()->insert(*it);
+                    insert_populated(*it);
                 }
                 _last_row = partition_snapshot_row_weakref(*_snp, it, true);
             } else {
@@ -31,8 +31,11 @@
 #include "sstables/sstable_writer.hh"
 #include "sstables/progress_monitor.hh"
 #include "sstables/sstables_manager.hh"
+#include "sstables/value_log.hh"
+#include "db/value_log_extension.hh"
 #include "compaction.hh"
 #include "compaction_manager.hh"
+#include "raw_partition_copier.hh"
 #include "schema.hh"
 #include "db/system_keyspace.hh"
 #include "service/priority_manager.hh"
@@ -275,9 +278,14 @@ class compacted_fragments_writer {
     stop_func_t _stop_compaction_writer;
     std::optional<utils::observer<>> _stop_request_observer;
     bool _unclosed_partition = false;
+    raw_partition_copier* _raw_partition_copier = nullptr;
 private:
     inline void maybe_abort_compaction();
 
+    // Writes the partitions copied verbatim which precede upper_bound,
+    // or all remaining ones if it's null.
+    void copy_raw_partitions(const dht::decorated_key* upper_bound);
+
     utils::observer<> make_stop_request_observer(utils::observable<>& sro) {
         return sro.observe([this] () mutable {
             assert(!_unclosed_partition);
@@ -285,10 +293,11 @@ class compacted_fragments_writer {
         });
     }
 public:
-    explicit compacted_fragments_writer(compaction& c, creator_func_t cpw, stop_func_t scw)
+    explicit compacted_fragments_writer(compaction& c, creator_func_t cpw, stop_func_t scw, raw_partition_copier* rpc = nullptr)
             : _c(c)
             , _create_compaction_writer(std::move(cpw))
-            , _stop_compaction_writer(std::move(scw)) {
+            , _stop_compaction_writer(std::move(scw))
+            , _raw_partition_copier(rpc) {
     }
     explicit compacted_fragments_writer(compaction& c, creator_func_t cpw, stop_func_t scw, utils::observable<>& sro)
             : _c(c)
@@ -461,6 +470,14 @@ class compaction {
     // Garbage collected sstables that were added to SSTable set and should be eventually removed from it.
     std::vector<shared_sstable> _used_garbage_collected_sstables;
     utils::observable<> _stop_request_observable;
+    // Set if some partitions of the input are copied verbatim to the output.
+    std::unique_ptr<raw_partition_copier> _raw_partition_copier;
+    // Set if the inputs point into value logs, which the output can point
+    // into as well, see sstables/value_log.hh.
+    lw_shared_ptr<const value_log_sources> _value_logs;
+    // See compaction_descriptor::token_range.
+    std::optional<dht::token_range> _token_range;
+    dht::partition_range _partition_range;
 private:
     compaction_data& init_compaction_data(compaction_data& cdata, const compaction_descriptor& descriptor) const {
         cdata.compaction_fan_in = descriptor.fan_in();
@@ -483,6 +500,8 @@ class compaction {
         , _sstable_set(std::move(descriptor.all_sstables_snapshot))
         , _selector(_sstable_set ? _sstable_set->make_incremental_selector() : std::optional<sstable_set::incremental_selector>{})
         , _compacting_for_max_purgeable_func(std::unordered_set<shared_sstable>(_sstables.begin(), _sstables.end()))
+        , _token_range(std::move(descriptor.token_range))
+        , _partition_range(_token_range ? dht::to_partition_range(*_token_range) : query::full_partition_range)
     {
         for (auto& sst : _sstables) {
             _stats_collector.update(sst->get_encoding_stats_for_compaction());
@@ -528,6 +547,7 @@ class compaction {
         cfg.run_identifier = _run_identifier;
         cfg.replay_position = _rp;
         cfg.sstable_level = _sstable_level;
+        cfg.value_logs = _value_logs;
         return cfg;
     }
 
@@ -542,6 +562,45 @@ class compaction {
         return _stats_collector.get();
     }
 
+    // Reads the input sstables, except for the partitions copied verbatim, if
+    // any, and the ones outside of _token_range.
+    // Cells whose value is in a value log are read as pointers, which the
+    // writer passes through to the output, unless they may tie with a cell
+    // of another input.
+    flat_mutation_reader_v2 make_local_shard_sstable_reader(read_monitor_generator& monitor_generator) const {
+        auto vl_pointers = make_value_log_pointers();
+        if (_raw_partition_copier) {
+            return _compacting->make_local_shard_sstable_reader(_schema,
+                    _permit,
+                    _partition_range,
+                    tracing::trace_state_ptr(),
+                    ::streamed_mutation::forwarding::no,
+                    ::mutation_reader::forwarding::no,
+                    _raw_partition_copier->make_reader_factory(monitor_generator, vl_pointers));
+        }
+        if (vl_pointers) {
+            return _compacting->make_local_shard_sstable_reader(_schema,
+                    _permit,
+                    _partition_range,
+                    tracing::trace_state_ptr(),
+                    ::streamed_mutation::forwarding::no,
+                    ::mutation_reader::forwarding::no,
+                    [this, &monitor_generator, vl_pointers] (shared_sstable& sst, const dht::partition_range& pr) {
+                return sst->make_reader(_schema, _permit, pr, _schema->full_slice(), _io_priority, {},
+                        ::streamed_mutation::forwarding::no, ::mutation_reader::forwarding::no, monitor_generator(sst), vl_pointers);
+            });
+        }
+        return _compacting->make_local_shard_sstable_reader(_schema,
+                _permit,
+                _partition_range,
+                _schema->full_slice(),
+                _io_priority,
+                tracing::trace_state_ptr(),
+                ::streamed_mutation::forwarding::no,
+                ::mutation_reader::forwarding::no,
+                monitor_generator);
+    }
+
     virtual compaction_completion_desc
     get_compaction_completion_desc(std::vector<shared_sstable> input_sstables, std::vector<shared_sstable> output_sstables) {
         return compaction_completion_desc{std::move(input_sstables), std::move(output_sstables)};
@@ -560,6 +619,7 @@ class compaction {
         auto monitor = std::make_unique<compaction_write_monitor>(sst, _table_s, maximum_timestamp(), _sstable_level);
         sstable_writer_config cfg = _table_s.configure_writer("garbage_collection");
         cfg.run_identifier = _run_identifier;
+        cfg.value_logs = _value_logs;
         cfg.monitor = monitor.get();
         auto writer = sst->get_writer(*schema(), partitions_per_sstable(), cfg, get_encoding_stats(), priority);
         return compaction_writer(std::move(monitor), std::move(writer), std::move(sst));
@@ -599,7 +659,7 @@ class compaction {
     }
 
     bool enable_garbage_collected_sstable_writer() const noexcept {
-        return _contains_multi_fragment_runs && _max_sstable_size != std::numeric_limits<uint64_t>::max();
+        return _contains_multi_fragment_runs && _max_sstable_size != std::numeric_limits<uint64_t>::max() && !_token_range;
     }
 public:
     compaction& operator=(const compaction&) = delete;
@@ -633,8 +693,15 @@ class compaction {
 
             // Compacted sstable keeps track of its ancestors.
             _input_sstable_generations.push_back(sst->generation());
-            _start_size += sst->bytes_on_disk();
-            _cdata.total_partitions += sst->get_estimated_key_count();
+            auto estimated_keys = sst->get_estimated_key_count();
+            auto bytes_on_disk = sst->bytes_on_disk();
+            if (_token_range) {
+                auto keys_in_range = sst->estimated_keys_for_range(*_token_range);
+                bytes_on_disk = estimated_keys ? uint64_t(double(bytes_on_disk) * keys_in_range / estimated_keys) : 0;
+                estimated_keys = keys_in_range;
+            }
+            _start_size += bytes_on_disk;
+            _cdata.total_partitions += estimated_keys;
             formatted_msg += sst;
 
             // Do not actually compact a sstable that is fully expired and can be safely
@@ -649,7 +716,7 @@ class compaction {
             // FIXME: If the sstables have cardinality estimation bitmaps, use that
             // for a better estimate for the number of partitions in the merged
             // sstable than just adding up the lengths of individual sstables.
-            _estimated_partitions += sst->get_estimated_key_count();
+            _estimated_partitions += estimated_keys;
             // TODO:
             // Note that this is not fully correct. Since we might be merging sstables that originated on
             // another shard (#cpu changed), we might be comparing RP:s with differing shard ids,
@@ -669,6 +736,110 @@ class compaction {
 
         _ms_metadata.min_timestamp = timestamp_tracker.min();
         _ms_metadata.max_timestamp = timestamp_tracker.max();
+
+        setup_value_logs();
+        co_await setup_raw_partition_copier();
+    }
+
+    value_log_pointers make_value_log_pointers() const {
+        if (!_value_logs) {
+            return value_log_pointers();
+        }
+        auto ssts = _compacting->all();
+        std::vector<value_log_pointers::input> inputs;
+        for (auto& sst : *ssts) {
+            const auto& stats = sst->get_stats_metadata();
+            inputs.push_back({sst.get(), stats.min_timestamp, stats.max_timestamp});
+        }
+        return value_log_pointers(std::move(inputs));
+    }
+
+    void setup_value_logs() {
+        auto inputs = _compacting->all();
+        if (std::none_of(inputs->begin(), inputs->end(), std::mem_fn(&sstable::has_value_logs))) {
+            return;
+        }
+        // The values still referenced in value logs with too much garbage
+        // are moved to the value log of the output, so that the sstables
+        // which link the old value logs are eventually all compacted away.
+        auto garbage_ratios = value_log_garbage_ratios(*_table_s.get_sstable_set().all());
+        auto gc_garbage_ratio = _schema->value_log_options().gc_garbage_ratio;
+        auto sources = make_lw_shared<value_log_sources>(_permit);
+        for (auto& sst : *inputs) {
+            auto* sm = sst->get_scylla_metadata();
+            auto* m = sm ? sm->get_value_logs() : nullptr;
+            if (!m) {
+                continue;
+            }
+            for (auto& e : m->logs.elements) {
+                auto it = garbage_ratios.find(e.id);
+                bool relocate = it != garbage_ratios.end() && it->second >= gc_garbage_ratio;
+                sources->logs.try_emplace(e.id, value_log_source{sst, e.size, relocate});
+            }
+        }
+        _value_logs = std::move(sources);
+    }
+
+    bool raw_partition_copy_enabled() const {
+        // Other types filter or transform every partition.
+        if (_type != compaction_type::Compaction && _type != compaction_type::Reshape) {
+            return false;
+        }
+        // The copier walks the whole index of its sources.
+        return !_sstables.empty() && _sstables.front()->manager().config().compaction_raw_partition_copy()
+            && !use_interposer_consumer() && !_token_range;
+    }
+
+    future<> setup_raw_partition_copier() {
+        if (!raw_partition_copy_enabled()) {
+            co_return;
+        }
+        auto now = gc_clock::now();
+        std::vector<shared_sstable> candidates;
+        for (auto& sst : *_compacting->all()) {
+            if (sst->get_version() < sstable_version_types::mc || sst->is_shared()) {
+                continue;
+            }
+            // Copied partitions aren't compacted, so only take them from
+            // sstables which have no data to purge, or whose tombstone
+            // density tells the token ranges which have none.
+            auto gc_before = sst->get_gc_before_for_drop_estimation(now);
+            auto* sm = sst->get_scylla_metadata();
+            if (sst->get_stats_metadata().min_local_deletion_time < gc_before.time_since_epoch().count()
+                    && !(sm && sm->get_tombstone_density())) {
+                continue;
+            }
+            candidates.push_back(sst);
+        }
+        if (candidates.empty()) {
+            co_return;
+        }
+
+        // Partitions can only be copied from sstables which are serialized
+        // against the same bases as the output, so lower the bases of the
+        // output to the ones of the candidates. The fragments of a run, which
+        // were written by the same compaction, share them.
+        auto stats_collector = _stats_collector;
+        for (auto& sst : candidates) {
+            auto& header = sst->get_serialization_header();
+            _stats_collector.update(encoding_stats{
+                header.get_min_timestamp(),
+                gc_clock::time_point(gc_clock::duration(header.get_min_local_deletion_time())),
+                gc_clock::duration(header.get_min_ttl())});
+        }
+        auto enc_stats = get_encoding_stats();
+
+        auto copier = std::make_unique<raw_partition_copier>(_schema, _permit, _io_priority);
+        for (auto& sst : candidates) {
+            if (can_copy_raw_partitions(*sst, *_schema, enc_stats)) {
+                co_await copier->add_source(sst, *_compacting, sst->get_gc_before_for_drop_estimation(now));
+            }
+        }
+        if (copier->empty()) {
+            _stats_collector = stats_collector;
+            co_return;
+        }
+        _raw_partition_copier = std::move(copier);
     }
 
     // This consumer will perform mutation compaction on producer side using
@@ -716,7 +887,14 @@ class compaction {
                 reader.consume_in_thread(std::move(cfc));
             });
         });
-        return consumer(make_sstable_reader());
+        return consumer(make_sstable_reader()).finally([this] {
+            if (!_raw_partition_copier) {
+                return make_ready_future<>();
+            }
+            log_debug("Copied {} partitions ({}) verbatim", _raw_partition_copier->partitions_copied(),
+                    pretty_printed_data_size(_raw_partition_copier->bytes_copied()));
+            return _raw_partition_copier->close();
+        });
     }
 
     virtual reader_consumer_v2 make_interposer_consumer(reader_consumer_v2 end_consumer) {
@@ -724,7 +902,7 @@ class compaction {
     }
 
     virtual bool use_interposer_consumer() const {
-        return _table_s.get_compaction_strategy().use_interposer_consumer();
+        return _table_s.get_compaction_strategy().use_interposer_consumer(_ms_metadata);
     }
 
     compaction_result finish(std::chrono::time_point<db_clock> started_at, std::chrono::time_point<db_clock> ended_at) {
@@ -733,6 +911,8 @@ class compaction {
             .ended_at = ended_at,
             .start_size = _start_size,
             .end_size = _end_size,
+            .partitions_copied = _raw_partition_copier ? _raw_partition_copier->partitions_copied() : 0,
+            .bytes_copied = _raw_partition_copier ? _raw_partition_copier->bytes_copied() : 0,
         };
 
         auto ratio = double(_end_size) / double(_start_size);
@@ -788,7 +968,8 @@ class compaction {
     compacted_fragments_writer get_compacted_fragments_writer() {
         return compacted_fragments_writer(*this,
             [this] (const dht::decorated_key& dk) { return create_compaction_writer(dk); },
-            [this] (compaction_writer* cw) { stop_sstable_writer(cw); });
+            [this] (compaction_writer* cw) { stop_sstable_writer(cw); },
+            _raw_partition_copier.get());
     }
 
     const schema_ptr& schema() const {
@@ -847,7 +1028,8 @@ compacted_fragments_writer::compacted_fragments_writer(compacted_fragments_write
         : _c(other._c)
         , _compaction_writer(std::move(other._compaction_writer))
         , _create_compaction_writer(std::move(other._create_compaction_writer))
-        , _stop_compaction_writer(std::move(other._stop_compaction_writer)) {
+        , _stop_compaction_writer(std::move(other._stop_compaction_writer))
+        , _raw_partition_copier(std::exchange(other._raw_partition_copier, nullptr)) {
     if (std::exchange(other._stop_request_observer, std::nullopt)) {
         _stop_request_observer = make_stop_request_observer(_c._stop_request_observable);
     }
@@ -860,8 +1042,29 @@ void compacted_fragments_writer::maybe_abort_compaction() {
     }
 }
 
+void compacted_fragments_writer::copy_raw_partitions(const dht::decorated_key* upper_bound) {
+    if (!_raw_partition_copier) {
+        return;
+    }
+    raw_partition_copier::consumer_fn consumer = [this] (const sstable& source, const dht::decorated_key& dk, temporary_buffer<char> data) {
+        maybe_abort_compaction();
+        if (!_compaction_writer) {
+            _compaction_writer = _create_compaction_writer(dk);
+        }
+        _c.on_new_partition();
+        auto ret = _compaction_writer->writer.consume_raw_partition(source, dk, std::move(data));
+        _c._cdata.total_keys_written++;
+        if (ret == stop_iteration::yes) {
+            _stop_compaction_writer(&*_compaction_writer);
+            _compaction_writer = std::nullopt;
+        }
+    };
+    _raw_partition_copier->copy(upper_bound, consumer);
+}
+
 void compacted_fragments_writer::consume_new_partition(const dht::decorated_key& dk) {
     maybe_abort_compaction();
+    copy_raw_partitions(&dk);
     if (!_compaction_writer) {
         _compaction_writer = _create_compaction_writer(dk);
     }
@@ -884,6 +1087,7 @@ stop_iteration compacted_fragments_writer::consume_end_of_partition() {
 }
 
 void compacted_fragments_writer::consume_end_of_stream() {
+    copy_raw_partitions(nullptr);
     if (_compaction_writer) {
         _stop_compaction_writer(&*_compaction_writer);
         _compaction_writer = std::nullopt;
@@ -901,15 +1105,7 @@ class reshape_compaction : public compaction {
     }
 
     flat_mutation_reader_v2 make_sstable_reader() const override {
-        return _compacting->make_local_shard_sstable_reader(_schema,
-                _permit,
-                query::full_partition_range,
-                _schema->full_slice(),
-                _io_priority,
-                tracing::trace_state_ptr(),
-                ::streamed_mutation::forwarding::no,
-                ::mutation_reader::forwarding::no,
-                default_read_monitor_generator());
+        return make_local_shard_sstable_reader(default_read_monitor_generator());
     }
 
     std::string_view report_start_desc() const override {
@@ -947,15 +1143,7 @@ class regular_compaction : public compaction {
     }
 
     flat_mutation_reader_v2 make_sstable_reader() const override {
-        return _compacting->make_local_shard_sstable_reader(_schema,
-                _permit,
-                query::full_partition_range,
-                _schema->full_slice(),
-                _io_priority,
-                tracing::trace_state_ptr(),
-                ::streamed_mutation::forwarding::no,
-                ::mutation_reader::forwarding::no,
-                _monitor_generator);
+        return make_local_shard_sstable_reader(_monitor_generator);
     }
 
     std::string_view report_start_desc() const override {
@@ -1725,6 +1913,10 @@ compact_sstables(sstables::compaction_descriptor descriptor, compaction_data& cd
         return make_exception_future<compaction_result>(std::runtime_error(format("Called {} compaction with empty set on behalf of {}.{}",
                 compaction_name(descriptor.options.type()), table_s.schema()->ks_name(), table_s.schema()->cf_name())));
     }
+    if (descriptor.token_range && (descriptor.options.type() == compaction_type::Scrub || descriptor.options.type() == compaction_type::Reshard)) {
+        return make_exception_future<compaction_result>(std::runtime_error(format("Called {} compaction restricted to a token range on behalf of {}.{}",
+                compaction_name(descriptor.options.type()), table_s.schema()->ks_name(), table_s.schema()->cf_name())));
+    }
     if (descriptor.options.type() == compaction_type::Scrub
             && std::get<compaction_type_options::scrub>(descriptor.options.options()).operation_mode == compaction_type_options::scrub::mode::validate) {
         // Bypass the usual compaction machinery for dry-mode scrub
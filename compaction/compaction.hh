@@ -90,6 +90,9 @@ struct compaction_result {
     std::chrono::time_point<db_clock> ended_at;
     uint64_t start_size = 0;
     uint64_t end_size = 0;
+    // Partitions copied verbatim from the inputs, see raw_partition_copier.
+    uint64_t partitions_copied = 0;
+    uint64_t bytes_copied = 0;
 };
 
 // Compact a list of N sstables into M sstables.
@@ -157,6 +157,14 @@ struct compaction_descriptor {
     // Denotes if this compaction task is comprised solely of completely expired SSTables
     sstables::has_only_fully_expired has_only_fully_expired = has_only_fully_expired::no;
 
+    // If set, only the partitions of this token range are compacted, and
+    // the input sstables are only passed to the replacer once the compaction
+    // is done, even if they are exhausted earlier. Sub-jobs of a compaction
+    // split by the compaction manager compact disjoint ranges of the same
+    // sstables. Not supported by scrub and resharding, which read the whole
+    // data file.
+    std::optional<dht::token_range> token_range;
+
     compaction_descriptor() = default;
 
     static constexpr int default_level = 0;
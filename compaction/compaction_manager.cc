@@ -8,6 +8,7 @@
 
 #include "compaction_manager.hh"
 #include "compaction_strategy.hh"
+#include "compaction_strategy_impl.hh"
 #include "compaction_backlog_manager.hh"
 #include "sstables/sstables.hh"
 #include "sstables/sstables_manager.hh"
@@ -16,12 +17,15 @@
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/switch_to.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/core/thread.hh>
 #include "sstables/exceptions.hh"
 #include "locator/abstract_replication_strategy.hh"
 #include "utils/fb_utilities.hh"
 #include "utils/UUID_gen.hh"
 #include <cmath>
 #include <boost/algorithm/cxx11/any_of.hpp>
+#include <boost/range/adaptor/map.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
 
 static logging::logger cmlog("compaction_manager");
@@ -285,10 +289,10 @@ future<> compaction_manager::perform_task(shared_ptr<compaction_manager::task> t
     }
 }
 
-future<> compaction_manager::task::compact_sstables_and_update_history(sstables::compaction_descriptor descriptor, sstables::compaction_data& cdata, release_exhausted_func_t release_exhausted, can_purge_tombstones can_purge) {
+future<sstables::compaction_result> compaction_manager::task::compact_sstables_and_update_history(sstables::compaction_descriptor descriptor, sstables::compaction_data& cdata, release_exhausted_func_t release_exhausted, can_purge_tombstones can_purge) {
     if (!descriptor.sstables.size()) {
         // if there is nothing to compact, just return.
-        co_return;
+        co_return sstables::compaction_result{};
     }
 
     bool should_update_history = this->should_update_history(descriptor.options.type());
@@ -297,6 +301,7 @@ future<> compaction_manager::task::compact_sstables_and_update_history(sstables:
     if (should_update_history) {
         co_await update_history(*_compacting_table, res, cdata);
     }
+    co_return res;
 }
 future<sstables::compaction_result> compaction_manager::task::compact_sstables(sstables::compaction_descriptor descriptor, sstables::compaction_data& cdata, release_exhausted_func_t release_exhausted, can_purge_tombstones can_purge) {
     replica::table& t = *_compacting_table;
@@ -319,6 +324,142 @@ future<sstables::compaction_result> compaction_manager::task::compact_sstables(s
 
     co_return co_await sstables::compact_sstables(std::move(descriptor), cdata, t.as_table_state());
 }
+
+// Splits the token span of the sstables of descriptor into disjoint ranges, one
+// for each sub-job, see compaction_max_sub_jobs. Returns no range if the job
+// isn't worth splitting.
+static dht::token_range_vector split_into_sub_job_ranges(const sstables::compaction_descriptor& descriptor) {
+    if (descriptor.sstables.empty()) {
+        return {};
+    }
+    auto& cfg = descriptor.sstables.front()->manager().config();
+    uint64_t min_sub_job_size = std::max(uint64_t(cfg.compaction_min_sub_job_size_in_mb()), uint64_t(1)) << 20;
+    uint64_t size = descriptor.sstables_size();
+    uint64_t sub_jobs = std::min(uint64_t(cfg.compaction_max_sub_jobs()), size / min_sub_job_size);
+    if (sub_jobs <= 1) {
+        return {};
+    }
+
+    auto first = std::ranges::min(descriptor.sstables | std::views::transform([] (const sstables::shared_sstable& sst) {
+        return dht::token::to_int64(sst->get_first_decorated_key().token());
+    }));
+    auto last = std::ranges::max(descriptor.sstables | std::views::transform([] (const sstables::shared_sstable& sst) {
+        return dht::token::to_int64(sst->get_last_decorated_key().token());
+    }));
+    uint64_t span = uint64_t(last) - uint64_t(first);
+    if (span < sub_jobs) {
+        return {};
+    }
+
+    // Subdivides the span evenly. The first and last ranges are left unbounded,
+    // so that the ranges cover the whole ring, whatever the tokens of the keys.
+    auto boundary = [&] (uint64_t i) {
+        return dht::token::from_int64(int64_t(uint64_t(first) + span / sub_jobs * i));
+    };
+    dht::token_range_vector ranges;
+    ranges.reserve(sub_jobs);
+    ranges.push_back(dht::token_range::make_ending_with({boundary(1), true}));
+    for (uint64_t i = 1; i < sub_jobs - 1; ++i) {
+        ranges.push_back(dht::token_range::make({boundary(i), false}, {boundary(i + 1), true}));
+    }
+    ranges.push_back(dht::token_range::make_starting_with({boundary(sub_jobs - 1), false}));
+    return ranges;
+}
+
+future<sstables::compaction_result> compaction_manager::task::compact_sstables_in_sub_jobs_and_update_history(sstables::compaction_descriptor descriptor, release_exhausted_func_t release_exhausted, can_purge_tombstones can_purge) {
+    auto ranges = split_into_sub_job_ranges(descriptor);
+    if (ranges.empty()) {
+        co_return co_await compact_sstables_and_update_history(std::move(descriptor), _compaction_data, std::move(release_exhausted), can_purge);
+    }
+
+    replica::table& t = *_compacting_table;
+    auto inputs = descriptor.sstables;
+    bool should_update_history = this->should_update_history(descriptor.options.type());
+    cmlog.debug("Splitting {} compaction of {} sstables of {}.{} into {} sub-jobs", descriptor.options.type(), inputs.size(),
+            t.schema()->ks_name(), t.schema()->cf_name(), ranges.size());
+
+    // The outputs of the sub-jobs replace the inputs at once, when all are
+    // done, as every input is compacted by every sub-job.
+    std::vector<sstables::shared_sstable> new_sstables;
+    dht::partition_range_vector ranges_for_cache_invalidation;
+    uint64_t end_size = 0;
+    auto fold_sub_jobs_data = defer([this] () noexcept {
+        for (auto& cdata : _sub_jobs_data) {
+            _compaction_data.total_partitions += cdata.total_partitions;
+            _compaction_data.total_keys_written += cdata.total_keys_written;
+        }
+        _sub_jobs_data.clear();
+    });
+
+    std::exception_ptr ex;
+    try {
+        co_await coroutine::parallel_for_each(ranges, [&] (const dht::token_range& range) -> future<> {
+            auto& cdata = _sub_jobs_data.emplace_back(create_compaction_data());
+            auto sub_job = descriptor;
+            sub_job.token_range = range;
+            // Each sub-job writes its own run of disjoint sstables.
+            sub_job.run_identifier = utils::make_random_uuid();
+            if (can_purge) {
+                sub_job.enable_garbage_collection(t.get_sstable_set());
+            }
+            sub_job.creator = [&t] (shard_id dummy) {
+                return t.make_sstable();
+            };
+            sub_job.replacer = [&] (sstables::compaction_completion_desc desc) {
+                std::move(desc.new_sstables.begin(), desc.new_sstables.end(), std::back_inserter(new_sstables));
+                std::move(desc.ranges_for_cache_invalidation.begin(), desc.ranges_for_cache_invalidation.end(), std::back_inserter(ranges_for_cache_invalidation));
+            };
+            try {
+                auto res = co_await sstables::compact_sstables(std::move(sub_job), cdata, t.as_table_state());
+                end_size += res.end_size;
+            } catch (...) {
+                // Stops the sibling sub-jobs, as the compaction failed anyway.
+                for (auto& other : _sub_jobs_data) {
+                    if (&other != &cdata && !other.is_stop_requested()) {
+                        other.stop("sibling sub-job failed");
+                    }
+                }
+                throw;
+            }
+        });
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        // The outputs of the sub-jobs that succeeded replace nothing.
+        for (auto& sst : new_sstables) {
+            sst->mark_for_deletion();
+        }
+        co_return coroutine::exception(std::move(ex));
+    }
+
+    co_await seastar::async([&] {
+        auto desc = sstables::compaction_completion_desc{
+            .old_sstables = inputs,
+            .new_sstables = new_sstables,
+            .ranges_for_cache_invalidation = dht::partition_range::deoverlap(std::move(ranges_for_cache_invalidation), dht::ring_position_comparator(*t.schema())),
+        };
+        t.get_compaction_strategy().notify_completion(desc.old_sstables, desc.new_sstables);
+        _cm.propagate_replacement(&t, desc.old_sstables, desc.new_sstables);
+        t.on_compaction_completion(desc);
+        if (release_exhausted) {
+            release_exhausted(desc.old_sstables);
+        }
+    });
+
+    sstables::compaction_result res;
+    res.new_sstables = std::move(new_sstables);
+    res.ended_at = db_clock::now();
+    for (auto& sst : inputs) {
+        res.start_size += sst->bytes_on_disk();
+    }
+    res.end_size = end_size;
+    if (should_update_history) {
+        co_await update_history(t, res, _compaction_data);
+    }
+    co_return res;
+}
+
 future<> compaction_manager::task::update_history(replica::table& t, const sstables::compaction_result& res, const sstables::compaction_data& cdata) {
     auto ended_at = std::chrono::duration_cast<std::chrono::milliseconds>(res.ended_at.time_since_epoch());
 
@@ -361,7 +502,7 @@ class compaction_manager::major_compaction_task : public compaction_manager::tas
         compaction_backlog_tracker bt(std::make_unique<user_initiated_backlog_tracker>(_cm._compaction_controller.backlog_of_shares(200), _cm._available_memory));
         _cm.register_backlog_tracker(bt);
 
-        co_await compact_sstables_and_update_history(std::move(descriptor), _compaction_data, std::move(release_exhausted));
+        co_await compact_sstables_in_sub_jobs_and_update_history(std::move(descriptor), std::move(release_exhausted));
 
         finish_compaction();
     }
@@ -579,6 +720,9 @@ void compaction_manager::task::finish_compaction(state finish_state) noexcept {
 }
 
 void compaction_manager::task::stop(sstring reason) noexcept {
+    for (auto& cdata : _sub_jobs_data) {
+        cdata.stop(reason);
+    }
     _compaction_data.stop(std::move(reason));
 }
 
@@ -587,6 +731,47 @@ sstables::compaction_stopped_exception compaction_manager::task::make_compaction
     return sstables::compaction_stopped_exception(s->ks_name(), s->cf_name(), _compaction_data.stop_requested);
 }
 
+float compaction_manager::sample_read_amplification() {
+    // Weight of the last sample in the moving averages. The controller samples
+    // every 250ms, so older samples fade out in a few seconds.
+    static constexpr double alpha = 0.2;
+
+    auto target = _read_amplification_target();
+    double worst_ratio = 0;
+    for (auto& [t, cs] : _compaction_state) {
+        auto& stats = t->get_stats();
+        auto sstables_read = stats.estimated_sstable_per_read.get_histogram();
+        auto reads = int64_t(sstables_read.sample_count) - std::exchange(cs.sampled_reads, sstables_read.sample_count);
+        auto sstables = int64_t(sstables_read.sample_sum) - std::exchange(cs.sampled_sstables_read, sstables_read.sample_sum);
+        // Only a sample of the reads is timed.
+        auto timed_reads = stats.reads.hist.total - std::exchange(cs.sampled_timed_reads, stats.reads.hist.total);
+        auto latency_sum = stats.reads.hist.sum - std::exchange(cs.sampled_read_latency_sum, stats.reads.hist.sum);
+
+        auto& ra = cs.read_amplification;
+        // Tables which weren't read since the last sample keep their averages.
+        if (reads > 0) {
+            ra.sstables_per_read = alpha * sstables / reads + (1 - alpha) * ra.sstables_per_read;
+        }
+        if (timed_reads > 0) {
+            ra.read_latency_us = alpha * latency_sum / timed_reads + (1 - alpha) * ra.read_latency_us;
+        }
+        ra.exceeded = target > 0 && ra.sstables_per_read > target;
+        if (ra.exceeded) {
+            worst_ratio = std::max(worst_ratio, ra.sstables_per_read / target);
+        }
+    }
+    // Proportional to the excess of the worst table over the target, so that
+    // compaction gets the maximum shares once reads touch twice as many
+    // sstables as the target.
+    _read_amplification_backlog = worst_ratio > 1 ? std::min(float(worst_ratio - 1), 1.0f) * compaction_controller::normalization_factor : 0.0f;
+    return _read_amplification_backlog;
+}
+
+compaction_manager::read_amplification_stats compaction_manager::get_read_amplification(replica::table* t) const {
+    auto it = _compaction_state.find(t);
+    return it != _compaction_state.end() ? it->second.read_amplification : read_amplification_stats{};
+}
+
 compaction_manager::compaction_manager(compaction_scheduling_group csg, maintenance_scheduling_group msg, size_t available_memory, abort_source& as)
     : _compaction_controller(csg.cpu, csg.io, 250ms, [this, available_memory] () -> float {
         _last_backlog = backlog();
@@ -598,7 +783,7 @@ compaction_manager::compaction_manager(compaction_scheduling_group csg, maintena
             // all strategies.
             return compaction_controller::normalization_factor;
         }
-        return b;
+        return std::max(b, sample_read_amplification());
     })
     , _backlog_manager(_compaction_controller)
     , _maintenance_sg(msg)
@@ -659,6 +844,14 @@ void compaction_manager::register_metrics() {
                        sm::description("Holds the sum of compaction backlog for all tables in the system.")),
         sm::make_gauge("normalized_backlog", [this] { return _last_backlog / _available_memory; },
                        sm::description("Holds the sum of normalized compaction backlog for all tables in the system. Backlog is normalized by dividing backlog by shard's available memory.")),
+        sm::make_counter("cleanup_bytes_reclaimed", [this] { return _stats.cleanup_bytes_reclaimed; },
+                       sm::description("Holds the number of bytes on disk which cleanup freed, by dropping sstables which hold no owned token, or by rewriting them.")),
+        sm::make_counter("expired_sstables_dropped", [this] { return _stats.expired_sstables_dropped; },
+                       sm::description("Holds the number of fully expired sstables which were dropped without being compacted.")),
+        sm::make_counter("expired_bytes_dropped", [this] { return _stats.expired_bytes_dropped; },
+                       sm::description("Holds the number of bytes on disk of the fully expired sstables which were dropped without being compacted.")),
+        sm::make_gauge("read_amplification_backlog", [this] { return _read_amplification_backlog; },
+                       sm::description("Holds the normalized backlog which reads touching more sstables than compaction_read_amplification_target add to the compaction controller.")),
     });
 }
 
@@ -666,6 +859,7 @@ void compaction_manager::enable() {
     assert(_state == state::none || _state == state::disabled);
     _state = state::enabled;
     _compaction_submission_timer.arm(periodic_compaction_submission_interval());
+    _expired_sstables_sweep_timer.arm_periodic(expired_sstables_sweep_interval());
     postponed_compactions_reevaluation();
 }
 
@@ -677,6 +871,39 @@ std::function<void()> compaction_manager::compaction_submission_callback() {
     };
 }
 
+std::chrono::seconds compaction_manager::expired_sstables_sweep_interval() {
+    return sstables::compaction_strategy_impl::DEFAULT_EXPIRED_SSTABLE_CHECK_FREQUENCY();
+}
+
+std::function<void()> compaction_manager::expired_sstables_sweep_callback() {
+    return [this] () mutable {
+        // Skip this round if the previous sweep is still going.
+        if (_expired_sstables_sweep.available()) {
+            _expired_sstables_sweep = sweep_expired_sstables();
+        }
+    };
+}
+
+future<> compaction_manager::sweep_expired_sstables() {
+    auto now = gc_clock::now();
+    auto may_be_expired = [now] (const sstables::shared_sstable& sst) {
+        return sst->get_max_local_deletion_time() < sst->get_gc_before_for_fully_expire(now);
+    };
+    // Tables may be removed while we yield.
+    auto tables = boost::copy_range<std::vector<replica::table*>>(_compaction_state | boost::adaptors::map_keys);
+    for (auto t : tables) {
+        if (_state != state::enabled) {
+            break;
+        }
+        // Whether they're really fully expired is up to the strategy,
+        // see compaction_strategy::get_fully_expired_sstables_job().
+        if (_compaction_state.contains(t) && std::ranges::any_of(get_candidates(*t), may_be_expired)) {
+            submit(t);
+        }
+        co_await coroutine::maybe_yield();
+    }
+}
+
 void compaction_manager::postponed_compactions_reevaluation() {
     _waiting_reevalution = repeat([this] {
         return _postponed_reevaluation.wait().then([this] {
@@ -781,6 +1008,9 @@ void compaction_manager::really_do_stop() {
     }).then([this] {
         _weight_tracker.clear();
         _compaction_submission_timer.cancel();
+        _expired_sstables_sweep_timer.cancel();
+        return std::move(_expired_sstables_sweep);
+    }).then([this] {
         cmlog.info("Stopped");
         return _compaction_controller.shutdown();
     }));
@@ -865,7 +1095,12 @@ class compaction_manager::regular_compaction_task : public compaction_manager::t
 
             replica::table& t = *_compacting_table;
             sstables::compaction_strategy cs = t.get_compaction_strategy();
-            sstables::compaction_descriptor descriptor = cs.get_sstables_for_compaction(t.as_table_state(), _cm.get_strategy_control(), _cm.get_candidates(t));
+            auto candidates = _cm.get_candidates(t);
+            // Fully expired sstables are dropped first, whatever the strategy.
+            sstables::compaction_descriptor descriptor = cs.get_fully_expired_sstables_job(t.as_table_state(), candidates);
+            if (descriptor.sstables.empty()) {
+                descriptor = cs.get_sstables_for_compaction(t.as_table_state(), _cm.get_strategy_control(), std::move(candidates));
+            }
             int weight = calculate_weight(descriptor);
 
             if (descriptor.sstables.empty() || !can_proceed() || t.is_auto_compaction_disabled_by_user()) {
@@ -892,8 +1127,13 @@ class compaction_manager::regular_compaction_task : public compaction_manager::t
 
             try {
                 bool should_update_history = this->should_update_history(descriptor.options.type());
+                auto expired = descriptor.has_only_fully_expired ? descriptor.sstables.size() : 0;
                 sstables::compaction_result res = co_await compact_sstables(std::move(descriptor), _compaction_data, std::move(release_exhausted));
                 finish_compaction();
+                if (expired) {
+                    _cm._stats.expired_sstables_dropped += expired;
+                    _cm._stats.expired_bytes_dropped += res.start_size;
+                }
                 if (should_update_history) {
                     // update_history can take a long time compared to
                     // compaction, as a call issued on shard S1 can be
@@ -1108,7 +1348,13 @@ class compaction_manager::rewrite_sstables_compaction_task : public compaction_m
 
             std::exception_ptr ex;
             try {
-                co_await compact_sstables_and_update_history(std::move(descriptor), _compaction_data, std::move(release_exhausted), _can_purge);
+                // Scrub reads the sstable with a crawling reader, which can't be
+                // restricted to a token range.
+                if (_options.type() == sstables::compaction_type::Scrub) {
+                    co_await compact_sstables_and_update_history(std::move(descriptor), _compaction_data, std::move(release_exhausted), _can_purge);
+                } else {
+                    co_await compact_sstables_in_sub_jobs_and_update_history(std::move(descriptor), std::move(release_exhausted), _can_purge);
+                }
                 finish_compaction();
                 _cm.reevaluate_postponed_compactions();
                 co_return;  // done with current sstable
@@ -1216,13 +1462,31 @@ future<> compaction_manager::perform_sstable_scrub_validate_mode(replica::table*
 class compaction_manager::cleanup_sstables_compaction_task : public compaction_manager::task {
     const sstables::compaction_type_options _cleanup_options;
     compacting_sstable_registration _compacting;
+    // Candidates which hold no owned token, dropped without being rewritten.
+    std::vector<sstables::shared_sstable> _unowned_sstables;
     std::vector<sstables::compaction_descriptor> _pending_cleanup_jobs;
+private:
+    static std::vector<sstables::shared_sstable> extract_unowned(replica::table* t, const sstables::compaction_type_options& options,
+                                                                 std::vector<sstables::shared_sstable>& candidates) {
+        auto& owned_ranges = std::get<sstables::compaction_type_options::cleanup>(options.options()).owned_ranges;
+        // Without owned ranges, leave it to cleanup compaction to decide what to keep.
+        if (owned_ranges.empty()) {
+            return {};
+        }
+        auto unowned = std::ranges::partition(candidates, [&] (const sstables::shared_sstable& sst) {
+            return !is_fully_unowned(sst, owned_ranges, t->schema());
+        });
+        std::vector<sstables::shared_sstable> ret(unowned.begin(), unowned.end());
+        candidates.erase(unowned.begin(), unowned.end());
+        return ret;
+    }
 public:
     cleanup_sstables_compaction_task(compaction_manager& mgr, replica::table* t, sstables::compaction_type_options options,
                                      std::vector<sstables::shared_sstable> candidates, compacting_sstable_registration compacting)
             : task(mgr, t, options.type(), sstring(sstables::to_string(options.type())))
             , _cleanup_options(std::move(options))
             , _compacting(std::move(compacting))
+            , _unowned_sstables(extract_unowned(t, _cleanup_options, candidates))
             , _pending_cleanup_jobs(t->get_compaction_strategy().get_cleanup_compaction_jobs(t->as_table_state(), std::move(candidates)))
     {
         // Cleanup is made more resilient under disk space pressure, by cleaning up smaller jobs first, so larger jobs
@@ -1239,6 +1503,9 @@ class compaction_manager::cleanup_sstables_compaction_task : public compaction_m
         switch_state(state::pending);
         auto maintenance_permit = co_await acquire_semaphore(_cm._maintenance_ops_sem);
 
+        if (!_unowned_sstables.empty() && can_proceed()) {
+            co_await drop_unowned_sstables();
+        }
         while (!_pending_cleanup_jobs.empty() && can_proceed()) {
             auto active_job = std::move(_pending_cleanup_jobs.back());
             active_job.options = _cleanup_options;
@@ -1253,6 +1520,34 @@ class compaction_manager::cleanup_sstables_compaction_task : public compaction_m
         _compacting.release_compacting(exhausted_sstables);
     }
 
+    // Removes the sstables which hold no owned token from the table, as
+    // cleanup compaction would write nothing out of them anyway.
+    future<> drop_unowned_sstables() {
+        replica::table& t = *_compacting_table;
+        auto sstables = std::exchange(_unowned_sstables, {});
+        uint64_t bytes = 0;
+        dht::partition_range_vector ranges;
+        ranges.reserve(sstables.size());
+        for (auto& sst : sstables) {
+            bytes += sst->bytes_on_disk();
+            ranges.push_back(dht::partition_range::make(sst->get_first_decorated_key(), sst->get_last_decorated_key()));
+        }
+        cmlog.info("Cleanup of {}.{}: dropping {} sstables ({} bytes) which hold no owned token", t.schema()->ks_name(), t.schema()->cf_name(),
+                sstables.size(), bytes);
+        co_await seastar::async([&] {
+            auto desc = sstables::compaction_completion_desc{
+                .old_sstables = sstables,
+                .new_sstables = {},
+                .ranges_for_cache_invalidation = dht::partition_range::deoverlap(std::move(ranges), dht::ring_position_comparator(*t.schema())),
+            };
+            t.get_compaction_strategy().notify_completion(desc.old_sstables, desc.new_sstables);
+            _cm.propagate_replacement(&t, desc.old_sstables, desc.new_sstables);
+            t.on_compaction_completion(desc);
+            release_exhausted(desc.old_sstables);
+        });
+        _cm._stats.cleanup_bytes_reclaimed += bytes;
+    }
+
     future<> run_cleanup_job(sstables::compaction_descriptor descriptor) {
         co_await coroutine::switch_to(_cm._compaction_controller.sg());
 
@@ -1263,8 +1558,9 @@ class compaction_manager::cleanup_sstables_compaction_task : public compaction_m
             std::exception_ptr ex;
             try {
                 setup_new_compaction(descriptor.run_identifier);
-                co_await compact_sstables_and_update_history(descriptor, _compaction_data,
+                auto res = co_await compact_sstables_in_sub_jobs_and_update_history(descriptor,
                                           std::bind(&cleanup_sstables_compaction_task::release_exhausted, this, std::placeholders::_1));
+                _cm._stats.cleanup_bytes_reclaimed += res.start_size - std::min(res.start_size, res.end_size);
                 finish_compaction();
                 _cm.reevaluate_postponed_compactions();
                 co_return;  // done with current job
@@ -1305,7 +1601,57 @@ bool needs_cleanup(const sstables::shared_sstable& sst,
     return true;
 }
 
+bool is_fully_unowned(const sstables::shared_sstable& sst,
+                      const dht::token_range_vector& sorted_owned_ranges,
+                      schema_ptr s) {
+    auto first_token = sst->get_first_decorated_key().token();
+    auto last_token = sst->get_last_decorated_key().token();
+    dht::token_range sst_token_range = dht::token_range::make(first_token, last_token);
+
+    // The first owned range which doesn't end before the sstable starts is
+    // the only one which may overlap it.
+    auto r = std::lower_bound(sorted_owned_ranges.begin(), sorted_owned_ranges.end(), first_token,
+            [] (const range<dht::token>& a, const dht::token& b) {
+        return a.after(b, dht::token_comparator());
+    });
+    return r == sorted_owned_ranges.end() || !r->overlaps(sst_token_range, dht::token_comparator());
+}
+
+uint64_t cleanup_reclaimable_bytes(const sstables::shared_sstable& sst,
+                                   const dht::token_range_vector& sorted_owned_ranges,
+                                   schema_ptr s) {
+    if (sorted_owned_ranges.empty() || is_fully_unowned(sst, sorted_owned_ranges, s)) {
+        return sst->bytes_on_disk();
+    }
+    if (!needs_cleanup(sst, sorted_owned_ranges, s)) {
+        return 0;
+    }
+    auto first = sst->get_first_decorated_key().token();
+    auto last = sst->get_last_decorated_key().token();
+    auto distance = [] (const dht::token& a, const dht::token& b) {
+        return double(dht::token::to_int64(b)) - double(dht::token::to_int64(a));
+    };
+    auto span = distance(first, last);
+    if (span <= 0) {
+        return 0;
+    }
+    dht::token_comparator cmp;
+    double owned = 0;
+    for (auto& r : sorted_owned_ranges) {
+        auto start = r.start() && cmp(r.start()->value(), first) > 0 ? r.start()->value() : first;
+        auto end = r.end() && cmp(r.end()->value(), last) < 0 ? r.end()->value() : last;
+        if (cmp(start, end) < 0) {
+            owned += distance(start, end);
+        }
+    }
+    return uint64_t(sst->bytes_on_disk() * std::clamp(1 - owned / span, 0.0, 1.0));
+}
+
 future<> compaction_manager::perform_cleanup(replica::database& db, replica::table* t) {
+    co_await perform_cleanup(t, db.get_keyspace_local_ranges(t->schema()->ks_name()));
+}
+
+future<> compaction_manager::perform_cleanup(replica::table* t, dht::token_range_vector sorted_owned_ranges) {
     auto check_for_cleanup = [this, t] {
         return boost::algorithm::any_of(_tasks, [t] (auto& task) {
             return task->compacting_table() == t && task->type() == sstables::compaction_type::Cleanup;
@@ -1316,9 +1662,8 @@ future<> compaction_manager::perform_cleanup(replica::database& db, replica::tab
             t->schema()->ks_name(), t->schema()->cf_name()));
     }
 
-    auto sorted_owned_ranges = db.get_keyspace_local_ranges(t->schema()->ks_name());
-    auto get_sstables = [this, &db, t, sorted_owned_ranges] () -> future<std::vector<sstables::shared_sstable>> {
-        return seastar::async([this, &db, t, sorted_owned_ranges = std::move(sorted_owned_ranges)] {
+    auto get_sstables = [this, t, sorted_owned_ranges] () -> future<std::vector<sstables::shared_sstable>> {
+        return seastar::async([this, t, sorted_owned_ranges = std::move(sorted_owned_ranges)] {
             auto schema = t->schema();
             auto sstables = std::vector<sstables::shared_sstable>{};
             const auto candidates = get_candidates(*t);
@@ -1334,6 +1679,67 @@ future<> compaction_manager::perform_cleanup(replica::database& db, replica::tab
                                                                          std::move(get_sstables));
 }
 
+future<> compaction_manager::perform_keyspace_cleanup(replica::database& db, sstring ks_name, std::vector<utils::UUID> table_ids) {
+    auto sorted_owned_ranges = db.get_keyspace_local_ranges(ks_name);
+
+    // Tables are looked up again after every preemption point, as they can be
+    // dropped in the meantime.
+    auto find_table = [&db] (const utils::UUID& id) -> replica::table* {
+        try {
+            return &db.find_column_family(id);
+        } catch (replica::no_such_column_family&) {
+            return nullptr;
+        }
+    };
+
+    std::vector<std::pair<utils::UUID, uint64_t>> pending;
+    pending.reserve(table_ids.size());
+    for (auto& id : table_ids) {
+        auto* t = find_table(id);
+        if (!t) {
+            continue;
+        }
+        // The estimate only orders the tables: whether a table is cleaned up
+        // is decided by needs_cleanup(), like perform_cleanup() does, over all
+        // of its sstables, including the ones being compacted now.
+        bool cleanup_needed = false;
+        uint64_t reclaimable = 0;
+        auto sstables = t->get_sstables();
+        for (auto& sst : *sstables) {
+            if (sorted_owned_ranges.empty() || needs_cleanup(sst, sorted_owned_ranges, t->schema())) {
+                cleanup_needed = true;
+                reclaimable += cleanup_reclaimable_bytes(sst, sorted_owned_ranges, t->schema());
+            }
+        }
+        if (cleanup_needed) {
+            pending.emplace_back(id, reclaimable);
+        }
+        co_await coroutine::maybe_yield();
+    }
+    std::ranges::sort(pending, std::ranges::greater(), &std::pair<utils::UUID, uint64_t>::second);
+    uint64_t total_reclaimable = 0;
+    for (auto& [id, reclaimable] : pending) {
+        total_reclaimable += reclaimable;
+    }
+    cmlog.info("Cleanup of keyspace {}: {} of {} tables to clean up, {} bytes estimated to be reclaimable", ks_name, pending.size(), table_ids.size(),
+            total_reclaimable);
+
+    auto started_at = lowres_clock::now();
+    auto reclaimed_before = _stats.cleanup_bytes_reclaimed;
+    for (auto& [id, reclaimable] : pending) {
+        auto* t = find_table(id);
+        if (!t) {
+            continue;
+        }
+        cmlog.debug("Cleanup of keyspace {}: cleaning up {} with {} bytes estimated to be reclaimable", ks_name, t->schema()->cf_name(), reclaimable);
+        co_await perform_cleanup(t, sorted_owned_ranges);
+    }
+    auto reclaimed = _stats.cleanup_bytes_reclaimed - reclaimed_before;
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(lowres_clock::now() - started_at).count();
+    cmlog.info("Cleanup of keyspace {}: reclaimed {} bytes in {:.3f}s ({:.0f} bytes/s)", ks_name, reclaimed, elapsed,
+            elapsed > 0 ? reclaimed / elapsed : 0.0);
+}
+
 // Submit a table to be upgraded and wait for its termination.
 future<> compaction_manager::perform_sstable_upgrade(replica::database& db, replica::table* t, bool exclude_current_version) {
     auto get_sstables = [this, &db, t, exclude_current_version] {
@@ -1440,6 +1846,10 @@ const std::vector<sstables::compaction_info> compaction_manager::get_compactions
         ret.cf_name = task->compacting_table()->schema()->cf_name();
         ret.total_partitions = task->compaction_data().total_partitions;
         ret.total_keys_written = task->compaction_data().total_keys_written;
+        for (auto& cdata : task->sub_jobs_compaction_data()) {
+            ret.total_partitions += cdata.total_partitions;
+            ret.total_keys_written += cdata.total_keys_written;
+        }
         return ret;
     };
     using ret = std::vector<sstables::compaction_info>;
@@ -1472,6 +1882,9 @@ void compaction_manager::propagate_replacement(replica::table* t,
     for (auto& task : _tasks) {
         if (task->compacting_table() == t && task->compaction_running()) {
             task->compaction_data().pending_replacements.push_back({ removed, added });
+            for (auto& cdata : task->sub_jobs_compaction_data()) {
+                cdata.pending_replacements.push_back({ removed, added });
+            }
         }
     }
 }
@@ -1488,6 +1901,12 @@ class compaction_manager::strategy_control : public compaction::strategy_control
                 && task->compacting_table()->schema()->cf_name() == s->cf_name();
         });
     }
+
+    bool read_amplification_exceeded(table_state& table_s) const noexcept override {
+        return std::any_of(_cm._compaction_state.begin(), _cm._compaction_state.end(), [&s = table_s.schema()] (const auto& e) {
+            return e.second.read_amplification.exceeded && e.first->schema()->id() == s->id();
+        });
+    }
 };
 
 compaction::strategy_control& compaction_manager::get_strategy_control() const noexcept {
@@ -20,6 +20,7 @@
 #include <seastar/core/condition-variable.hh>
 #include "log.hh"
 #include "utils/exponential_backoff_retry.hh"
+#include "utils/updateable_value.hh"
 #include <vector>
 #include <list>
 #include <functional>
@@ -47,6 +48,11 @@ class compaction_manager {
         int64_t completed_tasks = 0;
         uint64_t active_tasks = 0; // Number of compaction going on.
         int64_t errors = 0;
+        // Bytes on disk which cleanup freed, by dropping or rewriting sstables.
+        uint64_t cleanup_bytes_reclaimed = 0;
+        // Fully expired sstables which were dropped without being read.
+        uint64_t expired_sstables_dropped = 0;
+        uint64_t expired_bytes_dropped = 0;
     };
     struct compaction_scheduling_group {
         seastar::scheduling_group cpu;
@@ -56,6 +62,16 @@ class compaction_manager {
         seastar::scheduling_group cpu;
         const ::io_priority_class& io;
     };
+    // Read amplification of a table, as last sampled by the read amplification
+    // controller, see compaction_read_amplification_target.
+    struct read_amplification_stats {
+        // Moving averages, over the sampled reads, of the sstables touched and
+        // of the latency in microseconds per read.
+        double sstables_per_read = 0;
+        double read_latency_us = 0;
+        // Whether sstables_per_read exceeds the target.
+        bool exceeded = false;
+    };
 private:
     struct compaction_state {
         // Used both by compaction tasks that refer to the compaction_state
@@ -71,6 +87,14 @@ class compaction_manager {
         bool compaction_disabled() const noexcept {
             return compaction_disabled_counter > 0;
         }
+
+        read_amplification_stats read_amplification;
+        // Totals of the read statistics of the table as of the last sample,
+        // see sample_read_amplification().
+        int64_t sampled_reads = 0;
+        int64_t sampled_sstables_read = 0;
+        int64_t sampled_timed_reads = 0;
+        int64_t sampled_read_latency_sum = 0;
     };
 
 public:
@@ -99,6 +123,9 @@ class compaction_manager {
         replica::table* _compacting_table = nullptr;
         compaction_state& _compaction_state;
         sstables::compaction_data _compaction_data;
+        // The compaction data of the running sub-jobs of the compaction, if
+        // it's split, see compact_sstables_in_sub_jobs_and_update_history().
+        std::list<sstables::compaction_data> _sub_jobs_data;
         state _state = state::none;
 
     private:
@@ -147,10 +174,16 @@ class compaction_manager {
 
         // Compacts set of SSTables according to the descriptor.
         using release_exhausted_func_t = std::function<void(const std::vector<sstables::shared_sstable>& exhausted_sstables)>;
-        future<> compact_sstables_and_update_history(sstables::compaction_descriptor descriptor, sstables::compaction_data& cdata, release_exhausted_func_t release_exhausted,
+        future<sstables::compaction_result> compact_sstables_and_update_history(sstables::compaction_descriptor descriptor, sstables::compaction_data& cdata, release_exhausted_func_t release_exhausted,
                                   can_purge_tombstones can_purge = can_purge_tombstones::yes);
         future<sstables::compaction_result> compact_sstables(sstables::compaction_descriptor descriptor, sstables::compaction_data& cdata, release_exhausted_func_t release_exhausted,
                                   can_purge_tombstones can_purge = can_purge_tombstones::yes);
+        // Like compact_sstables_and_update_history(), but splits large jobs into
+        // sub-jobs which compact disjoint token ranges of the sstables concurrently,
+        // each into its own output run (see compaction_max_sub_jobs). The inputs
+        // are replaced by the outputs of all sub-jobs at once, when all are done.
+        future<sstables::compaction_result> compact_sstables_in_sub_jobs_and_update_history(sstables::compaction_descriptor descriptor, release_exhausted_func_t release_exhausted,
+                                  can_purge_tombstones can_purge = can_purge_tombstones::yes);
         future<> update_history(replica::table& t, const sstables::compaction_result& res, const sstables::compaction_data& cdata);
         bool should_update_history(sstables::compaction_type ct) {
             return ct == sstables::compaction_type::Compaction;
@@ -178,6 +211,14 @@ class compaction_manager {
             return _compaction_data;
         }
 
+        std::list<sstables::compaction_data>& sub_jobs_compaction_data() noexcept {
+            return _sub_jobs_data;
+        }
+
+        const std::list<sstables::compaction_data>& sub_jobs_compaction_data() const noexcept {
+            return _sub_jobs_data;
+        }
+
         bool generating_output_run() const noexcept {
             return compaction_running() && _output_run_identifier;
         }
@@ -254,6 +295,11 @@ class compaction_manager {
     stats _stats;
     seastar::metrics::metric_groups _metrics;
     double _last_backlog = 0.0f;
+    // Target of the read amplification controller, in sstables touched per
+    // read. 0 disables the controller.
+    utils::updateable_value<float> _read_amplification_target;
+    // Last input which the read amplification fed to the controller.
+    float _read_amplification_backlog = 0.0f;
 
     // Store sstables that are being compacted at the moment. That's needed to prevent
     // a sstable from being compacted twice.
@@ -284,6 +330,15 @@ class compaction_manager {
     timer<lowres_clock> _compaction_submission_timer = timer<lowres_clock>(compaction_submission_callback());
     static constexpr std::chrono::seconds periodic_compaction_submission_interval() { return std::chrono::seconds(3600); }
 
+    std::function<void()> expired_sstables_sweep_callback();
+    future<> sweep_expired_sstables();
+    // tables which may hold fully expired sstables are submitted more often, so
+    // that they're dropped even if nothing else triggers a compaction of the table.
+    timer<lowres_clock> _expired_sstables_sweep_timer = timer<lowres_clock>(expired_sstables_sweep_callback());
+    future<> _expired_sstables_sweep = make_ready_future<>();
+    // Strategies don't look for fully expired sstables more often than that anyway.
+    static std::chrono::seconds expired_sstables_sweep_interval();
+
     compaction_controller _compaction_controller;
     compaction_backlog_manager _backlog_manager;
     maintenance_scheduling_group _maintenance_sg;
@@ -311,6 +366,12 @@ class compaction_manager {
     // Get candidates for compaction strategy, which are all sstables but the ones being compacted.
     std::vector<sstables::shared_sstable> get_candidates(const replica::table& t);
 
+    // Samples the read statistics of every table and updates their
+    // read_amplification_stats. Returns the input of the compaction controller
+    // which makes compaction catch up with the tables whose reads touch more
+    // sstables than the target, as a normalized backlog.
+    float sample_read_amplification();
+
     template <typename Iterator, typename Sentinel>
     requires std::same_as<Sentinel, Iterator> || std::sentinel_for<Sentinel, Iterator>
     void register_compacting_sstables(Iterator first, Sentinel last);
@@ -392,6 +453,21 @@ class compaction_manager {
     // of a newly added node.
     future<> perform_cleanup(replica::database& db, replica::table* t);
 
+    // Like perform_cleanup(), with owned ranges computed by the caller.
+    //
+    // Sstables which don't hold any owned token are dropped outright, rather
+    // than rewritten.
+    future<> perform_cleanup(replica::table* t, dht::token_range_vector sorted_owned_ranges);
+
+    // Submit the tables of a keyspace to be cleaned up and wait for their termination.
+    //
+    // The owned ranges of the keyspace are computed once, for all the tables,
+    // which are cleaned up one after the other, in decreasing order of their
+    // bytes reclaimable by cleanup (see cleanup_reclaimable_bytes()). Tables
+    // with no sstable which needs cleanup, and tables dropped in the meantime,
+    // are skipped.
+    future<> perform_keyspace_cleanup(replica::database& db, sstring ks_name, std::vector<utils::UUID> table_ids);
+
     // Submit a table to be upgraded and wait for its termination.
     future<> perform_sstable_upgrade(replica::database& db, replica::table* t, bool exclude_current_version);
 
@@ -452,6 +528,22 @@ class compaction_manager {
         return _stats;
     }
 
+    // Sets the target of the read amplification controller.
+    void set_read_amplification_target(utils::updateable_value<float> target) {
+        _read_amplification_target = std::move(target);
+    }
+
+    float read_amplification_target() const noexcept {
+        return _read_amplification_target();
+    }
+
+    float read_amplification_backlog() const noexcept {
+        return _read_amplification_backlog;
+    }
+
+    // Returns the read amplification of the table, as last sampled.
+    read_amplification_stats get_read_amplification(replica::table* t) const;
+
     const std::vector<sstables::compaction_info> get_compactions(replica::table* t = nullptr) const;
 
     // Returns true if table has an ongoing compaction, running on its behalf
@@ -490,5 +582,13 @@ class compaction_manager {
 
 bool needs_cleanup(const sstables::shared_sstable& sst, const dht::token_range_vector& owned_ranges, schema_ptr s);
 
+// Returns true iff none of the owned ranges overlap the token span of sst,
+// which cleanup can then drop without rewriting it.
+bool is_fully_unowned(const sstables::shared_sstable& sst, const dht::token_range_vector& sorted_owned_ranges, schema_ptr s);
+
+// Estimates the bytes on disk which cleanup reclaims from sst, assuming its
+// data is spread evenly over its token span.
+uint64_t cleanup_reclaimable_bytes(const sstables::shared_sstable& sst, const dht::token_range_vector& sorted_owned_ranges, schema_ptr s);
+
 std::ostream& operator<<(std::ostream& os, compaction_manager::task::state s);
 std::ostream& operator<<(std::ostream& os, const compaction_manager::task& task);
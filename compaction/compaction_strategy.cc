@@ -13,6 +13,8 @@
 #include <chrono>
 #include <seastar/core/shared_ptr.hh>
 #include "sstables/sstables.hh"
+#include "sstables/value_log.hh"
+#include "db/value_log_extension.hh"
 #include "compaction.hh"
 #include "compaction_strategy.hh"
 #include "compaction_strategy_impl.hh"
@@ -25,6 +27,7 @@
 #include "size_tiered_compaction_strategy.hh"
 #include "date_tiered_compaction_strategy.hh"
 #include "leveled_compaction_strategy.hh"
+#include "incremental_compaction_strategy.hh"
 #include "time_window_compaction_strategy.hh"
 #include "backlog_controller.hh"
 #include "compaction_backlog_manager.hh"
@@ -61,7 +64,33 @@ bool compaction_strategy_impl::worth_dropping_tombstones(const shared_sstable& s
         return false;
     }
     auto gc_before = sst->get_gc_before_for_drop_estimation(compaction_time);
-    return sst->estimate_droppable_tombstone_ratio(gc_before) >= _tombstone_threshold;
+    if (sst->estimate_droppable_tombstone_ratio(gc_before) >= _tombstone_threshold) {
+        return true;
+    }
+    // Tombstones concentrated in a few token ranges, e.g. of a deleted range
+    // of partitions, are diluted by the rest of the sstable.
+    return sst->estimate_droppable_tombstone_ratio_of_densest_range(gc_before) >= _tombstone_density_threshold;
+}
+
+compaction_descriptor compaction_strategy_impl::get_fully_expired_sstables_job(table_state& table_s, const std::vector<shared_sstable>& candidates, gc_clock::time_point compaction_time) {
+    if (candidates.empty() || db_clock::now() - _last_expired_check <= expired_sstable_check_frequency()) {
+        return compaction_descriptor();
+    }
+    _last_expired_check = db_clock::now();
+    // The overlap check of get_fully_expired_sstables() isn't worth it
+    // unless some sstable may be fully expired.
+    auto may_be_expired = [&] (const shared_sstable& sst) {
+        return sst->get_max_local_deletion_time() < sst->get_gc_before_for_fully_expire(compaction_time);
+    };
+    if (!std::ranges::any_of(candidates, may_be_expired)) {
+        return compaction_descriptor();
+    }
+    auto expired = table_s.fully_expired_sstables(candidates, compaction_time);
+    if (expired.empty()) {
+        return compaction_descriptor();
+    }
+    clogger.debug("Going to drop {} fully expired sstables of {}.{}", expired.size(), table_s.schema()->ks_name(), table_s.schema()->cf_name());
+    return compaction_descriptor(has_only_fully_expired::yes, std::vector<shared_sstable>(expired.begin(), expired.end()), service::get_local_compaction_priority());
 }
 
 uint64_t compaction_strategy_impl::adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) {
@@ -91,6 +120,9 @@ compaction_strategy_impl::compaction_strategy_impl(const std::map<sstring, sstri
     auto tmp_value = get_value(options, TOMBSTONE_THRESHOLD_OPTION);
     _tombstone_threshold = property_definitions::to_double(TOMBSTONE_THRESHOLD_OPTION, tmp_value, DEFAULT_TOMBSTONE_THRESHOLD);
 
+    tmp_value = get_value(options, TOMBSTONE_DENSITY_THRESHOLD_OPTION);
+    _tombstone_density_threshold = property_definitions::to_double(TOMBSTONE_DENSITY_THRESHOLD_OPTION, tmp_value, DEFAULT_TOMBSTONE_DENSITY_THRESHOLD);
+
     tmp_value = get_value(options, TOMBSTONE_COMPACTION_INTERVAL_OPTION);
     auto interval = property_definitions::to_long(TOMBSTONE_COMPACTION_INTERVAL_OPTION, tmp_value, DEFAULT_TOMBSTONE_COMPACTION_INTERVAL().count());
     _tombstone_compaction_interval = db_clock::duration(std::chrono::seconds(interval));
@@ -188,6 +220,105 @@ void size_tiered_backlog_tracker::replace_sstables(std::vector<sstables::shared_
     refresh_sstables_backlog_contribution();
 }
 
+// Backlog for ICS is the same as STCS's (see size_tiered_backlog_tracker.hh),
+// but accounted per run instead of per SSTable, as runs are what ICS compacts
+// together: Si is the size of the run i, and Ci the amount of bytes already
+// compacted from its fragments.
+class incremental_backlog_tracker final : public compaction_backlog_tracker::impl {
+    sstables::size_tiered_compaction_strategy_options _stcs_options;
+    int64_t _total_bytes = 0;
+    double _runs_backlog_contribution = 0.0f;
+    // Data size of the runs contributing backlog, by run identifier.
+    std::unordered_map<utils::UUID, uint64_t> _runs_contributing_backlog;
+    std::unordered_map<utils::UUID, sstables::sstable_run> _all;
+
+    struct inflight_component {
+        uint64_t total_bytes = 0;
+        double contribution = 0;
+    };
+
+    static double log4(double x) {
+        double inv_log_4 = 1.0f / std::log(4);
+        return log(x) * inv_log_4;
+    }
+
+    inflight_component compacted_backlog(const compaction_backlog_tracker::ongoing_compactions& ongoing_compactions) const {
+        inflight_component in;
+        for (auto const& crp : ongoing_compactions) {
+            auto it = _runs_contributing_backlog.find(crp.first->run_identifier());
+            if (it == _runs_contributing_backlog.end()) {
+                continue;
+            }
+            auto compacted = crp.second->compacted();
+            in.total_bytes += compacted;
+            in.contribution += compacted * log4(it->second);
+        }
+        return in;
+    }
+
+    void refresh_runs_backlog_contribution() {
+        _runs_backlog_contribution = 0.0f;
+        _runs_contributing_backlog = {};
+        if (_all.empty()) {
+            return;
+        }
+        using namespace sstables;
+
+        auto& any_sst = *_all.begin()->second.all().begin();
+        auto threshold = any_sst->get_schema()->min_compaction_threshold();
+
+        auto runs = boost::copy_range<std::vector<sstable_run>>(_all | boost::adaptors::map_values);
+        for (auto& bucket : incremental_compaction_strategy::get_buckets(std::move(runs), _stcs_options)) {
+            if (!incremental_compaction_strategy::is_bucket_interesting(bucket, threshold)) {
+                continue;
+            }
+            for (auto& run : bucket) {
+                auto run_size = run.data_size();
+                _runs_backlog_contribution += run_size * log4(run_size);
+                _runs_contributing_backlog.emplace((*run.all().begin())->run_identifier(), run_size);
+            }
+        }
+    }
+public:
+    incremental_backlog_tracker(sstables::size_tiered_compaction_strategy_options stcs_options) : _stcs_options(stcs_options) {}
+
+    virtual double backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const override {
+        inflight_component compacted = compacted_backlog(oc);
+
+        auto total_backlog_bytes = boost::accumulate(_runs_contributing_backlog | boost::adaptors::map_values, uint64_t(0));
+        if (total_backlog_bytes <= compacted.total_bytes) {
+            return 0;
+        }
+        auto effective_backlog_bytes = total_backlog_bytes - compacted.total_bytes;
+        auto runs_contribution = _runs_backlog_contribution - compacted.contribution;
+        auto b = (effective_backlog_bytes * log4(_total_bytes)) - runs_contribution;
+        return b > 0 ? b : 0;
+    }
+
+    virtual void replace_sstables(std::vector<sstables::shared_sstable> old_ssts, std::vector<sstables::shared_sstable> new_ssts) override {
+        for (auto& sst : old_ssts) {
+            if (sst->data_size() > 0) {
+                auto it = _all.find(sst->run_identifier());
+                if (it == _all.end()) {
+                    continue;
+                }
+                _total_bytes -= sst->data_size();
+                it->second.erase(sst);
+                if (it->second.all().empty()) {
+                    _all.erase(it);
+                }
+            }
+        }
+        for (auto& sst : new_ssts) {
+            if (sst->data_size() > 0) {
+                _total_bytes += sst->data_size();
+                _all[sst->run_identifier()].insert(std::move(sst));
+            }
+        }
+        refresh_runs_backlog_contribution();
+    }
+};
+
 namespace sstables {
 
 extern logging::logger clogger;
@@ -496,6 +627,14 @@ time_window_compaction_strategy::time_window_compaction_strategy(const std::map<
     _use_clustering_key_filter = true;
 }
 
+incremental_compaction_strategy::incremental_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _fragment_size(calculate_fragment_size(compaction_strategy_impl::get_value(options, SSTABLE_SIZE_OPTION)))
+    , _stcs_options(options)
+    , _backlog_tracker(std::make_unique<incremental_backlog_tracker>(_stcs_options))
+{
+}
+
 } // namespace sstables
 
 std::vector<sstables::shared_sstable>
@@ -707,8 +846,44 @@ compaction_strategy_type compaction_strategy::type() const {
     return _compaction_strategy_impl->type();
 }
 
+// Returns a job which rewrites the sstable which points to the most bytes of
+// value logs with too much garbage, which moves them to a new value log, see
+// sstables/value_log.hh.
+static compaction_descriptor get_value_log_gc_job(table_state& table_s, const std::vector<sstables::shared_sstable>& candidates) {
+    if (std::none_of(candidates.begin(), candidates.end(), std::mem_fn(&sstable::has_value_logs))) {
+        return compaction_descriptor();
+    }
+    auto garbage_ratios = value_log_garbage_ratios(*table_s.get_sstable_set().all());
+    auto gc_garbage_ratio = table_s.schema()->value_log_options().gc_garbage_ratio;
+    shared_sstable selected;
+    uint64_t selected_bytes = 0;
+    for (auto& sst : candidates) {
+        auto bytes = value_log_garbage_referenced_bytes(*sst, garbage_ratios, gc_garbage_ratio);
+        if (bytes > selected_bytes) {
+            selected = sst;
+            selected_bytes = bytes;
+        }
+    }
+    if (!selected) {
+        return compaction_descriptor();
+    }
+    return compaction_descriptor({ selected }, service::get_local_compaction_priority(),
+        selected->get_sstable_level(), compaction_descriptor::default_max_sstable_bytes, selected->run_identifier());
+}
+
 compaction_descriptor compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) {
-    return _compaction_strategy_impl->get_sstables_for_compaction(table_s, control, std::move(candidates));
+    auto desc = _compaction_strategy_impl->get_sstables_for_compaction(table_s, control, candidates);
+    if (desc.sstables.empty()) {
+        desc = get_value_log_gc_job(table_s, candidates);
+    }
+    return desc;
+}
+
+compaction_descriptor compaction_strategy::get_fully_expired_sstables_job(table_state& table_s, const std::vector<sstables::shared_sstable>& candidates) {
+    if (type() == compaction_strategy_type::null) {
+        return compaction_descriptor();
+    }
+    return _compaction_strategy_impl->get_fully_expired_sstables_job(table_s, candidates, gc_clock::now());
 }
 
 compaction_descriptor compaction_strategy::get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) {
@@ -756,6 +931,10 @@ bool compaction_strategy::use_interposer_consumer() const {
     return _compaction_strategy_impl->use_interposer_consumer();
 }
 
+bool compaction_strategy::use_interposer_consumer(const mutation_source_metadata& ms_meta) const {
+    return _compaction_strategy_impl->use_interposer_consumer(ms_meta);
+}
+
 compaction_strategy make_compaction_strategy(compaction_strategy_type strategy, const std::map<sstring, sstring>& options) {
     ::shared_ptr<compaction_strategy_impl> impl;
 
@@ -775,6 +954,9 @@ compaction_strategy make_compaction_strategy(compaction_strategy_type strategy,
     case compaction_strategy_type::time_window:
         impl = ::make_shared<time_window_compaction_strategy>(options);
         break;
+    case compaction_strategy_type::incremental:
+        impl = ::make_shared<incremental_compaction_strategy>(options);
+        break;
     default:
         throw std::runtime_error("strategy not supported");
     }
@@ -46,6 +46,10 @@ class compaction_strategy {
     // Return a list of sstables to be compacted after applying the strategy.
     compaction_descriptor get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<shared_sstable> candidates);
 
+    // Return a job which drops the fully expired sstables among candidates,
+    // whatever the strategy, or an empty descriptor if there's none.
+    compaction_descriptor get_fully_expired_sstables_job(table_state& table_s, const std::vector<shared_sstable>& candidates);
+
     compaction_descriptor get_major_compaction_job(table_state& table_s, std::vector<shared_sstable> candidates);
 
     std::vector<compaction_descriptor> get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const;
@@ -75,6 +79,8 @@ class compaction_strategy {
             return "DateTieredCompactionStrategy";
         case compaction_strategy_type::time_window:
             return "TimeWindowCompactionStrategy";
+        case compaction_strategy_type::incremental:
+            return "IncrementalCompactionStrategy";
         default:
             throw std::runtime_error("Invalid Compaction Strategy");
         }
@@ -93,6 +99,8 @@ class compaction_strategy {
             return compaction_strategy_type::date_tiered;
         } else if (short_name == "TimeWindowCompactionStrategy") {
             return compaction_strategy_type::time_window;
+        } else if (short_name == "IncrementalCompactionStrategy") {
+            return compaction_strategy_type::incremental;
         } else {
             throw exceptions::configuration_exception(format("Unable to find compaction strategy class '{}'", name));
         }
@@ -115,6 +123,9 @@ class compaction_strategy {
     // Returns whether or not interposer consumer is used by a given strategy.
     bool use_interposer_consumer() const;
 
+    // Returns whether or not interposer consumer splits a mutation source with the given metadata.
+    bool use_interposer_consumer(const mutation_source_metadata& ms_meta) const;
+
     // Informs the caller (usually the compaction manager) about what would it take for this set of
     // SSTables closer to becoming in-strategy. If this returns an empty compaction descriptor, this
     // means that the sstable set is already in-strategy.
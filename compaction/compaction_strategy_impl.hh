@@ -28,17 +28,28 @@ class resharding_descriptor;
 
 class compaction_strategy_impl {
     static constexpr float DEFAULT_TOMBSTONE_THRESHOLD = 0.2f;
+    static constexpr float DEFAULT_TOMBSTONE_DENSITY_THRESHOLD = 0.5f;
     // minimum interval needed to perform tombstone removal compaction in seconds, default 86400 or 1 day.
     static constexpr std::chrono::seconds DEFAULT_TOMBSTONE_COMPACTION_INTERVAL() { return std::chrono::seconds(86400); }
+    db_clock::time_point _last_expired_check;
 protected:
     const sstring TOMBSTONE_THRESHOLD_OPTION = "tombstone_threshold";
     const sstring TOMBSTONE_COMPACTION_INTERVAL_OPTION = "tombstone_compaction_interval";
+    const sstring TOMBSTONE_DENSITY_THRESHOLD_OPTION = "tombstone_density_threshold";
 
     bool _use_clustering_key_filter = false;
     bool _disable_tombstone_compaction = false;
     float _tombstone_threshold = DEFAULT_TOMBSTONE_THRESHOLD;
+    // Droppable tombstone ratio of a token range of an sstable, see
+    // sstable::estimate_droppable_tombstone_ratio_of_densest_range(), above
+    // which the sstable is worth compacting even if its own ratio is below
+    // _tombstone_threshold.
+    float _tombstone_density_threshold = DEFAULT_TOMBSTONE_DENSITY_THRESHOLD;
     db_clock::duration _tombstone_compaction_interval = DEFAULT_TOMBSTONE_COMPACTION_INTERVAL();
 public:
+    // minimum interval between checks for fully expired sstables, default 600 or 10 minutes.
+    static constexpr std::chrono::seconds DEFAULT_EXPIRED_SSTABLE_CHECK_FREQUENCY() { return std::chrono::seconds(600); }
+
     static std::optional<sstring> get_value(const std::map<sstring, sstring>& options, const sstring& name);
 protected:
     compaction_strategy_impl() = default;
@@ -60,8 +71,19 @@ class compaction_strategy_impl {
         return _use_clustering_key_filter;
     }
 
+    // Returns a job which drops the fully expired sstables among the candidates
+    // (see get_fully_expired_sstables()), or an empty one if there's none, or
+    // if the last check was less than expired_sstable_check_frequency() ago.
+    // The job reads none of the sstables, see has_only_fully_expired.
+    compaction_descriptor get_fully_expired_sstables_job(table_state& table_s, const std::vector<shared_sstable>& candidates, gc_clock::time_point compaction_time);
+
+    virtual db_clock::duration expired_sstable_check_frequency() const {
+        return DEFAULT_EXPIRED_SSTABLE_CHECK_FREQUENCY();
+    }
+
     // Check if a given sstable is entitled for tombstone compaction based on its
-    // droppable tombstone histogram and gc_before.
+    // droppable tombstone histogram, or the tombstone density of its token
+    // ranges, and gc_before.
     bool worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point compaction_time);
 
     virtual compaction_backlog_tracker& get_backlog_tracker() = 0;
@@ -74,6 +96,12 @@ class compaction_strategy_impl {
         return false;
     }
 
+    // Whether make_interposer_consumer() splits a mutation source with the
+    // given metadata, rather than passing it through to the end consumer.
+    virtual bool use_interposer_consumer(const mutation_source_metadata& ms_meta) const {
+        return use_interposer_consumer();
+    }
+
     virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode);
 };
 }
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "incremental_compaction_strategy.hh"
+#include "sstables/sstables.hh"
+#include "service/priority_manager.hh"
+#include "cql3/statements/property_definitions.hh"
+
+#include <boost/algorithm/cxx11/all_of.hpp>
+#include <boost/algorithm/cxx11/any_of.hpp>
+#include <boost/range/adaptor/map.hpp>
+#include <boost/range/adaptor/reversed.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/algorithm/remove_if.hpp>
+
+namespace sstables {
+
+uint64_t incremental_compaction_strategy::calculate_fragment_size(std::optional<sstring> option_value) const {
+    using namespace cql3::statements;
+    auto size_in_mb = property_definitions::to_int(SSTABLE_SIZE_OPTION, option_value, DEFAULT_MAX_SSTABLE_SIZE_IN_MB);
+    if (size_in_mb <= 0) {
+        throw exceptions::configuration_exception(format("{} value ({}) must be positive", SSTABLE_SIZE_OPTION, size_in_mb));
+    }
+    return uint64_t(size_in_mb) * 1024 * 1024;
+}
+
+std::vector<sstable_run>
+incremental_compaction_strategy::get_runs(table_state& table_s, const std::vector<shared_sstable>& candidates) {
+    auto candidate_set = std::unordered_set<shared_sstable>(candidates.begin(), candidates.end());
+    auto runs = table_s.get_sstable_set().select_sstable_runs(candidates);
+    auto e = boost::range::remove_if(runs, [&] (const sstable_run& run) {
+        return !boost::algorithm::all_of(run.all(), [&] (const shared_sstable& sst) { return candidate_set.contains(sst); });
+    });
+    runs.erase(e, runs.end());
+    return runs;
+}
+
+std::vector<std::vector<sstable_run>>
+incremental_compaction_strategy::get_buckets(std::vector<sstable_run> runs, const size_tiered_compaction_strategy_options& options) {
+    // runs sorted by the size of their data.
+    std::vector<std::pair<sstable_run, uint64_t>> sorted_runs;
+    sorted_runs.reserve(runs.size());
+    for (auto& run : runs) {
+        auto size = run.data_size();
+        sorted_runs.emplace_back(std::move(run), size);
+    }
+    std::sort(sorted_runs.begin(), sorted_runs.end(), [] (auto& i, auto& j) {
+        return i.second < j.second;
+    });
+
+    // Same grouping as size_tiered_compaction_strategy::get_buckets(), applied to runs.
+    std::vector<std::vector<sstable_run>> bucket_list;
+    std::vector<double> bucket_average_size_list;
+    std::vector<uint64_t> bucket_smallest_size_list;
+
+    for (auto& [run, size] : sorted_runs) {
+        if (!bucket_list.empty()) {
+            auto& bucket_average_size = bucket_average_size_list.back();
+
+            if ((size > (bucket_average_size * options.bucket_low) && size < (bucket_average_size * options.bucket_high)) ||
+                    (size < options.min_sstable_size && bucket_average_size < options.min_sstable_size)) {
+                auto& bucket = bucket_list.back();
+                auto total_size = bucket.size() * bucket_average_size;
+                auto new_average_size = (total_size + size) / (bucket.size() + 1);
+
+                if (size < options.min_sstable_size || bucket_smallest_size_list.back() > new_average_size * options.bucket_low) {
+                    bucket.push_back(std::move(run));
+                    bucket_average_size = new_average_size;
+                    continue;
+                }
+            }
+        }
+
+        bucket_list.push_back({std::move(run)});
+        bucket_average_size_list.push_back(size);
+        bucket_smallest_size_list.push_back(size);
+    }
+
+    return bucket_list;
+}
+
+std::vector<sstable_run>
+incremental_compaction_strategy::most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets, size_t min_threshold, size_t max_threshold) {
+    std::vector<sstable_run>* max = nullptr;
+    for (auto& bucket : buckets) {
+        if (!is_bucket_interesting(bucket, min_threshold)) {
+            continue;
+        }
+        // Buckets are sorted by size, so the trimmed runs are the largest ones.
+        bucket.resize(std::min(bucket.size(), max_threshold));
+        // Pick the bucket with more runs, as efficiency of same-tier compactions increases with their number.
+        if (!max || bucket.size() > max->size()) {
+            max = &bucket;
+        }
+    }
+    return max ? std::move(*max) : std::vector<sstable_run>();
+}
+
+compaction_descriptor incremental_compaction_strategy::make_descriptor(const std::vector<sstable_run>& runs) const {
+    std::vector<shared_sstable> sstables;
+    for (auto& run : runs) {
+        sstables.insert(sstables.end(), run.all().begin(), run.all().end());
+    }
+    return compaction_descriptor(std::move(sstables), service::get_local_compaction_priority(), 0, _fragment_size);
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) {
+    size_t min_threshold = table_s.min_compaction_threshold();
+    size_t max_threshold = table_s.schema()->max_compaction_threshold();
+    auto compaction_time = gc_clock::now();
+
+    auto buckets = get_buckets(get_runs(table_s, candidates), _stcs_options);
+
+    auto most_interesting = most_interesting_bucket(buckets, min_threshold, max_threshold);
+    if (!most_interesting.empty()) {
+        return make_descriptor(most_interesting);
+    }
+
+    // If we are not enforcing min_threshold explicitly, try any pair of runs in the same tier.
+    if (!table_s.compaction_enforce_min_threshold()) {
+        most_interesting = most_interesting_bucket(buckets, 2, max_threshold);
+        if (!most_interesting.empty()) {
+            return make_descriptor(most_interesting);
+        }
+    }
+
+    // If reads touch too many sstables, merge runs of neighbouring tiers, like STCS.
+    if (control.read_amplification_exceeded(table_s)) {
+        auto wide_buckets = get_buckets(get_runs(table_s, candidates), _stcs_options.widened(size_tiered_compaction_strategy_options::READ_AMPLIFICATION_WIDENING));
+        most_interesting = most_interesting_bucket(wide_buckets, table_s.compaction_enforce_min_threshold() ? min_threshold : 2, max_threshold);
+        if (!most_interesting.empty()) {
+            return make_descriptor(most_interesting);
+        }
+    }
+
+    // If there is no run to compact in the standard way, try compacting a single run
+    // which has fragments with a droppable tombstone ratio greater than threshold,
+    // preferring the oldest runs of the largest tiers, like STCS.
+    for (auto& bucket : buckets | boost::adaptors::reversed) {
+        auto e = boost::range::remove_if(bucket, [this, compaction_time] (const sstable_run& run) {
+            return !boost::algorithm::any_of(run.all(), [&] (const shared_sstable& sst) {
+                return worth_dropping_tombstones(sst, compaction_time);
+            });
+        });
+        bucket.erase(e, bucket.end());
+        if (bucket.empty()) {
+            continue;
+        }
+        auto min_timestamp = [] (const sstable_run& run) {
+            return std::ranges::min(run.all() | boost::adaptors::transformed([] (const shared_sstable& sst) {
+                return sst->get_stats_metadata().min_timestamp;
+            }));
+        };
+        auto& oldest = *std::ranges::min_element(bucket, std::less<>(), min_timestamp);
+        return make_descriptor({ oldest });
+    }
+    return compaction_descriptor();
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) {
+    if (candidates.empty()) {
+        return compaction_descriptor();
+    }
+    return compaction_descriptor(std::move(candidates), service::get_local_compaction_priority(), 0, _fragment_size);
+}
+
+std::vector<compaction_descriptor>
+incremental_compaction_strategy::get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const {
+    // Cleans up one run at a time, so that the temporary space overhead is bounded by its fragments too.
+    std::unordered_map<utils::UUID, std::vector<shared_sstable>> runs;
+    for (auto& sst : candidates) {
+        runs[sst->run_identifier()].push_back(sst);
+    }
+    std::vector<compaction_descriptor> ret;
+    ret.reserve(runs.size());
+    for (auto& [run_id, sstables] : runs) {
+        ret.push_back(compaction_descriptor(std::move(sstables), service::get_local_compaction_priority(), 0, _fragment_size, run_id));
+    }
+    return ret;
+}
+
+int64_t incremental_compaction_strategy::estimated_pending_compactions(table_state& table_s) const {
+    size_t min_threshold = table_s.min_compaction_threshold();
+    size_t max_threshold = table_s.schema()->max_compaction_threshold();
+    auto all_sstables = table_s.get_sstable_set().all();
+    auto runs = table_s.get_sstable_set().select_sstable_runs(boost::copy_range<std::vector<shared_sstable>>(*all_sstables));
+
+    int64_t n = 0;
+    for (auto& bucket : get_buckets(std::move(runs), _stcs_options)) {
+        if (is_bucket_interesting(bucket, min_threshold)) {
+            n += std::ceil(double(bucket.size()) / max_threshold);
+        }
+    }
+    return n;
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) {
+    size_t offstrategy_threshold = std::max(schema->min_compaction_threshold(), 4);
+    size_t max_runs = std::max(schema->max_compaction_threshold(), int(offstrategy_threshold));
+
+    if (mode == reshape_mode::relaxed) {
+        offstrategy_threshold = max_runs;
+    }
+
+    std::unordered_map<utils::UUID, sstable_run> runs_by_id;
+    for (auto& sst : input) {
+        runs_by_id[sst->run_identifier()].insert(sst);
+    }
+    auto runs = boost::copy_range<std::vector<sstable_run>>(runs_by_id | boost::adaptors::map_values);
+
+    for (auto& bucket : get_buckets(std::move(runs), _stcs_options)) {
+        if (bucket.size() >= offstrategy_threshold) {
+            bucket.resize(std::min(bucket.size(), max_runs));
+            auto desc = make_descriptor(bucket);
+            desc.io_priority = iop;
+            desc.options = compaction_type_options::make_reshape();
+            return desc;
+        }
+    }
+
+    return compaction_descriptor();
+}
+
+}
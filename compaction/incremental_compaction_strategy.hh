@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "compaction_strategy_impl.hh"
+#include "compaction_backlog_manager.hh"
+#include "size_tiered_compaction_strategy.hh"
+#include "sstables/sstable_set.hh"
+
+class incremental_backlog_tracker;
+
+namespace sstables {
+
+// Incremental compaction strategy (ICS).
+//
+// Like STCS, ICS compacts together runs of similar size, so it has the same
+// write amplification. But every run is made of fragments of at most
+// sstable_size_in_mb, i.e. sstables which share a run identifier and have
+// disjoint token ranges, and compactions write their output as a new run of
+// such fragments. As soon as an output fragment is sealed, the input fragments
+// whose token range it covers are released (see regular_compaction), so the
+// temporary space needed by a compaction is bounded by a few fragments per
+// input run, instead of by the size of the whole input.
+class incremental_compaction_strategy : public compaction_strategy_impl {
+    static constexpr int32_t DEFAULT_MAX_SSTABLE_SIZE_IN_MB = 1000;
+    const sstring SSTABLE_SIZE_OPTION = "sstable_size_in_mb";
+
+    uint64_t _fragment_size;
+    size_tiered_compaction_strategy_options _stcs_options;
+    compaction_backlog_tracker _backlog_tracker;
+private:
+    uint64_t calculate_fragment_size(std::optional<sstring> option_value) const;
+
+    // Returns the runs of the candidates, leaving out the runs some fragments
+    // of which are not candidates, e.g. because they are being compacted.
+    static std::vector<sstable_run> get_runs(table_state& table_s, const std::vector<shared_sstable>& candidates);
+
+    compaction_descriptor make_descriptor(const std::vector<sstable_run>& runs) const;
+public:
+    // Group runs of similar size into buckets, like STCS does with sstables.
+    static std::vector<std::vector<sstable_run>> get_buckets(std::vector<sstable_run> runs, const size_tiered_compaction_strategy_options& options);
+
+    static bool is_bucket_interesting(const std::vector<sstable_run>& bucket, size_t min_threshold) {
+        return bucket.size() >= min_threshold;
+    }
+
+    // Returns the largest interesting bucket, trimmed to max_threshold runs, if any.
+    static std::vector<sstable_run> most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets, size_t min_threshold, size_t max_threshold);
+
+    incremental_compaction_strategy(const std::map<sstring, sstring>& options);
+
+    virtual compaction_descriptor get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual compaction_descriptor get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual std::vector<compaction_descriptor> get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const override;
+
+    virtual int64_t estimated_pending_compactions(table_state& table_s) const override;
+
+    virtual compaction_strategy_type type() const override {
+        return compaction_strategy_type::incremental;
+    }
+
+    virtual std::unique_ptr<sstable_set_impl> make_sstable_set(schema_ptr schema) const override;
+
+    virtual compaction_backlog_tracker& get_backlog_tracker() override {
+        return _backlog_tracker;
+    }
+
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) override;
+
+    uint64_t fragment_size() const {
+        return _fragment_size;
+    }
+
+    friend class ::incremental_backlog_tracker;
+};
+
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+
+#include "raw_partition_copier.hh"
+#include "sstables/sstables.hh"
+#include "sstables/index_reader.hh"
+#include "readers/multi_range.hh"
+#include "readers/mutation_source.hh"
+
+namespace sstables {
+
+struct raw_partition_copier::source {
+    shared_sstable sst;
+    // Identifies the sstable once it's released, see copy_next_partition().
+    generation_type generation;
+    std::vector<run> runs;
+    // The ranges between the runs, which the reader of the sstable reads.
+    dht::partition_range_vector ranges;
+
+    // The run being copied, or the next one.
+    size_t next_run = 0;
+    // Partitions left to copy of the run being copied, if any.
+    uint64_t remaining = 0;
+    // Key and data file position of the next partition of the run being copied.
+    std::optional<dht::decorated_key> key;
+    uint64_t position = 0;
+    std::unique_ptr<index_reader> index;
+    std::optional<input_stream<char>> data;
+
+    explicit source(shared_sstable sst) : sst(std::move(sst)), generation(this->sst->generation()) {}
+
+    bool exhausted() const noexcept {
+        return next_run == runs.size();
+    }
+
+    const dht::decorated_key& next_key() const noexcept {
+        return remaining ? *key : runs[next_run].first;
+    }
+
+    future<> close() noexcept {
+        if (data) {
+            co_await data->close();
+            data.reset();
+        }
+        if (index) {
+            co_await index->close();
+            index.reset();
+        }
+    }
+};
+
+raw_partition_copier::raw_partition_copier(schema_ptr s, reader_permit permit, const io_priority_class& pc)
+    : _schema(std::move(s))
+    , _permit(std::move(permit))
+    , _pc(pc) {
+}
+
+raw_partition_copier::~raw_partition_copier() = default;
+
+future<> raw_partition_copier::add_source(shared_sstable sst, const sstable_set& compacting, gc_clock::time_point gc_before) {
+    auto src = std::make_unique<source>(sst);
+    auto selector = compacting.make_incremental_selector();
+    auto may_overlap = [&] (const dht::decorated_key& dk) {
+        auto hk = sstable::make_hashed_key(*_schema, dk.key());
+        return std::ranges::any_of(selector.select(dht::ring_position_view(dk)).sstables, [&] (const shared_sstable& other) {
+            return other != sst && other->filter_has_key(hk);
+        });
+    };
+
+    // Without tombstone density metadata, only the bounds of the whole
+    // sstable are known.
+    auto* sm = sst->get_scylla_metadata();
+    auto* td = sm ? sm->get_tombstone_density() : nullptr;
+    auto gc_before_count = gc_before.time_since_epoch().count();
+    bool all_purgeable = !td && sst->get_stats_metadata().min_local_deletion_time < gc_before_count;
+    size_t segment = 0;
+    auto may_hold_purgeable_data = [&] (uint64_t pos) {
+        if (!td) {
+            return all_purgeable;
+        }
+        auto& segments = td->segments.elements;
+        while (segment < segments.size() && segments[segment].data_offset + segments[segment].data_size <= pos) {
+            ++segment;
+        }
+        return segment < segments.size() && segments[segment].tombstones && segments[segment].min_deletion_time < gc_before_count;
+    };
+
+    index_reader idx(sst, _permit, _pc, {}, use_caching::no);
+    std::exception_ptr ex;
+    try {
+        std::optional<run> current;
+        auto end_run = [&] (uint64_t end) {
+            if (current && end - current->start >= min_run_size) {
+                current->end = end;
+                src->runs.push_back(std::move(*current));
+            }
+            current.reset();
+        };
+        while (!idx.eof()) {
+            co_await idx.read_partition_data();
+            auto pos = idx.get_data_file_position();
+            auto dk = dht::decorate_key(*_schema, idx.get_partition_key());
+            // Partitions with a promoted index would need it rewritten, as it
+            // holds positions relative to the data file.
+            if (!idx.get_promoted_index_size() && !may_hold_purgeable_data(pos) && !may_overlap(dk)) {
+                if (!current) {
+                    current.emplace(run{dk, dk, pos, pos, 0});
+                }
+                current->last = std::move(dk);
+                ++current->partitions;
+            } else {
+                end_run(pos);
+            }
+            co_await idx.advance_to_next_partition();
+        }
+        end_run(sst->data_size());
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await idx.close();
+    if (ex) {
+        co_return coroutine::exception(std::move(ex));
+    }
+
+    auto& runs = src->runs;
+    if (runs.empty()) {
+        co_return;
+    }
+    src->ranges.reserve(runs.size() + 1);
+    src->ranges.push_back(dht::partition_range::make_ending_with({dht::ring_position(runs.front().first), false}));
+    for (size_t i = 1; i < runs.size(); ++i) {
+        src->ranges.push_back(dht::partition_range::make({dht::ring_position(runs[i - 1].last), false}, {dht::ring_position(runs[i].first), false}));
+    }
+    src->ranges.push_back(dht::partition_range::make_starting_with({dht::ring_position(runs.back().last), false}));
+    _sources.push_back(std::move(src));
+}
+
+sstable_reader_factory_type raw_partition_copier::make_reader_factory(read_monitor_generator& monitor_generator, value_log_pointers vl_pointers) {
+    return [this, &monitor_generator, vl_pointers] (shared_sstable& sst, const dht::partition_range& pr) {
+        auto& monitor = monitor_generator(sst);
+        auto it = std::ranges::find_if(_sources, [&] (const std::unique_ptr<source>& src) {
+            return src->generation == sst->generation();
+        });
+        if (it == _sources.end()) {
+            return sst->make_reader(_schema, _permit, pr, _schema->full_slice(), _pc, {},
+                    streamed_mutation::forwarding::no, mutation_reader::forwarding::no, monitor, vl_pointers);
+        }
+        auto ms = mutation_source([sst, &monitor, vl_pointers] (schema_ptr s,
+                reader_permit permit,
+                const dht::partition_range& pr,
+                const query::partition_slice& slice,
+                const io_priority_class& pc,
+                tracing::trace_state_ptr trace_state,
+                streamed_mutation::forwarding fwd,
+                mutation_reader::forwarding fwd_mr) {
+            return sst->make_reader(std::move(s), std::move(permit), pr, slice, pc, std::move(trace_state), fwd, fwd_mr, monitor, vl_pointers);
+        });
+        return make_flat_multi_range_reader(_schema, _permit, std::move(ms), (*it)->ranges, _schema->full_slice(), _pc,
+                nullptr, mutation_reader::forwarding::no);
+    };
+}
+
+void raw_partition_copier::copy_next_partition(source& src, consumer_fn& consumer) {
+    auto& r = src.runs[src.next_run];
+    if (!src.remaining) {
+        if (!src.index) {
+            src.index = std::make_unique<index_reader>(src.sst, _permit, _pc, tracing::trace_state_ptr(), use_caching::no);
+        }
+        src.index->advance_to(dht::ring_position_view(r.first)).get();
+        src.index->read_partition_data().get();
+        if (src.index->get_data_file_position() != r.start) {
+            throw malformed_sstable_exception(format("index position {} of partition {} differs from the one seen when planning the copy ({})",
+                    src.index->get_data_file_position(), r.first, r.start), src.sst->get_filename());
+        }
+        src.data = src.sst->data_stream(r.start, r.end - r.start, _pc, _permit, nullptr, nullptr);
+        src.remaining = r.partitions;
+        src.key = r.first;
+        src.position = r.start;
+    }
+
+    uint64_t end = r.end;
+    std::optional<dht::decorated_key> next_key;
+    if (--src.remaining) {
+        src.index->advance_to_next_partition().get();
+        src.index->read_partition_data().get();
+        end = src.index->get_data_file_position();
+        next_key = dht::decorate_key(*_schema, src.index->get_partition_key());
+    }
+    auto size = end - src.position;
+    auto data = src.data->read_exactly(size).get0();
+    if (data.size() != size) {
+        throw malformed_sstable_exception(format("unexpected end of data file while copying partition {}", *src.key), src.sst->get_filename());
+    }
+    auto dk = std::exchange(src.key, std::move(next_key));
+    src.position = end;
+
+    ++_partitions_copied;
+    _bytes_copied += size;
+    consumer(*src.sst, *dk, std::move(data));
+
+    if (!src.remaining) {
+        src.data->close().get();
+        src.data.reset();
+        if (++src.next_run == src.runs.size()) {
+            // Release the sstable, so that it can be deleted as soon as the
+            // compaction is done with it, see regular_compaction.
+            src.close().get();
+            src.sst = {};
+        }
+    }
+}
+
+void raw_partition_copier::copy(const dht::decorated_key* upper_bound, consumer_fn& consumer) {
+    for (;;) {
+        source* next = nullptr;
+        for (auto& src : _sources) {
+            if (!src->exhausted() && (!next || src->next_key().tri_compare(*_schema, next->next_key()) < 0)) {
+                next = src.get();
+            }
+        }
+        if (!next || (upper_bound && next->next_key().tri_compare(*_schema, *upper_bound) >= 0)) {
+            return;
+        }
+        copy_next_partition(*next, consumer);
+    }
+}
+
+future<> raw_partition_copier::close() noexcept {
+    for (auto& src : _sources) {
+        co_await src->close();
+    }
+}
+
+}
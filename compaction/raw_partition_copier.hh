@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/future.hh>
+#include <seastar/core/temporary_buffer.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include "sstables/sstable_set.hh"
+#include "sstables/progress_monitor.hh"
+#include "reader_permit.hh"
+#include "schema_fwd.hh"
+#include "dht/i_partitioner.hh"
+
+namespace sstables {
+
+// Copies the partitions of the inputs of a compaction which have nothing to
+// compact, i.e. which no other input may contain and which hold no purgeable
+// data (see tombstone_density_metadata), verbatim from the data files of the inputs to the output, sparing
+// their parsing and re-serialization.
+//
+// The copied partitions are found by walking the index of the inputs whose
+// partitions can be copied to the output (see can_copy_raw_partitions()).
+// They are copied in runs of consecutive partitions, large enough to make up
+// for the skip they cause in the reader of the input. The readers of the
+// inputs skip the runs (see make_reader_factory()), and the writer of the
+// compaction interleaves their partitions with the ones it writes, in key
+// order (see copy()).
+class raw_partition_copier {
+public:
+    // Consecutive partitions of a source, which are copied verbatim.
+    struct run {
+        dht::decorated_key first;
+        dht::decorated_key last;
+        // Span of the partitions in the (uncompressed) data file.
+        uint64_t start;
+        uint64_t end;
+        uint64_t partitions;
+    };
+
+    using consumer_fn = noncopyable_function<void(const sstable& source, const dht::decorated_key& dk, temporary_buffer<char> data)>;
+
+    // Smaller runs are read by the reader of their source, rather than copied.
+    static constexpr uint64_t min_run_size = 64 * 1024;
+private:
+    struct source;
+
+    schema_ptr _schema;
+    reader_permit _permit;
+    const io_priority_class& _pc;
+    std::vector<std::unique_ptr<source>> _sources;
+    uint64_t _partitions_copied = 0;
+    uint64_t _bytes_copied = 0;
+private:
+    void copy_next_partition(source& src, consumer_fn& consumer);
+public:
+    raw_partition_copier(schema_ptr s, reader_permit permit, const io_priority_class& pc);
+    ~raw_partition_copier();
+
+    // Finds the runs of partitions of sst which no other sstable of
+    // compacting may contain, and which hold no tombstones older than
+    // gc_before. sst must belong to compacting, and its partitions must be
+    // copyable to the output.
+    future<> add_source(shared_sstable sst, const sstable_set& compacting, gc_clock::time_point gc_before);
+
+    bool empty() const noexcept {
+        return _sources.empty();
+    }
+
+    // Returns a reader factory for sstable_set::make_local_shard_sstable_reader(),
+    // which reads the full range of every sstable, except for the runs of the
+    // sources.
+    sstable_reader_factory_type make_reader_factory(read_monitor_generator& monitor_generator, value_log_pointers vl_pointers = {});
+
+    // Passes to consumer, in key order, the partitions of the runs which are
+    // smaller than upper_bound, or all remaining ones if it's null.
+    // Must be called in a seastar thread.
+    void copy(const dht::decorated_key* upper_bound, consumer_fn& consumer);
+
+    uint64_t partitions_copied() const noexcept {
+        return _partitions_copied;
+    }
+
+    uint64_t bytes_copied() const noexcept {
+        return _bytes_copied;
+    }
+
+    future<> close() noexcept;
+};
+
+}
@@ -163,6 +163,17 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(table_state& table_
         return sstables::compaction_descriptor(std::move(most_interesting), service::get_local_compaction_priority());
     }
 
+    // If reads touch too many sstables, merge sstables of neighbouring tiers,
+    // rather than waiting for each tier to fill up.
+    if (control.read_amplification_exceeded(table_s)) {
+        auto wide_buckets = get_buckets(candidates, _options.widened(size_tiered_compaction_strategy_options::READ_AMPLIFICATION_WIDENING));
+        int threshold = table_s.compaction_enforce_min_threshold() ? min_threshold : 2;
+        if (is_any_bucket_interesting(wide_buckets, threshold)) {
+            std::vector<sstables::shared_sstable> most_interesting = most_interesting_bucket(std::move(wide_buckets), threshold, max_threshold);
+            return sstables::compaction_descriptor(std::move(most_interesting), service::get_local_compaction_priority());
+        }
+    }
+
     // if there is no sstable to compact in standard way, try compacting single sstable whose droppable tombstone
     // ratio is greater than threshold.
     // prefer oldest sstables from biggest size tiers because they will be easier to satisfy conditions for
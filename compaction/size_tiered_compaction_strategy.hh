@@ -22,6 +22,7 @@ class size_tiered_compaction_strategy_options {
     static constexpr double DEFAULT_BUCKET_LOW = 0.5;
     static constexpr double DEFAULT_BUCKET_HIGH = 1.5;
     static constexpr double DEFAULT_COLD_READS_TO_OMIT = 0.05;
+    static constexpr double READ_AMPLIFICATION_WIDENING = 2.0;
     const sstring MIN_SSTABLE_SIZE_KEY = "min_sstable_size";
     const sstring BUCKET_LOW_KEY = "bucket_low";
     const sstring BUCKET_HIGH_KEY = "bucket_high";
@@ -36,6 +37,16 @@ class size_tiered_compaction_strategy_options {
 
     size_tiered_compaction_strategy_options();
 
+    // Options which group sstables of sizes up to factor times further apart
+    // in the same tier. Used to merge neighbouring tiers when reads of the
+    // table touch too many sstables, see strategy_control::read_amplification_exceeded().
+    size_tiered_compaction_strategy_options widened(double factor) const {
+        auto options = *this;
+        options.bucket_low /= factor;
+        options.bucket_high *= factor;
+        return options;
+    }
+
     // FIXME: convert java code below.
 #if 0
     public static Map<String, String> validateOptions(Map<String, String> options, Map<String, String> uncheckedOptions) throws ConfigurationException
@@ -78,6 +89,7 @@ class size_tiered_compaction_strategy_options {
     }
 #endif
     friend class size_tiered_compaction_strategy;
+    friend class incremental_compaction_strategy;
 };
 
 class size_tiered_compaction_strategy : public compaction_strategy_impl {
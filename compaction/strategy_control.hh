@@ -18,6 +18,9 @@ class strategy_control {
 public:
     virtual ~strategy_control() {}
     virtual bool has_ongoing_compaction(table_state& table_s) const noexcept = 0;
+    // Whether reads of the table touch more sstables than the read
+    // amplification target, see compaction_read_amplification_target.
+    virtual bool read_amplification_exceeded(table_state& table_s) const noexcept = 0;
 };
 
 }
@@ -110,9 +110,13 @@ uint64_t time_window_compaction_strategy::adjust_partition_estimate(const mutati
     return partition_estimate / std::max(1UL, uint64_t(estimated_window_count));
 }
 
+bool time_window_compaction_strategy::use_interposer_consumer(const mutation_source_metadata& ms_meta) const {
+    return !ms_meta.min_timestamp || !ms_meta.max_timestamp
+            || get_window_for(_options, *ms_meta.min_timestamp) != get_window_for(_options, *ms_meta.max_timestamp);
+}
+
 reader_consumer_v2 time_window_compaction_strategy::make_interposer_consumer(const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer) {
-    if (ms_meta.min_timestamp && ms_meta.max_timestamp
-            && get_window_for(_options, *ms_meta.min_timestamp) == get_window_for(_options, *ms_meta.max_timestamp)) {
+    if (!use_interposer_consumer(ms_meta)) {
         return end_consumer;
     }
     return [options = _options, end_consumer = std::move(end_consumer)] (flat_mutation_reader_v2 rd) mutable -> future<> {
@@ -222,25 +226,25 @@ time_window_compaction_strategy::get_sstables_for_compaction(table_state& table_
     }
 
     // Find fully expired SSTables. Those will be included no matter what.
-    std::unordered_set<shared_sstable> expired;
-
-    if (db_clock::now() - _last_expired_check > _options.expired_sstable_check_frequency) {
-        clogger.debug("TWCS expired check sufficiently far in the past, checking for fully expired SSTables");
-        expired = table_s.fully_expired_sstables(candidates, compaction_time);
-        _last_expired_check = db_clock::now();
-    } else {
-        clogger.debug("TWCS skipping check for fully expired SSTables");
-    }
-
-    if (!expired.empty()) {
-        clogger.debug("Going to compact {} expired sstables", expired.size());
-        return compaction_descriptor(has_only_fully_expired::yes, std::vector<shared_sstable>(expired.begin(), expired.end()), service::get_local_compaction_priority());
+    auto expired = get_fully_expired_sstables_job(table_s, candidates, compaction_time);
+    if (!expired.sstables.empty()) {
+        return expired;
     }
 
     auto compaction_candidates = get_next_non_expired_sstables(table_s, control, std::move(candidates), compaction_time);
     return compaction_descriptor(std::move(compaction_candidates), service::get_local_compaction_priority());
 }
 
+bool time_window_compaction_strategy::needs_late_merge(const bucket_t& bucket) {
+    uint64_t largest = 0;
+    uint64_t total = 0;
+    for (auto& sst : bucket) {
+        largest = std::max(largest, sst->data_size());
+        total += sst->data_size();
+    }
+    return total - largest >= largest * late_merge_min_ratio;
+}
+
 time_window_compaction_strategy::bucket_compaction_mode
 time_window_compaction_strategy::compaction_mode(const bucket_t& bucket, timestamp_type bucket_key,
         timestamp_type now, size_t min_threshold) const {
@@ -250,6 +254,8 @@ time_window_compaction_strategy::compaction_mode(const bucket_t& bucket, timesta
 
     if (bucket.size() >= 2 && !is_last_active_bucket(bucket_key, now) && _recent_active_windows.contains(bucket_key)) {
         return bucket_compaction_mode::major;
+    } else if (bucket.size() >= 2 && !is_last_active_bucket(bucket_key, now) && needs_late_merge(bucket)) {
+        return bucket_compaction_mode::late_merge;
     } else if (bucket.size() >= size_t(min_threshold)) {
         return bucket_compaction_mode::size_tiered;
     }
@@ -362,6 +368,13 @@ time_window_compaction_strategy::newest_bucket(table_state& table_s, strategy_co
             }
             clogger.debug("bucket size {} >= 2 and not in current bucket, key {}, compacting what's here", bucket.size(), key);
             return trim_to_threshold(std::move(bucket), max_threshold);
+        case bucket_compaction_mode::late_merge:
+            // serialized like major, for the same reason.
+            if (control.has_ongoing_compaction(table_s)) {
+                break;
+            }
+            clogger.debug("bucket size {} >= 2 with late writes, key {}, merging them into the window", bucket.size(), key);
+            return trim_to_threshold(std::move(bucket), max_threshold);
         default:
             // windows needing major will remain with major state until they're compacted into one file.
             // after that, they will fall into default mode where we'll stop considering them as a recent window
@@ -401,6 +414,7 @@ void time_window_compaction_strategy::update_estimated_compaction_by_tasks(std::
             n += size_tiered_compaction_strategy::estimated_pending_compactions(bucket, min_threshold, max_threshold, _stcs_options);
             break;
         case bucket_compaction_mode::major:
+        case bucket_compaction_mode::late_merge:
             n++;
         default:
             break;
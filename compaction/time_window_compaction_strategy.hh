@@ -67,7 +67,6 @@ using timestamp_type = api::timestamp_type;
 class time_window_compaction_strategy : public compaction_strategy_impl {
     time_window_compaction_strategy_options _options;
     int64_t _estimated_remaining_tasks = 0;
-    db_clock::time_point _last_expired_check;
     // As timestamp_type is an int64_t, a primitive type, it must be initialized here.
     timestamp_type _highest_window_seen = 0;
     // Keep track of all recent active windows that still need to be compacted into a single SSTable
@@ -80,8 +79,16 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
     // Better co-locate some windows into the same sstables than OOM.
     static constexpr uint64_t max_data_segregation_window_count = 100;
 
+    // Late writes to a past window, e.g. out-of-order ingestion or repair, add
+    // small sstables next to the large one of the window, which size-tiered
+    // compaction never merges back with it. The window is merged back into a
+    // single sstable once its late sstables reach this fraction of the size of
+    // the largest one. Until then, many late sstables are only compacted
+    // together by size-tiered compaction, rather than rewriting the window.
+    static constexpr double late_merge_min_ratio = 0.1;
+
     using bucket_t = std::vector<shared_sstable>;
-    enum class bucket_compaction_mode { none, size_tiered, major };
+    enum class bucket_compaction_mode { none, size_tiered, major, late_merge };
 public:
     time_window_compaction_strategy(const std::map<sstring, sstring>& options);
     virtual compaction_descriptor get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<shared_sstable> candidates) override;
@@ -105,6 +112,10 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
         return bucket_key >= now;
     }
 
+    // Returns true if the late sstables of a past window are worth merging
+    // with its largest sstable, see late_merge_min_ratio.
+    static bool needs_late_merge(const bucket_t& bucket);
+
     // Returns which compaction type should be performed on a given window bucket.
     bucket_compaction_mode
     compaction_mode(const bucket_t& bucket, timestamp_type bucket_key, timestamp_type now, size_t min_threshold) const;
@@ -146,6 +157,10 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
 
     friend class time_window_backlog_tracker;
 public:
+    virtual db_clock::duration expired_sstable_check_frequency() const override {
+        return _options.expired_sstable_check_frequency;
+    }
+
     virtual int64_t estimated_pending_compactions(table_state& table_s) const override {
         return _estimated_remaining_tasks;
     }
@@ -168,6 +183,9 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
         return true;
     }
 
+    // Sources whose data all belong to the same window aren't split.
+    virtual bool use_interposer_consumer(const mutation_source_metadata& ms_meta) const override;
+
     virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) override;
 };
 
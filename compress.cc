@@ -60,6 +60,14 @@ std::map<sstring, sstring> compressor::options() const {
     return {};
 }
 
+size_t compressor::train_dictionary(const std::vector<temporary_buffer<char>>&, bytes_mutable_view) const {
+    return 0;
+}
+
+shared_ptr<compressor> compressor::with_dictionary(bytes_view dictionary) const {
+    throw std::runtime_error(format("Compressor {} does not support dictionaries", name()));
+}
+
 compressor::ptr_type compressor::create(const sstring& name, const opt_getter& opts) {
     if (name.empty()) {
         return {};
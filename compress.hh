@@ -14,7 +14,9 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sstring.hh>
+#include <seastar/core/temporary_buffer.hh>
 
+#include "bytes.hh"
 #include "exceptions/exceptions.hh"
 
 
@@ -51,6 +53,36 @@ class compressor {
      */
     virtual std::map<sstring, sstring> options() const;
 
+    /**
+     * Number of uncompressed bytes the compressor wants to see before it can
+     * train a dictionary for an sstable, or 0 if it doesn't use dictionaries.
+     */
+    virtual size_t dictionary_training_sample_size() const {
+        return 0;
+    }
+    /**
+     * Maximum size of the dictionaries trained by train_dictionary().
+     */
+    virtual size_t dictionary_size() const {
+        return 0;
+    }
+    /**
+     * Trains a dictionary from the given samples (typically the first chunks
+     * of an sstable) into the given buffer, of dictionary_size() bytes, and
+     * returns its size. Returns 0 if training wasn't possible, in which case
+     * the chunks are compressed without a dictionary.
+     *
+     * Called outside of the reactor, in a thread of its own, so it must not
+     * use any seastar facility, nor leave behind memory allocated by it.
+     */
+    virtual size_t train_dictionary(const std::vector<temporary_buffer<char>>& samples, bytes_mutable_view dictionary) const;
+    /**
+     * Returns a compressor which compresses and uncompresses with the given
+     * dictionary. The dictionary is referenced, not copied, so it must outlive
+     * the returned compressor.
+     */
+    virtual shared_ptr<compressor> with_dictionary(bytes_view dictionary) const;
+
     /**
      * Compressor class name.
      */
@@ -358,6 +358,7 @@ modes = {
 scylla_tests = set([
     'test/boost/UUID_test',
     'test/boost/cdc_generation_test',
+    'test/boost/adaptive_readahead_file_test',
     'test/boost/aggregate_fcts_test',
     'test/boost/allocation_strategy_test',
     'test/boost/alternator_unit_test',
@@ -449,6 +450,7 @@ scylla_tests = set([
     'test/boost/query_processor_test',
     'test/boost/range_test',
     'test/boost/range_tombstone_list_test',
+    'test/boost/read_batching_file_test',
     'test/boost/reusable_buffer_test',
     'test/boost/restrictions_test',
     'test/boost/repair_test',
@@ -477,6 +479,7 @@ scylla_tests = set([
     'test/boost/sstable_move_test',
     'test/boost/statement_restrictions_test',
     'test/boost/storage_proxy_test',
+    'test/boost/stream_sstable_files_test',
     'test/boost/top_k_test',
     'test/boost/transport_test',
     'test/boost/types_test',
@@ -545,6 +548,7 @@ scylla_tests = set([
 perf_tests = set([
     'test/perf/perf_mutation_readers',
     'test/perf/perf_checksum',
+    'test/perf/perf_bloom_filter',
     'test/perf/perf_mutation_fragment',
     'test/perf/perf_idl',
     'test/perf/perf_vint',
@@ -668,6 +672,7 @@ scylla_core = (['replica/database.cc',
                 'replica/table.cc',
                 'replica/distributed_loader.cc',
                 'replica/memtable.cc',
+                'replica/hot_partition_cache.cc',
                 'absl-flat_hash_map.cc',
                 'atomic_cell.cc',
                 'caching_options.cc',
@@ -713,6 +718,11 @@ scylla_core = (['replica/database.cc',
                 'zstd.cc',
                 'sstables/sstables.cc',
                 'sstables/sstables_manager.cc',
+                'sstables/summary_learned_index.cc',
+                'sstables/index_cache_warmup.cc',
+                'sstables/adaptive_readahead_file.cc',
+                'sstables/read_batching_file.cc',
+                'sstables/value_log.cc',
                 'sstables/sstable_set.cc',
                 'sstables/mx/partition_reversing_data_source.cc',
                 'sstables/mx/reader.cc',
@@ -726,7 +736,9 @@ scylla_core = (['replica/database.cc',
                 'compaction/size_tiered_compaction_strategy.cc',
                 'compaction/leveled_compaction_strategy.cc',
                 'compaction/time_window_compaction_strategy.cc',
+                'compaction/incremental_compaction_strategy.cc',
                 'compaction/compaction_manager.cc',
+                'compaction/raw_partition_copier.cc',
                 'sstables/integrity_checked_file_impl.cc',
                 'sstables/prepended_input_stream.cc',
                 'sstables/m_format_read_helpers.cc',
@@ -900,6 +912,7 @@ scylla_core = (['replica/database.cc',
                 'utils/config_file.cc',
                 'utils/multiprecision_int.cc',
                 'utils/gz/crc_combine.cc',
+                'utils/gz/crc32_multibuffer.cc',
                 'gms/version_generator.cc',
                 'gms/versioned_value.cc',
                 'gms/gossiper.cc',
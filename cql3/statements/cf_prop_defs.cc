@@ -17,6 +17,8 @@
 #include "gms/feature_service.hh"
 #include "tombstone_gc_extension.hh"
 #include "tombstone_gc.hh"
+#include "db/value_log_extension.hh"
+#include "db/bloom_filter_format_extension.hh"
 
 #include <boost/algorithm/string/predicate.hpp>
 
@@ -130,6 +132,14 @@ void cf_prop_defs::validate(const data_dictionary::database db, sstring ks_name,
     auto tombstone_gc_options = get_tombstone_gc_options(schema_extensions);
     validate_tombstone_gc_options(tombstone_gc_options, db, ks_name);
 
+    if (schema_extensions.contains(db::bloom_filter_format_extension::NAME) && !db.features().bloom_filter_format) {
+        throw exceptions::configuration_exception("bloom_filter_format option not supported by the cluster");
+    }
+
+    if (schema_extensions.contains(db::value_log_extension::NAME) && !db.features().value_log) {
+        throw exceptions::configuration_exception("value_log option not supported by the cluster");
+    }
+
     validate_minimum_int(KW_DEFAULT_TIME_TO_LIVE, 0, DEFAULT_DEFAULT_TIME_TO_LIVE);
     validate_minimum_int(KW_PAXOSGRACESECONDS, 0, DEFAULT_GC_GRACE_SECONDS);
 
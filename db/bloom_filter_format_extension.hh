@@ -0,0 +1,67 @@
+/*
+ * Copyright 2022-present ScyllaDB
+ */
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "serializer.hh"
+#include "serializer_impl.hh"
+#include "schema.hh"
+#include "exceptions/exceptions.hh"
+#include "log.hh"
+
+extern logging::logger dblog;
+
+namespace db {
+
+/**
+ * \brief Schema extension which represents `bloom_filter_format` per-table option.
+ *
+ * Selects the layout of the bloom filter written to new sstables of the table:
+ *  - 'classic' (the default) is the Cassandra-compatible filter, which probes
+ *    one random bit per hash function;
+ *  - 'split_block' confines all the bits of a key to a single cache line, trading
+ *    a few more bits per key for one memory access per lookup.
+ *
+ * Sstables record the layout of their own filter, so existing sstables stay
+ * readable regardless of the current value of the option.
+ */
+class bloom_filter_format_extension : public schema_extension {
+    sstring _format;
+public:
+    static constexpr auto NAME = "bloom_filter_format";
+    static constexpr auto CLASSIC = "classic";
+    static constexpr auto SPLIT_BLOCK = "split_block";
+
+    bloom_filter_format_extension() = default;
+
+    explicit bloom_filter_format_extension(const std::map<sstring, sstring>& map) {
+        on_internal_error(dblog, "Cannot create bloom_filter_format_extension from map");
+    }
+
+    explicit bloom_filter_format_extension(bytes b) : _format(deserialize(b))
+    {}
+
+    explicit bloom_filter_format_extension(const sstring& s) : _format(s) {
+        if (_format != CLASSIC && _format != SPLIT_BLOCK) {
+            throw exceptions::configuration_exception(format("Invalid {} '{}': must be one of '{}', '{}'", NAME, s, CLASSIC, SPLIT_BLOCK));
+        }
+    }
+
+    bytes serialize() const override {
+        return ser::serialize_to_buffer<bytes>(_format);
+    }
+
+    static sstring deserialize(const bytes_view& buffer) {
+        return ser::deserialize_from_buffer(buffer, boost::type<sstring>());
+    }
+
+    bool is_split_block() const {
+        return _format == SPLIT_BLOCK;
+    }
+};
+
+} // namespace db
@@ -9,9 +9,11 @@
 #pragma once
 
 #include "utils/lru.hh"
+#include "utils/frequency_sketch.hh"
 #include "utils/logalloc.hh"
 #include "partition_version.hh"
 #include "mutation_cleaner.hh"
+#include "dht/i_partitioner.hh"
 
 #include <seastar/core/metrics_registration.hh>
 
@@ -66,13 +68,39 @@ class cache_tracker final {
         uint64_t pinned_dirty_memory_overload;
         uint64_t range_tombstone_reads;
         uint64_t row_tombstone_reads;
+        // Partition hits and misses of reads, split by whether the
+        // admission policy admitted the partition, see admits().
+        uint64_t admitted_partition_hits;
+        uint64_t admitted_partition_misses;
+        uint64_t probationary_partition_hits;
+        uint64_t probationary_partition_misses;
+        uint64_t probationary_row_insertions;
+        // Cold partitions compressed and inflated back, see row_cache::compress_cold_entries().
+        uint64_t partition_compressions;
+        uint64_t partition_inflations;
+        uint64_t compressed_partitions;
+        uint64_t compressed_bytes_saved;
 
         uint64_t active_reads() const {
             return reads - reads_done;
         }
     };
+    // How entries which reads populate the cache with are linked in the LRU.
+    enum class admission_policy {
+        // Every entry is added to the LRU.
+        lru,
+        // Only the entries of partitions which were read recently enough, as
+        // estimated by a frequency sketch, are added to the LRU. The others
+        // are probationary, and evicted first unless read again, so that the
+        // rows brought in by scans don't evict the hot ones.
+        tinylfu,
+    };
+    static admission_policy admission_policy_from_string(std::string_view);
 private:
     stats _stats{};
+    admission_policy _admission_policy = admission_policy::lru;
+    bool _compress_cold_partitions = false;
+    utils::frequency_sketch _access_frequency;
     seastar::metrics::metric_groups _metrics;
     logalloc::region _region;
     lru _lru;
@@ -88,6 +116,11 @@ class cache_tracker final {
     void clear();
     void touch(rows_entry&);
     void insert(cache_entry&);
+    // Like insert(), but links the entries as probationary,
+    // see lru::add_probationary().
+    void insert_probationary(cache_entry&);
+    void insert_probationary(rows_entry&) noexcept;
+    void touch_probationary(rows_entry&);
     void insert(partition_entry&) noexcept;
     void insert(partition_version&) noexcept;
     void insert(rows_entry&) noexcept;
@@ -95,8 +128,9 @@ class cache_tracker final {
     void clear_continuity(cache_entry& ce) noexcept;
     void on_partition_erase() noexcept;
     void on_partition_merge() noexcept;
-    void on_partition_hit() noexcept;
-    void on_partition_miss() noexcept;
+    // Also record the access to the partition for the admission policy.
+    void on_partition_hit(const dht::decorated_key&) noexcept;
+    void on_partition_miss(const dht::decorated_key&) noexcept;
     void on_partition_eviction() noexcept;
     void on_row_eviction() noexcept;
     void on_row_hit() noexcept;
@@ -109,6 +143,16 @@ class cache_tracker final {
     void on_row_merged_from_memtable() noexcept { ++_stats.rows_merged_from_memtable; }
     void on_range_tombstone_read() noexcept { ++_stats.range_tombstone_reads; }
     void on_row_tombstone_read() noexcept { ++_stats.row_tombstone_reads; }
+    void on_partition_compression(size_t bytes_saved) noexcept {
+        ++_stats.partition_compressions;
+        ++_stats.compressed_partitions;
+        _stats.compressed_bytes_saved += bytes_saved;
+    }
+    void on_partition_inflation() noexcept {
+        ++_stats.partition_inflations;
+        --_stats.compressed_partitions;
+    }
+    void on_compressed_partition_erase() noexcept { --_stats.compressed_partitions; }
     void pinned_dirty_memory_overload(uint64_t bytes) noexcept;
     allocation_strategy& allocator() noexcept;
     logalloc::region& region() noexcept;
@@ -118,6 +162,14 @@ class cache_tracker final {
     uint64_t partitions() const noexcept { return _stats.partitions; }
     const stats& get_stats() const noexcept { return _stats; }
     void set_compaction_scheduling_group(seastar::scheduling_group);
+    void set_admission_policy(admission_policy);
+    admission_policy get_admission_policy() const noexcept { return _admission_policy; }
+    // Whether row caches keep their cold partitions compressed, see row_cache::compress_cold_entries().
+    void set_compress_cold_partitions(bool v) noexcept { _compress_cold_partitions = v; }
+    bool compress_cold_partitions() const noexcept { return _compress_cold_partitions; }
+    // Returns whether the entries of the partition which reads populate the
+    // cache with are added to the LRU, or are probationary.
+    bool admits(const dht::decorated_key&) const noexcept;
     lru& get_lru() { return _lru; }
 };
 
@@ -134,6 +186,14 @@ void cache_tracker::insert(rows_entry& entry) noexcept {
     _lru.add(entry);
 }
 
+inline
+void cache_tracker::insert_probationary(rows_entry& entry) noexcept {
+    ++_stats.row_insertions;
+    ++_stats.probationary_row_insertions;
+    ++_stats.rows;
+    _lru.add_probationary(entry);
+}
+
 inline
 void cache_tracker::insert(partition_version& pv) noexcept {
     for (rows_entry& row : pv.partition().clustered_rows()) {
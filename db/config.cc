@@ -282,6 +282,20 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
         "If set to true, enforce the min_threshold option for compactions strictly. If false (default), Scylla may decide to compact even if below min_threshold")
+    , compaction_raw_partition_copy(this, "compaction_raw_partition_copy", liveness::LiveUpdate, value_status::Used, false,
+        "If set to true, compactions copy partitions which only one input sstable contains, and which have nothing to purge, to the output verbatim instead of parsing and re-serializing them. "
+        "Only applies to inputs whose serialization header matches the one of the output, and to partitions without a promoted index.")
+    , compaction_max_sub_jobs(this, "compaction_max_sub_jobs", liveness::LiveUpdate, value_status::Used, 1,
+        "Maximum number of sub-jobs which major compaction, cleanup and upgrade of a table split their work into. "
+        "Sub-jobs compact disjoint token ranges of the same sstables concurrently, each into its own sstable run. Set to 1 to disable the splitting.")
+    , compaction_min_sub_job_size_in_mb(this, "compaction_min_sub_job_size_in_mb", liveness::LiveUpdate, value_status::Used, 1024,
+        "Minimum size of the input of a compaction sub-job, see compaction_max_sub_jobs. Compactions with less than twice as much input aren't split.")
+    , compaction_read_amplification_target(this, "compaction_read_amplification_target", liveness::LiveUpdate, value_status::Used, 0,
+        "Target of the average number of sstables which reads of a table touch. When the reads of a table exceed it, compaction gets more shares, "
+        "in proportion to the excess, and size-tiered strategies merge neighbouring tiers. Has no effect with compaction_static_shares. Set to 0 to disable.")
+    , compaction_promoted_index_read_size_in_kb(this, "compaction_promoted_index_read_size_in_kb", liveness::LiveUpdate, value_status::Used, 0,
+        "Maximum size of the promoted index of a partition in sstables written by compaction. Compaction sizes the promoted index blocks of wide partitions by their row size, "
+        "and merges them as needed to stay within this size. Promoted indexes of at most 32 KB are read with a single read of the index file. Set to 0 to disable.")
     /* Initialization properties */
     /* The minimal properties needed for configuring a cluster. */
     , cluster_name(this, "cluster_name", value_status::Used, "",
@@ -308,8 +322,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The directory where hints files are stored if hinted handoff is enabled.")
     , view_hints_directory(this, "view_hints_directory", value_status::Used, "",
         "The directory where materialized-view updates are stored while a view replica is unreachable.")
-    , saved_caches_directory(this, "saved_caches_directory", value_status::Unused, "",
-        "The directory location where table key and row caches are stored.")
+    , saved_caches_directory(this, "saved_caches_directory", value_status::Used, "",
+        "The directory location where the hot set of the sstable index caches is saved, to warm up the caches after a restart.")
     /* Commonly used properties */
     /* Properties most frequently used when configuring Scylla. */
     /* Before starting a node for the first time, you should carefully evaluate your requirements. */
@@ -523,10 +537,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     /* Key caches and global row properties */
     /* When creating or modifying tables, you enable or disable the key cache (partition key cache) or row cache for that table by setting the caching parameter. Other row and key cache tuning and configuration options are set at the global (node) level. Cassandra uses these settings to automatically distribute memory for each table on the node based on the overall workload and specific table usage. You can also configure the save periods for these caches globally. */
     /* Related information: Configuring caches */
-    , key_cache_keys_to_save(this, "key_cache_keys_to_save", value_status::Unused, 0,
-        "Number of keys from the key cache to save. (0: all)")
-    , key_cache_save_period(this, "key_cache_save_period", value_status::Unused, 14400,
-        "Duration in seconds that keys are saved in cache. Caches are saved to saved_caches_directory. Saved caches greatly improve cold-start speeds and has relatively little effect on I/O.")
+    , key_cache_keys_to_save(this, "key_cache_keys_to_save", value_status::Used, 0,
+        "Maximum number of sstable index file pages to save per shard. (0: all)")
+    , key_cache_save_period(this, "key_cache_save_period", value_status::Used, 14400,
+        "Interval in seconds between saves of the hot set of the sstable index caches to saved_caches_directory. The hot set is also saved on shutdown and is loaded back on startup, before the node starts serving. (0: save only on shutdown)")
     , key_cache_size_in_mb(this, "key_cache_size_in_mb", value_status::Unused, 100,
         "A global cache setting for tables. It is the maximum size of the key cache in memory. To disable set to 0.\n"
         "Related information: nodetool setcachecapacity.")
@@ -771,6 +785,25 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The SSL port for encrypted communication. Unused unless enabled in encryption_options.")
     , enable_in_memory_data_store(this, "enable_in_memory_data_store", value_status::Used, false, "Enable in memory mode (system tables are always persisted)")
     , enable_cache(this, "enable_cache", value_status::Used, true, "Enable cache")
+    , cache_admission_policy(this, "cache_admission_policy", value_status::Used, "lru",
+        "How rows read from sstables are admitted to the row cache.\n"
+        "\n"
+        "\tlru      Every row is cached, and evicts the least recently used ones.\n"
+        "\ttinylfu  Only the rows of partitions read recently enough, as estimated by a frequency sketch, can evict others. "
+        "The rows of the other partitions are evicted first unless read again, so that scans don't evict the hot rows."
+        , {"lru", "tinylfu"})
+    , cache_compress_cold_partitions(this, "cache_compress_cold_partitions", value_status::Used, false,
+        "Keep the partitions of the row cache which weren't read for a while serialized and compressed, so that more of them fit in memory. "
+        "They are inflated back when read or updated.")
+    , cache_prefetch_paged_reads(this, "cache_prefetch_paged_reads", value_status::Used, false,
+        "When a page of a paged read ends, read the rows of the next page into the row cache in the background, "
+        "with a low priority, so that the next page is served from memory.")
+    , enable_hot_partition_replication(this, "enable_hot_partition_replication", value_status::Used, false,
+        "Copy the small partitions which a shard reads the most from the shards which own them, and serve their reads from the copy. "
+        "Spreads the reads of hot partitions over all shards, at the cost of invalidating the copies on every write to them.")
+    , hot_partition_replication_min_reads(this, "hot_partition_replication_min_reads", value_status::Used, 100,
+        "The number of reads of a partition, by a shard which doesn't own it, within 10 seconds, after which the shard copies it. "
+        "See enable_hot_partition_replication.")
     , enable_commitlog(this, "enable_commitlog", value_status::Used, true, "Enable commitlog")
     , volatile_system_keyspace_for_testing(this, "volatile_system_keyspace_for_testing", value_status::Used, false, "Don't persist system keyspace - testing only!")
     , api_port(this, "api_port", value_status::Used, 10000, "Http Rest API port")
@@ -787,6 +820,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , override_decommission(this, "override_decommission", value_status::Used, false, "Set true to force a decommissioned node to join the cluster")
     , enable_repair_based_node_ops(this, "enable_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, true, "Set true to use enable repair based node operations instead of streaming based")
     , allowed_repair_based_node_ops(this, "allowed_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, "replace", "A comma separated list of node operations which are allowed to enable repair based node operations. The operations can be bootstrap, replace, removenode, decommission and rebuild")
+    , enable_sstable_file_streaming(this, "enable_sstable_file_streaming", liveness::LiveUpdate, value_status::Used, false,
+        "Set true to let streaming ship the sstables which lie entirely within a streamed range as files, instead of reading and re-writing their mutations. "
+        "The receiver loads the sstables as they are. Only sstables of tables without materialized views are shipped this way, and only once all nodes support it.")
     , ring_delay_ms(this, "ring_delay_ms", value_status::Used, 30 * 1000, "Time a node waits to hear from other nodes before joining the ring in milliseconds. Same as -Dcassandra.ring_delay_ms in cassandra.")
     , shadow_round_ms(this, "shadow_round_ms", value_status::Used, 300 * 1000, "The maximum gossip shadow round time. Can be used to reduce the gossip feature check time during node boot up.")
     , fd_max_interval_ms(this, "fd_max_interval_ms", value_status::Used, 2 * 1000, "The maximum failure_detector interval time in milliseconds. Interval larger than the maximum will be ignored. Larger cluster may need to increase the default.")
@@ -806,6 +842,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , virtual_dirty_soft_limit(this, "virtual_dirty_soft_limit", value_status::Used, 0.6, "Soft limit of virtual dirty memory expressed as a portion of the hard limit")
     , sstable_summary_ratio(this, "sstable_summary_ratio", value_status::Used, 0.0005, "Enforces that 1 byte of summary is written for every N (2000 by default) "
         "bytes written to data file. Value must be between 0 and 1.")
+    , sstable_summary_learned_index_max_error(this, "sstable_summary_learned_index_max_error", value_status::Used, 0,
+        "Build a learned index (piecewise linear model) over the tokens of the summary of every sstable when it is opened, and use it instead of binary search over the whole summary for partition lookups. "
+        "The value is the maximum error of the model, in summary entries: lookups search a window of about twice this many entries. Smaller values make the model larger. Set to zero to disable.")
+    , sstable_read_batching(this, "sstable_read_batching", value_status::Used, false,
+        "Batch the reads of sstable data and index files issued by concurrent readers: reads are queued for one task queue pass, and overlapping or adjacent reads of the same file are merged into a single I/O request. "
+        "Reduces the number of I/O submissions of point-read-heavy workloads, at the cost of a slightly higher latency of each read. Applies to sstables opened after the change.")
     , large_memory_allocation_warning_threshold(this, "large_memory_allocation_warning_threshold", value_status::Used, size_t(1) << 20, "Warn about memory allocations above this size; set to zero to disable")
     , enable_deprecated_partitioners(this, "enable_deprecated_partitioners", value_status::Used, false, "Enable the byteordered and random partitioners. These partitioners are deprecated and will be removed in a future version.")
     , enable_keyspace_column_family_metrics(this, "enable_keyspace_column_family_metrics", value_status::Used, false, "Enable per keyspace and per column family metrics reporting")
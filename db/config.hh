@@ -137,6 +137,11 @@ class config : public utils::config_file {
     named_value<float> memtable_flush_static_shares;
     named_value<float> compaction_static_shares;
     named_value<bool> compaction_enforce_min_threshold;
+    named_value<bool> compaction_raw_partition_copy;
+    named_value<uint32_t> compaction_max_sub_jobs;
+    named_value<uint32_t> compaction_min_sub_job_size_in_mb;
+    named_value<float> compaction_read_amplification_target;
+    named_value<uint32_t> compaction_promoted_index_read_size_in_kb;
     named_value<sstring> cluster_name;
     named_value<sstring> listen_address;
     named_value<sstring> listen_interface;
@@ -278,6 +283,11 @@ class config : public utils::config_file {
     named_value<uint32_t> ssl_storage_port;
     named_value<bool> enable_in_memory_data_store;
     named_value<bool> enable_cache;
+    named_value<sstring> cache_admission_policy;
+    named_value<bool> cache_compress_cold_partitions;
+    named_value<bool> cache_prefetch_paged_reads;
+    named_value<bool> enable_hot_partition_replication;
+    named_value<uint32_t> hot_partition_replication_min_reads;
     named_value<bool> enable_commitlog;
     named_value<bool> volatile_system_keyspace_for_testing;
     named_value<uint16_t> api_port;
@@ -294,6 +304,7 @@ class config : public utils::config_file {
     named_value<bool> override_decommission;
     named_value<bool> enable_repair_based_node_ops;
     named_value<sstring> allowed_repair_based_node_ops;
+    named_value<bool> enable_sstable_file_streaming;
     named_value<uint32_t> ring_delay_ms;
     named_value<uint32_t> shadow_round_ms;
     named_value<uint32_t> fd_max_interval_ms;
@@ -312,6 +323,8 @@ class config : public utils::config_file {
     named_value<unsigned> murmur3_partitioner_ignore_msb_bits;
     named_value<double> virtual_dirty_soft_limit;
     named_value<double> sstable_summary_ratio;
+    named_value<uint32_t> sstable_summary_learned_index_max_error;
+    named_value<bool> sstable_read_batching;
     named_value<size_t> large_memory_allocation_warning_threshold;
     named_value<bool> enable_deprecated_partitioners;
     named_value<bool> enable_keyspace_column_family_metrics;
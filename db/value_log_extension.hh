@@ -0,0 +1,117 @@
+/*
+ * Copyright 2022-present ScyllaDB
+ */
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <map>
+
+#include <seastar/core/sstring.hh>
+
+#include "serializer.hh"
+#include "serializer_impl.hh"
+#include "schema.hh"
+#include "exceptions/exceptions.hh"
+
+namespace db {
+
+struct value_log_options {
+    static constexpr auto ENABLED = "enabled";
+    static constexpr auto MIN_VALUE_SIZE_IN_KB = "min_value_size_in_kb";
+    static constexpr auto GC_GARBAGE_RATIO = "gc_garbage_ratio";
+
+    bool enabled = false;
+    // Values of at least this size are written to the value log.
+    uint64_t min_value_size = 16 * 1024;
+    // Value logs with a larger fraction of unreferenced bytes are garbage
+    // collected, by rewriting the values still referenced into new ones.
+    double gc_garbage_ratio = 0.5;
+
+    value_log_options() = default;
+
+    explicit value_log_options(const std::map<sstring, sstring>& map) {
+        for (auto& [key, value] : map) {
+            try {
+                if (key == ENABLED) {
+                    if (value != "true" && value != "false") {
+                        throw exceptions::configuration_exception(format("Invalid value_log option '{}': must be 'true' or 'false'", ENABLED));
+                    }
+                    enabled = value == "true";
+                } else if (key == MIN_VALUE_SIZE_IN_KB) {
+                    auto kb = std::stoll(value);
+                    if (kb < 1) {
+                        throw exceptions::configuration_exception(format("Invalid value_log option '{}': must be at least 1", MIN_VALUE_SIZE_IN_KB));
+                    }
+                    min_value_size = uint64_t(kb) * 1024;
+                } else if (key == GC_GARBAGE_RATIO) {
+                    gc_garbage_ratio = std::stod(value);
+                    if (gc_garbage_ratio <= 0 || gc_garbage_ratio > 1) {
+                        throw exceptions::configuration_exception(format("Invalid value_log option '{}': must be in (0, 1]", GC_GARBAGE_RATIO));
+                    }
+                } else {
+                    throw exceptions::configuration_exception(format("Invalid value_log option '{}'", key));
+                }
+            } catch (const std::logic_error&) {
+                throw exceptions::configuration_exception(format("Invalid value '{}' of value_log option '{}'", value, key));
+            }
+        }
+    }
+
+    std::map<sstring, sstring> to_map() const {
+        return {
+            {ENABLED, enabled ? "true" : "false"},
+            {MIN_VALUE_SIZE_IN_KB, to_sstring(min_value_size / 1024)},
+            {GC_GARBAGE_RATIO, to_sstring(gc_garbage_ratio)},
+        };
+    }
+
+    bool operator==(const value_log_options&) const = default;
+};
+
+/**
+ * \brief Schema extension which represents `value_log` per-table option.
+ *
+ * When enabled, large values of regular and static cells of new sstables are
+ * written to value logs, append-only files next to the data file, and only a
+ * pointer to them is kept in the data file. Compaction copies the pointers
+ * rather than the values, so large values are written once, until the value
+ * log they live in is garbage collected (see sstables/value_log.hh).
+ *
+ * Sstables record their value logs, so existing sstables stay readable
+ * regardless of the current value of the option.
+ */
+class value_log_extension : public schema_extension {
+    value_log_options _options;
+public:
+    static constexpr auto NAME = "value_log";
+
+    value_log_extension() = default;
+
+    explicit value_log_extension(const value_log_options& opts) : _options(opts) {}
+
+    explicit value_log_extension(const std::map<sstring, sstring>& map) : _options(map) {}
+
+    explicit value_log_extension(bytes b) : _options(deserialize(b))
+    {}
+
+    explicit value_log_extension(const sstring& s) {
+        throw exceptions::configuration_exception(format("Invalid {} '{}': must be a map of options", NAME, s));
+    }
+
+    bytes serialize() const override {
+        return ser::serialize_to_buffer<bytes>(_options.to_map());
+    }
+
+    static std::map<sstring, sstring> deserialize(const bytes_view& buffer) {
+        return ser::deserialize_from_buffer(buffer, boost::type<std::map<sstring, sstring>>());
+    }
+
+    const value_log_options& get_options() const {
+        return _options;
+    }
+};
+
+} // namespace db
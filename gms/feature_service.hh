@@ -108,6 +108,9 @@ class feature_service final {
     gms::feature tombstone_gc_options { *this, "TOMBSTONE_GC_OPTIONS"sv };
     gms::feature parallelized_aggregation { *this, "PARALLELIZED_AGGREGATION"sv };
     gms::feature keyspace_storage_options { *this, "KEYSPACE_STORAGE_OPTIONS"sv };
+    gms::feature stream_sstable_files { *this, "STREAM_SSTABLE_FILES"sv };
+    gms::feature value_log { *this, "VALUE_LOG"sv };
+    gms::feature bloom_filter_format { *this, "BLOOM_FILTER_FORMAT"sv };
 
 public:
 
@@ -80,6 +80,8 @@
 #include "tombstone_gc_extension.hh"
 #include "alternator/tags_extension.hh"
 #include "db/paxos_grace_seconds_extension.hh"
+#include "db/bloom_filter_format_extension.hh"
+#include "db/value_log_extension.hh"
 #include "service/qos/standard_service_level_distributed_data_accessor.hh"
 #include "service/storage_proxy.hh"
 #include "service/forward_service.hh"
@@ -459,6 +461,8 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
     ext->add_schema_extension<cdc::cdc_extension>(cdc::cdc_extension::NAME);
     ext->add_schema_extension<db::paxos_grace_seconds_extension>(db::paxos_grace_seconds_extension::NAME);
     ext->add_schema_extension<tombstone_gc_extension>(tombstone_gc_extension::NAME);
+    ext->add_schema_extension<db::bloom_filter_format_extension>(db::bloom_filter_format_extension::NAME);
+    ext->add_schema_extension<db::value_log_extension>(db::value_log_extension::NAME);
 
     auto cfg = make_lw_shared<db::config>(ext);
     auto init = app.get_options_description().add_options();
@@ -773,6 +777,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             dbcfg.memtable_scheduling_group = make_sched_group("memtable", 1000);
             dbcfg.memtable_to_cache_scheduling_group = make_sched_group("memtable_to_cache", 200);
             dbcfg.gossip_scheduling_group = make_sched_group("gossip", 1000);
+            dbcfg.cache_prefetch_scheduling_group = make_sched_group("cache_prefetch", 100);
             dbcfg.available_memory = memory::stats().total_memory();
 
             netw::messaging_service::config mscfg;
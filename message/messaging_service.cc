@@ -39,6 +39,7 @@
 #include "digest_algorithm.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "cache_temperature.hh"
 #include "raft/raft.hh"
 #include "service/raft/messaging.hh"
@@ -467,6 +468,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::REPLICATION_FINISHED:
     case messaging_verb::UNUSED__REPAIR_CHECKSUM_RANGE:
     case messaging_verb::STREAM_MUTATION_FRAGMENTS:
+    case messaging_verb::STREAM_SSTABLE_FILES:
     case messaging_verb::REPAIR_ROW_LEVEL_START:
     case messaging_verb::REPAIR_ROW_LEVEL_STOP:
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES:
@@ -841,6 +843,35 @@ future<> messaging_service::unregister_stream_mutation_fragments() {
     return unregister_handler(messaging_verb::STREAM_MUTATION_FRAGMENTS);
 }
 
+rpc::sink<int32_t> messaging_service::make_sink_for_stream_sstable_files(rpc::source<streaming::stream_sstable_files_cmd, sstring, bytes>& source) {
+    return source.make_sink<netw::serializer, int32_t>();
+}
+
+future<std::tuple<rpc::sink<streaming::stream_sstable_files_cmd, sstring, bytes>, rpc::source<int32_t>>>
+messaging_service::make_sink_and_source_for_stream_sstable_files(utils::UUID schema_id, utils::UUID plan_id, utils::UUID cf_id, sstring version, sstring format, streaming::stream_reason reason, msg_addr id) {
+    using value_type = std::tuple<rpc::sink<streaming::stream_sstable_files_cmd, sstring, bytes>, rpc::source<int32_t>>;
+    if (is_shutting_down()) {
+        return make_exception_future<value_type>(rpc::closed_error());
+    }
+    auto rpc_client = get_rpc_client(messaging_verb::STREAM_SSTABLE_FILES, id);
+    return rpc_client->make_stream_sink<netw::serializer, streaming::stream_sstable_files_cmd, sstring, bytes>().then([this, plan_id, schema_id, cf_id, version = std::move(version), format = std::move(format), reason, rpc_client] (rpc::sink<streaming::stream_sstable_files_cmd, sstring, bytes> sink) mutable {
+        auto rpc_handler = rpc()->make_client<rpc::source<int32_t> (utils::UUID, utils::UUID, utils::UUID, sstring, sstring, streaming::stream_reason, rpc::sink<streaming::stream_sstable_files_cmd, sstring, bytes>)>(messaging_verb::STREAM_SSTABLE_FILES);
+        return rpc_handler(*rpc_client, plan_id, schema_id, cf_id, version, format, reason, sink).then_wrapped([sink, rpc_client] (future<rpc::source<int32_t>> source) mutable {
+            return (source.failed() ? sink.close() : make_ready_future<>()).then([sink = std::move(sink), source = std::move(source)] () mutable {
+                return make_ready_future<value_type>(value_type(std::move(sink), source.get0()));
+            });
+        });
+    });
+}
+
+void messaging_service::register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, UUID plan_id, UUID schema_id, UUID cf_id, sstring version, sstring format, streaming::stream_reason reason, rpc::source<streaming::stream_sstable_files_cmd, sstring, bytes> source)>&& func) {
+    register_handler(this, messaging_verb::STREAM_SSTABLE_FILES, std::move(func));
+}
+
+future<> messaging_service::unregister_stream_sstable_files() {
+    return unregister_handler(messaging_verb::STREAM_SSTABLE_FILES);
+}
+
 template<class SinkType, class SourceType>
 future<std::tuple<rpc::sink<SinkType>, rpc::source<SourceType>>>
 do_make_sink_source(messaging_verb verb, uint32_t repair_meta_id, shared_ptr<messaging_service::rpc_protocol_client_wrapper> rpc_client, std::unique_ptr<messaging_service::rpc_protocol_wrapper>& rpc) {
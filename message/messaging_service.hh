@@ -30,6 +30,7 @@
 namespace streaming {
     class prepare_message;
     enum class stream_mutation_fragments_cmd : uint8_t;
+    enum class stream_sstable_files_cmd : uint8_t;
 }
 
 namespace gms {
@@ -192,7 +193,8 @@ enum class messaging_verb : int32_t {
     REPAIR_UPDATE_SYSTEM_TABLE = 59,
     REPAIR_FLUSH_HINTS_BATCHLOG = 60,
     FORWARD_REQUEST = 61,
-    LAST = 62,
+    STREAM_SSTABLE_FILES = 62,
+    LAST = 63,
 };
 
 } // namespace netw
@@ -368,6 +370,14 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     rpc::sink<int32_t> make_sink_for_stream_mutation_fragments(rpc::source<frozen_mutation_fragment, rpc::optional<streaming::stream_mutation_fragments_cmd>>& source);
     future<std::tuple<rpc::sink<frozen_mutation_fragment, streaming::stream_mutation_fragments_cmd>, rpc::source<int32_t>>> make_sink_and_source_for_stream_mutation_fragments(utils::UUID schema_id, utils::UUID plan_id, utils::UUID cf_id, uint64_t estimated_partitions, streaming::stream_reason reason, msg_addr id);
 
+    // Wrapper for STREAM_SSTABLE_FILES
+    // Ships the component files of a single sstable, in chunks tagged with the name of the component they belong to.
+    // The receiver sends a status code, like for STREAM_MUTATION_FRAGMENTS, once it has loaded the sstable.
+    void register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, UUID plan_id, UUID schema_id, UUID cf_id, sstring version, sstring format, streaming::stream_reason reason, rpc::source<streaming::stream_sstable_files_cmd, sstring, bytes> source)>&& func);
+    future<> unregister_stream_sstable_files();
+    rpc::sink<int32_t> make_sink_for_stream_sstable_files(rpc::source<streaming::stream_sstable_files_cmd, sstring, bytes>& source);
+    future<std::tuple<rpc::sink<streaming::stream_sstable_files_cmd, sstring, bytes>, rpc::source<int32_t>>> make_sink_and_source_for_stream_sstable_files(utils::UUID schema_id, utils::UUID plan_id, utils::UUID cf_id, sstring version, sstring format, streaming::stream_reason reason, msg_addr id);
+
     // Wrapper for REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM
     future<std::tuple<rpc::sink<repair_hash_with_cmd>, rpc::source<repair_row_on_wire_with_cmd>>> make_sink_and_source_for_repair_get_row_diff_with_rpc_stream(uint32_t repair_meta_id, msg_addr id);
     rpc::sink<repair_row_on_wire_with_cmd> make_sink_for_repair_get_row_diff_with_rpc_stream(rpc::source<repair_hash_with_cmd>& source);
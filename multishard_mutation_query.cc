@@ -520,10 +520,16 @@ future<> read_context::save_reader(shard_id shard, const dht::decorated_key& las
                     last_pkey,
                     last_ckey);
 
-            db.get_querier_cache().insert(query_uuid, std::move(querier), gts.get());
-
             db.get_stats().multishard_query_unpopped_fragments += fragments;
             db.get_stats().multishard_query_unpopped_bytes += (size_after - size_before);
+
+            if (db.prefetch_next_page(querier, _cmd)) {
+                // The next page reads the prefetched rows with a new reader.
+                return do_with(std::move(querier), [] (query::shard_mutation_querier& q) {
+                    return q.close();
+                });
+            }
+            db.get_querier_cache().insert(query_uuid, std::move(querier), gts.get());
             return make_ready_future<>();
         } catch (...) {
             // We don't want to fail a read just because of a failure to
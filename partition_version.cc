@@ -631,6 +631,18 @@ void partition_snapshot::touch() noexcept {
     }
 }
 
+void partition_snapshot::touch_probationary() noexcept {
+    // The last dummy is never removed by eviction, so unlike for other rows,
+    // evicting it before the ones of older versions doesn't break the snapshot.
+    if (_tracker && at_latest_version()) {
+        auto&& rows = version()->partition().clustered_rows();
+        assert(!rows.empty());
+        rows_entry& last_dummy = *rows.rbegin();
+        assert(last_dummy.is_last_dummy());
+        _tracker->touch_probationary(last_dummy);
+    }
+}
+
 std::ostream& operator<<(std::ostream& out, const partition_entry::printer& p) {
     auto& e = p._partition_entry;
     out << "{";
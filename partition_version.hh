@@ -353,6 +353,10 @@ class partition_snapshot : public enable_lw_shared_from_this<partition_snapshot>
     // Brings the snapshot to the front of the LRU.
     void touch() noexcept;
 
+    // Like touch(), but to the probationary entries of the LRU,
+    // see lru::add_probationary().
+    void touch_probationary() noexcept;
+
     // Must be called after snapshot's original region is merged into a different region
     // before the original region is destroyed, unless the snapshot is destroyed earlier.
     void migrate(logalloc::region* region, mutation_cleaner* cleaner) noexcept {
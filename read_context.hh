@@ -143,6 +143,8 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     std::optional<dht::decorated_key> _key;
     bool _partition_exists;
     row_cache::phase_type _phase;
+    // Whether the admission policy admits the current partition, see cache_tracker::admits().
+    bool _admitted = true;
 public:
     read_context(row_cache& cache,
             schema_ptr schema,
@@ -197,6 +199,7 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     row_cache::phase_type phase() const { return _phase; }
     const dht::decorated_key& key() const { return *_key; }
     bool partition_exists() const { return _partition_exists; }
+    bool admitted() const { return _admitted; }
     void on_underlying_created() { ++_underlying_created; }
     bool digest_requested() const { return _slice.options.contains<query::partition_slice::option::with_digest>(); }
 public:
@@ -221,6 +224,7 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
         _phase = phase;
         _underlying_snapshot = snapshot;
         _key = dk;
+        _admitted = _cache._tracker.admits(dk);
     }
     // Precondition: each caller needs to make sure that partition with |dk| key
     //               exists in underlying before calling this function.
@@ -228,6 +232,7 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
         _phase = phase;
         _underlying_snapshot = {};
         _key = dk;
+        _admitted = _cache._tracker.admits(dk);
     }
     future<> close() noexcept {
         return _underlying.close();
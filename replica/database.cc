@@ -98,11 +98,13 @@ make_compaction_manager(const db::config& cfg, database_config& dbcfg, abort_sou
                 cfg.compaction_static_shares(),
                 as);
     }
-    return std::make_unique<compaction_manager>(
+    auto cm = std::make_unique<compaction_manager>(
             compaction_manager::compaction_scheduling_group{dbcfg.compaction_scheduling_group, service::get_local_compaction_priority()},
             compaction_manager::maintenance_scheduling_group{dbcfg.streaming_scheduling_group, service::get_local_streaming_priority()},
             dbcfg.available_memory,
             as);
+    cm->set_read_amplification_target(cfg.compaction_read_amplification_target);
+    return cm;
 }
 
 keyspace::keyspace(lw_shared_ptr<keyspace_metadata> metadata, config cfg, locator::effective_replication_map_factory& erm_factory)
@@ -385,6 +387,12 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     setup_metrics();
 
     _row_cache_tracker.set_compaction_scheduling_group(dbcfg.memory_compaction_scheduling_group);
+    _row_cache_tracker.set_admission_policy(cache_tracker::admission_policy_from_string(_cfg.cache_admission_policy()));
+    _row_cache_tracker.set_compress_cold_partitions(_cfg.cache_compress_cold_partitions());
+    _hot_partitions.enable(_cfg.enable_hot_partition_replication());
+    auto hot_partitions_cfg = _hot_partitions.get_config();
+    hot_partitions_cfg.min_reads = _cfg.hot_partition_replication_min_reads();
+    _hot_partitions.set_config(std::move(hot_partitions_cfg));
 
     setup_scylla_memory_diagnostics_producer();
     if (_dbcfg.sstables_format) {
@@ -726,6 +734,27 @@ database::setup_metrics() {
 
         sm::make_total_operations("total_view_updates_failed_remote", _cf_stats.total_view_updates_failed_remote,
                 sm::description("Total number of view updates generated for tables and failed to be sent to remote replicas.")),
+
+        sm::make_counter("cache_prefetches", _stats->cache_prefetches,
+                sm::description("The number of times the rows of the next page of a paged read were read into the row cache in the background.")),
+
+        sm::make_counter("cache_prefetches_dropped", _stats->cache_prefetches_dropped,
+                sm::description("The number of prefetches of the next page of a paged read dropped because too many were in progress.")),
+
+        sm::make_counter("cache_prefetched_rows", _stats->cache_prefetched_rows,
+                sm::description("The number of rows read into the row cache by prefetches of the next page of paged reads.")),
+
+        sm::make_counter("hot_partition_hits", [this] { return _hot_partitions.get_stats().hits; },
+                sm::description("The number of reads of partitions of other shards served from their copy on this shard.")),
+
+        sm::make_counter("hot_partition_misses", [this] { return _hot_partitions.get_stats().misses; },
+                sm::description("The number of reads of partitions of other shards which had no copy on this shard.")),
+
+        sm::make_counter("hot_partition_replications", [this] { return _hot_partitions.get_stats().replications; },
+                sm::description("The number of partitions of other shards copied to this shard because they are read often.")),
+
+        sm::make_counter("hot_partition_invalidations", [this] { return _hot_partitions.get_stats().invalidations; },
+                sm::description("The number of copies of partitions of other shards dropped because the partition was written to.")),
     });
     if (this_shard_id() == 0) {
         _metrics.add_group("database", {
@@ -889,6 +918,9 @@ void database::add_column_family(keyspace& ks, schema_ptr schema, column_family:
     schema->registry_entry()->mark_synced();
     // avoid self-reporting
     auto& sst_manager = is_system_table(*schema) ? get_system_sstables_manager() : get_user_sstables_manager();
+    cfg.invalidate_hot_partition_replicas = [this, uuid = schema->id()] {
+        return invalidate_hot_partition_replicas(uuid);
+    };
     lw_shared_ptr<column_family> cf;
     if (cfg.enable_commitlog && _commitlog) {
        cf = make_lw_shared<column_family>(schema, std::move(cfg), *_commitlog, *_compaction_manager, sst_manager, *_cl_stats, _row_cache_tracker);
@@ -1329,7 +1361,7 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
             co_await semaphore.with_permit(s.get(), "data-query", cf.estimate_read_memory_cost(), timeout, read_func);
         }
 
-        if (cmd.query_uuid != utils::UUID{} && querier_opt) {
+        if (cmd.query_uuid != utils::UUID{} && querier_opt && !prefetch_next_page(*querier_opt, cmd)) {
             _querier_cache.insert(cmd.query_uuid, std::move(*querier_opt), std::move(trace_state));
         }
     } catch (...) {
@@ -1390,7 +1422,7 @@ database::query_mutations(schema_ptr s, const query::read_command& cmd, const dh
             co_await semaphore.with_permit(s.get(), "mutation-query", cf.estimate_read_memory_cost(), timeout, read_func);
         }
 
-        if (cmd.query_uuid != utils::UUID{} && querier_opt) {
+        if (cmd.query_uuid != utils::UUID{} && querier_opt && !prefetch_next_page(*querier_opt, cmd)) {
             _querier_cache.insert(cmd.query_uuid, std::move(*querier_opt), std::move(trace_state));
         }
 
@@ -1412,6 +1444,199 @@ database::query_mutations(schema_ptr s, const query::read_command& cmd, const dh
     co_return std::tuple(std::move(result), hit_rate);
 }
 
+std::optional<query::result> database::query_hot_partition(const schema_ptr& s, const query::read_command& cmd, query::result_options opts,
+        const dht::decorated_key& dk) {
+    for (auto& k : _hot_partitions.maybe_end_window()) {
+        unregister_hot_partition_replica(std::move(k));
+    }
+    auto res = _hot_partitions.query(s, cmd, opts, dk);
+    if (_hot_partitions.record_read(s, dk)) {
+        replicate_hot_partition(s, dk);
+    }
+    return res;
+}
+
+void database::replicate_hot_partition(const schema_ptr& s, const dht::decorated_key& dk) {
+    hot_partition_cache::key k(s, dk);
+    if (_hot_partitions_gate.is_closed()) {
+        _hot_partitions.abort_replication(k);
+        return;
+    }
+    // Uses the default smp service group, like unregister_hot_partition_replica(),
+    // so that the owner sees the registrations and unregistrations of a
+    // partition in order.
+    auto owner = dht::shard_of(*s, dk.token());
+    (void)with_gate(_hot_partitions_gate, [this, k = std::move(k), owner] {
+        return container().invoke_on(owner, [gs = global_schema_ptr(k.schema), dk = k.key, shard = this_shard_id()] (database& db) mutable {
+            return db.read_hot_partition(std::move(gs), std::move(dk), shard);
+        }).then_wrapped([this, k] (future<foreign_ptr<std::unique_ptr<frozen_mutation>>> f) {
+            try {
+                auto fm = f.get0();
+                if (!fm) {
+                    _hot_partitions.abort_replication(k);
+                } else if (!_hot_partitions.complete_replication(k, fm->unfreeze(k.schema))) {
+                    dblog.trace("Copy of hot partition {} was invalidated while it was made", sstring(k));
+                }
+            } catch (...) {
+                dblog.debug("Failed to copy hot partition {}: {}", sstring(k), std::current_exception());
+                _hot_partitions.abort_replication(k);
+                unregister_hot_partition_replica(k);
+            }
+        });
+    });
+}
+
+future<foreign_ptr<std::unique_ptr<frozen_mutation>>> database::read_hot_partition(global_schema_ptr gs, dht::decorated_key dk, unsigned shard) {
+    schema_ptr s = gs.get();
+    auto& cfg = _hot_partitions.get_config();
+    // Registered before the read, so that the writes which the read misses
+    // invalidate the copy.
+    _hot_partitions.add_replica_shard(hot_partition_cache::key(s, dk), shard);
+    auto cmd = query::read_command(s->id(), s->version(), s->full_slice(), get_unlimited_query_max_result_size(),
+            query::row_limit(cfg.max_rows + 1), query::partition_limit(1));
+    auto [result, hit_rate] = co_await query_mutations(s, cmd, dht::partition_range::make_singular(dk), nullptr, db::no_timeout);
+    auto& partitions = result.partitions();
+    if (partitions.empty()) {
+        co_return make_foreign(std::make_unique<frozen_mutation>(freeze(mutation(s, dk))));
+    }
+    if (result.is_short_read() || result.row_count() > cfg.max_rows || partitions.front().mut().representation().size() > cfg.max_size) {
+        _hot_partitions.remove_replica_shard(hot_partition_cache::key(s, dk), shard);
+        co_return nullptr;
+    }
+    co_return make_foreign(std::make_unique<frozen_mutation>(std::move(partitions.front().mut())));
+}
+
+void database::unregister_hot_partition_replica(hot_partition_cache::key k) {
+    if (_hot_partitions_gate.is_closed()) {
+        return;
+    }
+    auto owner = dht::shard_of(*k.schema, k.key.token());
+    // Not waited for, a stale registration only causes spurious invalidations.
+    (void)with_gate(_hot_partitions_gate, [this, owner, k = db::toppartitions_global_item_key(std::move(k))] () mutable {
+        return container().invoke_on(owner, [k = std::move(k), shard = this_shard_id()] (database& db) {
+            db._hot_partitions.remove_replica_shard(k, shard);
+        });
+    }).handle_exception([] (std::exception_ptr ep) {
+        dblog.debug("Failed to unregister the copy of a hot partition: {}", ep);
+    });
+}
+
+future<> database::invalidate_hot_partition_replicas(const schema& s, partition_key_view key) {
+    if (!_hot_partitions.has_replica_shards(s.id())) {
+        co_return;
+    }
+    auto dk = dht::decorate_key(s, partition_key(key));
+    auto shards = _hot_partitions.take_replica_shards(hot_partition_cache::key(s.shared_from_this(), dk));
+    co_await coroutine::parallel_for_each(shards, [this, &s, &dk] (unsigned shard) -> future<> {
+        co_await container().invoke_on(shard, [id = s.id(), &dk] (database& db) {
+            db._hot_partitions.invalidate(id, dk);
+        });
+    });
+}
+
+bool database::prefetch_next_page(const query::querier_base& q, const query::read_command& cmd) noexcept {
+    const auto& slice = cmd.slice;
+    const auto pos = q.current_position();
+    if (!_cfg.cache_prefetch_paged_reads() || !pos.partition_key || slice.is_reversed()
+            || slice.options.contains(query::partition_slice::option::bypass_cache)) {
+        return false;
+    }
+    if (_cache_prefetches_in_progress >= max_concurrent_cache_prefetches || _cache_prefetch_gate.is_closed()) {
+        ++_stats->cache_prefetches_dropped;
+        return false;
+    }
+
+    try {
+        auto s = q.schema().shared_from_this();
+        const auto& dk = *pos.partition_key;
+        const auto cmp = dht::ring_position_comparator(*s);
+        auto ranges = q.ranges();
+        auto it = std::find_if(ranges.begin(), ranges.end(), [&] (const dht::partition_range& r) {
+            return r.contains(dht::ring_position(dk), cmp);
+        });
+        if (it == ranges.end()) {
+            return false;
+        }
+        // Same as the start of the next page, see ring_position_matches() in querier.cc.
+        const bool same_partition = s->clustering_key_size() > 0
+                && !slice.options.contains<query::partition_slice::option::distinct>()
+                && pos.clustering_key;
+        dht::partition_range range;
+        if (it->is_singular() || (it->end() && cmp(it->end()->value(), dht::ring_position_view(dk)) == 0)) {
+            if (!same_partition) {
+                return false;
+            }
+            range = dht::partition_range::make_singular(dk);
+        } else {
+            range = dht::partition_range({dht::partition_range::bound(dht::ring_position(dk), same_partition)}, it->end());
+        }
+        auto next_slice = slice;
+        if (same_partition) {
+            auto row_ranges = slice.row_ranges(*s, dk.key());
+            query::trim_clustering_row_ranges_to(*s, row_ranges, *pos.clustering_key);
+            next_slice.set_range(*s, dk.key(), std::move(row_ranges));
+        }
+
+        ++_stats->cache_prefetches;
+        ++_cache_prefetches_in_progress;
+        (void)with_gate(_cache_prefetch_gate, [this, s = std::move(s), range = std::move(range), slice = std::move(next_slice),
+                row_limit = cmd.get_row_limit(), partition_limit = cmd.partition_limit] () mutable {
+            return with_scheduling_group(_dbcfg.cache_prefetch_scheduling_group, [this, s = std::move(s), range = std::move(range),
+                    slice = std::move(slice), row_limit, partition_limit] () mutable {
+                return do_prefetch_next_page(std::move(s), std::move(range), std::move(slice), row_limit, partition_limit);
+            });
+        }).then_wrapped([this] (future<> f) {
+            --_cache_prefetches_in_progress;
+            if (f.failed()) {
+                dblog.debug("Failed to prefetch the next page of a paged read: {}", f.get_exception());
+            }
+        });
+        return true;
+    } catch (...) {
+        // Never fails the read.
+        dblog.debug("Failed to start prefetching the next page of a paged read: {}", std::current_exception());
+        return false;
+    }
+}
+
+future<> database::do_prefetch_next_page(schema_ptr s, dht::partition_range range, query::partition_slice slice,
+        uint64_t row_limit, uint32_t partition_limit) {
+    auto& cf = find_column_family(s);
+    auto op = cf.read_in_progress();
+    // Not worth it once the querier is evicted.
+    auto permit = co_await obtain_reader_permit(cf, "cache-prefetch", db::timeout_clock::now() + query::querier_cache::default_entry_ttl);
+    auto reader = cf.get_row_cache().make_reader(s, std::move(permit), range, slice, service::get_local_streaming_priority());
+    uint64_t rows = 0;
+    uint32_t partitions = 0;
+    std::exception_ptr ex;
+    try {
+        while (auto mf = co_await reader()) {
+            if (mf->is_partition_start() && ++partitions > partition_limit) {
+                break;
+            }
+            if (mf->is_clustering_row() && ++rows >= row_limit) {
+                break;
+            }
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await reader.close();
+    _stats->cache_prefetched_rows += rows;
+    if (ex) {
+        co_return coroutine::exception(std::move(ex));
+    }
+}
+
+future<> database::invalidate_hot_partition_replicas(const utils::UUID& table_id) {
+    auto replicas = _hot_partitions.take_replica_shards(table_id);
+    co_await coroutine::parallel_for_each(replicas, [this, &table_id] (const std::pair<dht::decorated_key, unsigned>& r) -> future<> {
+        co_await container().invoke_on(r.second, [&table_id, &dk = r.first] (database& db) {
+            db._hot_partitions.invalidate(table_id, dk);
+        });
+    });
+}
+
 namespace {
 
 enum class query_class {
@@ -1436,7 +1661,8 @@ query_class classify_query(const database_config& _dbcfg) {
             || current_group == _dbcfg.memtable_to_cache_scheduling_group) {
         return query_class::system;
     // Reads done on behalf of view update generation run in the streaming group
-    } else if (current_scheduling_group() == _dbcfg.streaming_scheduling_group) {
+    } else if (current_scheduling_group() == _dbcfg.streaming_scheduling_group
+            || current_scheduling_group() == _dbcfg.cache_prefetch_scheduling_group) {
         return query_class::maintenance;
     // Everything else is considered a user query
     } else {
@@ -1695,13 +1921,17 @@ future<> database::apply_in_memory(const frozen_mutation& m, schema_ptr m_schema
     data_listeners().on_write(m_schema, m);
 
     return with_gate(cf.async_gate(), [this, &m, m_schema = std::move(m_schema), h = std::move(h), &cf, timeout] () mutable -> future<> {
-        return cf.apply(m, std::move(m_schema), std::move(h), timeout);
+        return cf.apply(m, m_schema, std::move(h), timeout).then([this, &m, m_schema] {
+            return invalidate_hot_partition_replicas(*m_schema, m.key());
+        });
     });
 }
 
 future<> database::apply_in_memory(const mutation& m, column_family& cf, db::rp_handle&& h, db::timeout_clock::time_point timeout) {
     return with_gate(cf.async_gate(), [this, &m, h = std::move(h), &cf, timeout]() mutable -> future<> {
-        return cf.apply(m, std::move(h), timeout);
+        return cf.apply(m, std::move(h), timeout).then([this, &m] {
+            return invalidate_hot_partition_replicas(*m.schema(), m.key());
+        });
     });
 }
 
@@ -2007,9 +2237,15 @@ future<> database::shutdown() {
     _shutdown = true;
     auto b = defer([this] { _stop_barrier.abort(); });
     co_await _compaction_manager->stop();
+    co_await _hot_partitions_gate.close();
+    co_await _cache_prefetch_gate.close();
     co_await _stop_barrier.arrive_and_wait();
     b.cancel();
 
+    // Save the index cache hot set while user tables are still open, so
+    // that the next start can warm up the index caches from it.
+    co_await _user_sstables_manager->save_index_caches();
+
     // Closing a table can cause us to find a large partition. Since we want to record that, we have to close
     // system.large_partitions after the regular tables.
     co_await close_tables(database::table_kind::user);
@@ -2185,6 +2421,7 @@ future<> database::truncate(const keyspace& ks, column_family& cf, timestamp_fun
     // will be available until next reboot and a client will have to retry truncation anyway.
     cf.cache_truncation_record(truncated_at);
     co_await db::system_keyspace::save_truncation_record(cf, truncated_at, rp);
+    co_await invalidate_hot_partition_replicas(uuid);
 
     drop_repair_history_map_for_table(uuid);
 }
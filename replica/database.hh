@@ -66,6 +66,7 @@
 #include "absl-flat_hash_map.hh"
 #include "utils/cross-shard-barrier.hh"
 #include "sstables/generation_type.hh"
+#include "replica/hot_partition_cache.hh"
 
 class cell_locker;
 class cell_locker_stats;
@@ -378,6 +379,11 @@ class table : public enable_lw_shared_from_this<table> {
         db::timeout_semaphore* view_update_concurrency_semaphore;
         size_t view_update_concurrency_semaphore_limit;
         db::data_listeners* data_listeners = nullptr;
+        // Drops the copies of the hot partitions of the table made by other
+        // shards, see database::invalidate_hot_partition_replicas(). Called
+        // when sstables which didn't come from this table's memtables or
+        // compactions are added, as their data bypassed database::apply().
+        std::function<future<> ()> invalidate_hot_partition_replicas;
         // Not really table-specific (it's a global configuration parameter), but stored here
         // for easy access from `table` member functions:
         utils::updateable_value<bool> reversed_reads_auto_bypass_cache{false};
@@ -616,6 +622,13 @@ class table : public enable_lw_shared_from_this<table> {
                                         streamed_mutation::forwarding fwd,
                                         mutation_reader::forwarding fwd_mr) const;
 
+    // Drops the ranges of a multi-partition read whose partition is in none of
+    // the memtables and, going by a batched probe of the bloom filters, in none
+    // of the sstables. The cache only holds data backed by those, so reading
+    // such partitions cannot find anything. Returns nullopt when nothing can be
+    // pruned, i.e. unless all ranges are singular.
+    std::optional<dht::partition_range_vector> prune_absent_partitions(const dht::partition_range_vector& ranges) const;
+
     lw_shared_ptr<sstables::sstable_set> make_maintenance_sstable_set() const;
     lw_shared_ptr<sstables::sstable_set> make_compound_sstable_set();
     // Compound sstable set must be refreshed whenever any of its managed sets are changed
@@ -699,6 +712,10 @@ class table : public enable_lw_shared_from_this<table> {
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit,
             const dht::partition_range_vector& ranges) const;
 
+    // Like the above, but doesn't read from the excluded sstables.
+    flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit,
+            const dht::partition_range_vector& ranges, lw_shared_ptr<const sstables::sstable_list> excluded) const;
+
     // Single range overload.
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
             const query::partition_slice& slice,
@@ -1197,6 +1214,8 @@ struct database_config {
     seastar::scheduling_group statement_scheduling_group;
     seastar::scheduling_group streaming_scheduling_group;
     seastar::scheduling_group gossip_scheduling_group;
+    // Speculative reads of the next page of paged reads, see database::prefetch_next_page().
+    seastar::scheduling_group cache_prefetch_scheduling_group;
     size_t available_memory;
     std::optional<sstables::sstable_version_types> sstables_format;
 };
@@ -1260,6 +1279,10 @@ class database : public peering_sharded_service<database> {
         uint64_t multishard_query_unpopped_bytes = 0;
         uint64_t multishard_query_failed_reader_stops = 0;
         uint64_t multishard_query_failed_reader_saves = 0;
+
+        uint64_t cache_prefetches = 0;
+        uint64_t cache_prefetches_dropped = 0;
+        uint64_t cache_prefetched_rows = 0;
     };
 
     lw_shared_ptr<db_stats> _stats;
@@ -1308,6 +1331,11 @@ class database : public peering_sharded_service<database> {
     bool _shutdown = false;
     bool _enable_autocompaction_toggle = false;
     query::querier_cache _querier_cache;
+    hot_partition_cache _hot_partitions;
+    // Background replications of hot partitions, see replicate_hot_partition().
+    seastar::gate _hot_partitions_gate;
+    seastar::gate _cache_prefetch_gate;
+    unsigned _cache_prefetches_in_progress = 0;
 
     std::unique_ptr<db::large_data_handler> _large_data_handler;
     std::unique_ptr<db::large_data_handler> _nop_large_data_handler;
@@ -1329,6 +1357,20 @@ class database : public peering_sharded_service<database> {
     std::unique_ptr<wasm::engine> _wasm_engine;
     utils::cross_shard_barrier _stop_barrier;
 
+private:
+    // Copies the partition to this shard, in the background.
+    void replicate_hot_partition(const schema_ptr& s, const dht::decorated_key& dk);
+    // On the shard which owns the partition. Returns null if the partition is
+    // too large to be copied.
+    future<foreign_ptr<std::unique_ptr<frozen_mutation>>> read_hot_partition(global_schema_ptr gs, dht::decorated_key dk, unsigned shard);
+    void unregister_hot_partition_replica(hot_partition_cache::key k);
+    // Drops the copies of the partition, or of all the partitions of the
+    // table, made by other shards.
+    future<> invalidate_hot_partition_replicas(const schema& s, partition_key_view key);
+    future<> invalidate_hot_partition_replicas(const utils::UUID& table_id);
+    future<> do_prefetch_next_page(schema_ptr s, dht::partition_range range, query::partition_slice slice,
+            uint64_t row_limit, uint32_t partition_limit);
+
 public:
     data_dictionary::database as_data_dictionary() const;
     std::shared_ptr<data_dictionary::user_types_storage> as_user_types_storage() const noexcept;
@@ -1607,6 +1649,32 @@ class database : public peering_sharded_service<database> {
         return _querier_cache;
     }
 
+    hot_partition_cache& hot_partitions() noexcept {
+        return _hot_partitions;
+    }
+
+    // Serves a read of a single partition, owned by another shard, from its
+    // copy on this shard, if there is one. Otherwise, counts the read, and
+    // starts copying the partition if it's read often enough.
+    std::optional<query::result> query_hot_partition(const schema_ptr& s, const query::read_command& cmd, query::result_options opts,
+            const dht::decorated_key& dk);
+
+    // More prefetches are dropped.
+    static constexpr unsigned max_concurrent_cache_prefetches = 16;
+
+    // Called when a page of the paged read cmd ends and its querier is saved.
+    // Reads the rows of the next page, from where q stopped, into the row
+    // cache in the background, so that the next page doesn't miss the cache
+    // at the page boundary. Only the cache and the sstables are read, and
+    // nothing is returned.
+    //
+    // Returns true if the prefetch was started. The caller must then drop q
+    // instead of saving it: a cache reader which went to the sstables keeps
+    // reading them up to the end of the range it missed, so resuming q would
+    // not make use of the prefetched rows. The next page creates a new reader,
+    // which finds them in the cache.
+    bool prefetch_next_page(const query::querier_base& q, const query::read_command& cmd) noexcept;
+
     db::view::update_backlog get_view_update_backlog() const {
         return {max_memory_pending_view_updates() - _view_update_concurrency_sem.current(), max_memory_pending_view_updates()};
     }
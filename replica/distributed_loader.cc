@@ -676,6 +676,14 @@ future<> distributed_loader::init_non_system_keyspaces(distributed<replica::data
                 return make_ready_future<>();
             });
         }).get();
+
+        // Bring back the index cache hot set of the previous run before the
+        // node starts serving, so that reads don't start with cold index caches.
+        // Use the low priority streaming I/O class, as the warmup competes for
+        // the disk with the rest of the startup.
+        db.invoke_on_all([] (replica::database& db) {
+            return db.get_user_sstables_manager().warm_up_index_caches(service::get_local_streaming_priority());
+        }).get();
     });
 }
 
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <algorithm>
+
+#include "replica/hot_partition_cache.hh"
+#include "mutation_query.hh"
+
+namespace replica {
+
+void hot_partition_cache::set_config(config cfg) {
+    _cfg = std::move(cfg);
+    _reads = top_k(_cfg.tracked_partitions);
+    _window_start = lowres_clock::now();
+}
+
+std::optional<query::result> hot_partition_cache::query(const schema_ptr& s, const query::read_command& cmd, query::result_options opts,
+        const dht::decorated_key& dk) {
+    auto it = _replicas.find(key(s, dk));
+    if (it != _replicas.end() && it->second.version != s->version()) {
+        // Not worth upgrading, let it be copied again.
+        _replicas.erase(it);
+        it = _replicas.end();
+    }
+    // The copy is in the native order.
+    if (it == _replicas.end()
+            || cmd.slice.options.contains(query::partition_slice::option::reversed)
+            || cmd.slice.options.contains(query::partition_slice::option::bypass_cache)) {
+        ++_stats.misses;
+        return std::nullopt;
+    }
+    ++_stats.hits;
+    return query_mutation(mutation(it->second.data), cmd.slice, cmd.get_row_limit(), cmd.timestamp, opts);
+}
+
+bool hot_partition_cache::record_read(const schema_ptr& s, const dht::decorated_key& dk) {
+    key k(s, dk);
+    _reads.append(k);
+    if (_reads.guaranteed_count(k) < _cfg.min_reads || _replicas.size() + _pending.size() >= _cfg.capacity) {
+        return false;
+    }
+    if (_replicas.contains(k)) {
+        return false;
+    }
+    return _pending.insert(std::move(k)).second;
+}
+
+template <typename Pred>
+size_t hot_partition_cache::drop_replicas_if(Pred pred) {
+    std::erase_if(_pending, pred);
+    return std::erase_if(_replicas, [&] (const auto& r) { return pred(r.first); });
+}
+
+std::vector<hot_partition_cache::key> hot_partition_cache::maybe_end_window() {
+    std::vector<key> dropped;
+    auto now = lowres_clock::now();
+    if (now - _window_start < _cfg.window) {
+        return dropped;
+    }
+    _window_start = now;
+    for (auto it = _replicas.begin(); it != _replicas.end();) {
+        if (_reads.guaranteed_count(it->first) < _cfg.min_reads) {
+            dropped.push_back(it->first);
+            it = _replicas.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    _reads = top_k(_cfg.tracked_partitions);
+    return dropped;
+}
+
+bool hot_partition_cache::complete_replication(const key& k, mutation m) {
+    if (!_pending.erase(k)) {
+        return false;
+    }
+    auto version = m.schema()->version();
+    _replicas.insert_or_assign(k, replica{version, std::move(m)});
+    ++_stats.replications;
+    return true;
+}
+
+void hot_partition_cache::abort_replication(const key& k) {
+    _pending.erase(k);
+}
+
+void hot_partition_cache::invalidate(const utils::UUID& table_id, const dht::decorated_key& dk) {
+    // There are few copies, and the key may be of another version of the schema.
+    _stats.invalidations += drop_replicas_if([&] (const key& k) {
+        return k.schema->id() == table_id && k.key.equal(*k.schema, dk);
+    });
+}
+
+void hot_partition_cache::add_replica_shard(const key& k, unsigned shard) {
+    auto [it, inserted] = _replica_shards.try_emplace(k);
+    if (inserted) {
+        ++_replicated_tables[k.schema->id()];
+    }
+    if (std::find(it->second.begin(), it->second.end(), shard) == it->second.end()) {
+        it->second.push_back(shard);
+    }
+}
+
+void hot_partition_cache::remove_replica_shard(const key& k, unsigned shard) {
+    auto it = _replica_shards.find(k);
+    if (it == _replica_shards.end()) {
+        return;
+    }
+    std::erase(it->second, shard);
+    if (it->second.empty()) {
+        _replica_shards.erase(it);
+        auto t = _replicated_tables.find(k.schema->id());
+        if (!--t->second) {
+            _replicated_tables.erase(t);
+        }
+    }
+}
+
+std::vector<unsigned> hot_partition_cache::take_replica_shards(const key& k) {
+    auto it = _replica_shards.find(k);
+    if (it == _replica_shards.end()) {
+        return {};
+    }
+    auto shards = std::move(it->second);
+    _replica_shards.erase(it);
+    auto t = _replicated_tables.find(k.schema->id());
+    if (!--t->second) {
+        _replicated_tables.erase(t);
+    }
+    return shards;
+}
+
+std::vector<std::pair<dht::decorated_key, unsigned>> hot_partition_cache::take_replica_shards(const utils::UUID& table_id) {
+    std::vector<std::pair<dht::decorated_key, unsigned>> ret;
+    if (!_replicated_tables.erase(table_id)) {
+        return ret;
+    }
+    for (auto it = _replica_shards.begin(); it != _replica_shards.end();) {
+        if (it->first.schema->id() == table_id) {
+            for (auto shard : it->second) {
+                ret.emplace_back(it->first.key, shard);
+            }
+            it = _replica_shards.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return ret;
+}
+
+std::vector<hot_partition_cache::hot_partition> hot_partition_cache::top(size_t k) const {
+    std::vector<hot_partition> ret;
+    for (auto& r : _reads.top(k)) {
+        ret.push_back(hot_partition{r.item.schema->ks_name(), r.item.schema->cf_name(), sstring(r.item),
+                r.count, r.error, _replicas.contains(r.item)});
+    }
+    return ret;
+}
+
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <seastar/core/lowres_clock.hh>
+
+#include "db/data_listeners.hh"
+#include "mutation.hh"
+#include "query-request.hh"
+#include "query-result.hh"
+
+namespace replica {
+
+// Copies, on the shard which coordinates their reads, of the partitions of
+// other shards which it reads the most.
+//
+// Under a skewed workload, the shard which owns a hot partition serves all
+// of its reads while the other shards idle. Each shard counts the reads of
+// the partitions of other shards which it coordinates, with a
+// space_saving_top_k over a time window (see record_read()). Once a partition
+// is read often enough, it's copied from its owner (see
+// database::replicate_hot_partition()), and its reads are served from the
+// copy (see query()), without a cross-shard hop.
+//
+// The owner of a partition keeps track of the shards which replicate it (see
+// add_replica_shard()). Applying a write to the memtable of the partition
+// invalidates the copies before the write completes (see
+// database::invalidate_hot_partition_replicas()), so that a copy never
+// misses an acknowledged write. Copies which are invalidated while they're
+// being made are dropped (see complete_replication()). Sstables added by
+// streaming, repair or refresh, whose data bypasses the memtable, invalidate
+// all the copies of the partitions of their table when they're added (see
+// table::do_add_sstable_and_update_cache()).
+class hot_partition_cache {
+public:
+    using key = db::toppartitions_item_key;
+    using top_k = db::toppartitions_data_listener::top_k;
+
+    struct config {
+        // Maximum number of partitions copied to this shard.
+        size_t capacity = 16;
+        // Number of partitions whose reads are counted.
+        size_t tracked_partitions = 256;
+        // Reads of a partition within a window after which it's copied.
+        unsigned min_reads = 100;
+        std::chrono::milliseconds window = std::chrono::seconds(10);
+        // Larger partitions aren't copied.
+        uint64_t max_rows = 1000;
+        size_t max_size = 1024 * 1024;
+    };
+
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t replications = 0;
+        uint64_t invalidations = 0;
+    };
+
+    struct hot_partition {
+        sstring keyspace;
+        sstring table;
+        sstring partition;
+        unsigned count;
+        unsigned error;
+        bool replicated;
+    };
+private:
+    struct replica {
+        table_schema_version version;
+        mutation data;
+    };
+
+    config _cfg;
+    bool _enabled = false;
+    stats _stats;
+    top_k _reads;
+    lowres_clock::time_point _window_start = lowres_clock::now();
+    std::unordered_map<key, replica, key::hash, key::comp> _replicas;
+    // Partitions being copied from their owner.
+    std::unordered_set<key, key::hash, key::comp> _pending;
+    // Shards which replicate the partitions owned by this shard.
+    std::unordered_map<key, std::vector<unsigned>, key::hash, key::comp> _replica_shards;
+    std::unordered_map<utils::UUID, size_t> _replicated_tables;
+private:
+    template <typename Pred>
+    size_t drop_replicas_if(Pred pred);
+public:
+    hot_partition_cache() : _reads(_cfg.tracked_partitions) {}
+
+    void set_config(config cfg);
+    void enable(bool enabled) noexcept { _enabled = enabled; }
+    bool enabled() const noexcept { return _enabled; }
+    const config& get_config() const noexcept { return _cfg; }
+    const stats& get_stats() const noexcept { return _stats; }
+
+    // Serves a read of a partition owned by another shard from its copy, if
+    // there is one.
+    std::optional<query::result> query(const schema_ptr& s, const query::read_command& cmd, query::result_options opts,
+            const dht::decorated_key& dk);
+
+    // Counts a read of a partition owned by another shard. Returns true if
+    // the partition should be copied to this shard, in which case the copy is
+    // pending until complete_replication() or abort_replication().
+    bool record_read(const schema_ptr& s, const dht::decorated_key& dk);
+    // Ends the window if it's over, dropping the copies of the partitions
+    // which weren't read enough in it. Returns their keys, which the owners
+    // must be told about (see remove_replica_shard()).
+    std::vector<key> maybe_end_window();
+    // Returns true if the copy was kept, i.e. it wasn't invalidated while
+    // it was made.
+    bool complete_replication(const key& k, mutation m);
+    void abort_replication(const key& k);
+    // Drops the copy of the partition, if any.
+    void invalidate(const utils::UUID& table_id, const dht::decorated_key& dk);
+
+    // On the shard which owns the partition.
+    void add_replica_shard(const key& k, unsigned shard);
+    void remove_replica_shard(const key& k, unsigned shard);
+    bool has_replica_shards(const utils::UUID& table_id) const noexcept {
+        return _replicated_tables.contains(table_id);
+    }
+    // Returns the shards which replicate the partition and forgets them.
+    std::vector<unsigned> take_replica_shards(const key& k);
+    // Same, for all the partitions of the table.
+    std::vector<std::pair<dht::decorated_key, unsigned>> take_replica_shards(const utils::UUID& table_id);
+
+    // The partitions read the most in the current window.
+    std::vector<hot_partition> top(size_t k) const;
+};
+
+}
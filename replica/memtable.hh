@@ -107,7 +107,7 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private loga
 public:
     using partitions_type = double_decker<int64_t, memtable_entry,
                             dht::raw_token_less_comparator, dht::ring_position_comparator,
-                            16, bplus::key_search::linear>;
+                            16, bplus::key_search::simd>;
 private:
     dirty_memory_manager& _dirty_mgr;
     mutation_cleaner _cleaner;
@@ -229,6 +229,9 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private loga
     }
 
     size_t partition_count() const { return nr_partitions; }
+    // Whether the memtable holds the partition. Once the memtable is flushed,
+    // its partitions move to the cache and the sstables, and this returns false.
+    bool contains(const dht::decorated_key& key) const;
     logalloc::occupancy_stats occupancy() const;
 
     // Creates a reader of data in this memtable for given partition range.
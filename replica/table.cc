@@ -231,10 +231,16 @@ sstables::shared_sstable table::make_streaming_staging_sstable() {
 flat_mutation_reader_v2
 table::make_streaming_reader(schema_ptr s, reader_permit permit,
                            const dht::partition_range_vector& ranges) const {
+    return make_streaming_reader(std::move(s), std::move(permit), ranges, nullptr);
+}
+
+flat_mutation_reader_v2
+table::make_streaming_reader(schema_ptr s, reader_permit permit,
+                           const dht::partition_range_vector& ranges, lw_shared_ptr<const sstables::sstable_list> excluded) const {
     auto& slice = s->full_slice();
     auto& pc = service::get_local_streaming_priority();
 
-    auto source = mutation_source([this] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
+    auto source = mutation_source([this, excluded = std::move(excluded)] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
                                       const io_priority_class& pc, tracing::trace_state_ptr trace_state, streamed_mutation::forwarding fwd, mutation_reader::forwarding fwd_mr) {
         std::vector<flat_mutation_reader_v2> readers;
         readers.reserve(_memtables->size() + 1);
@@ -243,7 +249,18 @@ table::make_streaming_reader(schema_ptr s, reader_permit permit,
                 readers.emplace_back(std::move(*reader_opt));
             }
         }
-        readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, slice, pc, std::move(trace_state), fwd, fwd_mr));
+        auto set = _sstables;
+        if (excluded && !excluded->empty()) {
+            // The sstable list may have changed since the excluded sstables were
+            // selected, e.g. by memtable flushes, so filter the current one.
+            set = make_lw_shared<sstables::sstable_set>(_compaction_strategy.make_sstable_set(_schema));
+            _sstables->for_each_sstable([&] (const sstables::shared_sstable& sst) {
+                if (!excluded->contains(sst)) {
+                    set->insert(sst);
+                }
+            });
+        }
+        readers.emplace_back(make_sstable_reader(s, permit, std::move(set), range, slice, pc, std::move(trace_state), fwd, fwd_mr));
         return make_combined_reader(s, std::move(permit), std::move(readers), fwd, fwd_mr);
     });
 
@@ -438,7 +455,7 @@ void table::enable_off_strategy_trigger() {
 future<>
 table::do_add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::offstrategy offstrategy) {
     auto permit = co_await seastar::get_units(_sstable_set_mutation_sem, 1);
-    co_return co_await get_row_cache().invalidate(row_cache::external_updater([this, sst, offstrategy] () noexcept {
+    co_await get_row_cache().invalidate(row_cache::external_updater([this, sst, offstrategy] () noexcept {
         // FIXME: this is not really noexcept, but we need to provide strong exception guarantees.
         // atomically load all opened sstables into column family.
         if (!offstrategy) {
@@ -447,6 +464,11 @@ table::do_add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::o
             add_maintenance_sstable(sst);
         }
     }), dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true}));
+    // Like the row cache, the copies of hot partitions on other shards miss
+    // the data of the sstable, which never went through database::apply().
+    if (_config.invalidate_hot_partition_replicas) {
+        co_await _config.invalidate_hot_partition_replicas();
+    }
 }
 
 future<>
@@ -2021,6 +2043,37 @@ struct query_state {
     }
 };
 
+std::optional<dht::partition_range_vector>
+table::prune_absent_partitions(const dht::partition_range_vector& ranges) const {
+    if (ranges.size() < 2 || _virtual_reader || (_config.data_listeners && !_config.data_listeners->empty())) {
+        return std::nullopt;
+    }
+    std::vector<dht::decorated_key> keys;
+    keys.reserve(ranges.size());
+    for (auto& r : ranges) {
+        if (!r.is_singular() || !r.start()->value().has_key()) {
+            return std::nullopt;
+        }
+        keys.push_back(r.start()->value().as_decorated_key());
+    }
+
+    // Must not defer between looking at the memtables and the sstables, as a
+    // flush moves data from the former to the latter.
+    auto selected = _sstables->select_by_pk(keys);
+    dht::partition_range_vector pruned;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (!selected[i].empty() || std::any_of(_memtables->begin(), _memtables->end(), [&] (const shared_memtable& mt) { return mt->contains(keys[i]); })) {
+            pruned.push_back(ranges[i]);
+        }
+    }
+    if (pruned.size() == ranges.size()) {
+        return std::nullopt;
+    }
+    tlogger.trace("Pruned {} out of {} partitions of a multi-partition read of {}.{}", ranges.size() - pruned.size(), ranges.size(),
+            _schema->ks_name(), _schema->cf_name());
+    return pruned;
+}
+
 future<lw_shared_ptr<query::result>>
 table::query(schema_ptr s,
         reader_permit permit,
@@ -2052,13 +2105,15 @@ table::query(schema_ptr s,
              ? memory_limiter.new_digest_read(permit.max_result_size(), short_read_allowed)
              : memory_limiter.new_data_read(permit.max_result_size(), short_read_allowed));
 
-    query_state qs(s, cmd, opts, partition_ranges, std::move(accounter));
-
     std::optional<query::data_querier> querier_opt;
     if (saved_querier) {
         querier_opt = std::move(*saved_querier);
     }
 
+    // A saved querier is positioned in the first range, which must then be kept.
+    auto pruned_ranges = querier_opt ? std::nullopt : prune_absent_partitions(partition_ranges);
+    query_state qs(s, cmd, opts, pruned_ranges ? *pruned_ranges : partition_ranges, std::move(accounter));
+
     while (!qs.done()) {
         auto&& range = *qs.current_partition_range++;
 
@@ -2083,7 +2138,8 @@ table::query(schema_ptr s,
         }
     }
 
-    if (!saved_querier || (querier_opt && !querier_opt->are_limits_reached() && !qs.builder.is_short_read())) {
+    // querier_opt is disengaged if all ranges were pruned.
+    if (querier_opt && (!saved_querier || (!querier_opt->are_limits_reached() && !qs.builder.is_short_read()))) {
         co_await querier_opt->close();
         querier_opt = {};
     }
@@ -2410,7 +2466,11 @@ class table::table_state : public compaction::table_state {
         return _t.compaction_concurrency_semaphore().make_tracking_only_permit(schema().get(), "compaction", db::no_timeout);
     }
     sstables::sstable_writer_config configure_writer(sstring origin) const override {
-        return _t.get_sstables_manager().configure_writer(std::move(origin));
+        auto& manager = _t.get_sstables_manager();
+        auto cfg = manager.configure_writer(std::move(origin));
+        // Only compaction lays its output out for locality of wide partitions.
+        cfg.promoted_index_read_budget = size_t(manager.config().compaction_promoted_index_read_size_in_kb()) * 1024;
+        return cfg;
     }
     api::timestamp_type min_memtable_timestamp() const override {
         return _t.min_memtable_timestamp();
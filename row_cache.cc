@@ -11,11 +11,13 @@
 #include <seastar/core/do_with.hh>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/metrics.hh>
+#include <seastar/core/byteorder.hh>
 #include <seastar/util/defer.hh>
 #include "replica/memtable.hh"
 #include <chrono>
 #include <boost/version.hpp>
 #include <sys/sdt.h>
+#include <lz4.h>
 #include "read_context.hh"
 #include "dirty_memory_manager.hh"
 #include "real_dirty_memory_accounter.hh"
@@ -24,6 +26,7 @@
 #include "readers/nonforwardable.hh"
 #include "cache_flat_mutation_reader.hh"
 #include "clustering_key_filter.hh"
+#include "frozen_mutation.hh"
 
 namespace cache {
 
@@ -139,6 +142,23 @@ cache_tracker::setup_metrics() {
             sm::description("total amount of range tombstones processed during read")),
         sm::make_counter("row_tombstone_reads", _stats.row_tombstone_reads,
             sm::description("total amount of row tombstones processed during read")),
+        sm::make_counter("admitted_partition_hits", _stats.admitted_partition_hits,
+            sm::description("number of partitions needed by reads, found in cache, which the admission policy admits")),
+        sm::make_counter("admitted_partition_misses", _stats.admitted_partition_misses,
+            sm::description("number of partitions needed by reads, missing in cache, which the admission policy admits")),
+        sm::make_counter("probationary_partition_hits", _stats.probationary_partition_hits,
+            sm::description("number of partitions needed by reads, found in cache, which the admission policy doesn't admit")),
+        sm::make_counter("probationary_partition_misses", _stats.probationary_partition_misses,
+            sm::description("number of partitions needed by reads, missing in cache, which the admission policy doesn't admit")),
+        sm::make_counter("probationary_row_insertions", _stats.probationary_row_insertions,
+            sm::description("total number of rows added to cache as probationary, i.e. to be evicted first unless read again")),
+        sm::make_counter("partition_compressions", _stats.partition_compressions,
+            sm::description("total number of cold partitions which were compressed")),
+        sm::make_counter("partition_inflations", _stats.partition_inflations,
+            sm::description("total number of compressed partitions which were inflated back on access")),
+        sm::make_gauge("compressed_partitions", sm::description("number of cached partitions which are compressed"), _stats.compressed_partitions),
+        sm::make_counter("compressed_bytes_saved", _stats.compressed_bytes_saved,
+            sm::description("total number of bytes of memory which the compression of cold partitions saved")),
     });
 }
 
@@ -173,6 +193,58 @@ void cache_tracker::insert(cache_entry& entry) {
     _region.allocator().invalidate_references();
 }
 
+void cache_tracker::insert_probationary(cache_entry& entry) {
+    for (partition_version& pv : entry.partition().versions_from_oldest()) {
+        for (rows_entry& row : pv.partition().clustered_rows()) {
+            insert_probationary(row);
+        }
+    }
+    ++_stats.partition_insertions;
+    ++_stats.partitions;
+    // partition_range_cursor depends on this to detect invalidation of _end
+    _region.allocator().invalidate_references();
+}
+
+void cache_tracker::touch_probationary(rows_entry& e) {
+    e.unlink_from_lru();
+    _lru.add_probationary(e);
+}
+
+// Number of partitions whose accesses the frequency sketch of the tinylfu
+// admission policy tells apart, per shard.
+static constexpr size_t tinylfu_sketch_capacity = 256 * 1024;
+// Partitions read at least this many times recently are admitted.
+static constexpr unsigned tinylfu_admission_frequency = 2;
+
+cache_tracker::admission_policy cache_tracker::admission_policy_from_string(std::string_view name) {
+    if (name == "lru") {
+        return admission_policy::lru;
+    } else if (name == "tinylfu") {
+        return admission_policy::tinylfu;
+    }
+    throw std::invalid_argument(format("Invalid cache admission policy: {}", name));
+}
+
+void cache_tracker::set_admission_policy(admission_policy policy) {
+    _admission_policy = policy;
+    if (policy == admission_policy::tinylfu) {
+        if (_access_frequency.empty()) {
+            _access_frequency = utils::frequency_sketch(tinylfu_sketch_capacity);
+        }
+    } else {
+        _access_frequency = utils::frequency_sketch();
+    }
+}
+
+static uint64_t access_hash(const dht::decorated_key& dk) noexcept {
+    return uint64_t(dk.token().raw());
+}
+
+bool cache_tracker::admits(const dht::decorated_key& dk) const noexcept {
+    return _admission_policy == admission_policy::lru
+        || _access_frequency.frequency(access_hash(dk)) >= tinylfu_admission_frequency;
+}
+
 void cache_tracker::on_partition_erase() noexcept {
     --_stats.partitions;
     ++_stats.partition_removals;
@@ -183,12 +255,16 @@ void cache_tracker::on_partition_merge() noexcept {
     ++_stats.partition_merges;
 }
 
-void cache_tracker::on_partition_hit() noexcept {
+void cache_tracker::on_partition_hit(const dht::decorated_key& dk) noexcept {
     ++_stats.partition_hits;
+    _access_frequency.increment(access_hash(dk));
+    ++(admits(dk) ? _stats.admitted_partition_hits : _stats.probationary_partition_hits);
 }
 
-void cache_tracker::on_partition_miss() noexcept {
+void cache_tracker::on_partition_miss(const dht::decorated_key& dk) noexcept {
     ++_stats.partition_misses;
+    _access_frequency.increment(access_hash(dk));
+    ++(admits(dk) ? _stats.admitted_partition_misses : _stats.probationary_partition_misses);
 }
 
 void cache_tracker::on_partition_eviction() noexcept {
@@ -440,12 +516,12 @@ void cache_tracker::clear_continuity(cache_entry& ce) noexcept {
     ce.set_continuous(false);
 }
 
-void row_cache::on_partition_hit() {
-    _tracker.on_partition_hit();
+void row_cache::on_partition_hit(const dht::decorated_key& dk) {
+    _tracker.on_partition_hit(dk);
 }
 
-void row_cache::on_partition_miss() {
-    _tracker.on_partition_miss();
+void row_cache::on_partition_miss(const dht::decorated_key& dk) {
+    _tracker.on_partition_miss(dk);
 }
 
 void row_cache::on_row_hit() {
@@ -520,9 +596,9 @@ class range_populating_reader {
                         return make_ready_future<read_result>(read_result(std::nullopt, std::nullopt));
                     });
                 }
-                _cache.on_partition_miss();
                 const partition_start& ps = mfopt->as_partition_start();
                 const dht::decorated_key& key = ps.key();
+                _cache.on_partition_miss(key);
                 if (_reader.creation_phase() == _cache.phase_of(key)) {
                     return _cache._read_section(_cache._tracker.region(), [&] {
                         cache_entry& e = _cache.find_or_create_incomplete(ps, _reader.creation_phase(),
@@ -573,7 +649,7 @@ class scanning_and_populating_reader final : public flat_mutation_reader_v2::imp
 private:
     flat_mutation_reader_v2 read_from_entry(cache_entry& ce) {
         _cache.upgrade_entry(ce);
-        _cache.on_partition_hit();
+        _cache.on_partition_hit(ce.key());
         return ce.read(_cache, *_read_context);
     }
 
@@ -733,6 +809,8 @@ row_cache::make_reader_opt(schema_ptr s,
                        streamed_mutation::forwarding fwd,
                        mutation_reader::forwarding fwd_mr)
 {
+    compress_cold_entries();
+
     auto make_context = [&] {
         return std::make_unique<read_context>(*this, s, std::move(permit), range, slice, pc, trace_state, fwd_mr);
     };
@@ -748,13 +826,13 @@ row_cache::make_reader_opt(schema_ptr s,
             if (hint.match) {
                 cache_entry& e = *i;
                 upgrade_entry(e);
-                on_partition_hit();
+                on_partition_hit(e.key());
                 return e.read(*this, make_context());
             } else if (i->continuous()) {
                 return {};
             } else {
                 tracing::trace(trace_state, "Range {} not found in cache", range);
-                on_partition_miss();
+                on_partition_miss(pos.as_decorated_key());
                 return make_flat_mutation_reader_v2<single_partition_populating_reader>(*this, make_context());
             }
         });
@@ -812,6 +890,9 @@ cache_entry& row_cache::do_find_or_create_entry(const dht::decorated_key& key,
         if (i == _partitions.end() || !hint.match) {
             i = create_entry(i, hint);
         } else {
+            if (i->is_compressed()) {
+                inflate(*i);
+            }
             visit_entry(i);
         }
 
@@ -831,13 +912,25 @@ cache_entry& row_cache::do_find_or_create_entry(const dht::decorated_key& key,
     });
 }
 
+void row_cache::insert_populated(cache_entry& e) {
+    if (_tracker.admits(e.key())) {
+        _tracker.insert(e);
+    } else {
+        _tracker.insert_probationary(e);
+    }
+    // Let the partition wait for a whole sweep of compress_cold_entries()
+    // before being considered cold.
+    e._flags._referenced = true;
+    ++_cold_tier_credit;
+}
+
 cache_entry& row_cache::find_or_create_incomplete(const partition_start& ps, row_cache::phase_type phase, const previous_entry_pointer* previous) {
     return do_find_or_create_entry(ps.key(), previous, [&] (auto i, const partitions_type::bound_hint& hint) { // create
         // Create an fully discontinuous, except for the partition tombstone, entry
         mutation_partition mp = mutation_partition::make_incomplete(*_schema, ps.partition_tombstone());
         partitions_type::iterator entry = _partitions.emplace_before(i, ps.key().token().raw(), hint,
                 _schema, ps.key(), std::move(mp));
-        _tracker.insert(*entry);
+        insert_populated(*entry);
         return entry;
     }, [&] (auto i) { // visit
         _tracker.on_miss_already_populated();
@@ -853,7 +946,7 @@ cache_entry& row_cache::find_or_create_missing(const dht::decorated_key& key) {
         bool cont = i->continuous();
         partitions_type::iterator entry = _partitions.emplace_before(i, key.token().raw(), hint,
                 _schema, key, std::move(mp));
-        _tracker.insert(*entry);
+        insert_populated(*entry);
         entry->set_continuous(cont);
         return entry;
     }, [&] (auto i) {
@@ -1194,6 +1287,7 @@ cache_entry::cache_entry(cache_entry&& o) noexcept
     : _schema(std::move(o._schema))
     , _key(std::move(o._key))
     , _pe(std::move(o._pe))
+    , _compressed(std::move(o._compressed))
     , _flags(o._flags)
 {
 }
@@ -1202,6 +1296,10 @@ cache_entry::~cache_entry() {
 }
 
 void cache_entry::evict(cache_tracker& tracker) noexcept {
+    if (is_compressed()) {
+        _compressed = {};
+        tracker.on_compressed_partition_erase();
+    }
     _pe.evict(tracker.cleaner());
 }
 
@@ -1305,7 +1403,113 @@ const schema_ptr& row_cache::schema() const {
     return _schema;
 }
 
+// Larger partitions are never compressed, as inflating them would stall.
+static constexpr size_t max_compressed_partition_size = 128 * 1024;
+// Upper bound on the number of entries visited by compress_cold_entries().
+static constexpr uint64_t max_cold_tier_steps = 16;
+
+// The compressed form of a partition is the size of its frozen_mutation, as
+// a 32-bit little endian integer, followed by the frozen_mutation compressed
+// with LZ4.
+bool row_cache::compress(cache_entry& e) {
+    auto& s = *e._schema;
+    auto size = e._pe.version()->size_in_allocator(s, _tracker.allocator());
+    if (size > max_compressed_partition_size) {
+        return false;
+    }
+    auto compressed = with_allocator(standard_allocator(), [&] {
+        auto fm = frozen_mutation(mutation(e._schema, e._key, e._pe.squashed(s)));
+        auto rep = fm.representation();
+        auto in = rep.linearize();
+        bytes out(bytes::initialized_later(), sizeof(uint32_t) + LZ4_compressBound(in.size()));
+        write_le<uint32_t>(reinterpret_cast<char*>(out.data()), in.size());
+        auto len = LZ4_compress_default(reinterpret_cast<const char*>(in.data()), reinterpret_cast<char*>(out.data()) + sizeof(uint32_t),
+                in.size(), out.size() - sizeof(uint32_t));
+        return len > 0 ? bytes(out.data(), sizeof(uint32_t) + len) : bytes();
+    });
+    // Not worth it if it doesn't save a quarter of the memory.
+    if (compressed.empty() || compressed.size() > size * 3 / 4) {
+        return false;
+    }
+    managed_bytes blob(compressed);
+    auto pe = partition_entry::make_evictable(s, mutation_partition::make_incomplete(s));
+    e._pe.evict(_tracker.cleaner());
+    e._pe = std::move(pe);
+    _tracker.insert(e._pe);
+    e._compressed = std::move(blob);
+    _tracker.on_partition_compression(size - compressed.size());
+    return true;
+}
+
+void row_cache::inflate(cache_entry& e) {
+    auto& r = _tracker.region();
+    assert(!r.reclaiming_enabled());
+    with_allocator(standard_allocator(), [&] {
+        auto blob = to_bytes(e._compressed);
+        auto size = read_le<uint32_t>(reinterpret_cast<const char*>(blob.data()));
+        bytes_ostream out;
+        auto dst = out.write_place_holder(size);
+        auto len = LZ4_decompress_safe(reinterpret_cast<const char*>(blob.data()) + sizeof(uint32_t), reinterpret_cast<char*>(dst),
+                blob.size() - sizeof(uint32_t), size);
+        if (len < 0 || uint32_t(len) != size) {
+            on_internal_error(clogger, format("Failed to inflate compressed cache entry for {}", e.key()));
+        }
+        auto m = frozen_mutation(std::move(out)).unfreeze(e._schema);
+        with_allocator(r.allocator(), [&] {
+            auto pe = partition_entry::make_evictable(*e._schema, mutation_partition(*e._schema, m.partition()));
+            e._pe.evict(_tracker.cleaner());
+            e._pe = std::move(pe);
+            _tracker.insert(e._pe);
+            e._compressed = {};
+        });
+    });
+    _tracker.on_partition_inflation();
+}
+
+void row_cache::compress_cold_entries() {
+    if (!_tracker.compress_cold_partitions()) {
+        return;
+    }
+    auto steps = std::min((_cold_tier_credit + 1) * 2, max_cold_tier_steps);
+    _cold_tier_credit = 0;
+    _update_section(_tracker.region(), [&] {
+        with_allocator(_tracker.allocator(), [&] {
+            dht::ring_position_comparator cmp(*_schema);
+            auto it = _cold_tier_hand ? _partitions.upper_bound(*_cold_tier_hand, cmp) : _partitions.begin();
+            cache_entry* last = nullptr;
+            for (uint64_t i = 0; i < steps; ++i) {
+                // A CLOCK sweep: partitions which weren't accessed since the
+                // last visit of the hand are cold.
+                if (it == partitions_end()) {
+                    it = _partitions.begin();
+                    if (it == partitions_end()) {
+                        break;
+                    }
+                }
+                cache_entry& e = *it;
+                last = &e;
+                ++it;
+                if (e._flags._referenced) {
+                    e._flags._referenced = false;
+                } else if (e._schema == _schema && e.can_compress() && compress(e)) {
+                    // Compressing is what costs, so the read pays for one at most.
+                    break;
+                }
+            }
+            if (last) {
+                with_allocator(standard_allocator(), [&] {
+                    _cold_tier_hand = last->key();
+                });
+            }
+        });
+    });
+}
+
 void row_cache::upgrade_entry(cache_entry& e) {
+    e._flags._referenced = true;
+    if (e.is_compressed()) {
+        inflate(e);
+    }
     if (e._schema != _schema && !e.partition().is_locked()) {
         auto& r = _tracker.region();
         assert(!r.reclaiming_enabled());
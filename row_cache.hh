@@ -53,6 +53,10 @@ class cache_entry {
     schema_ptr _schema;
     dht::decorated_key _key;
     partition_entry _pe;
+    // The partition, serialized and compressed, when it's cold. _pe then only
+    // holds an incomplete placeholder, which is replaced by the inflated
+    // partition before the entry is read or updated, see row_cache::inflate().
+    managed_bytes _compressed;
     // True when we know that there is nothing between this entry and the previous one in cache
     struct {
         bool _continuous : 1;
@@ -60,6 +64,8 @@ class cache_entry {
         bool _head : 1;
         bool _tail : 1;
         bool _train : 1;
+        // Set when the entry is accessed, cleared by row_cache::compress_cold_entries().
+        bool _referenced : 1;
     } _flags{};
     friend class size_calculator;
 
@@ -118,6 +124,14 @@ class cache_entry {
     // The caller is still responsible for unlinking and destroying this entry.
     void evict(cache_tracker&) noexcept;
 
+    bool is_compressed() const noexcept { return !_compressed.empty(); }
+    // Whether the partition can be replaced by its compressed form, i.e. whether
+    // it's fully continuous, and no snapshot refers to it.
+    bool can_compress() const noexcept {
+        return !is_dummy_entry() && !is_compressed() && !_pe._snapshot && !_pe._version->next()
+            && _pe._version->partition().is_fully_continuous();
+    }
+
     const dht::decorated_key& key() const noexcept { return _key; }
     dht::ring_position_view position() const noexcept {
         if (is_dummy_entry()) {
@@ -161,8 +175,7 @@ class row_cache final {
     using phase_type = utils::phased_barrier::phase_type;
     using partitions_type = double_decker<int64_t, cache_entry,
                             dht::raw_token_less_comparator, dht::ring_position_comparator,
-                            16, bplus::key_search::linear>;
-    static_assert(bplus::SimpleLessCompare<int64_t, dht::raw_token_less_comparator>);
+                            16, bplus::key_search::simd>;
     friend class cache::autoupdating_underlying_reader;
     friend class single_partition_populating_reader;
     friend class cache_entry;
@@ -257,15 +270,34 @@ class row_cache final {
     logalloc::allocating_section _update_section;
     logalloc::allocating_section _populate_section;
     logalloc::allocating_section _read_section;
+    // Position of the last entry visited by compress_cold_entries().
+    std::optional<dht::decorated_key> _cold_tier_hand;
+    // Number of partitions populated since the last compress_cold_entries().
+    uint64_t _cold_tier_credit = 0;
     flat_mutation_reader_v2 create_underlying_reader(cache::read_context&, mutation_source&, const dht::partition_range&);
     flat_mutation_reader_v2 make_scanning_reader(const dht::partition_range&, std::unique_ptr<cache::read_context>);
-    void on_partition_hit();
-    void on_partition_miss();
+    void on_partition_hit(const dht::decorated_key&);
+    void on_partition_miss(const dht::decorated_key&);
     void on_row_hit();
     void on_row_miss();
     void on_static_row_insert();
     void on_mispopulate();
     void upgrade_entry(cache_entry&);
+    // Replaces the compressed partition of the entry by the inflated one.
+    // Must be run under reclaim lock.
+    void inflate(cache_entry&);
+    // Replaces the partition of the entry by its compressed form, unless it
+    // doesn't compress well enough. Must be run under reclaim lock.
+    bool compress(cache_entry&);
+    // Compresses the partitions which weren't accessed since the last time
+    // they were visited. Called for every read, it advances through the cache
+    // by a few entries, and more if partitions were populated since the last call,
+    // but stops at the first partition it compresses.
+    // Does nothing unless cache_tracker::compress_cold_partitions().
+    void compress_cold_entries();
+    // Links a new entry which a read populates the cache with into the LRU,
+    // as probationary unless the admission policy admits it.
+    void insert_populated(cache_entry&);
     void invalidate_locked(const dht::decorated_key&);
     void clear_now() noexcept;
 
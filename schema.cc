@@ -29,6 +29,8 @@
 #include "cdc/cdc_extension.hh"
 #include "tombstone_gc_extension.hh"
 #include "db/paxos_grace_seconds_extension.hh"
+#include "db/bloom_filter_format_extension.hh"
+#include "db/value_log_extension.hh"
 #include "utils/rjson.hh"
 #include "tombstone_gc_options.hh"
 
@@ -1292,6 +1294,25 @@ const ::tombstone_gc_options& schema::tombstone_gc_options() const {
     return default_tombstone_gc_options;
 }
 
+bool schema::split_block_bloom_filter() const {
+    const auto& schema_extensions = _raw._extensions;
+
+    if (auto it = schema_extensions.find(db::bloom_filter_format_extension::NAME); it != schema_extensions.end()) {
+        return dynamic_pointer_cast<db::bloom_filter_format_extension>(it->second)->is_split_block();
+    }
+    return false;
+}
+
+const db::value_log_options& schema::value_log_options() const {
+    static const db::value_log_options default_value_log_options;
+    const auto& schema_extensions = _raw._extensions;
+
+    if (auto it = schema_extensions.find(db::value_log_extension::NAME); it != schema_extensions.end()) {
+        return dynamic_pointer_cast<db::value_log_extension>(it->second)->get_options();
+    }
+    return default_value_log_options;
+}
+
 schema_builder& schema_builder::with_cdc_options(const cdc::options& opts) {
     add_extension(cdc::cdc_extension::NAME, ::make_shared<cdc::cdc_extension>(opts));
     return *this;
@@ -1307,6 +1328,16 @@ schema_builder& schema_builder::set_paxos_grace_seconds(int32_t seconds) {
     return *this;
 }
 
+schema_builder& schema_builder::set_bloom_filter_format(const sstring& format) {
+    add_extension(db::bloom_filter_format_extension::NAME, ::make_shared<db::bloom_filter_format_extension>(format));
+    return *this;
+}
+
+schema_builder& schema_builder::with_value_log_options(const db::value_log_options& opts) {
+    add_extension(db::value_log_extension::NAME, ::make_shared<db::value_log_extension>(opts));
+    return *this;
+}
+
 gc_clock::duration schema::paxos_grace_seconds() const {
     return std::chrono::duration_cast<gc_clock::duration>(
         std::chrono::seconds(
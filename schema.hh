@@ -134,6 +134,7 @@ void read_collections(schema_builder& builder, sstring comparator);
 
 namespace db {
 class extensions;
+struct value_log_options;
 }
 // make sure these match the order we like columns back from schema
 enum class column_kind { partition_key, clustering_key, static_column, regular_column };
@@ -706,6 +707,12 @@ class schema final : public enable_lw_shared_from_this<schema> {
     double bloom_filter_fp_chance() const {
         return _raw._bloom_filter_fp_chance;
     }
+    // Whether new sstables should use the cache-line blocked filter layout,
+    // see db::bloom_filter_format_extension.
+    bool split_block_bloom_filter() const;
+    // Whether and how new sstables should move large values to value logs,
+    // see db::value_log_extension.
+    const db::value_log_options& value_log_options() const;
     sstring thrift_key_validator() const;
     const compression_parameters& get_compressor_params() const {
         return _raw._compressor_params;
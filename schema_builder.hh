@@ -88,6 +88,8 @@ struct schema_builder {
     }
 
     schema_builder& set_paxos_grace_seconds(int32_t seconds);
+    schema_builder& set_bloom_filter_format(const sstring& format);
+    schema_builder& with_value_log_options(const db::value_log_options& opts);
 
     schema_builder& set_dc_local_read_repair_chance(double chance) {
         _raw._dc_local_read_repair_chance = chance;
@@ -4059,6 +4059,14 @@ storage_proxy::query_result_local(schema_ptr s, lw_shared_ptr<query::read_comman
     cmd->slice.options.set_if<query::partition_slice::option::with_digest>(opts.request != query::result_request::only_result);
     if (pr.is_singular()) {
         unsigned shard = dht::shard_of(*s, pr.start()->value().token());
+        auto& local_db = _db.local();
+        if (shard != this_shard_id() && local_db.hot_partitions().enabled() && pr.start()->value().has_key()) {
+            if (auto res = local_db.query_hot_partition(s, *cmd, opts, pr.start()->value().as_decorated_key())) {
+                tracing::trace(trace_state, "Queried the copy of hot partition {} on this shard", pr);
+                return make_ready_future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>(
+                        rpc::tuple(make_foreign(make_lw_shared<query::result>(std::move(*res))), cache_temperature::invalid()));
+            }
+        }
         get_stats().replica_cross_shard_ops += shard != this_shard_id();
         return _db.invoke_on(shard, _read_smp_service_group, [gs = global_schema_ptr(s), prv = dht::partition_range_vector({pr}) /* FIXME: pr is copied */, cmd, opts, timeout, gt = tracing::global_trace_state_ptr(std::move(trace_state))] (replica::database& db) mutable {
             auto trace_state = gt.get();
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/when_all.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include "sstables/adaptive_readahead_file.hh"
+
+namespace sstables {
+
+class adaptive_readahead_file_impl : public file_impl {
+    // Data read ahead of the reader, covering [start, end) of the file, or less
+    // at the end of the file.
+    struct segment {
+        uint64_t start;
+        uint64_t end;
+        // End of the data handed out to the reader so far.
+        uint64_t served;
+        reader_permit::resource_units units;
+        temporary_buffer<uint8_t> buf;
+        std::exception_ptr ex;
+        shared_future<> ready;
+
+        segment(uint64_t start, uint64_t end, uint64_t served, reader_permit permit)
+            : start(start), end(end), served(served), units(permit.consume_memory(end - served)) {
+        }
+        bool contains(uint64_t pos) const {
+            return pos >= start && pos < end;
+        }
+        // The data handed out is accounted to the permit by the buffers
+        // returned to the reader (see make_tracked_file()), so only the rest
+        // of the segment is accounted here.
+        void serve_until(uint64_t pos) {
+            served = std::max(served, pos);
+            units.reset(reader_resources::with_memory(end - std::min(end, served)));
+        }
+    };
+
+    file _file;
+    reader_permit _permit;
+    size_t _min_window;
+    size_t _max_window;
+    size_t _window = 0;
+    std::optional<uint64_t> _next_offset;
+    lw_shared_ptr<segment> _segment;
+
+private:
+    static future<temporary_buffer<uint8_t>> serve(lw_shared_ptr<segment> seg, uint64_t offset, size_t range_size) {
+        return seg->ready.get_future().then([seg, offset, range_size] {
+            if (seg->ex) {
+                return make_exception_future<temporary_buffer<uint8_t>>(seg->ex);
+            }
+            auto pos = offset - seg->start;
+            if (pos >= seg->buf.size()) {
+                return make_ready_future<temporary_buffer<uint8_t>>();
+            }
+            return make_ready_future<temporary_buffer<uint8_t>>(seg->buf.share(pos, std::min(range_size, seg->buf.size() - pos)));
+        });
+    }
+
+    // Serves a range which starts in prev and continues in next, which
+    // follows it.
+    static future<temporary_buffer<uint8_t>> serve(lw_shared_ptr<segment> prev, lw_shared_ptr<segment> next, uint64_t offset, size_t range_size) {
+        auto head_size = next->start - offset;
+        return when_all_succeed(serve(std::move(prev), offset, head_size), serve(next, next->start, range_size - head_size)).then_unpack(
+                [] (temporary_buffer<uint8_t> head, temporary_buffer<uint8_t> tail) {
+            if (tail.empty()) {
+                return head;
+            }
+            temporary_buffer<uint8_t> buf(head.size() + tail.size());
+            std::copy(tail.begin(), tail.end(), std::copy(head.begin(), head.end(), buf.get_write()));
+            return buf;
+        });
+    }
+
+    lw_shared_ptr<segment> read_segment(uint64_t start, uint64_t served, size_t read_size, const io_priority_class& pc) {
+        auto seg = make_lw_shared<segment>(start, start + read_size, served, _permit);
+        seg->ready = get_file_impl(_file)->dma_read_bulk(start, read_size, pc).then_wrapped([seg] (future<temporary_buffer<uint8_t>> f) {
+            if (f.failed()) {
+                seg->ex = f.get_exception();
+                seg->units.reset();
+            } else {
+                seg->buf = f.get0();
+                seg->end = std::min(seg->end, seg->start + seg->buf.size());
+                seg->serve_until(seg->served);
+            }
+        });
+        return seg;
+    }
+
+    void grow_window() {
+        _window = _window ? std::min(_window * 2, _max_window) : _min_window;
+    }
+
+    void collapse_window() {
+        _window = 0;
+        _segment = nullptr;
+    }
+
+public:
+    adaptive_readahead_file_impl(file f, reader_permit permit, size_t min_window, size_t max_window)
+        : file_impl(*get_file_impl(f))
+        , _file(std::move(f))
+        , _permit(std::move(permit))
+        , _min_window(min_window)
+        , _max_window(std::max(min_window, max_window)) {
+    }
+
+    adaptive_readahead_file_impl(const adaptive_readahead_file_impl&) = delete;
+    adaptive_readahead_file_impl& operator=(const adaptive_readahead_file_impl&) = delete;
+
+    virtual future<size_t> write_dma(uint64_t pos, const void* buffer, size_t len, const io_priority_class& pc) override {
+        return get_file_impl(_file)->write_dma(pos, buffer, len, pc);
+    }
+
+    virtual future<size_t> write_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
+        return get_file_impl(_file)->write_dma(pos, std::move(iov), pc);
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, const io_priority_class& pc) override {
+        return get_file_impl(_file)->read_dma(pos, buffer, len, pc);
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
+        return get_file_impl(_file)->read_dma(pos, iov, pc);
+    }
+
+    virtual future<> flush(void) override {
+        return get_file_impl(_file)->flush();
+    }
+
+    virtual future<struct stat> stat(void) override {
+        return get_file_impl(_file)->stat();
+    }
+
+    virtual future<> truncate(uint64_t length) override {
+        return get_file_impl(_file)->truncate(length);
+    }
+
+    virtual future<> discard(uint64_t offset, uint64_t length) override {
+        return get_file_impl(_file)->discard(offset, length);
+    }
+
+    virtual future<> allocate(uint64_t position, uint64_t length) override {
+        return get_file_impl(_file)->allocate(position, length);
+    }
+
+    virtual future<uint64_t> size(void) override {
+        return get_file_impl(_file)->size();
+    }
+
+    virtual future<> close() override {
+        _segment = nullptr;
+        return get_file_impl(_file)->close();
+    }
+
+    virtual std::unique_ptr<file_handle_impl> dup() override {
+        return get_file_impl(_file)->dup();
+    }
+
+    virtual subscription<directory_entry> list_directory(std::function<future<> (directory_entry de)> next) override {
+        return get_file_impl(_file)->list_directory(std::move(next));
+    }
+
+    virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, const io_priority_class& pc) override {
+        auto end = offset + range_size;
+        bool sequential = (_next_offset && offset == *_next_offset) || (_segment && _segment->contains(offset));
+        _next_offset = end;
+
+        if (!sequential) {
+            collapse_window();
+            return get_file_impl(_file)->dma_read_bulk(offset, range_size, pc);
+        }
+
+        grow_window();
+
+        if (_segment && _segment->contains(offset)) {
+            if (end <= _segment->end) {
+                _segment->serve_until(end);
+                return serve(_segment, offset, range_size);
+            }
+            // Only read what the segment is missing, together with the
+            // window following it.
+            auto prev = std::exchange(_segment, read_segment(_segment->end, end, end - _segment->end + _window, pc));
+            prev->serve_until(prev->end);
+            return serve(std::move(prev), _segment, offset, range_size);
+        }
+
+        // Read the requested range together with the window following it.
+        // Reads issued by the stream while this one is in flight are served
+        // from it once it completes.
+        _segment = read_segment(offset, end, range_size + _window, pc);
+        return serve(_segment, offset, range_size);
+    }
+};
+
+file make_adaptive_readahead_file(file f, reader_permit permit, size_t min_window, size_t max_window) {
+    return file(make_shared<adaptive_readahead_file_impl>(std::move(f), std::move(permit), min_window, max_window));
+}
+
+}
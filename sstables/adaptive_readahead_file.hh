@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/file.hh>
+#include "reader_permit.hh"
+#include "seastarx.hh"
+
+namespace sstables {
+
+// Returns a file which extends the reads of a single reader with a
+// read-ahead window adapted to the observed access pattern.
+//
+// Every dma_read_bulk() which continues the access pattern of the previous
+// ones (starts where the previous one ended, or within data already read
+// ahead) doubles the window, starting from min_window up to max_window, and
+// is extended by it, so that the following reads are served from memory.
+// A read which only partly falls within the data read ahead reads just the
+// rest of it. Any other read is treated as a skip: the read-ahead data is
+// dropped and the window collapses, so fast-forwarded and short reads don't
+// pay for read-ahead they won't use.
+//
+// Read-ahead data is accounted to the permit until it's handed out. The
+// returned buffers aren't, they're meant to be tracked by wrapping the file
+// with make_tracked_file().
+//
+// The file is meant to be read by a single input stream, which must not
+// outlive the permit, and which doesn't need to read ahead on its own.
+file make_adaptive_readahead_file(file f, reader_permit permit, size_t min_window, size_t max_window);
+
+}
@@ -11,6 +11,7 @@
 #include <zlib.h>
 #include "libdeflate/libdeflate.h"
 #include "utils/gz/crc_combine.hh"
+#include "utils/gz/crc32_multibuffer.hh"
 
 template<typename Checksum>
 concept ChecksumUtils = requires(const char* input, size_t size, uint32_t checksum) {
@@ -118,4 +119,22 @@ struct crc32_utils {
     static constexpr bool prefer_combine() {
         return fast_crc32_combine_optimized();
     }
+
+    static void checksum_many(size_t count, const char* const inputs[], const size_t input_lens[], uint32_t checksums[]) {
+        crc32_multibuffer(count, inputs, input_lens, checksums);
+    }
 };
+
+// Computes the checksums of count independent buffers. Checksummers which
+// provide checksum_many() can overlap the work on the buffers, which is
+// faster than checksumming them one by one when the buffers are small.
+template<typename Checksum>
+inline void checksum_many(size_t count, const char* const inputs[], const size_t input_lens[], uint32_t checksums[]) {
+    if constexpr (requires { Checksum::checksum_many(count, inputs, input_lens, checksums); }) {
+        Checksum::checksum_many(count, inputs, input_lens, checksums);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            checksums[i] = Checksum::checksum(inputs[i], input_lens[i]);
+        }
+    }
+}
@@ -26,6 +26,7 @@ enum class component_type {
     TemporaryTOC,
     TemporaryStatistics,
     Scylla,
+    CompressionDictionary,
     Unknown,
 };
 
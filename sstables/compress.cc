@@ -8,12 +8,20 @@
 
 #include <stdexcept>
 #include <cstdlib>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include <boost/range/algorithm/find_if.hpp>
+#include <seastar/core/alien.hh>
 #include <seastar/core/align.hh>
 #include <seastar/core/bitops.hh>
 #include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/fstream.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/semaphore.hh>
 
 #include "../compress.hh"
 #include "compress.hh"
@@ -238,6 +246,10 @@ class local_compression {
                     size_t output_len) const;
     size_t compress_max_size(size_t input_len) const;
 
+    size_t dictionary_training_sample_size() const;
+    size_t dictionary_size() const;
+    size_t train_dictionary(const std::vector<temporary_buffer<char>>& samples, bytes_mutable_view dictionary) const;
+
     operator bool() const {
         return _compressor != nullptr;
     }
@@ -268,7 +280,11 @@ local_compression::local_compression(const compression& c)
             return std::nullopt;
         });
     }())
-{}
+{
+    if (_compressor && !c.dictionary.value.empty()) {
+        _compressor = _compressor->with_dictionary(bytes_view(c.dictionary.value));
+    }
+}
 
 size_t local_compression::uncompress(const char* input,
                 size_t input_len, char* output, size_t output_len) const {
@@ -287,6 +303,100 @@ size_t local_compression::compress(const char* input, size_t input_len,
 size_t local_compression::compress_max_size(size_t input_len) const {
     return _compressor ? _compressor->compress_max_size(input_len) : 0;
 }
+size_t local_compression::dictionary_training_sample_size() const {
+    return _compressor ? _compressor->dictionary_training_sample_size() : 0;
+}
+size_t local_compression::dictionary_size() const {
+    return _compressor ? _compressor->dictionary_size() : 0;
+}
+size_t local_compression::train_dictionary(const std::vector<temporary_buffer<char>>& samples, bytes_mutable_view dictionary) const {
+    if (!_compressor) {
+        throw std::runtime_error("train_dictionary is not supported");
+    }
+    return _compressor->train_dictionary(samples, dictionary);
+}
+
+// Trains the dictionaries of the sstables written by a shard outside of the
+// reactor. Training takes from tens to hundreds of milliseconds, in a single
+// library call which can't be preempted, so it's handed to a thread of the
+// shard's own, one sstable at a time.
+//
+// All the memory the thread works on is allocated, and freed, by the shard.
+class dictionary_trainer {
+    struct job {
+        const local_compression& compression;
+        const std::vector<temporary_buffer<char>>& samples;
+        bytes_mutable_view dictionary;
+        alien::instance& alien;
+        unsigned shard;
+        size_t size = 0;
+        promise<> done;
+    };
+
+    semaphore _sem{1};
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    job* _job = nullptr;
+    bool _stopped = false;
+    std::thread _thread;
+
+    // The thread's loop.
+    void run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (;;) {
+            _cv.wait(lock, [this] { return _job || _stopped; });
+            if (!_job) {
+                return;
+            }
+            auto& j = *std::exchange(_job, nullptr);
+            lock.unlock();
+            try {
+                j.size = j.compression.train_dictionary(j.samples, j.dictionary);
+            } catch (...) {
+                // The exception belongs to this thread, so the sstable is
+                // compressed without a dictionary rather than failed with it.
+                j.size = 0;
+            }
+            alien::run_on(j.alien, j.shard, [&j] () noexcept {
+                j.done.set_value();
+            });
+            lock.lock();
+        }
+    }
+public:
+    ~dictionary_trainer() {
+        if (_thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopped = true;
+            }
+            _cv.notify_one();
+            _thread.join();
+        }
+    }
+
+    // compression and samples must be kept alive until the returned future
+    // resolves.
+    future<bytes> train(const local_compression& compression, const std::vector<temporary_buffer<char>>& samples) {
+        auto units = co_await get_units(_sem, 1);
+        if (!_thread.joinable()) {
+            _thread = std::thread([this] { run(); });
+        }
+        bytes dictionary(bytes::initialized_later(), compression.dictionary_size());
+        job j{compression, samples, bytes_mutable_view(dictionary), engine().alien(), this_shard_id()};
+        auto done = j.done.get_future();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _job = &j;
+        }
+        _cv.notify_one();
+        co_await std::move(done);
+        dictionary.resize(j.size);
+        co_return dictionary;
+    }
+};
+
+static thread_local dictionary_trainer the_dictionary_trainer;
 
 void compression::set_compressor(compressor_ptr c) {
     if (c) {
@@ -334,6 +444,17 @@ compression::locate(uint64_t position, const compression::segmented_offsets::acc
 template <typename ChecksumType>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_source_impl : public data_source_impl {
+    // Consecutive chunks are read and verified together, as long as
+    // they add up to no more than max_batched_bytes of uncompressed data.
+    static constexpr size_t max_batched_chunks = 4;
+    static constexpr size_t max_batched_bytes = 32 * 1024;
+
+    struct batch {
+        std::array<sstables::compression::chunk_and_offset, max_batched_chunks> chunks;
+        size_t count;
+        uint64_t compressed_len;
+    };
+
     std::optional<input_stream<char>> _input_stream;
     sstables::compression* _compression_metadata;
     sstables::compression::segmented_offsets::accessor _offsets;
@@ -385,32 +506,66 @@ class compressed_file_data_source_impl : public data_source_impl {
         if (_pos != _beg_pos && addr.offset != 0) {
             throw std::runtime_error("compressed reader out of sync");
         }
-        return _input_stream->read_exactly(addr.chunk_len).
-            then([this, addr](temporary_buffer<char> buf) {
-                // The last 4 bytes of the chunk are the adler32/crc32 checksum
+        // When the read covers the following chunks too, fetch a batch of
+        // them at once (they are contiguous on disk), so that their checksums
+        // can be computed together.
+        const auto chunk_len = _compression_metadata->uncompressed_chunk_length();
+        const auto max_chunks = std::clamp<size_t>(max_batched_bytes / chunk_len, 1, max_batched_chunks);
+        batch b;
+        b.chunks[0] = addr;
+        b.count = 1;
+        b.compressed_len = addr.chunk_len;
+        for (auto next_pos = _pos - addr.offset + chunk_len; b.count < max_chunks && next_pos < _end_pos; next_pos += chunk_len) {
+            b.chunks[b.count] = _compression_metadata->locate(next_pos, _offsets);
+            b.compressed_len += b.chunks[b.count].chunk_len;
+            ++b.count;
+        }
+        return _input_stream->read_exactly(b.compressed_len).
+            then([this, b](temporary_buffer<char> buf) {
+                if (buf.size() != b.compressed_len) {
+                    throw sstables::malformed_sstable_exception(format("compressed chunks of size {} at file offset {} are truncated to {} bytes", b.compressed_len, _underlying_pos, buf.size()));
+                }
+
+                // The last 4 bytes of each chunk are the adler32/crc32 checksum
                 // of the rest of the (compressed) chunk.
-                auto compressed_len = addr.chunk_len - 4;
+                std::array<const char*, max_batched_chunks> inputs;
+                std::array<size_t, max_batched_chunks> compressed_lens;
+                std::array<uint32_t, max_batched_chunks> actual_checksums;
+                for (size_t i = 0, offset = 0; i < b.count; offset += b.chunks[i++].chunk_len) {
+                    inputs[i] = buf.get() + offset;
+                    compressed_lens[i] = b.chunks[i].chunk_len - 4;
+                }
                 // FIXME: Do not always calculate checksum - Cassandra has a
                 // probability (defaulting to 1.0, but still...)
-                auto expected_checksum = read_be<uint32_t>(buf.get() + compressed_len);
-                auto actual_checksum = ChecksumType::checksum(buf.get(), compressed_len);
-                if (expected_checksum != actual_checksum) {
-                    throw sstables::malformed_sstable_exception(format("compressed chunk of size {} at file offset {} failed checksum, expected={}, actual={}", addr.chunk_len, _underlying_pos, expected_checksum, actual_checksum));
+                checksum_many<ChecksumType>(b.count, inputs.data(), compressed_lens.data(), actual_checksums.data());
+                for (size_t i = 0; i < b.count; ++i) {
+                    auto expected_checksum = read_be<uint32_t>(inputs[i] + compressed_lens[i]);
+                    if (expected_checksum != actual_checksums[i]) {
+                        throw sstables::malformed_sstable_exception(format("compressed chunk of size {} at file offset {} failed checksum, expected={}, actual={}",
+                                b.chunks[i].chunk_len, _underlying_pos + (inputs[i] - buf.get()), expected_checksum, actual_checksums[i]));
+                    }
                 }
 
                 // We know that the uncompressed data will take exactly
-                // chunk_length bytes (or less, if reading the last chunk).
-                temporary_buffer<char> out(
-                        _compression_metadata->uncompressed_chunk_length());
-                // The compressed data is the whole chunk, minus the last 4
-                // bytes (which contain the checksum verified above).
-
-                auto len = _compression.uncompress(buf.get(), compressed_len, out.get_write(), out.size());
+                // chunk_length bytes per chunk (or less, if reading the last chunk).
+                const auto chunk_len = _compression_metadata->uncompressed_chunk_length();
+                temporary_buffer<char> out(chunk_len * b.count);
+                size_t len = 0;
+                for (size_t i = 0; i < b.count; ++i) {
+                    // The compressed data is the whole chunk, minus the last 4
+                    // bytes (which contain the checksum verified above).
+                    auto chunk_out_len = _compression.uncompress(inputs[i], compressed_lens[i], out.get_write() + len, chunk_len);
+                    if (i + 1 < b.count && chunk_out_len != chunk_len) {
+                        throw sstables::malformed_sstable_exception(format("compressed chunk of size {} at file offset {} uncompressed to {} bytes, expected {}",
+                                b.chunks[i].chunk_len, _underlying_pos + (inputs[i] - buf.get()), chunk_out_len, chunk_len));
+                    }
+                    len += chunk_out_len;
+                }
 
                 out.trim(len);
-                out.trim_front(addr.offset);
+                out.trim_front(b.chunks[0].offset);
                 _pos += out.size();
-                _underlying_pos += addr.chunk_len;
+                _underlying_pos += b.compressed_len;
 
                 return out;
         });
@@ -480,6 +635,11 @@ class compressed_file_data_sink_impl : public data_sink_impl {
     sstables::local_compression _compression;
     size_t _pos = 0;
     uint32_t _full_checksum;
+    // Chunks held back until the compressor has seen enough of them
+    // to train the sstable's dictionary.
+    std::vector<temporary_buffer<char>> _training_samples;
+    size_t _training_samples_size = 0;
+    bool _training;
 public:
     compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
             : _out(std::move(out))
@@ -487,10 +647,46 @@ class compressed_file_data_sink_impl : public data_sink_impl {
             , _offsets(_compression_metadata->offsets.get_writer())
             , _compression(lc)
             , _full_checksum(ChecksumType::init_checksum())
+            , _training(_compression.dictionary_training_sample_size() > 0)
     {}
 
     virtual future<> put(net::packet data) override { abort(); }
     virtual future<> put(temporary_buffer<char> buf) override {
+        if (_training) {
+            _training_samples_size += buf.size();
+            _training_samples.push_back(std::move(buf));
+            if (_training_samples_size < _compression.dictionary_training_sample_size()) {
+                return make_ready_future<>();
+            }
+            return train_and_flush();
+        }
+        return compress_and_write(std::move(buf));
+    }
+private:
+    // Trains the dictionary on the chunks held back so far (or on whatever
+    // was written, if the sstable turned out to be smaller than the training
+    // sample) and writes them out, compressed with it.
+    //
+    // Note that compressed_file_length() lags behind while chunks are held
+    // back, which only delays the writer's size-based heuristics a bit.
+    future<> train_and_flush() {
+        if (!_training) {
+            return make_ready_future<>();
+        }
+        _training = false;
+        return the_dictionary_trainer.train(_compression, _training_samples).then([this] (bytes dictionary) {
+            _compression_metadata->dictionary.value = std::move(dictionary);
+            _compression = sstables::local_compression(_compression.compressor()->with_dictionary(
+                    bytes_view(_compression_metadata->dictionary.value)));
+            return do_with(std::exchange(_training_samples, {}), [this] (std::vector<temporary_buffer<char>>& samples) {
+                return do_for_each(samples, [this] (temporary_buffer<char>& buf) {
+                    return compress_and_write(std::move(buf));
+                });
+            });
+        });
+    }
+
+    future<> compress_and_write(temporary_buffer<char> buf) {
         auto output_len = _compression.compress_max_size(buf.size());
 
         // account space for checksum that goes after compressed data.
@@ -530,8 +726,11 @@ class compressed_file_data_sink_impl : public data_sink_impl {
         auto f = _out.write(compressed.get(), compressed.size());
         return f.then([compressed = std::move(compressed)] {});
     }
+public:
     virtual future<> close() override {
-        return _out.close();
+        return futurize_invoke([this] { return train_and_flush(); }).finally([this] {
+            return _out.close();
+        });
     }
 
     virtual size_t buffer_size() const noexcept override {
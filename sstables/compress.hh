@@ -296,6 +296,10 @@ struct compression {
     uint32_t chunk_len = 0;
     uint64_t data_len = 0;
     segmented_offsets offsets;
+    // Dictionary the chunks were compressed with, for compressors which
+    // train one per sstable. Stored in the CompressionDictionary component,
+    // not in CompressionInfo. Empty if not used.
+    disk_string<uint32_t> dictionary;
 
 private:
     // Variables *not* found in the "Compression Info" file (added by update()):
@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/util/file.hh>
+
+#include "sstables/index_cache_warmup.hh"
+#include "sstables/sstables_manager.hh"
+#include "sstables/sstables.hh"
+#include "utils/cached_file.hh"
+#include "db/config.hh"
+#include "log.hh"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+
+extern thread_local cached_file::metrics index_page_cache_metrics;
+
+namespace sstables {
+
+// The hot set is saved as text, one sstable per group of lines:
+//
+//   index_cache_hot_set <version>
+//   hit_ratio <index page cache hit ratio>
+//   sstable <data file name>
+//   summary <summary index>...
+//   pages <index file page id>...
+//
+static constexpr unsigned hot_set_format_version = 1;
+
+// Upper bound on the size of a single prefetch read, in pages.
+static constexpr uint64_t max_pages_per_read = 32;
+
+// Number of sstables warmed up concurrently on a shard.
+static constexpr size_t warmup_concurrency = 4;
+
+thread_local index_cache_warmup::stats index_cache_warmup::_shard_stats;
+
+namespace {
+
+struct saved_sstable {
+    std::vector<uint64_t> summary_indexes;
+    std::vector<uint64_t> index_pages;
+};
+
+using hot_set = std::unordered_map<sstring, saved_sstable>;
+
+std::vector<uint64_t> parse_numbers(std::istringstream& in) {
+    std::vector<uint64_t> numbers;
+    uint64_t n;
+    while (in >> n) {
+        numbers.push_back(n);
+    }
+    return numbers;
+}
+
+std::pair<hot_set, double> parse_hot_set(const sstring& contents) {
+    hot_set sstables;
+    double hit_ratio = 0;
+    saved_sstable* current = nullptr;
+    std::istringstream in(contents);
+    std::string line;
+    unsigned line_nr = 0;
+    while (std::getline(in, line)) {
+        ++line_nr;
+        auto sep = line.find(' ');
+        auto tag = line.substr(0, sep);
+        auto rest = sep == std::string::npos ? std::string() : line.substr(sep + 1);
+        std::istringstream values(rest);
+        if (line_nr == 1) {
+            unsigned version = 0;
+            if (tag != "index_cache_hot_set" || !(values >> version) || version != hot_set_format_version) {
+                throw std::runtime_error(format("unsupported format: {}", line));
+            }
+        } else if (tag == "hit_ratio") {
+            values >> hit_ratio;
+        } else if (tag == "sstable") {
+            current = &sstables[sstring(rest)];
+        } else if (tag == "summary" && current) {
+            current->summary_indexes = parse_numbers(values);
+        } else if (tag == "pages" && current) {
+            current->index_pages = parse_numbers(values);
+        } else if (!line.empty()) {
+            throw std::runtime_error(format("unexpected line {}: {}", line_nr, line));
+        }
+    }
+    return {std::move(sstables), hit_ratio};
+}
+
+double index_page_cache_hit_ratio(uint64_t hits, uint64_t misses) {
+    return hits + misses ? double(hits) / (hits + misses) : 0;
+}
+
+// Returns the sorted ids of the index file pages of sst referred to by the saved entry.
+std::vector<uint64_t> pages_to_load(const sstable& sst, const saved_sstable& saved) {
+    std::vector<uint64_t> pages = saved.index_pages;
+    auto nr_summary_entries = sst.get_summary().header.size;
+    for (auto idx : saved.summary_indexes) {
+        if (idx >= nr_summary_entries) {
+            continue;
+        }
+        auto [first, last] = sst.index_pages_of_summary_entry(idx);
+        for (auto p = first; p <= last; ++p) {
+            pages.push_back(p);
+        }
+    }
+    std::sort(pages.begin(), pages.end());
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+    auto nr_pages = (sst.index_size() + cached_file::page_size - 1) / cached_file::page_size;
+    pages.erase(std::lower_bound(pages.begin(), pages.end(), nr_pages), pages.end());
+    return pages;
+}
+
+future<> warm_up_sstable(shared_sstable sst, std::vector<uint64_t> pages, const io_priority_class& pc) {
+    try {
+        auto i = pages.begin();
+        while (i != pages.end()) {
+            // Coalesce consecutive pages into a single read.
+            auto first = *i;
+            uint64_t count = 0;
+            while (i != pages.end() && *i == first + count && count < max_pages_per_read) {
+                ++count;
+                ++i;
+            }
+            co_await sst->prefetch_index_pages(first, count, pc);
+            index_cache_warmup::on_pages_loaded(count);
+        }
+    } catch (...) {
+        sstlog.warn("Failed to warm up index cache of {}: {}", sst->get_filename(), std::current_exception());
+    }
+}
+
+} // anonymous namespace
+
+index_cache_warmup::index_cache_warmup(sstables_manager& manager)
+    : _manager(manager)
+    , _save_timer([this] {
+        (void)save();
+    })
+{ }
+
+std::filesystem::path index_cache_warmup::path() const {
+    auto dir = _manager.config().saved_caches_directory();
+    if (dir.empty()) {
+        return {};
+    }
+    return std::filesystem::path(dir) / format("index_cache-{}.txt", this_shard_id());
+}
+
+future<> index_cache_warmup::warm_up(const io_priority_class& pc) {
+    auto file_name = path();
+    if (file_name.empty()) {
+        co_return;
+    }
+    auto holder = _gate.hold();
+
+    std::optional<std::pair<hot_set, double>> saved;
+    try {
+        if (co_await file_exists(file_name.native())) {
+            auto f = co_await open_file_dma(file_name.native(), open_flags::ro);
+            auto in = make_file_input_stream(std::move(f));
+            std::exception_ptr ex;
+            try {
+                saved = parse_hot_set(co_await util::read_entire_stream_contiguous(in));
+            } catch (...) {
+                ex = std::current_exception();
+            }
+            co_await in.close();
+            if (ex) {
+                std::rethrow_exception(std::move(ex));
+            }
+        }
+    } catch (...) {
+        sstlog.warn("Failed to load the index cache hot set from {}: {}. Starting with cold index caches.", file_name.native(), std::current_exception());
+    }
+
+    if (saved) {
+        auto& [sstables, hit_ratio] = *saved;
+        _shard_stats.saved_hit_ratio = hit_ratio;
+
+        std::vector<std::pair<shared_sstable, std::vector<uint64_t>>> work;
+        for (auto& sst : _manager._active) {
+            auto it = sstables.find(sst.get_filename());
+            if (it == sstables.end()) {
+                continue;
+            }
+            auto pages = pages_to_load(sst, it->second);
+            _shard_stats.pages_to_load += pages.size();
+            work.emplace_back(sst.shared_from_this(), std::move(pages));
+            sstables.erase(it);
+        }
+        _shard_stats.missing_sstables += sstables.size();
+        sstlog.info("Warming up index caches of {} sstables with {} pages from {}", work.size(), _shard_stats.pages_to_load, file_name.native());
+
+        co_await max_concurrent_for_each(work, warmup_concurrency, [&pc] (auto& sst_and_pages) {
+            return warm_up_sstable(sst_and_pages.first, std::move(sst_and_pages.second), pc);
+        });
+        sstlog.info("Index cache warmup done: loaded {} out of {} pages", _shard_stats.pages_loaded, _shard_stats.pages_to_load);
+    }
+
+    _shard_stats.hits_after_warmup = index_page_cache_metrics.page_hits;
+    _shard_stats.misses_after_warmup = index_page_cache_metrics.page_misses;
+
+    _enabled = true;
+    auto period = _manager.config().key_cache_save_period();
+    if (period) {
+        _save_timer.arm_periodic(std::chrono::seconds(period));
+    }
+}
+
+future<> index_cache_warmup::save() {
+    if (!_enabled || _saving || _gate.is_closed()) {
+        return make_ready_future<>();
+    }
+    _saving = true;
+    return with_gate(_gate, [this] {
+        return do_save();
+    }).handle_exception([this] (std::exception_ptr ep) {
+        sstlog.warn("Failed to save the index cache hot set to {}: {}", path().native(), ep);
+    }).finally([this] {
+        _saving = false;
+    });
+}
+
+future<> index_cache_warmup::do_save() {
+    auto file_name = path();
+    auto max_pages = _manager.config().key_cache_keys_to_save();
+
+    // Keep the sstables alive while the hot set is being collected, as the list
+    // of active sstables may change across preemption points.
+    std::vector<shared_sstable> sstables;
+    for (auto& sst : _manager._active) {
+        sstables.push_back(sst.shared_from_this());
+    }
+
+    std::ostringstream out;
+    fmt::print(out, "index_cache_hot_set {}\n", hot_set_format_version);
+    fmt::print(out, "hit_ratio {}\n", index_page_cache_hit_ratio(index_page_cache_metrics.page_hits, index_page_cache_metrics.page_misses));
+    uint64_t nr_pages = 0;
+    for (auto& sst : sstables) {
+        if (max_pages && nr_pages >= max_pages) {
+            break;
+        }
+        auto summary_indexes = sst->get_cached_summary_indexes();
+        auto pages = sst->get_cached_index_pages();
+        if (summary_indexes.empty() && pages.empty()) {
+            continue;
+        }
+        if (max_pages && nr_pages + pages.size() > max_pages) {
+            pages.resize(max_pages - nr_pages);
+        }
+        nr_pages += pages.size();
+        fmt::print(out, "sstable {}\nsummary {}\npages {}\n", sst->get_filename(), fmt::join(summary_indexes, " "), fmt::join(pages, " "));
+        co_await coroutine::maybe_yield();
+    }
+    sstables.clear();
+    auto contents = out.str();
+
+    auto dir = file_name.parent_path().native();
+    auto tmp_name = file_name.native() + ".tmp";
+    co_await recursive_touch_directory(dir);
+    auto f = co_await open_file_dma(tmp_name, open_flags::wo | open_flags::create | open_flags::truncate);
+    auto os = co_await make_file_output_stream(std::move(f));
+    std::exception_ptr ex;
+    try {
+        co_await os.write(contents.data(), contents.size());
+        co_await os.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await os.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    co_await rename_file(tmp_name, file_name.native());
+    co_await sync_directory(dir);
+    sstlog.debug("Saved index cache hot set of {} pages to {}", nr_pages, file_name.native());
+}
+
+future<> index_cache_warmup::stop() {
+    _save_timer.cancel();
+    return _gate.close();
+}
+
+double index_cache_warmup::hit_ratio_recovery() {
+    if (!_shard_stats.saved_hit_ratio) {
+        return 0;
+    }
+    auto hits = index_page_cache_metrics.page_hits - _shard_stats.hits_after_warmup;
+    auto misses = index_page_cache_metrics.page_misses - _shard_stats.misses_after_warmup;
+    return index_page_cache_hit_ratio(hits, misses) / _shard_stats.saved_hit_ratio;
+}
+
+}   // namespace sstables
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/io_priority_class.hh>
+#include "seastarx.hh"
+
+namespace sstables {
+
+class sstables_manager;
+
+// Persists the hot set of the sstable index caches of a shard across restarts.
+//
+// The hot set is the set of partition index pages (identified by their summary
+// index) and index file pages which are held in memory by partition_index_cache
+// and by the cached_file of the index of every sstable of the shard. It is
+// saved periodically to saved_caches_directory and, on startup, the index file
+// pages it refers to are read back into the cache before the node starts
+// serving, so that reads do not have to start with cold index caches.
+//
+// Sstables are identified by the name of their data file, so entries of
+// sstables which are gone by the time of the warmup are ignored.
+class index_cache_warmup {
+public:
+    struct stats {
+        uint64_t pages_to_load = 0; // Index pages scheduled for loading by the warmup
+        uint64_t pages_loaded = 0; // Index pages loaded by the warmup so far
+        uint64_t missing_sstables = 0; // Saved sstables which were not found during the warmup
+        double saved_hit_ratio = 0; // Index page cache hit ratio at the time the hot set was saved
+        // Index page cache hits and misses when the warmup completed.
+        uint64_t hits_after_warmup = 0;
+        uint64_t misses_after_warmup = 0;
+    };
+private:
+    sstables_manager& _manager;
+    timer<lowres_clock> _save_timer;
+    gate _gate;
+    bool _enabled = false;
+    bool _saving = false;
+    static thread_local stats _shard_stats;
+private:
+    std::filesystem::path path() const;
+    future<> do_save();
+public:
+    explicit index_cache_warmup(sstables_manager& manager);
+
+    // Loads the index pages of the hot set saved by the previous run into the
+    // caches of the sstables of this shard and starts saving the hot set
+    // periodically. Failures are logged and otherwise ignored.
+    future<> warm_up(const io_priority_class& pc);
+
+    // Saves the current hot set, if warm_up() was called before. Never fails.
+    future<> save();
+
+    future<> stop();
+
+    static const stats& shard_stats() { return _shard_stats; }
+    static void on_pages_loaded(uint64_t count) { _shard_stats.pages_loaded += count; }
+
+    // Ratio between the index page cache hit ratio since the warmup
+    // completed and the hit ratio saved with the hot set.
+    static double hit_ratio_recovery();
+};
+
+}   // namespace sstables
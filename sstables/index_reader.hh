@@ -637,9 +637,7 @@ class index_reader {
             return make_ready_future<>();
         }
 
-        auto& summary = _sstable->get_summary();
-        bound.previous_summary_idx = std::distance(std::begin(summary.entries),
-            std::lower_bound(summary.entries.begin() + bound.previous_summary_idx, summary.entries.end(), pos, index_comparator(*_sstable->_schema)));
+        bound.previous_summary_idx = _sstable->summary_lower_bound(pos, bound.previous_summary_idx);
 
         if (bound.previous_summary_idx == 0) {
             sstlog.trace("index {}: first entry", fmt::ptr(this));
@@ -10,6 +10,8 @@
 #include "metadata_collector.hh"
 #include "position_in_partition.hh"
 
+#include <cmath>
+
 logging::logger mdclogger("metadata_collector");
 
 namespace sstables {
@@ -51,4 +53,73 @@ void metadata_collector::update_min_max_components(position_in_partition_view po
     }
 }
 
+// Extends a with b, the segment which follows it in the data file.
+static void merge_tombstone_density_segments(tombstone_density_segment& a, const tombstone_density_segment& b) {
+    if (b.tombstones) {
+        a.min_deletion_time = a.tombstones ? std::min(a.min_deletion_time, b.min_deletion_time) : b.min_deletion_time;
+        a.max_deletion_time = a.tombstones ? std::max(a.max_deletion_time, b.max_deletion_time) : b.max_deletion_time;
+    }
+    a.last_token = b.last_token;
+    a.data_size = b.data_offset + b.data_size - a.data_offset;
+    a.rows += b.rows;
+    a.cells += b.cells;
+    a.tombstones += b.tombstones;
+}
+
+void metadata_collector::update_tombstone_density(const tombstone_density_segment& seg) {
+    if (!_tombstone_density.empty() && _tombstone_density.back().data_size < _tombstone_density_segment_size) {
+        merge_tombstone_density_segments(_tombstone_density.back(), seg);
+        return;
+    }
+    if (_tombstone_density.size() == max_tombstone_density_segments) {
+        // Halve the resolution, rather than grow the metadata with the sstable.
+        for (size_t i = 0; i < _tombstone_density.size() / 2; ++i) {
+            _tombstone_density[i] = _tombstone_density[2 * i];
+            merge_tombstone_density_segments(_tombstone_density[i], _tombstone_density[2 * i + 1]);
+        }
+        _tombstone_density.resize(_tombstone_density.size() / 2);
+        _tombstone_density_segment_size *= 2;
+    }
+    _tombstone_density.push_back(seg);
+}
+
+void metadata_collector::update_from_raw_partitions(sstable_version_types version, const stats_metadata& stats, double fraction) {
+    _timestamp_tracker.update(stats.min_timestamp);
+    _timestamp_tracker.update(stats.max_timestamp);
+    _local_deletion_time_tracker.update(stats.min_local_deletion_time);
+    _local_deletion_time_tracker.update(stats.max_local_deletion_time);
+    _ttl_tracker.update(stats.min_ttl);
+    _ttl_tracker.update(stats.max_ttl);
+    update_has_legacy_counter_shards(stats.has_legacy_counter_shards);
+
+    utils::streaming_histogram tombstone_histogram(TOMBSTONE_HISTOGRAM_BIN_SIZE);
+    for (auto& [point, count] : stats.estimated_tombstone_drop_time.bin) {
+        tombstone_histogram.update(point, std::max<uint64_t>(1, std::llround(count * fraction)));
+    }
+    merge_tombstone_histogram(tombstone_histogram);
+    _columns_count += std::llround(stats.columns_count * fraction);
+    _rows_count += std::llround(stats.rows_count * fraction);
+
+    if (_schema.clustering_key_size()) {
+        auto& min_elements = stats.min_column_names.elements;
+        auto& max_elements = stats.max_column_names.elements;
+        // Only md and later sstables have reliable bounds, see sstable::may_contain_rows().
+        if (version < sstable_version_types::md || (min_elements.empty() && max_elements.empty())) {
+            update_min_max_components(position_in_partition_view::before_all_clustered_rows());
+            update_min_max_components(position_in_partition_view::after_all_clustered_rows());
+        } else {
+            auto pip = [] (const utils::chunked_vector<disk_string<uint16_t>>& column_names, bound_kind kind) {
+                std::vector<bytes> key_bytes;
+                key_bytes.reserve(column_names.size());
+                for (auto& value : column_names) {
+                    key_bytes.emplace_back(bytes_view(value));
+                }
+                return position_in_partition(position_in_partition::range_tag_t(), kind, clustering_key_prefix(std::move(key_bytes)));
+            };
+            update_min_max_components(pip(min_elements, bound_kind::incl_start));
+            update_min_max_components(pip(max_elements, bound_kind::incl_end));
+        }
+    }
+}
+
 } // namespace sstables
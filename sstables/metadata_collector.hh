@@ -44,6 +44,9 @@ struct column_stats {
     min_max_tracker<int32_t> ttl_tracker;
     /** histogram of tombstone drop time */
     utils::streaming_histogram tombstone_histogram;
+    /** how many tombstones (including expiring cells) are there in the partition, and their drop time bounds */
+    uint64_t tombstones_count = 0;
+    min_max_tracker<int32_t> tombstone_deletion_time_tracker;
 
     bool has_legacy_counter_shards;
     bool capped_local_deletion_time = false;
@@ -79,6 +82,8 @@ struct column_stats {
     void update_local_deletion_time_and_tombstone_histogram(int32_t value) {
         local_deletion_time_tracker.update(value);
         tombstone_histogram.update(value);
+        tombstone_deletion_time_tracker.update(value);
+        ++tombstones_count;
     }
     void update_local_deletion_time_and_tombstone_histogram(gc_clock::time_point value) {
         bool capped;
@@ -138,6 +143,11 @@ class metadata_collector {
     uint64_t _columns_count = 0;
     uint64_t _rows_count = 0;
 
+    // Segments of the data file, see tombstone_density_metadata. Partitions
+    // are added to the last segment until it reaches _tombstone_density_segment_size.
+    std::vector<tombstone_density_segment> _tombstone_density;
+    uint64_t _tombstone_density_segment_size = min_tombstone_density_segment_size;
+
     /**
      * Default cardinality estimation method is to use HyperLogLog++.
      * Parameter here(p=13, sp=25) should give reasonable estimation
@@ -148,6 +158,12 @@ class metadata_collector {
 private:
     void convert(disk_array<uint32_t, disk_string<uint16_t>>&to, const std::optional<position_in_partition>& from);
 public:
+    // The tombstone density metadata has segments of at least this size, and
+    // at most max_tombstone_density_segments of them; the segment size of
+    // larger sstables grows accordingly.
+    static constexpr uint64_t min_tombstone_density_segment_size = 256 * 1024;
+    static constexpr size_t max_tombstone_density_segments = 128;
+
     explicit metadata_collector(const schema& schema, sstring name, const utils::UUID& host_id)
         : _schema(schema)
         , _name(name)
@@ -207,6 +223,11 @@ class metadata_collector {
     // pos must be in the clustered region
     void update_min_max_components(position_in_partition_view pos);
 
+    // Accounts for a partition of the data file in the tombstone density
+    // metadata. seg describes the partition alone, and partitions must be
+    // added in data file order.
+    void update_tombstone_density(const tombstone_density_segment& seg);
+
     void update(column_stats&& stats) {
         _timestamp_tracker.update(stats.timestamp_tracker);
         _local_deletion_time_tracker.update(stats.local_deletion_time_tracker);
@@ -219,6 +240,13 @@ class metadata_collector {
         _rows_count += stats.rows_count;
     }
 
+    // Accounts for partitions copied verbatim from an sstable with the given
+    // metadata, which hold the given fraction of its data, see
+    // sstable_writer::consume_raw_partition(). Their own statistics aren't
+    // known, so the bounds of the source are merged as a whole, and its
+    // counts are scaled by the fraction.
+    void update_from_raw_partitions(sstable_version_types version, const stats_metadata& stats, double fraction);
+
     void construct_compaction(compaction_metadata& m) {
         auto cardinality = _cardinality.get_bytes();
         m.cardinality.elements = utils::chunked_vector<uint8_t>(cardinality.get(), cardinality.get() + cardinality.size());
@@ -245,6 +273,10 @@ class metadata_collector {
         m.rows_count = _rows_count;
         m.originating_host_id = _host_id;
     }
+
+    void construct_tombstone_density(tombstone_density_metadata& m) {
+        m.segments.elements = utils::chunked_vector<tombstone_density_segment>(_tombstone_density.begin(), _tombstone_density.end());
+    }
 };
 
 }
@@ -108,6 +108,7 @@ class cached_promoted_index {
         uint64_t populations = 0; // Number of promoted_index_blocks which got inserted
         uint64_t block_count = 0; // Number of promoted_index_blocks currently cached
         uint64_t used_bytes = 0; // Number of bytes currently used by promoted_index_blocks
+        uint64_t single_reads = 0; // Number of promoted indexes which were read whole with a single read
     };
 
     struct block_comparator {
@@ -154,7 +155,17 @@ class cached_promoted_index {
     //
     using block_set_type = std::set<promoted_index_block, block_comparator>;
     block_set_type _blocks;
+    // Set once the pages of the whole promoted index were read, see maybe_read_whole().
+    bool _read_whole = false;
 public:
+    // Promoted indexes of at most this size are read whole, with a single read
+    // of the index file, before the first lookup which misses in _blocks.
+    // The bisection which follows then finds all the blocks in the page cache,
+    // so a clustering lookup costs a single index read, rather than one per
+    // step of the bisection. Writers can keep the promoted index within this
+    // size, see sstable_writer_config::promoted_index_read_budget.
+    static constexpr uint64_t single_read_size = 32 * 1024;
+
     const schema& _s;
     uint64_t _promoted_index_start;
     uint64_t _promoted_index_size;
@@ -235,6 +246,19 @@ class cached_promoted_index {
         });
     }
 
+    // Populates the page cache with the whole promoted index, with a single I/O,
+    // if it's not larger than single_read_size.
+    future<> maybe_read_whole() {
+        if (_read_whole || _promoted_index_size > single_read_size) {
+            return make_ready_future<>();
+        }
+        _read_whole = true;
+        ++_metrics.single_reads;
+        auto first = _promoted_index_start / cached_file::page_size;
+        auto last = (_promoted_index_start + _promoted_index_size - 1) / cached_file::page_size;
+        return _cached_file.prefetch(first, last - first + 1, _pc);
+    }
+
     /// \brief Returns a pointer to promoted_index_block entry which has at least offset and index fields valid.
     future<promoted_index_block*> get_block_only_offset(pi_index_type idx, tracing::trace_state_ptr trace_state) {
         auto i = _blocks.lower_bound(idx);
@@ -243,7 +267,9 @@ class cached_promoted_index {
             return make_ready_future<promoted_index_block*>(const_cast<promoted_index_block*>(&*i));
         }
         ++_metrics.misses_l0;
-        return read_block_offset(idx, trace_state).then([this, idx, hint = i] (pi_offset_type offset) {
+        return maybe_read_whole().then([this, idx, trace_state] {
+            return read_block_offset(idx, trace_state);
+        }).then([this, idx, hint = i] (pi_offset_type offset) {
             auto i = this->_blocks.emplace_hint(hint, idx, offset);
             _metrics.used_bytes += sizeof(promoted_index_block);
             ++_metrics.block_count;
@@ -355,7 +381,8 @@ class cached_promoted_index {
 /// Worst-case lookup cost:
 ///
 ///    comparisons: O(log(N))
-///    I/O:         O(log(N))
+///    I/O:         O(log(N)), or a single read when the promoted index is not
+///                 larger than cached_promoted_index::single_read_size
 ///
 /// N = number of index entries
 ///
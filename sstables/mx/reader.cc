@@ -12,6 +12,7 @@
 #include "sstables/mutation_fragment_filter.hh"
 #include "sstables/sstable_mutation_reader.hh"
 #include "sstables/processing_result_generator.hh"
+#include "sstables/value_log.hh"
 
 namespace sstables {
 namespace mx {
@@ -69,6 +70,21 @@ class mp_row_consumer_m {
     std::vector<cell> _cells;
     collection_mutation_description _cm;
 
+    value_log_pointers _value_log_pointers;
+    // A cell whose value is yet to be read from its value log, see resolve_pending_value().
+    struct pending_value {
+        column_id id;
+        value_log_pointer ptr;
+        api::timestamp_type timestamp;
+        gc_clock::duration ttl;
+        gc_clock::time_point local_deletion_time;
+    };
+    std::optional<pending_value> _pending_value;
+
+    // Tombstones of any kind parsed by the reader, including the ones it
+    // skips, see sstables_stats::on_read_completed().
+    uint64_t _tombstones_read = 0;
+
     struct range_tombstone_start {
         clustering_key_prefix ck;
         bound_kind kind;
@@ -203,7 +219,8 @@ class mp_row_consumer_m {
                         const io_priority_class& pc,
                         tracing::trace_state_ptr trace_state,
                         streamed_mutation::forwarding fwd,
-                        const shared_sstable& sst)
+                        const shared_sstable& sst,
+                        value_log_pointers vl_pointers = {})
         : _permit(std::move(permit))
         , _sst(sst)
         , _trace_state(std::move(trace_state))
@@ -214,6 +231,7 @@ class mp_row_consumer_m {
         , _fwd(fwd)
         , _treat_static_row_as_regular(_schema->is_static_compact_table()
             && (!sst->has_scylla_component() || sst->features().is_enabled(sstable_feature::CorrectStaticCompact))) // See #4139
+        , _value_log_pointers(vl_pointers)
     {
         _cells.reserve(std::max(_schema->static_columns_count(), _schema->regular_columns_count()));
     }
@@ -230,6 +248,28 @@ class mp_row_consumer_m {
 
     ~mp_row_consumer_m() {}
 
+    uint64_t tombstones_read() const noexcept {
+        return _tombstones_read;
+    }
+
+    // Reads the value of the cell whose value log pointer the parser stopped
+    // at, if any. Must be called whenever the parser returns.
+    future<> resolve_pending_value() {
+        if (!_pending_value) {
+            return make_ready_future<>();
+        }
+        return _sst->read_value_log(_pending_value->ptr, _pc, _permit).then([this] (temporary_buffer<char> buf) {
+            auto p = *std::exchange(_pending_value, std::nullopt);
+            auto& column_def = get_column_definition(p.id);
+            std::vector<temporary_buffer<char>> fragments;
+            fragments.push_back(std::move(buf));
+            fragmented_temporary_buffer value(std::move(fragments), p.ptr.size);
+            auto ac = make_atomic_cell(*column_def.type, p.timestamp, fragmented_temporary_buffer::view(value), p.ttl, p.local_deletion_time,
+                    atomic_cell::collection_member::no);
+            _cells.push_back({p.id, atomic_cell_or_collection(std::move(ac))});
+        });
+    }
+
     // See the RowConsumer concept
     void push_ready_fragments() {
         if (auto rto = std::move(_stored_tombstone)) {
@@ -305,6 +345,9 @@ class mp_row_consumer_m {
     proceed consume_partition_start(sstables::key_view key, sstables::deletion_time deltime) {
         sstlog.trace("mp_row_consumer_m {}: consume_partition_start(deltime=({}, {})), _is_mutation_end={}", fmt::ptr(this),
             deltime.local_deletion_time, deltime.marked_for_delete_at, _is_mutation_end);
+        if (!deltime.live()) {
+            ++_tombstones_read;
+        }
         if (!_is_mutation_end) {
             return proceed::yes;
         }
@@ -369,6 +412,7 @@ class mp_row_consumer_m {
         }
         if (_in_progress_row->tomb()) {
             _sst->get_stats().on_row_tombstone_read();
+            ++_tombstones_read;
         }
         return proceed::yes;
     }
@@ -389,10 +433,15 @@ class mp_row_consumer_m {
                                    api::timestamp_type timestamp,
                                    gc_clock::duration ttl,
                                    gc_clock::time_point local_deletion_time,
-                                   bool is_deleted) {
+                                   bool is_deleted,
+                                   bool is_value_log_pointer) {
         const std::optional<column_id>& column_id = column_info.id;
         sstlog.trace("mp_row_consumer_m {}: consume_column(id={}, path={}, value={}, ts={}, ttl={}, del_time={}, deleted={})", fmt::ptr(this),
             column_id, fmt_hex(cell_path), value, timestamp, ttl.count(), local_deletion_time.time_since_epoch().count(), is_deleted);
+        if (is_deleted) {
+            _sst->get_stats().on_cell_tombstone_read();
+            ++_tombstones_read;
+        }
         check_column_missing_in_current_schema(column_info, timestamp);
         if (!column_id) {
             return proceed::yes;
@@ -402,6 +451,13 @@ class mp_row_consumer_m {
             return proceed::yes;
         }
         check_schema_mismatch(column_info, column_def);
+        if (is_value_log_pointer && !is_deleted) {
+            if (column_def.is_multi_cell() || !_sst->has_value_logs() || !_sst->features().is_enabled(sstable_feature::ValueLogPointers)) {
+                throw malformed_sstable_exception(format("unexpected value log pointer in column {}", column_def.name_as_text()),
+                        _sst->get_filename());
+            }
+            return consume_value_log_pointer(*column_id, value, timestamp, ttl, local_deletion_time);
+        }
         if (column_def.is_multi_cell()) {
             auto& value_type = visit(*column_def.type, make_visitor(
                 [] (const collection_type_impl& ctype) -> const abstract_type& { return *ctype.value_comparator(); },
@@ -440,9 +496,28 @@ class mp_row_consumer_m {
         return proceed::yes;
     }
 
+    proceed consume_value_log_pointer(column_id id, fragmented_temporary_buffer::view value, api::timestamp_type timestamp,
+            gc_clock::duration ttl, gc_clock::time_point local_deletion_time) {
+        auto ptr = value_log_pointer::deserialize(value);
+        if (_value_log_pointers.emit_pointer(*_sst, timestamp)) {
+            auto pointer = ptr.serialize();
+            auto ac = ttl != gc_clock::duration::zero()
+                    ? atomic_cell::make_live_value_log_pointer(timestamp, pointer, local_deletion_time, ttl)
+                    : atomic_cell::make_live_value_log_pointer(timestamp, pointer);
+            _cells.push_back({id, atomic_cell_or_collection(std::move(ac))});
+            return proceed::yes;
+        }
+        // Stop the parser, so that the reader reads the value before resuming it.
+        _pending_value = pending_value{id, ptr, timestamp, ttl, local_deletion_time};
+        return proceed::no;
+    }
+
     proceed consume_complex_column_start(const sstables::column_translation::column_info& column_info,
                                                  tombstone tomb) {
         sstlog.trace("mp_row_consumer_m {}: consume_complex_column_start({}, {})", fmt::ptr(this), column_info.id, tomb);
+        if (tomb) {
+            ++_tombstones_read;
+        }
         _cm.tomb = tomb;
         _cm.cells.clear();
         return proceed::yes;
@@ -488,6 +563,7 @@ class mp_row_consumer_m {
     proceed consume_range_tombstone(const std::vector<fragmented_temporary_buffer>& ecp,
                                             bound_kind kind,
                                             tombstone tomb) {
+        ++_tombstones_read;
         auto ck = clustering_key_prefix::from_range(ecp | boost::adaptors::transformed(
             [] (const fragmented_temporary_buffer& b) { return fragmented_temporary_buffer::view(b); }));
         if (kind == bound_kind::incl_start || kind == bound_kind::excl_start) {
@@ -501,6 +577,7 @@ class mp_row_consumer_m {
                                             sstables::bound_kind_m kind,
                                             tombstone end_tombstone,
                                             tombstone start_tombstone) {
+        ++_tombstones_read;
         auto ck = clustering_key_prefix::from_range(ecp | boost::adaptors::transformed(
             [] (const fragmented_temporary_buffer& b) { return fragmented_temporary_buffer::view(b); }));
         switch (kind) {
@@ -1081,7 +1158,7 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                 _column_value = fragmented_temporary_buffer();
             } else {
                 read_status status = read_status::waiting;
-                if (auto len = get_column_value_length()) {
+                if (auto len = get_column_value_length(); len && !_column_flags.has_value_log_pointer()) {
                     status = read_bytes(*_processing_data, *len, _column_value);
                 } else {
                     status = read_unsigned_vint_length_bytes(*_processing_data, _column_value);
@@ -1102,7 +1179,8 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                                              _column_timestamp,
                                              _column_ttl,
                                              _column_local_deletion_time,
-                                             _column_flags.is_deleted()) == mp_row_consumer_m::proceed::no) {
+                                             _column_flags.is_deleted(),
+                                             _column_flags.has_value_log_pointer()) == mp_row_consumer_m::proceed::no) {
                     co_yield mp_row_consumer_m::proceed::no;
                 }
             }
@@ -1277,11 +1355,12 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
                             tracing::trace_state_ptr trace_state,
                             streamed_mutation::forwarding fwd,
                             mutation_reader::forwarding fwd_mr,
-                            read_monitor& mon)
+                            read_monitor& mon,
+                            value_log_pointers vl_pointers)
             : mp_row_consumer_reader_mx(std::move(schema), permit, std::move(sst))
             , _slice_holder(std::move(slice))
             , _slice(_slice_holder.get())
-            , _consumer(this, _schema, std::move(permit), _slice, pc, std::move(trace_state), fwd, _sst)
+            , _consumer(this, _schema, std::move(permit), _slice, pc, std::move(trace_state), fwd, _sst, vl_pointers)
             // FIXME: I want to add `&& fwd_mr == mutation_reader::forwarding::no` below
             // but can't because many call sites use the default value for
             // `mutation_reader::forwarding` which is `yes`.
@@ -1364,7 +1443,9 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
     }
     future<> read_from_datafile() {
         sstlog.trace("reader {}: read from data file", fmt::ptr(this));
-        return _context->consume_input();
+        return _context->consume_input().then([this] {
+            return _consumer.resolve_pending_value();
+        });
     }
     // Assumes that we're currently positioned at partition boundary.
     future<> read_partition() {
@@ -1619,6 +1700,8 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
                     maybe_timed_out();
                     return advance_context(_consumer.maybe_skip()).then([this] {
                         return _context->consume_input();
+                    }).then([this] {
+                        return _consumer.resolve_pending_value();
                     });
                 });
             }
@@ -1660,6 +1743,7 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
         auto close_context = make_ready_future<>();
         if (_context) {
             _monitor.on_read_completed();
+            _sst->get_stats().on_read_completed(_consumer.tombstones_read());
             // move _context to prevent double-close from destructor.
             close_context = _context->close().finally([_ = std::move(_context)] {});
         }
@@ -1687,7 +1771,8 @@ static flat_mutation_reader_v2 make_reader(
         tracing::trace_state_ptr trace_state,
         streamed_mutation::forwarding fwd,
         mutation_reader::forwarding fwd_mr,
-        read_monitor& monitor) {
+        read_monitor& monitor,
+        value_log_pointers vl_pointers) {
     // If we're provided a reversed slice we must fix it since currently callers
     // provide them in a 'half-reversed' format: the order of ranges in the slice is reversed,
     // but the ranges themselves are not.
@@ -1696,12 +1781,12 @@ static flat_mutation_reader_v2 make_reader(
     if (slice.get().is_reversed()) {
         return make_flat_mutation_reader_v2<mx_sstable_mutation_reader>(
             std::move(sstable), std::move(schema), std::move(permit), range,
-            legacy_reverse_slice_to_native_reverse_slice(*schema, slice.get()), pc, std::move(trace_state), fwd, fwd_mr, monitor);
+            legacy_reverse_slice_to_native_reverse_slice(*schema, slice.get()), pc, std::move(trace_state), fwd, fwd_mr, monitor, vl_pointers);
     }
 
     return make_flat_mutation_reader_v2<mx_sstable_mutation_reader>(
         std::move(sstable), std::move(schema), std::move(permit), range,
-        std::move(slice), pc, std::move(trace_state), fwd, fwd_mr, monitor);
+        std::move(slice), pc, std::move(trace_state), fwd, fwd_mr, monitor, vl_pointers);
 }
 
 flat_mutation_reader_v2 make_reader(
@@ -1714,9 +1799,10 @@ flat_mutation_reader_v2 make_reader(
         tracing::trace_state_ptr trace_state,
         streamed_mutation::forwarding fwd,
         mutation_reader::forwarding fwd_mr,
-        read_monitor& monitor) {
+        read_monitor& monitor,
+        value_log_pointers vl_pointers) {
     return make_reader(std::move(sstable), std::move(schema), std::move(permit), range,
-            value_or_reference(slice), pc, std::move(trace_state), fwd, fwd_mr, monitor);
+            value_or_reference(slice), pc, std::move(trace_state), fwd, fwd_mr, monitor, vl_pointers);
 }
 
 flat_mutation_reader_v2 make_reader(
@@ -1729,9 +1815,10 @@ flat_mutation_reader_v2 make_reader(
         tracing::trace_state_ptr trace_state,
         streamed_mutation::forwarding fwd,
         mutation_reader::forwarding fwd_mr,
-        read_monitor& monitor) {
+        read_monitor& monitor,
+        value_log_pointers vl_pointers) {
     return make_reader(std::move(sstable), std::move(schema), std::move(permit), range,
-            value_or_reference(std::move(slice)), pc, std::move(trace_state), fwd, fwd_mr, monitor);
+            value_or_reference(std::move(slice)), pc, std::move(trace_state), fwd, fwd_mr, monitor, vl_pointers);
 }
 
 class mx_crawling_sstable_mutation_reader : public mp_row_consumer_reader_mx {
@@ -1774,7 +1861,9 @@ class mx_crawling_sstable_mutation_reader : public mp_row_consumer_reader_mx {
             _end_of_stream = true;
             return make_ready_future<>();
         }
-        return _context->consume_input();
+        return _context->consume_input().then([this] {
+            return _consumer.resolve_pending_value();
+        });
     }
     virtual future<> close() noexcept override {
         if (!_context) {
@@ -31,7 +31,8 @@ flat_mutation_reader_v2 make_reader(
         tracing::trace_state_ptr trace_state,
         streamed_mutation::forwarding fwd,
         mutation_reader::forwarding fwd_mr,
-        read_monitor& monitor);
+        read_monitor& monitor,
+        value_log_pointers vl_pointers = {});
 
 // Same as above but the slice is moved and stored inside the reader.
 flat_mutation_reader_v2 make_reader(
@@ -44,7 +45,8 @@ flat_mutation_reader_v2 make_reader(
         tracing::trace_state_ptr trace_state,
         streamed_mutation::forwarding fwd,
         mutation_reader::forwarding fwd_mr,
-        read_monitor& monitor);
+        read_monitor& monitor,
+        value_log_pointers vl_pointers = {});
 
 // A reader which doesn't use the index at all. It reads everything from the
 // sstable and it doesn't support skipping.
@@ -14,9 +14,12 @@
 #include "vint-serialization.hh"
 #include "sstables/types.hh"
 #include "sstables/mx/types.hh"
+#include "sstables/value_log.hh"
+#include "db/value_log_extension.hh"
 #include "db/config.hh"
 #include "atomic_cell.hh"
 #include "utils/exceptions.hh"
+#include "utils/cached_file.hh"
 
 #include <functional>
 #include <boost/iterator/iterator_facade.hpp>
@@ -377,7 +380,7 @@ struct sstable_schema {
 };
 
 static
-sstable_schema make_sstable_schema(const schema& s, const encoding_stats& enc_stats, const sstable_writer_config& cfg) {
+sstable_schema make_sstable_schema(const schema& s, const encoding_stats& enc_stats) {
     sstable_schema sst_sch;
     serialization_header& header = sst_sch.header;
     // mc serialization header minimum values are delta-encoded based on the default timestamp epoch times
@@ -429,6 +432,7 @@ enum class cell_flags : uint8_t {
     has_empty_value_mask = 0x04, // Whether the cell has an empty value. This will be the case for a tombstone in particular.
     use_row_timestamp_mask = 0x08, // Whether the cell has the same timestamp as the row this is a cell of.
     use_row_ttl_mask = 0x10, // Whether the cell has the same TTL as the row this is a cell of.
+    is_value_log_pointer_mask = 0x20, // Scylla-specific: whether the value is a pointer into a value log.
 };
 
 inline cell_flags operator& (cell_flags lhs, cell_flags rhs) {
@@ -539,6 +543,7 @@ class writer : public sstable_writer::writer_impl {
     uint64_t _partition_header_length = 0;
     uint64_t _prev_row_start = 0;
     std::optional<key> _partition_key;
+    dht::token _partition_token;
     std::optional<key> _first_key, _last_key;
     index_sampling_state _index_sampling_state;
     bytes_ostream _tmp_bufs;
@@ -589,17 +594,47 @@ class writer : public sstable_writer::writer_impl {
         // from write config
         size_t promoted_index_block_size;
         size_t promoted_index_auto_scale_threshold;
+        size_t read_budget;
+
+        // When read_budget is set, the blocks of this partition, which get
+        // merged pairwise whenever their serialized size exceeds the budget.
+        std::vector<pi_block> merged_blocks;
+        // Size and count of the clustered rows written so far, for sizing
+        // the blocks by the observed row size when read_budget is set.
+        uint64_t observed_row_bytes = 0;
+        uint64_t observed_rows = 0;
     } _pi_write_m;
     utils::UUID _run_identifier;
     bool _write_regular_as_static; // See #4139
     scylla_metadata::large_data_stats _large_data_stats;
 
+    // Metadata of a source of partitions copied verbatim, see consume_raw_partition().
+    // Merged into the metadata of this sstable once it's known how much of the
+    // source's data was copied.
+    struct raw_partitions_source {
+        sstable_version_types version;
+        stats_metadata stats;
+        std::optional<tombstone_density_metadata> tombstone_density;
+        uint64_t data_size;
+        uint64_t bytes_copied = 0;
+    };
+    std::unordered_map<generation_type, raw_partitions_source> _raw_partitions_sources;
+
+    // The value log which this writer moves large values to, created with the
+    // first one, see sstables/value_log.hh.
+    std::optional<value_log_writer> _value_log;
+    // Bytes of each value log of the sstable which the data file points to.
+    std::unordered_map<utils::UUID, uint64_t> _value_log_referenced_bytes;
+
     void init_file_writers();
 
     // Returns the closed writer
     std::unique_ptr<file_writer> close_writer(std::unique_ptr<file_writer>& w);
 
     void close_data_writer();
+    // Estimates the tombstone density of a partition copied verbatim from
+    // the source, whose own statistics aren't known.
+    tombstone_density_segment estimate_tombstone_density(const raw_partitions_source& rs, dht::token token, uint64_t size) const;
     void ensure_tombstone_is_written() {
         if (!_tombstone_written) {
             consume(tombstone());
@@ -623,6 +658,8 @@ class writer : public sstable_writer::writer_impl {
     void maybe_set_pi_first_clustering(const clustering_info& info);
     void maybe_add_pi_block();
     void add_pi_block();
+    void merge_pi_blocks();
+    size_t adaptive_pi_block_size() const;
     void write_pi_block(const pi_block&);
 
     uint64_t get_data_offset() const {
@@ -687,6 +724,13 @@ class writer : public sstable_writer::writer_impl {
     void maybe_record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size);
 
+    // Returns the value log pointer to write in place of the value of the
+    // live atomic cell, if any. If the cell is a pointer whose value is moved
+    // out of its value log, the value is read into resolved_value, and written
+    // in place of the pointer unless a pointer is returned.
+    std::optional<bytes> maybe_write_to_value_log(const column_definition& cdef, atomic_cell_view cell, std::optional<managed_bytes>& resolved_value);
+    value_log_metadata make_value_log_metadata() const;
+
     // Writes single atomic cell
     void write_cell(bytes_ostream& writer, const clustering_key_prefix* clustering_key, atomic_cell_view cell, const column_definition& cdef,
         const row_time_properties& properties, std::optional<bytes_view> cell_path = {});
@@ -720,6 +764,8 @@ class writer : public sstable_writer::writer_impl {
         maybe_set_pi_first_clustering(info);
         uint64_t pos = _data_writer->offset();
         write_clustered(clustered, pos - _prev_row_start);
+        _pi_write_m.observed_row_bytes += _data_writer->offset() - pos;
+        ++_pi_write_m.observed_rows;
         _pi_write_m.last_clustering = info;
         _prev_row_start = pos;
         maybe_add_pi_block();
@@ -748,7 +794,7 @@ class writer : public sstable_writer::writer_impl {
         , _enc_stats(enc_stats)
         , _shard(shard)
         , _tmp_bufs(_sst.sstable_buffer_size)
-        , _sst_schema(make_sstable_schema(s, _enc_stats, _cfg))
+        , _sst_schema(make_sstable_schema(s, _enc_stats))
         , _run_identifier(cfg.run_identifier)
         , _write_regular_as_static(s.is_static_compact_table())
         , _large_data_stats({{
@@ -791,9 +837,11 @@ class writer : public sstable_writer::writer_impl {
         _sst._shards = { shard };
 
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
-        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
+        auto filter_format = _schema.split_block_bloom_filter() ? utils::filter_format::split_block_format : utils::filter_format::m_format;
+        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), filter_format);
         _pi_write_m.promoted_index_block_size = cfg.promoted_index_block_size;
         _pi_write_m.promoted_index_auto_scale_threshold = cfg.promoted_index_auto_scale_threshold;
+        _pi_write_m.read_budget = cfg.promoted_index_read_budget;
         _index_sampling_state.summary_byte_cost = _cfg.summary_byte_cost;
         prepare_summary(_sst._components->summary, estimated_partitions, _schema.min_index_interval());
     }
@@ -807,6 +855,7 @@ class writer : public sstable_writer::writer_impl {
     stop_iteration consume(range_tombstone_change&& rtc) override;
     stop_iteration consume_end_of_partition() override;
     void consume_end_of_stream() override;
+    stop_iteration consume_raw_partition(const sstable& source, const dht::decorated_key& dk, temporary_buffer<char> data) override;
 };
 
 writer::~writer() {
@@ -840,6 +889,18 @@ void writer::add_pi_block() {
         _data_writer->offset() - _pi_write_m.block_start_offset,
         (_current_tombstone ? std::make_optional(_current_tombstone) : std::optional<tombstone>{})};
 
+    if (_pi_write_m.read_budget) {
+        _pi_write_m.merged_blocks.push_back(std::move(block));
+        write_pi_block(_pi_write_m.merged_blocks.back());
+        ++_pi_write_m.promoted_index_size;
+        // Two blocks are the fewest a promoted index is written for, see
+        // write_promoted_index(), so those are kept even above the budget.
+        if (_pi_write_m.merged_blocks.size() > 2 && _pi_write_m.blocks.size() + _pi_write_m.offsets.size() > _pi_write_m.read_budget) {
+            merge_pi_blocks();
+        }
+        return;
+    }
+
     if (_pi_write_m.blocks.empty()) {
         if (!_pi_write_m.first_entry) {
             _pi_write_m.first_entry.emplace(std::move(block));
@@ -861,6 +922,50 @@ void writer::add_pi_block() {
     }
 }
 
+// Halves the number of blocks of the promoted index by merging neighbours,
+// and doubles the size of the blocks which follow, so that the promoted index
+// of a growing partition stays within the read budget. Called with at least
+// three blocks, so that at least two are left.
+void writer::merge_pi_blocks() {
+    auto& merged = _pi_write_m.merged_blocks;
+    size_t n = 0;
+    for (size_t i = 0; i < merged.size(); i += 2, ++n) {
+        if (i + 1 < merged.size()) {
+            auto& next = merged[i + 1];
+            merged[i].last = std::move(next.last);
+            merged[i].width = next.offset + next.width - merged[i].offset;
+            // The open marker is the one active at the end of the block.
+            merged[i].open_marker = next.open_marker;
+        }
+        if (n != i) {
+            merged[n] = std::move(merged[i]);
+        }
+    }
+    merged.erase(merged.begin() + n, merged.end());
+
+    _pi_write_m.blocks.clear();
+    _pi_write_m.offsets.clear();
+    for (auto& block : merged) {
+        write_pi_block(block);
+    }
+    _pi_write_m.promoted_index_size = merged.size();
+    _pi_write_m.desired_block_size *= 2;
+    _sst.get_stats().on_promoted_index_auto_scale();
+}
+
+// Blocks of a few dozen rows keep the data read by a clustering lookup small
+// for narrow rows. Blocks are never smaller than a page of the index cache,
+// nor larger than the configured block size.
+size_t writer::adaptive_pi_block_size() const {
+    static constexpr uint64_t rows_per_block = 32;
+    static constexpr uint64_t min_block_size = cached_file::page_size;
+    if (!_pi_write_m.observed_rows) {
+        return _pi_write_m.promoted_index_block_size;
+    }
+    auto avg_row_size = _pi_write_m.observed_row_bytes / _pi_write_m.observed_rows;
+    return std::min<uint64_t>(_pi_write_m.promoted_index_block_size, std::max(avg_row_size * rows_per_block, min_block_size));
+}
+
 void writer::maybe_add_pi_block() {
     uint64_t pos = _data_writer->offset();
     if (pos >= _pi_write_m.block_next_start_offset) {
@@ -913,6 +1018,7 @@ void writer::consume_new_partition(const dht::decorated_key& dk) {
     _prev_row_start = _data_writer->offset();
 
     _partition_key = key::from_partition_key(_schema, dk.key());
+    _partition_token = dk.token();
     maybe_add_summary_entry(dk.token(), bytes_view(*_partition_key));
 
     _sst._components->filter->add(bytes_view(*_partition_key));
@@ -935,8 +1041,15 @@ void writer::consume_new_partition(const dht::decorated_key& dk) {
     _pi_write_m.tomb = {};
     _pi_write_m.first_clustering.reset();
     _pi_write_m.last_clustering.reset();
-    _pi_write_m.desired_block_size = _pi_write_m.promoted_index_block_size;
-    _pi_write_m.auto_scale_threshold = _pi_write_m.promoted_index_auto_scale_threshold;
+    _pi_write_m.merged_blocks.clear();
+    if (_pi_write_m.read_budget) {
+        _pi_write_m.desired_block_size = adaptive_pi_block_size();
+        // Merging the blocks bounds the promoted index instead.
+        _pi_write_m.auto_scale_threshold = std::numeric_limits<size_t>::max();
+    } else {
+        _pi_write_m.desired_block_size = _pi_write_m.promoted_index_block_size;
+        _pi_write_m.auto_scale_threshold = _pi_write_m.promoted_index_auto_scale_threshold;
+    }
 
     write(_sst.get_version(), *_data_writer, p_key);
     _partition_header_length = _data_writer->offset() - _c_stats.start_offset;
@@ -1007,6 +1120,12 @@ void writer::write_cell(bytes_ostream& writer, const clustering_key_prefix* clus
                        properties.ttl == cell.ttl() &&
                        properties.local_deletion_time == cell.deletion_time();
 
+    std::optional<managed_bytes> resolved_value;
+    std::optional<bytes> value_log_pointer;
+    if (has_value && !cell_path && !cdef.is_counter() && !cdef.type->value_length_if_fixed()) {
+        value_log_pointer = maybe_write_to_value_log(cdef, cell, resolved_value);
+    }
+
     cell_flags flags = cell_flags::none;
     if ((!has_value && !cdef.is_counter()) || is_deleted) {
         flags |= cell_flags::has_empty_value_mask;
@@ -1022,6 +1141,9 @@ void writer::write_cell(bytes_ostream& writer, const clustering_key_prefix* clus
     if (use_row_ttl) {
         flags |= cell_flags::use_row_ttl_mask;
     }
+    if (value_log_pointer) {
+        flags |= cell_flags::is_value_log_pointer_mask;
+    }
     write(_sst.get_version(), writer, flags);
 
     if (!use_row_timestamp) {
@@ -1050,6 +1172,11 @@ void writer::write_cell(bytes_ostream& writer, const clustering_key_prefix* clus
                 return write_vint(out, value);
             });
         }
+    } else if (value_log_pointer) {
+        write_vint(writer, value_log_pointer->size());
+        write(_sst.get_version(), writer, bytes_view(*value_log_pointer));
+    } else if (resolved_value) {
+        write_cell_value(_sst.get_version(), writer, *cdef.type, managed_bytes_view(*resolved_value));
     } else {
         if (has_value) {
             write_cell_value(_sst.get_version(), writer, *cdef.type, cell.value());
@@ -1082,6 +1209,63 @@ void writer::write_cell(bytes_ostream& writer, const clustering_key_prefix* clus
     _sst.get_stats().on_cell_write();
 }
 
+std::optional<bytes> writer::maybe_write_to_value_log(const column_definition& cdef, atomic_cell_view cell, std::optional<managed_bytes>& resolved_value) {
+    const auto& options = _schema.value_log_options();
+    if (cell.is_value_log_pointer()) {
+        auto ptr = value_log_pointer::deserialize(cell.value());
+        const value_log_source* src = nullptr;
+        if (_cfg.value_logs) {
+            auto it = _cfg.value_logs->logs.find(ptr.id);
+            if (it != _cfg.value_logs->logs.end()) {
+                src = &it->second;
+            }
+        }
+        if (!src) {
+            on_internal_error(slogger, format("cell of column {} points into value log {}, which no input of {} links",
+                    cdef.name_as_text(), ptr.id, _sst.get_filename()));
+        }
+        if (options.enabled && !src->relocate) {
+            auto [it, inserted] = _value_log_referenced_bytes.try_emplace(ptr.id, 0);
+            if (inserted) {
+                _sst.add_value_log(ptr.id, _pc);
+                _sst.link_value_log(*src->sst, ptr.id).get();
+            }
+            it->second += ptr.size;
+            _sst.get_stats().on_value_log_pointer_write();
+            return ptr.serialize();
+        }
+        auto buf = src->sst->read_value_log(ptr, _pc, _cfg.value_logs->permit).get0();
+        resolved_value.emplace(bytes_view(reinterpret_cast<const int8_t*>(buf.get()), buf.size()));
+    }
+
+    auto value = resolved_value ? managed_bytes_view(*resolved_value) : cell.value();
+    if (!options.enabled || value.size_bytes() < options.min_value_size) {
+        return std::nullopt;
+    }
+    if (!_value_log) {
+        auto id = utils::make_random_uuid();
+        _sst.add_value_log(id, _pc);
+        file_output_stream_options opts;
+        opts.io_priority_class = _pc;
+        opts.buffer_size = _sst.sstable_buffer_size;
+        opts.write_behind = 10;
+        _value_log.emplace(id, _sst.make_value_log_writer(id, std::move(opts)).get0());
+    }
+    auto ptr = _value_log->append(value);
+    _value_log_referenced_bytes[ptr.id] += ptr.size;
+    _sst.get_stats().on_value_log_write(ptr.size);
+    return ptr.serialize();
+}
+
+value_log_metadata writer::make_value_log_metadata() const {
+    value_log_metadata m;
+    for (auto& [id, referenced_bytes] : _value_log_referenced_bytes) {
+        auto size = _value_log && _value_log->id() == id ? _value_log->size() : _cfg.value_logs->logs.at(id).size;
+        m.logs.elements.push_back(value_log_entry{id, size, referenced_bytes});
+    }
+    return m;
+}
+
 void writer::write_liveness_info(bytes_ostream& writer, const row_marker& marker) {
     if (marker.is_missing()) {
         return;
@@ -1396,6 +1580,17 @@ stop_iteration writer::consume_end_of_partition() {
 
     maybe_record_large_partitions(_sst, *_partition_key, _c_stats.partition_size, _c_stats.rows_count);
 
+    _collector.update_tombstone_density(tombstone_density_segment{
+        .first_token = _partition_token.raw(),
+        .last_token = _partition_token.raw(),
+        .data_offset = _c_stats.start_offset,
+        .data_size = _c_stats.partition_size,
+        .rows = _c_stats.rows_count,
+        .cells = _c_stats.cells_count,
+        .tombstones = _c_stats.tombstones_count,
+        .min_deletion_time = _c_stats.tombstones_count ? _c_stats.tombstone_deletion_time_tracker.min() : 0,
+        .max_deletion_time = _c_stats.tombstones_count ? _c_stats.tombstone_deletion_time_tracker.max() : 0,
+    });
 
     // update is about merging column_stats with the data being stored by collector.
     _collector.update(std::move(_c_stats));
@@ -1409,9 +1604,146 @@ stop_iteration writer::consume_end_of_partition() {
     return get_data_offset() < _cfg.max_sstable_size ? stop_iteration::no : stop_iteration::yes;
 }
 
+bool can_copy_raw_partitions(const sstable& source, const schema& s, const encoding_stats& enc_stats) {
+    // Later formats only differ in the statistics.
+    if (source.get_version() < sstable_version_types::mc || !source.has_scylla_component()
+            || source.features().enabled_features != sstable_enabled_features::all().enabled_features) {
+        return false;
+    }
+    // The value log pointers of the source would have to be accounted for in
+    // the value logs of the output.
+    if (source.has_value_logs()) {
+        return false;
+    }
+    // Only large partitions are recorded for the copied partitions, whose
+    // rows and cells aren't parsed. So the partitions of sources which may
+    // hold large rows or cells, or partitions with many rows, are rewritten,
+    // so that those are recorded for the output as well.
+    const auto& ldh = source.get_large_data_handler();
+    auto exceeds = [&source] (large_data_type t, uint64_t threshold) {
+        auto entry = source.get_large_data_stat(t);
+        return !entry || entry->max_value > threshold;
+    };
+    if (exceeds(large_data_type::row_size, ldh.get_row_threshold_bytes())
+            || exceeds(large_data_type::cell_size, ldh.get_cell_threshold_bytes())
+            || exceeds(large_data_type::rows_in_partition, ldh.get_rows_count_threshold())) {
+        return false;
+    }
+    // Cells are delta-encoded against the bases of the header, and rows
+    // reference columns by their position in it.
+    const auto& h = source.get_serialization_header();
+    const auto expected = make_sstable_schema(s, enc_stats).header;
+    auto same_columns = [] (const auto& a, const auto& b) {
+        return std::ranges::equal(a.elements, b.elements, [] (const serialization_header::column_desc& x, const serialization_header::column_desc& y) {
+            return x.name.value == y.name.value && x.type_name.value == y.type_name.value;
+        });
+    };
+    return h.min_timestamp_base.value == expected.min_timestamp_base.value
+        && h.min_local_deletion_time_base.value == expected.min_local_deletion_time_base.value
+        && h.min_ttl_base.value == expected.min_ttl_base.value
+        && h.pk_type_name.value == expected.pk_type_name.value
+        && std::ranges::equal(h.clustering_key_types_names.elements, expected.clustering_key_types_names.elements, [] (const auto& x, const auto& y) {
+            return x.value == y.value;
+        })
+        && same_columns(h.static_columns, expected.static_columns)
+        && same_columns(h.regular_columns, expected.regular_columns);
+}
+
+stop_iteration writer::consume_raw_partition(const sstable& source, const dht::decorated_key& dk, temporary_buffer<char> data) {
+    auto [it, inserted] = _raw_partitions_sources.try_emplace(source.generation());
+    auto& rs = it->second;
+    if (inserted) {
+        if (!can_copy_raw_partitions(source, _schema, _enc_stats)) {
+            on_internal_error(slogger, format("cannot copy raw partitions of {} to {}: incompatible serialization", source.get_filename(), _sst.get_filename()));
+        }
+        rs.version = source.get_version();
+        rs.stats = source.get_stats_metadata();
+        auto* sm = source.get_scylla_metadata();
+        if (auto* td = sm ? sm->get_tombstone_density() : nullptr) {
+            rs.tombstone_density = *td;
+        }
+        rs.data_size = source.data_size();
+    }
+
+    auto partition_key = key::from_partition_key(_schema, dk.key());
+    maybe_add_summary_entry(dk.token(), bytes_view(partition_key));
+    _sst._components->filter->add(bytes_view(partition_key));
+    _collector.add_key(bytes_view(partition_key));
+
+    // The data starts with the partition key, so the index entry is all
+    // there is to write besides it. Partitions with a promoted index are
+    // never copied.
+    auto p_key = disk_string_view<uint16_t>();
+    p_key.value = bytes_view(partition_key);
+    write(_sst.get_version(), *_index_writer, p_key);
+    write_vint(*_index_writer, _data_writer->offset());
+    write_vint(*_index_writer, uint64_t(0));
+
+    _collector.update_tombstone_density(estimate_tombstone_density(rs, dk.token(), data.size()));
+    _data_writer->write(data.get(), data.size());
+    rs.bytes_copied += data.size();
+
+    // Per-partition statistics are estimated from the source, see consume_end_of_stream().
+    _collector.add_partition_size(data.size());
+    _collector.add_cells_count(rs.stats.estimated_cells_count.mean());
+    maybe_record_large_partitions(_sst, partition_key, data.size(), 0);
+
+    if (!_first_key) {
+        _first_key = partition_key;
+    }
+    _last_key = std::move(partition_key);
+    return get_data_offset() < _cfg.max_sstable_size ? stop_iteration::no : stop_iteration::yes;
+}
+
+tombstone_density_segment writer::estimate_tombstone_density(const raw_partitions_source& rs, dht::token token, uint64_t size) const {
+    tombstone_density_segment seg{
+        .first_token = token.raw(),
+        .last_token = token.raw(),
+        .data_offset = _data_writer->offset(),
+        .data_size = size,
+    };
+    auto scale = [&] (uint64_t count, uint64_t total_size) -> uint64_t {
+        return total_size ? std::llround(double(count) * size / total_size) : 0;
+    };
+    if (rs.tombstone_density) {
+        // Scale the segment of the source which holds the partition.
+        auto& segments = rs.tombstone_density->segments.elements;
+        auto it = std::lower_bound(segments.begin(), segments.end(), token.raw(), [] (const tombstone_density_segment& s, int64_t t) {
+            return s.last_token < t;
+        });
+        if (it != segments.end()) {
+            seg.rows = scale(it->rows, it->data_size);
+            seg.cells = scale(it->cells, it->data_size);
+            seg.tombstones = scale(it->tombstones, it->data_size);
+            seg.min_deletion_time = it->min_deletion_time;
+            seg.max_deletion_time = it->max_deletion_time;
+        }
+        return seg;
+    }
+    // Spread the tombstones of the whole source evenly.
+    auto& bins = rs.stats.estimated_tombstone_drop_time.bin;
+    if (!bins.empty()) {
+        uint64_t tombstones = 0;
+        for (auto& [point, count] : bins) {
+            tombstones += count;
+        }
+        seg.tombstones = scale(tombstones, rs.data_size);
+        seg.min_deletion_time = bins.begin()->first;
+        seg.max_deletion_time = bins.rbegin()->first;
+    }
+    seg.rows = scale(rs.stats.rows_count, rs.data_size);
+    seg.cells = rs.stats.estimated_cells_count.mean();
+    return seg;
+}
+
 void writer::consume_end_of_stream() {
     _cfg.monitor->on_data_write_completed();
 
+    for (auto& [generation, rs] : _raw_partitions_sources) {
+        double fraction = rs.data_size ? std::min(1.0, double(rs.bytes_copied) / rs.data_size) : 1.0;
+        _collector.update_from_raw_partitions(rs.version, rs.stats, fraction);
+    }
+
     seal_summary(_sst._components->summary, std::move(_first_key), std::move(_last_key), _index_sampling_state).get();
 
     if (_sst.has_component(component_type::CompressionInfo)) {
@@ -1419,6 +1751,9 @@ void writer::consume_end_of_stream() {
     }
 
     close_writer(_index_writer);
+    if (_value_log) {
+        _value_log->close();
+    }
     _sst.set_first_and_last_keys();
 
     _sst._components->statistics.contents[metadata_type::Serialization] = std::make_unique<serialization_header>(std::move(_sst_schema.header));
@@ -1433,7 +1768,14 @@ void writer::consume_end_of_stream() {
     auto features = sstable_enabled_features::all();
     run_identifier identifier{_run_identifier};
     std::optional<scylla_metadata::large_data_stats> ld_stats(std::move(_large_data_stats));
-    _sst.write_scylla_metadata(_pc, _shard, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin);
+    std::optional<value_log_metadata> vl_metadata;
+    if (_sst.has_value_logs()) {
+        vl_metadata = make_value_log_metadata();
+    }
+    tombstone_density_metadata td_metadata;
+    _collector.construct_tombstone_density(td_metadata);
+    _sst.write_scylla_metadata(_pc, _shard, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin,
+            std::move(vl_metadata), std::move(td_metadata));
     if (!_cfg.leave_unsealed) {
         _sst.seal_sstable(_cfg.backup).get();
     }
@@ -23,5 +23,7 @@ std::unique_ptr<sstable_writer::writer_impl> make_writer(sstable& sst,
     const io_priority_class& pc,
     shard_id shard);
 
+bool can_copy_raw_partitions(const sstable& source, const schema& s, const encoding_stats& enc_stats);
+
 }
 }
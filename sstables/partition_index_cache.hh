@@ -252,6 +252,17 @@ class partition_index_cache {
 
     static const stats& shard_stats() { return _shard_stats; }
 
+    // Calls func with the key of every loaded entry, in increasing key order.
+    template <typename Func>
+    requires std::invocable<Func, key_type>
+    void for_each_key(Func&& func) const {
+        for (auto&& e : _cache) {
+            if (e.ready()) {
+                func(e.key());
+            }
+        }
+    }
+
     // Evicts all unreferenced entries.
     future<> evict_gently() {
         auto i = _cache.begin();
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/shared_ptr.hh>
+#include <seastar/core/future-util.hh>
+#include <seastar/util/later.hh>
+
+#include "sstables/read_batching_file.hh"
+
+#include <algorithm>
+#include <vector>
+
+namespace sstables {
+
+static thread_local read_batching_stats batching_stats;
+
+const read_batching_stats& get_read_batching_stats() {
+    return batching_stats;
+}
+
+namespace {
+
+struct read_request {
+    uint64_t offset;
+    size_t size;
+    const io_priority_class* pc;
+    promise<temporary_buffer<uint8_t>> pr;
+
+    uint64_t end() const {
+        return offset + size;
+    }
+};
+
+struct read_queue {
+    file f;
+    size_t max_read_size;
+    std::vector<read_request> pending;
+    bool flush_scheduled = false;
+
+    read_queue(file f, size_t max_read_size) : f(std::move(f)), max_read_size(max_read_size) { }
+};
+
+future<temporary_buffer<uint8_t>> do_read(file& f, uint64_t offset, size_t size, const io_priority_class& pc) {
+    ++batching_stats.submissions;
+    return futurize_invoke([&] {
+        return get_file_impl(f)->dma_read_bulk(offset, size, pc);
+    });
+}
+
+// Submits a single read covering [start, end) on behalf of all requests in
+// the group and distributes its result among them.
+//
+// Each request gets a copy of its part of the result rather than a share of
+// it. Readers charge their permit for the size of the buffers they get back
+// (see make_tracked_file()), and a share would keep the whole merged buffer
+// alive, for as long as the slowest of the readers holds on to its part.
+void submit(file& f, std::vector<read_request> group, uint64_t start, uint64_t end) {
+    auto& pc = *group.front().pc;
+    if (group.size() == 1) {
+        do_read(f, start, end - start, pc).forward_to(std::move(group.front().pr));
+        return;
+    }
+    (void)do_read(f, start, end - start, pc).then_wrapped([start, group = std::move(group)] (future<temporary_buffer<uint8_t>> f) mutable {
+        if (f.failed()) {
+            auto ex = f.get_exception();
+            for (auto& r : group) {
+                r.pr.set_exception(ex);
+            }
+            return;
+        }
+        auto buf = f.get0();
+        for (auto& r : group) {
+            auto pos = r.offset - start;
+            if (pos >= buf.size()) {
+                r.pr.set_value(temporary_buffer<uint8_t>());
+            } else {
+                r.pr.set_value(temporary_buffer<uint8_t>(buf.get() + pos, std::min<uint64_t>(r.size, buf.size() - pos)));
+            }
+        }
+    });
+}
+
+void flush(read_queue& q) {
+    q.flush_scheduled = false;
+    auto requests = std::exchange(q.pending, {});
+    std::sort(requests.begin(), requests.end(), [] (const read_request& a, const read_request& b) {
+        return std::tie(a.pc, a.offset) < std::tie(b.pc, b.offset);
+    });
+
+    std::vector<read_request> group;
+    uint64_t start = 0;
+    uint64_t end = 0;
+    for (auto& r : requests) {
+        if (!group.empty()) {
+            bool mergeable = r.pc == group.front().pc && r.offset <= end && std::max(end, r.end()) - start <= q.max_read_size;
+            if (mergeable) {
+                end = std::max(end, r.end());
+                group.push_back(std::move(r));
+                continue;
+            }
+            submit(q.f, std::exchange(group, {}), start, end);
+        }
+        start = r.offset;
+        end = r.end();
+        group.push_back(std::move(r));
+    }
+    if (!group.empty()) {
+        submit(q.f, std::move(group), start, end);
+    }
+}
+
+} // anonymous namespace
+
+class read_batching_file_impl : public file_impl {
+    lw_shared_ptr<read_queue> _queue;
+
+    file_impl* underlying() {
+        return get_file_impl(_queue->f);
+    }
+public:
+    read_batching_file_impl(file f, size_t max_read_size)
+        : file_impl(*get_file_impl(f))
+        , _queue(make_lw_shared<read_queue>(std::move(f), max_read_size)) {
+    }
+
+    virtual future<size_t> write_dma(uint64_t pos, const void* buffer, size_t len, const io_priority_class& pc) override {
+        return underlying()->write_dma(pos, buffer, len, pc);
+    }
+
+    virtual future<size_t> write_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
+        return underlying()->write_dma(pos, std::move(iov), pc);
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, const io_priority_class& pc) override {
+        return underlying()->read_dma(pos, buffer, len, pc);
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
+        return underlying()->read_dma(pos, iov, pc);
+    }
+
+    virtual future<> flush(void) override {
+        return underlying()->flush();
+    }
+
+    virtual future<struct stat> stat(void) override {
+        return underlying()->stat();
+    }
+
+    virtual future<> truncate(uint64_t length) override {
+        return underlying()->truncate(length);
+    }
+
+    virtual future<> discard(uint64_t offset, uint64_t length) override {
+        return underlying()->discard(offset, length);
+    }
+
+    virtual future<> allocate(uint64_t position, uint64_t length) override {
+        return underlying()->allocate(position, length);
+    }
+
+    virtual future<uint64_t> size(void) override {
+        return underlying()->size();
+    }
+
+    virtual future<> close() override {
+        return underlying()->close();
+    }
+
+    virtual std::unique_ptr<file_handle_impl> dup() override {
+        return underlying()->dup();
+    }
+
+    virtual subscription<directory_entry> list_directory(std::function<future<> (directory_entry de)> next) override {
+        return underlying()->list_directory(std::move(next));
+    }
+
+    virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, const io_priority_class& pc) override {
+        ++batching_stats.requests;
+        auto& q = *_queue;
+        q.pending.push_back(read_request{offset, range_size, &pc, {}});
+        auto fut = q.pending.back().pr.get_future();
+        if (!q.flush_scheduled) {
+            q.flush_scheduled = true;
+            // Let the tasks which are already queued issue their reads first.
+            (void)seastar::yield().then([q = _queue] {
+                flush(*q);
+            });
+        }
+        return fut;
+    }
+};
+
+file make_read_batching_file(file f, size_t max_read_size) {
+    return file(make_shared<read_batching_file_impl>(std::move(f), max_read_size));
+}
+
+}
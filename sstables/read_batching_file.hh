@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/file.hh>
+#include "seastarx.hh"
+
+namespace sstables {
+
+struct read_batching_stats {
+    uint64_t requests = 0; // dma_read_bulk() requests received by read batching files
+    uint64_t submissions = 0; // Reads submitted to the underlying files on behalf of the requests
+};
+
+const read_batching_stats& get_read_batching_stats();
+
+// Returns a file which batches the dma_read_bulk() requests issued by
+// concurrent readers of the file.
+//
+// Requests are not submitted right away, but queued until the tasks which
+// are ready to run at the time of the first request had a chance to issue
+// theirs. The queued requests are then sorted by offset, and requests which
+// overlap or are adjacent to each other are merged into a single read of at
+// most max_read_size bytes (larger requests are never split), whose result
+// is copied out to them. Readers which look up the same index pages or data
+// chunks, or neighbouring ones, thus share a single submission instead of
+// issuing one each.
+//
+// Other operations are forwarded to the underlying file unchanged.
+file make_read_batching_file(file f, size_t max_read_size);
+
+}
@@ -12,7 +12,10 @@
 #include <utility>
 #include <functional>
 #include <unordered_set>
+#include <vector>
+#include <algorithm>
 #include <seastar/core/shared_ptr.hh>
+#include "timestamp.hh"
 
 namespace sstables {
 
@@ -35,6 +38,45 @@ namespace sstables {
 using shared_sstable = seastar::lw_shared_ptr<sstable>;
 using sstable_list = std::unordered_set<shared_sstable>;
 
+// Which of the cells whose value is in a value log readers emit with a pointer
+// to it rather than with the value, see sstables/value_log.hh.
+//
+// Merging two live cells with the same timestamp keeps the one with the
+// greater value (see compare_atomic_cell_for_merge()), which can't be told
+// from their pointers. So the readers of the inputs of a merge read the
+// values of the cells which another input may have a cell with the same
+// timestamp for, i.e. whose timestamp is within the timestamp range of
+// another input.
+class value_log_pointers {
+public:
+    struct input {
+        const sstable* sst;
+        api::timestamp_type min_timestamp;
+        api::timestamp_type max_timestamp;
+    };
+private:
+    seastar::lw_shared_ptr<const std::vector<input>> _inputs;
+public:
+    // Readers emit values.
+    value_log_pointers() = default;
+
+    // Readers of the inputs emit pointers where no other input can tie.
+    explicit value_log_pointers(std::vector<input> inputs)
+        : _inputs(seastar::make_lw_shared<const std::vector<input>>(std::move(inputs))) {
+    }
+
+    explicit operator bool() const noexcept {
+        return bool(_inputs);
+    }
+
+    // Whether the reader of sst emits the cell with the timestamp with a pointer.
+    bool emit_pointer(const sstable& sst, api::timestamp_type timestamp) const noexcept {
+        return _inputs && std::none_of(_inputs->begin(), _inputs->end(), [&] (const input& in) {
+            return in.sst != &sst && in.min_timestamp <= timestamp && timestamp <= in.max_timestamp;
+        });
+    }
+};
+
 }
 
 
@@ -120,7 +120,7 @@ inline std::unique_ptr<DataConsumeRowsContext> data_consume_rows(const schema& s
     // can be beneficial if the user wants to fast_forward_to() on the
     // returned context, and may make small skips.
     auto input = sst->data_stream(toread.start, last_end - toread.start, consumer.io_priority(),
-            consumer.permit(), consumer.trace_state(), sst->_partition_range_history);
+            consumer.permit(), consumer.trace_state(), sst->_partition_range_history, sstable::raw_stream::no, sstable::adaptive_readahead::yes);
     return std::make_unique<DataConsumeRowsContext>(s, std::move(sst), consumer, std::move(input), toread.start, toread.end - toread.start);
 }
 
@@ -15,10 +15,12 @@
 
 #include "compatible_ring_position.hh"
 #include "compaction/compaction_strategy_impl.hh"
+#include "compaction/incremental_compaction_strategy.hh"
 #include "compaction/leveled_compaction_strategy.hh"
 #include "compaction/time_window_compaction_strategy.hh"
 
 #include "sstable_set_impl.hh"
+#include "utils/small_vector.hh"
 
 #include "replica/database.hh"
 #include "readers/from_mutations_v2.hh"
@@ -93,6 +95,11 @@ sstable_set::select(const dht::partition_range& range) const {
     return _impl->select(range);
 }
 
+std::vector<std::vector<shared_sstable>>
+sstable_set::select_by_pk(std::span<const dht::decorated_key> keys) const {
+    return _impl->select_by_pk(*_schema, keys);
+}
+
 std::vector<sstable_run>
 sstable_set::select_sstable_runs(const std::vector<shared_sstable>& sstables) const {
     return _impl->select_sstable_runs(sstables);
@@ -596,6 +603,12 @@ std::unique_ptr<sstable_set_impl> leveled_compaction_strategy::make_sstable_set(
     return std::make_unique<partitioned_sstable_set>(std::move(schema), make_lw_shared<sstable_list>());
 }
 
+std::unique_ptr<sstable_set_impl> incremental_compaction_strategy::make_sstable_set(schema_ptr schema) const {
+    // All fragments go to the interval map regardless of their level, so that reads only
+    // select the fragments of each run which overlap with their range.
+    return std::make_unique<partitioned_sstable_set>(std::move(schema), make_lw_shared<sstable_list>(), false);
+}
+
 std::unique_ptr<sstable_set_impl> time_window_compaction_strategy::make_sstable_set(schema_ptr schema) const {
     return std::make_unique<time_series_sstable_set>(std::move(schema));
 }
@@ -611,8 +624,6 @@ compaction_strategy::make_sstable_set(schema_ptr schema) const {
             schema);
 }
 
-using sstable_reader_factory_type = std::function<flat_mutation_reader_v2(shared_sstable&, const dht::partition_range& pr)>;
-
 static logging::logger irclogger("incremental_reader_selector");
 
 // Incremental selector implementation for combined_mutation_reader that
@@ -705,13 +716,59 @@ class incremental_reader_selector : public reader_selector {
 // Assumes the given `pos` and `schema` are alive during the function's lifetime.
 static std::predicate<const sstable&> auto
 make_pk_filter(const dht::ring_position& pos, const schema& schema) {
-    return [&pos, key = key::from_partition_key(schema, *pos.key()), cmp = dht::ring_position_comparator(schema)] (const sstable& sst) {
+    return [&pos, hk = sstable::make_hashed_key(schema, *pos.key()), cmp = dht::ring_position_comparator(schema)] (const sstable& sst) {
         return cmp(pos, sst.get_first_decorated_key()) >= 0 &&
                cmp(pos, sst.get_last_decorated_key()) <= 0 &&
-               sst.filter_has_key(key);
+               sst.filter_has_key(hk);
     };
 }
 
+std::vector<std::vector<shared_sstable>>
+sstable_set_impl::select_by_pk(const schema& s, std::span<const dht::decorated_key> keys) const {
+    auto cmp = dht::ring_position_comparator(s);
+
+    // Group the keys by the sstables whose range covers them, so that each
+    // filter is probed once for all its keys.
+    struct candidate {
+        shared_sstable sst;
+        std::vector<utils::hashed_key> hashes;
+        std::vector<size_t> key_indexes;
+    };
+    std::vector<candidate> candidates;
+    std::unordered_map<const sstable*, size_t> candidate_index;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        std::optional<utils::hashed_key> hk;
+        for (auto& sst : select(dht::partition_range::make_singular(keys[i]))) {
+            if (cmp(keys[i], sst->get_first_decorated_key()) < 0 || cmp(keys[i], sst->get_last_decorated_key()) > 0) {
+                continue;
+            }
+            if (!hk) {
+                hk = sstable::make_hashed_key(s, keys[i].key());
+            }
+            auto [it, inserted] = candidate_index.emplace(sst.get(), candidates.size());
+            if (inserted) {
+                candidates.push_back(candidate{sst});
+            }
+            auto& c = candidates[it->second];
+            c.hashes.push_back(*hk);
+            c.key_indexes.push_back(i);
+        }
+    }
+
+    std::vector<std::vector<shared_sstable>> selected(keys.size());
+    utils::small_vector<bool, 16> present;
+    for (auto& c : candidates) {
+        present.resize(c.hashes.size());
+        c.sst->filter_has_keys(c.hashes, present);
+        for (size_t j = 0; j < c.key_indexes.size(); ++j) {
+            if (present[j]) {
+                selected[c.key_indexes[j]].push_back(c.sst);
+            }
+        }
+    }
+    return selected;
+}
+
 // Filter out sstables for reader using bloom filter
 static std::vector<shared_sstable>
 filter_sstable_for_reader_by_pk(std::vector<shared_sstable>&& sstables, const schema& schema, const dht::ring_position& pos) {
@@ -1118,6 +1175,19 @@ sstable_set::make_local_shard_sstable_reader(
         assert(!sst->is_shared());
         return sst->make_reader(s, permit, pr, slice, pc, trace_state, fwd, fwd_mr, monitor_generator(sst));
     };
+    return make_local_shard_sstable_reader(std::move(s), std::move(permit), pr, std::move(trace_state), fwd, fwd_mr, std::move(reader_factory_fn));
+}
+
+flat_mutation_reader_v2
+sstable_set::make_local_shard_sstable_reader(
+        schema_ptr s,
+        reader_permit permit,
+        const dht::partition_range& pr,
+        tracing::trace_state_ptr trace_state,
+        streamed_mutation::forwarding fwd,
+        mutation_reader::forwarding fwd_mr,
+        sstable_reader_factory_type reader_factory_fn) const
+{
     if (auto sstables = _impl->all(); sstables->size() == 1) [[unlikely]] {
         auto sst = *sstables->begin();
         return reader_factory_fn(sst, pr);
@@ -15,6 +15,8 @@
 #include "dht/i_partitioner.hh"
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/io_priority_class.hh>
+#include <functional>
+#include <span>
 #include <vector>
 
 namespace utils {
@@ -26,6 +28,8 @@ namespace sstables {
 class sstable_set_impl;
 class incremental_selector_impl;
 
+using sstable_reader_factory_type = std::function<flat_mutation_reader_v2(shared_sstable&, const dht::partition_range& pr)>;
+
 // Structure holds all sstables (a.k.a. fragments) that belong to same run identifier, which is an UUID.
 // SStables in that same run will not overlap with one another.
 class sstable_run {
@@ -50,6 +54,10 @@ class sstable_set : public enable_lw_shared_from_this<sstable_set> {
     sstable_set& operator=(const sstable_set&);
     sstable_set& operator=(sstable_set&&) noexcept;
     std::vector<shared_sstable> select(const dht::partition_range& range) const;
+    // Return, for each of the keys, the sstables which may contain it according to their
+    // key range and bloom filter. Each candidate sstable's filter is probed for all of its
+    // keys in a single batch, instead of once per key.
+    std::vector<std::vector<shared_sstable>> select_by_pk(std::span<const dht::decorated_key> keys) const;
     // Return all runs which contain any of the input sstables.
     std::vector<sstable_run> select_sstable_runs(const std::vector<shared_sstable>& sstables) const;
     // Return all sstables. It's not guaranteed that sstable_set will keep a reference to the returned list, so user should keep it.
@@ -134,6 +142,17 @@ class sstable_set : public enable_lw_shared_from_this<sstable_set> {
         mutation_reader::forwarding,
         read_monitor_generator& rmg = default_read_monitor_generator()) const;
 
+    // Like above, but the sstables are read with the readers returned by
+    // the given factory.
+    flat_mutation_reader_v2 make_local_shard_sstable_reader(
+        schema_ptr,
+        reader_permit,
+        const dht::partition_range&,
+        tracing::trace_state_ptr,
+        streamed_mutation::forwarding,
+        mutation_reader::forwarding,
+        sstable_reader_factory_type reader_factory_fn) const;
+
     flat_mutation_reader_v2 make_crawling_reader(
             schema_ptr,
             reader_permit,
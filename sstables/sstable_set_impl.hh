@@ -33,6 +33,7 @@ class sstable_set_impl {
     virtual void insert(shared_sstable sst) = 0;
     virtual void erase(shared_sstable sst) = 0;
     virtual std::unique_ptr<incremental_selector_impl> make_incremental_selector() const = 0;
+    virtual std::vector<std::vector<shared_sstable>> select_by_pk(const schema& s, std::span<const dht::decorated_key> keys) const;
 
     virtual flat_mutation_reader_v2 create_single_key_sstable_reader(
         replica::column_family*,
@@ -11,6 +11,7 @@
 #include <memory>
 #include <seastar/core/io_priority_class.hh>
 #include <seastar/core/smp.hh>
+#include <seastar/core/temporary_buffer.hh>
 #include "schema_fwd.hh"
 #include "mutation_fragment.hh"
 #include "mutation_fragment_v2.hh"
@@ -44,7 +45,18 @@ class sstable_writer {
     stop_iteration consume(range_tombstone_change&& rtc);
     stop_iteration consume_end_of_partition();
     void consume_end_of_stream();
+
+    // Writes a whole partition of source, copying data, its serialized form as
+    // found in the (uncompressed) data file of source, verbatim.
+    // Only valid if can_copy_raw_partitions() returns true for source.
+    stop_iteration consume_raw_partition(const sstable& source, const dht::decorated_key& dk, temporary_buffer<char> data);
 };
 
+// Returns true if the partitions of source can be written with
+// sstable_writer::consume_raw_partition() to an sstable of schema s, written
+// with the given encoding stats. That's the case when they were serialized in
+// the same way, i.e. with the same serialization header and format features.
+bool can_copy_raw_partitions(const sstable& source, const schema& s, const encoding_stats& enc_stats);
+
 } // namespace sstables
 
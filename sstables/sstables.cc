@@ -66,6 +66,9 @@
 #include "sstables/random_access_reader.hh"
 #include "sstables/sstables_manager.hh"
 #include "sstables/partition_index_cache.hh"
+#include "sstables/adaptive_readahead_file.hh"
+#include "sstables/read_batching_file.hh"
+#include "sstables/value_log.hh"
 #include "utils/UUID_gen.hh"
 #include "sstables_manager.hh"
 #include <boost/algorithm/string/predicate.hpp>
@@ -820,6 +823,10 @@ future<> sstable::read_toc() noexcept {
                 try {
                     _recognized_components.insert(reverse_map(c, sstable_version_constants::get_component_map(_version)));
                 } catch (std::out_of_range& oor) {
+                    if (auto id = parse_value_log_component_name(c)) {
+                        _value_logs.push_back(*id);
+                        continue;
+                    }
                     _unrecognized_components.push_back(c);
                     sstlog.info("Unrecognized TOC component was found: {} in sstable {}", c, filename(component_type::TOC));
                 }
@@ -858,6 +865,9 @@ void sstable::generate_toc(compressor_ptr c, double filter_fp_chance) {
         _recognized_components.insert(component_type::CRC);
     } else {
         _recognized_components.insert(component_type::CompressionInfo);
+        if (c->dictionary_training_sample_size() > 0) {
+            _recognized_components.insert(component_type::CompressionDictionary);
+        }
     }
     _recognized_components.insert(component_type::Scylla);
 }
@@ -926,17 +936,49 @@ void sstable::write_toc(const io_priority_class& pc) {
         throw std::runtime_error(format("SSTable write failed due to existence of TOC file for generation {:d} of {}.{}", _generation, _schema->ks_name(), _schema->cf_name()));
     }
 
-    for (auto&& key : _recognized_components) {
-            // new line character is appended to the end of each component name.
-        auto value = sstable_version_constants::get_component_map(_version).at(key) + "\n";
+    write_toc_entries(w);
+    w.flush();
+    w.close();
+
+    // Flushing parent directory to guarantee that temporary TOC file reached
+    // the disk.
+    file dir_f = open_checked_directory(_write_error_handler, _dir).get0();
+    sstable_write_io_check([&] {
+        dir_f.flush().get();
+        dir_f.close().get();
+    });
+}
+
+void sstable::write_toc_entries(file_writer& w) {
+    auto write_entry = [&] (const sstring& name) {
+        // new line character is appended to the end of each component name.
+        auto value = name + "\n";
         bytes b = bytes(reinterpret_cast<const bytes::value_type *>(value.c_str()), value.size());
         write(_version, w, b);
+    };
+    for (auto&& key : _recognized_components) {
+        write_entry(sstable_version_constants::get_component_map(_version).at(key));
     }
+    for (auto& id : _value_logs) {
+        write_entry(value_log_component_name(id));
+    }
+}
+
+void sstable::add_value_log(const utils::UUID& id, const io_priority_class& pc) {
+    sstlog.debug("Adding value log {} to sstable {}", id, get_filename());
+    _value_logs.push_back(id);
+
+    // Rewrite the temporary TOC in place. If this fails midway, the sstable
+    // is left with a broken temporary TOC, which marks it for removal anyway.
+    file_output_stream_options options;
+    options.buffer_size = 4096;
+    options.io_priority_class = pc;
+    auto w = make_component_file_writer(component_type::TemporaryTOC, std::move(options),
+            open_flags::wo | open_flags::create | open_flags::truncate).get0();
+    write_toc_entries(w);
     w.flush();
     w.close();
 
-    // Flushing parent directory to guarantee that temporary TOC file reached
-    // the disk.
     file dir_f = open_checked_directory(_write_error_handler, _dir).get0();
     sstable_write_io_check([&] {
         dir_f.flush().get();
@@ -944,6 +986,47 @@ void sstable::write_toc(const io_priority_class& pc) {
     });
 }
 
+sstring sstable::value_log_filename(const utils::UUID& id) const {
+    return filename(get_dir(), _schema->ks_name(), _schema->cf_name(), _version, _generation, _format, value_log_component_name(id));
+}
+
+future<file_writer> sstable::make_value_log_writer(const utils::UUID& id, file_output_stream_options options) {
+    auto name = value_log_filename(id);
+    auto f = co_await open_checked_file_dma(_write_error_handler, name, open_flags::wo | open_flags::create | open_flags::exclusive);
+    co_return co_await file_writer::make(std::move(f), std::move(options), std::move(name));
+}
+
+future<> sstable::link_value_log(const sstable& source, const utils::UUID& id) {
+    return sstable_write_io_check(link_file, source.value_log_filename(id), value_log_filename(id));
+}
+
+future<file> sstable::open_value_log(const utils::UUID& id) {
+    auto it = _value_log_files.find(id);
+    if (it == _value_log_files.end()) {
+        if (std::ranges::find(_value_logs, id) == _value_logs.end()) {
+            return make_exception_future<file>(malformed_sstable_exception(format("pointer into unknown value log {}", id), get_filename()));
+        }
+        it = _value_log_files.emplace(id, shared_future<file>(open_checked_file_dma(_read_error_handler, value_log_filename(id), open_flags::ro))).first;
+    }
+    return it->second.get_future();
+}
+
+future<temporary_buffer<char>> sstable::read_value_log(const value_log_pointer& ptr, const io_priority_class& pc, reader_permit permit) {
+    auto f = make_tracked_file(co_await open_value_log(ptr.id), std::move(permit));
+    auto buf = co_await f.dma_read_exactly<char>(ptr.offset, ptr.size, pc);
+    if (buf.size() != ptr.size) {
+        throw malformed_sstable_exception(format("value at {} of value log {} is truncated: read {} bytes out of {}",
+                ptr.offset, ptr.id, buf.size(), ptr.size), value_log_filename(ptr.id));
+    }
+    if (auto checksum = value_log_checksum(single_fragmented_view(bytes_view(reinterpret_cast<const int8_t*>(buf.get()), buf.size())));
+            checksum != ptr.checksum) {
+        throw malformed_sstable_exception(format("checksum mismatch of value at {} of value log {}: expected {}, got {}",
+                ptr.offset, ptr.id, ptr.checksum, checksum), value_log_filename(ptr.id));
+    }
+    _stats.on_value_log_read(ptr.size);
+    co_return buf;
+}
+
 future<> sstable::seal_sstable() {
     // SSTable sealing is about renaming temporary TOC file after guaranteeing
     // that each component reached the disk safely.
@@ -1069,7 +1152,12 @@ future<> sstable::read_compression(const io_priority_class& pc) {
         return make_ready_future<>();
     }
 
-    return read_simple<component_type::CompressionInfo>(_components->compression, pc);
+    return read_simple<component_type::CompressionInfo>(_components->compression, pc).then([this, &pc] {
+        if (!has_component(component_type::CompressionDictionary)) {
+            return make_ready_future<>();
+        }
+        return read_simple<component_type::CompressionDictionary>(_components->compression.dictionary, pc);
+    });
 }
 
 void sstable::write_compression(const io_priority_class& pc) {
@@ -1078,6 +1166,9 @@ void sstable::write_compression(const io_priority_class& pc) {
     }
 
     write_simple<component_type::CompressionInfo>(_components->compression, pc);
+    if (has_component(component_type::CompressionDictionary)) {
+        write_simple<component_type::CompressionDictionary>(_components->compression.dictionary, pc);
+    }
 }
 
 void sstable::validate_partitioner() {
@@ -1184,6 +1275,38 @@ double sstable::estimate_droppable_tombstone_ratio(gc_clock::time_point gc_befor
     return 0.0f;
 }
 
+// The drop times of the tombstones of a segment are only known by their
+// bounds, so they are assumed to be spread evenly between them.
+static double estimate_droppable_tombstones(const tombstone_density_segment& seg, int32_t gc_before) {
+    if (!seg.tombstones || gc_before <= seg.min_deletion_time) {
+        return 0;
+    }
+    if (gc_before > seg.max_deletion_time) {
+        return seg.tombstones;
+    }
+    double span = double(seg.max_deletion_time) - seg.min_deletion_time + 1;
+    return seg.tombstones * ((double(gc_before) - seg.min_deletion_time) / span);
+}
+
+double sstable::estimate_droppable_tombstone_ratio_of_densest_range(gc_clock::time_point gc_before) const {
+    auto* sm = get_scylla_metadata();
+    auto* m = sm ? sm->get_tombstone_density() : nullptr;
+    if (!m) {
+        return 0.0;
+    }
+    auto gc_before_count = gc_before.time_since_epoch().count();
+    double ratio = 0.0;
+    for (auto& seg : m->segments.elements) {
+        // Tombstones which delete no cell, e.g. partition tombstones, count
+        // as cells of their own.
+        auto cells = std::max(seg.cells, seg.tombstones);
+        if (cells) {
+            ratio = std::max(ratio, estimate_droppable_tombstones(seg, gc_before_count) / cells);
+        }
+    }
+    return ratio;
+}
+
 future<> sstable::read_statistics(const io_priority_class& pc) {
     return read_simple<component_type::Statistics>(_components->statistics, pc);
 }
@@ -1273,7 +1396,15 @@ future<> sstable::open_data() noexcept {
     });
 }
 
+// Upper bound on the size of a read merged from the batched reads of
+// concurrent readers, see make_read_batching_file().
+static constexpr size_t read_batching_max_read_size = 128 * 1024;
+
 future<> sstable::update_info_for_opened_data() {
+    if (_manager.config().sstable_read_batching()) {
+        _data_file = make_read_batching_file(std::move(_data_file), read_batching_max_read_size);
+        _index_file = make_read_batching_file(std::move(_index_file), read_batching_max_read_size);
+    }
     return _data_file.stat().then([this] (struct stat st) {
         if (this->has_component(component_type::CompressionInfo)) {
             _components->compression.update(st.st_size);
@@ -1327,9 +1458,40 @@ future<> sstable::update_info_for_opened_data() {
                 _bytes_on_disk += bytes;
             });
         });
+    }).then([this] {
+        return build_summary_learned_index();
     });
 }
 
+future<> sstable::build_summary_learned_index() {
+    auto max_error = _manager.config().sstable_summary_learned_index_max_error();
+    if (!max_error || _summary_learned_index) {
+        co_return;
+    }
+    _summary_learned_index = co_await summary_learned_index::build(_components->summary.entries, max_error);
+    sstlog.trace("{}: summary learned index of {} segments for {} entries", get_filename(),
+            _summary_learned_index->segments().size(), _components->summary.entries.size());
+}
+
+uint64_t sstable::summary_lower_bound(dht::ring_position_view pos, uint64_t start) const {
+    auto& entries = _components->summary.entries;
+    index_comparator cmp(*_schema);
+    if (_summary_learned_index) {
+        auto [lo, hi] = _summary_learned_index->search_window(pos.token());
+        lo = std::max(lo, start);
+        hi = std::max(hi, lo);
+        auto i = std::lower_bound(entries.begin() + lo, entries.begin() + hi, pos, cmp);
+        // The window is only a prediction, so confirm that the answer is not
+        // outside of it before trusting it.
+        bool lo_ok = lo == start || cmp(entries[lo - 1], pos);
+        bool hi_ok = i != entries.begin() + hi || hi == entries.size() || !cmp(entries[hi], pos);
+        if (lo_ok && hi_ok) [[likely]] {
+            return std::distance(entries.begin(), i);
+        }
+    }
+    return std::distance(entries.begin(), std::lower_bound(entries.begin() + start, entries.end(), pos, cmp));
+}
+
 future<> sstable::create_data() noexcept {
     auto oflags = open_flags::wo | open_flags::create | open_flags::exclusive;
     file_open_options opt;
@@ -1346,6 +1508,38 @@ future<> sstable::drop_caches() {
     });
 }
 
+std::vector<uint64_t> sstable::get_cached_summary_indexes() const {
+    std::vector<uint64_t> idxs;
+    _index_cache->for_each_key([&] (uint64_t idx) {
+        idxs.push_back(idx);
+    });
+    return idxs;
+}
+
+std::vector<uint64_t> sstable::get_cached_index_pages() const {
+    std::vector<uint64_t> pages;
+    if (_cached_index_file) {
+        _cached_index_file->for_each_cached_page([&] (cached_file::page_idx_type idx) {
+            pages.push_back(idx);
+        });
+    }
+    return pages;
+}
+
+std::pair<uint64_t, uint64_t> sstable::index_pages_of_summary_entry(uint64_t summary_idx) const {
+    auto& summary = get_summary();
+    uint64_t begin = summary.entries[summary_idx].position;
+    uint64_t end = summary_idx + 1 < summary.header.size ? summary.entries[summary_idx + 1].position : index_size();
+    return {begin / cached_file::page_size, (end > begin ? end - 1 : begin) / cached_file::page_size};
+}
+
+future<> sstable::prefetch_index_pages(uint64_t first, uint64_t count, const io_priority_class& pc) {
+    if (!_cached_index_file) {
+        return make_ready_future<>();
+    }
+    return _cached_index_file->prefetch(first, count, pc);
+}
+
 future<> sstable::read_filter(const io_priority_class& pc) {
     if (!has_component(component_type::Filter)) {
         _components->filter = std::make_unique<utils::filter::always_present_filter>();
@@ -1356,10 +1550,16 @@ future<> sstable::read_filter(const io_priority_class& pc) {
         sstables::filter filter;
         read_simple<component_type::Filter>(filter, pc).get();
         auto nr_bits = filter.buckets.elements.size() * std::numeric_limits<typename decltype(filter.buckets.elements)::value_type>::digits;
-        large_bitset bs(nr_bits, std::move(filter.buckets.elements));
         utils::filter_format format = (_version >= sstable_version_types::mc)
                                       ? utils::filter_format::m_format
                                       : utils::filter_format::k_l_format;
+        if (_components->scylla_metadata && _components->scylla_metadata->get_filter_format() == filter_format_type::split_block) {
+            if (filter.buckets.elements.size() % utils::filter::split_block_bloom_filter::words_per_block) {
+                throw malformed_sstable_exception(fmt::format("Split block filter of {} bits is not a whole number of blocks", nr_bits), filename(component_type::Filter));
+            }
+            format = utils::filter_format::split_block_format;
+        }
+        large_bitset bs(nr_bits, std::move(filter.buckets.elements));
         _components->filter = utils::filter::create_filter(filter.hashes, std::move(bs), format);
     });
 }
@@ -1369,7 +1569,8 @@ void sstable::write_filter(const io_priority_class& pc) {
         return;
     }
 
-    auto f = static_cast<utils::filter::murmur3_bloom_filter *>(_components->filter.get());
+    // Covers split_block_bloom_filter too, which writes a hash count of zero.
+    auto f = static_cast<utils::filter::bloom_filter *>(_components->filter.get());
 
     auto&& bs = f->bits();
     auto filter_ref = sstables::filter_ref(f->num_hashes(), bs.get_storage());
@@ -1572,7 +1773,8 @@ sstable::read_scylla_metadata(const io_priority_class& pc) noexcept {
 
 void
 sstable::write_scylla_metadata(const io_priority_class& pc, shard_id shard, sstable_enabled_features features, struct run_identifier identifier,
-        std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin) {
+        std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin,
+        std::optional<value_log_metadata> vl_metadata, std::optional<tombstone_density_metadata> td_metadata) {
     auto&& first_key = get_first_decorated_key();
     auto&& last_key = get_last_decorated_key();
     auto sm = create_sharding_metadata(_schema, first_key, last_key, shard);
@@ -1593,12 +1795,23 @@ sstable::write_scylla_metadata(const io_priority_class& pc, shard_id shard, ssta
     if (ld_stats) {
         _components->scylla_metadata->data.set<scylla_metadata_type::LargeDataStats>(std::move(*ld_stats));
     }
+    if (vl_metadata) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::ValueLogs>(std::move(*vl_metadata));
+    }
+    if (td_metadata) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::TombstoneDensity>(std::move(*td_metadata));
+    }
     if (!origin.empty()) {
         scylla_metadata::sstable_origin o;
         o.value = bytes(to_bytes_view(sstring_view(origin)));
         _components->scylla_metadata->data.set<scylla_metadata_type::SSTableOrigin>(std::move(o));
     }
 
+    if (auto* f = dynamic_cast<utils::filter::bloom_filter*>(_components->filter.get());
+            f && f->format() == utils::filter_format::split_block_format) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::FilterFormat>(filter_format_metadata{filter_format_type::split_block});
+    }
+
     scylla_metadata::scylla_version version;
     version.value = bytes(to_bytes_view(sstring_view(scylla_version())));
     _components->scylla_metadata->data.set<scylla_metadata_type::ScyllaVersion>(std::move(version));
@@ -1927,13 +2140,16 @@ sstring sstable::filename(const sstring& dir, const sstring& ks, const sstring&
 
 std::vector<std::pair<component_type, sstring>> sstable::all_components() const {
     std::vector<std::pair<component_type, sstring>> all;
-    all.reserve(_recognized_components.size() + _unrecognized_components.size());
+    all.reserve(_recognized_components.size() + _unrecognized_components.size() + _value_logs.size());
     for (auto& c : _recognized_components) {
         all.push_back(std::make_pair(c, sstable_version_constants::get_component_map(_version).at(c)));
     }
     for (auto& c : _unrecognized_components) {
         all.push_back(std::make_pair(component_type::Unknown, c));
     }
+    for (auto& id : _value_logs) {
+        all.push_back(std::make_pair(component_type::Unknown, value_log_component_name(id)));
+    }
     return all;
 }
 
@@ -2153,10 +2369,12 @@ sstable::make_reader(
         tracing::trace_state_ptr trace_state,
         streamed_mutation::forwarding fwd,
         mutation_reader::forwarding fwd_mr,
-        read_monitor& mon) {
+        read_monitor& mon,
+        value_log_pointers vl_pointers) {
     const auto reversed = slice.is_reversed();
     if (_version >= version_types::mc && (!reversed || range.is_singular())) {
-        return mx::make_reader(shared_from_this(), std::move(schema), std::move(permit), range, slice, pc, std::move(trace_state), fwd, fwd_mr, mon);
+        return mx::make_reader(shared_from_this(), std::move(schema), std::move(permit), range, slice, pc, std::move(trace_state), fwd, fwd_mr, mon,
+                vl_pointers);
     }
 
     // Multi-partition reversed queries are not yet supported natively in the mx reader.
@@ -2167,8 +2385,8 @@ sstable::make_reader(
     if (_version >= version_types::mc) {
         // The only mx case falling through here is reversed multi-partition reader
         auto rd = make_reversing_reader(mx::make_reader(shared_from_this(), schema->make_reversed(), std::move(permit),
-                range, half_reverse_slice(*schema, slice), pc, std::move(trace_state), streamed_mutation::forwarding::no, fwd_mr, mon),
-            max_result_size);
+                range, half_reverse_slice(*schema, slice), pc, std::move(trace_state), streamed_mutation::forwarding::no, fwd_mr, mon,
+                vl_pointers), max_result_size);
         if (fwd) {
             rd = make_forwardable(std::move(rd));
         }
@@ -2283,6 +2501,14 @@ sstable::format_types sstable::format_from_sstring(sstring &s) {
     }
 }
 
+const sstring& sstable::version_to_sstring(version_types v) {
+    return _version_string.at(v);
+}
+
+const sstring& sstable::format_to_sstring(format_types f) {
+    return _format_string.at(f);
+}
+
 component_type sstable::component_from_sstring(version_types v, sstring &s) {
     try {
         return reverse_map(s, sstable_version_constants::get_component_map(v));
@@ -2291,15 +2517,26 @@ component_type sstable::component_from_sstring(version_types v, sstring &s) {
     }
 }
 
+// Upper bound on the read-ahead window of adaptive_readahead data streams, in
+// units of sstable_buffer_size.
+static constexpr size_t adaptive_readahead_max_buffers = 8;
+
 input_stream<char> sstable::data_stream(uint64_t pos, size_t len, const io_priority_class& pc,
-        reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history, raw_stream raw) {
+        reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history, raw_stream raw,
+        adaptive_readahead readahead) {
     file_input_stream_options options;
     options.buffer_size = sstable_buffer_size;
     options.io_priority_class = pc;
-    options.read_ahead = 4;
+    // The adaptive read-ahead file reads ahead on its own, the stream only
+    // needs to keep the next read in flight.
+    options.read_ahead = readahead ? 1 : 4;
     options.dynamic_adjustments = std::move(history);
 
-    file f = make_tracked_file(_data_file, std::move(permit));
+    file f = _data_file;
+    if (readahead) {
+        f = make_adaptive_readahead_file(std::move(f), permit, sstable_buffer_size, adaptive_readahead_max_buffers * sstable_buffer_size);
+    }
+    f = make_tracked_file(std::move(f), std::move(permit));
     if (trace_state) {
         f = tracing::make_traced_file(std::move(f), std::move(trace_state), format("{}:", get_filename()));
     }
@@ -2326,47 +2563,78 @@ future<temporary_buffer<char>> sstable::data_read(uint64_t pos, size_t len, cons
     });
 }
 
+// Chunks are read and checksummed in batches of this many,
+// so that checksum_many() can overlap the work on them.
+static constexpr size_t validate_checksums_batch_size = 4;
+
 template <typename ChecksumType>
 static future<bool> do_validate_compressed(input_stream<char>& stream, const sstables::compression& c, bool checksum_all, uint32_t expected_digest) {
     bool valid = true;
     uint64_t offset = 0;
     uint32_t actual_full_checksum = ChecksumType::init_checksum();
 
-    auto accessor = c.offsets.get_accessor();
-    for (size_t i = 0; i < c.offsets.size(); ++i) {
-        auto current_pos = accessor.at(i);
-        auto next_pos = i + 1 == c.offsets.size() ? c.compressed_file_length() : accessor.at(i + 1);
-        auto chunk_len = next_pos - current_pos;
-        auto buf = co_await stream.read_exactly(chunk_len);
+    std::array<uint64_t, validate_checksums_batch_size> chunk_lens;
+    std::array<const char*, validate_checksums_batch_size> inputs;
+    std::array<size_t, validate_checksums_batch_size> compressed_lens;
+    std::array<uint32_t, validate_checksums_batch_size> actual_checksums;
 
-        if (!chunk_len) {
-            sstlog.error("Found unexpected chunk of length 0 at offset {}", offset);
-            valid = false;
-            break;
+    bool stop = false;
+    auto accessor = c.offsets.get_accessor();
+    for (size_t i = 0; !stop && i < c.offsets.size(); ) {
+        bool empty_chunk = false;
+        size_t count = 0;
+        uint64_t batch_len = 0;
+        for (; count < validate_checksums_batch_size && i + count < c.offsets.size(); ++count) {
+            auto current_pos = accessor.at(i + count);
+            auto next_pos = i + count + 1 == c.offsets.size() ? c.compressed_file_length() : accessor.at(i + count + 1);
+            chunk_lens[count] = next_pos - current_pos;
+            if (!chunk_lens[count]) {
+                empty_chunk = true;
+                break;
+            }
+            batch_len += chunk_lens[count];
         }
 
-        if (buf.size() < chunk_len) {
-            sstlog.error("Truncated file at offset {}: expected to get chunk of size {}, got {}", offset, chunk_len, buf.size());
-            valid = false;
-            break;
-        }
+        auto buf = co_await stream.read_exactly(batch_len);
 
-        auto compressed_len = chunk_len - 4;
-        auto expected_checksum = read_be<uint32_t>(buf.get() + compressed_len);
-        auto actual_checksum = ChecksumType::checksum(buf.get(), compressed_len);
-        if (actual_checksum != expected_checksum) {
-            sstlog.error("Compressed chunk checksum mismatch at offset {}, for chunk #{} of size {}: expected={}, actual={}", offset, i, chunk_len, expected_checksum, actual_checksum);
-            valid = false;
+        size_t verified = 0;
+        for (uint64_t buf_offset = 0; verified < count; buf_offset += chunk_lens[verified++]) {
+            if (buf.size() < buf_offset + chunk_lens[verified]) {
+                sstlog.error("Truncated file at offset {}: expected to get chunk of size {}, got {}", offset + buf_offset, chunk_lens[verified], buf.size() - buf_offset);
+                valid = false;
+                stop = true;
+                break;
+            }
+            inputs[verified] = buf.get() + buf_offset;
+            compressed_lens[verified] = chunk_lens[verified] - 4;
         }
 
-        actual_full_checksum = checksum_combine_or_feed<ChecksumType>(actual_full_checksum, actual_checksum, buf.get(), compressed_len);
-        if (checksum_all) {
-            uint32_t be_actual_checksum = cpu_to_be(actual_checksum);
-            actual_full_checksum = ChecksumType::checksum(actual_full_checksum,
-                    reinterpret_cast<const char*>(&be_actual_checksum), sizeof(be_actual_checksum));
+        checksum_many<ChecksumType>(verified, inputs.data(), compressed_lens.data(), actual_checksums.data());
+
+        for (size_t j = 0; j < verified; ++j, ++i) {
+            auto compressed_len = compressed_lens[j];
+            auto expected_checksum = read_be<uint32_t>(inputs[j] + compressed_len);
+            auto actual_checksum = actual_checksums[j];
+            if (actual_checksum != expected_checksum) {
+                sstlog.error("Compressed chunk checksum mismatch at offset {}, for chunk #{} of size {}: expected={}, actual={}", offset, i, chunk_lens[j], expected_checksum, actual_checksum);
+                valid = false;
+            }
+
+            actual_full_checksum = checksum_combine_or_feed<ChecksumType>(actual_full_checksum, actual_checksum, inputs[j], compressed_len);
+            if (checksum_all) {
+                uint32_t be_actual_checksum = cpu_to_be(actual_checksum);
+                actual_full_checksum = ChecksumType::checksum(actual_full_checksum,
+                        reinterpret_cast<const char*>(&be_actual_checksum), sizeof(be_actual_checksum));
+            }
+
+            offset += chunk_lens[j];
         }
 
-        offset += chunk_len;
+        if (!stop && empty_chunk) {
+            sstlog.error("Found unexpected chunk of length 0 at offset {}", offset);
+            valid = false;
+            stop = true;
+        }
     }
 
     if (actual_full_checksum != expected_digest) {
@@ -2383,26 +2651,42 @@ static future<bool> do_validate_uncompressed(input_stream<char>& stream, const c
     uint64_t offset = 0;
     uint32_t actual_full_checksum = ChecksumType::init_checksum();
 
-    for (size_t i = 0; i < checksum.checksums.size(); ++i) {
-        const auto expected_checksum = checksum.checksums[i];
-        auto buf = co_await stream.read_exactly(checksum.chunk_size);
+    std::array<const char*, validate_checksums_batch_size> inputs;
+    std::array<size_t, validate_checksums_batch_size> input_lens;
+    std::array<uint32_t, validate_checksums_batch_size> actual_checksums;
 
-        if (buf.empty()) {
-            sstlog.error("Chunk count mismatch between CRC.db and Data.db at offset {}: expected {} chunks but data file has less", offset, checksum.checksums.size());
-            valid = false;
-            break;
+    for (size_t i = 0; i < checksum.checksums.size(); ) {
+        const auto count = std::min(validate_checksums_batch_size, checksum.checksums.size() - i);
+        auto buf = co_await stream.read_exactly(checksum.chunk_size * count);
+
+        // The last chunk of the data file may be partial.
+        size_t read = 0;
+        for (size_t buf_offset = 0; read < count && buf_offset < buf.size(); ++read, buf_offset += checksum.chunk_size) {
+            inputs[read] = buf.get() + buf_offset;
+            input_lens[read] = std::min<size_t>(checksum.chunk_size, buf.size() - buf_offset);
         }
 
-        auto actual_checksum = ChecksumType::checksum(buf.get(), buf.size());
+        checksum_many<ChecksumType>(read, inputs.data(), input_lens.data(), actual_checksums.data());
 
-        if (actual_checksum != expected_checksum) {
-            sstlog.error("Chunk checksum mismatch at offset {}, for chunk #{} of size {}: expected={}, actual={}", offset, i, checksum.chunk_size, expected_checksum, actual_checksum);
-            valid = false;
-        }
+        for (size_t j = 0; j < read; ++j, ++i) {
+            const auto expected_checksum = checksum.checksums[i];
+            auto actual_checksum = actual_checksums[j];
+
+            if (actual_checksum != expected_checksum) {
+                sstlog.error("Chunk checksum mismatch at offset {}, for chunk #{} of size {}: expected={}, actual={}", offset, i, checksum.chunk_size, expected_checksum, actual_checksum);
+                valid = false;
+            }
+
+            actual_full_checksum = checksum_combine_or_feed<ChecksumType>(actual_full_checksum, actual_checksum, inputs[j], input_lens[j]);
 
-        actual_full_checksum = checksum_combine_or_feed<ChecksumType>(actual_full_checksum, actual_checksum, buf.begin(), buf.size());
+            offset += input_lens[j];
+        }
 
-        offset += buf.size();
+        if (read < count) {
+            sstlog.error("Chunk count mismatch between CRC.db and Data.db at offset {}: expected {} chunks but data file has less", offset, checksum.checksums.size());
+            valid = false;
+            break;
+        }
     }
 
     if (!stream.eof()) {
@@ -2623,6 +2907,13 @@ future<> sstable::close_files() {
             general_disk_error();
         });
     }
+    auto value_logs_closed = parallel_for_each(std::exchange(_value_log_files, {}), [me = shared_from_this()] (auto& p) {
+        return p.second.get_future().then([] (file f) {
+            return f.close();
+        }).handle_exception([] (auto ep) {
+            sstlog.warn("sstable close value log failed: {}", ep);
+        });
+    });
 
     auto unlinked = make_ready_future<>();
     auto unlinked_temp_dir = make_ready_future<>();
@@ -2662,7 +2953,7 @@ future<> sstable::close_files() {
 
     _on_closed(*this);
 
-    return when_all_succeed(std::move(index_closed), std::move(data_closed), std::move(unlinked), std::move(unlinked_temp_dir)).discard_result().then([this, me = shared_from_this()] {
+    return when_all_succeed(std::move(index_closed), std::move(data_closed), std::move(value_logs_closed), std::move(unlinked), std::move(unlinked_temp_dir)).discard_result().then([this, me = shared_from_this()] {
         if (_open_mode) {
             if (_open_mode.value() == open_flags::ro) {
                 _stats.on_close_for_reading();
@@ -3112,6 +3403,24 @@ future<> init_metrics() {
             sm::description("Number of bytes currently used by cached promoted index blocks")),
         sm::make_gauge("pi_cache_block_count", [] { return promoted_index_cache_metrics.block_count; },
             sm::description("Number of promoted index blocks currently cached")),
+        sm::make_counter("pi_cache_single_reads", [] { return promoted_index_cache_metrics.single_reads; },
+            sm::description("Number of promoted indexes which were read whole with a single read of the index file")),
+
+        sm::make_gauge("index_cache_warmup_pages_to_load", [] { return index_cache_warmup::shard_stats().pages_to_load; },
+            sm::description("Number of index pages of the saved hot set which the warmup after restart is going to load")),
+        sm::make_gauge("index_cache_warmup_pages_loaded", [] { return index_cache_warmup::shard_stats().pages_loaded; },
+            sm::description("Number of index pages of the saved hot set loaded so far by the warmup after restart")),
+        sm::make_gauge("index_cache_warmup_missing_sstables", [] { return index_cache_warmup::shard_stats().missing_sstables; },
+            sm::description("Number of sstables in the saved hot set which no longer existed during the warmup after restart")),
+        sm::make_gauge("index_cache_saved_hit_ratio", [] { return index_cache_warmup::shard_stats().saved_hit_ratio; },
+            sm::description("Index page cache hit ratio at the time the hot set was saved by the previous run")),
+        sm::make_gauge("index_cache_hit_ratio_recovery", [] { return index_cache_warmup::hit_ratio_recovery(); },
+            sm::description("Index page cache hit ratio since the warmup after restart, relative to the hit ratio of the previous run")),
+
+        sm::make_counter("read_batching_requests", [] { return get_read_batching_stats().requests; },
+            sm::description("Number of sstable data and index file reads issued through read batching")),
+        sm::make_counter("read_batching_submissions", [] { return get_read_batching_stats().submissions; },
+            sm::description("Number of reads submitted to sstable data and index files on behalf of batched reads")),
 
         sm::make_counter("partition_writes", [] { return sstables_stats::get_shard_stats().partition_writes; },
             sm::description("Number of partitions written")),
@@ -3132,6 +3441,10 @@ future<> init_metrics() {
             sm::description("Number of range tombstones read")),
         sm::make_counter("row_tombstone_reads", [] { return sstables_stats::get_shard_stats().row_tombstone_reads; },
             sm::description("Number of row tombstones read")),
+        sm::make_counter("cell_tombstone_reads", [] { return sstables_stats::get_shard_stats().cell_tombstone_reads; },
+            sm::description("Number of cell tombstones read")),
+        sm::make_histogram("tombstones_per_read", sm::description("Histogram of the number of tombstones of any kind which sstable reads scanned, including the ones outside of the queried ranges"),
+            [] { return sstables_stats::get_shard_stats().tombstones_per_read.get_histogram(1, 16); }),
         sm::make_counter("cell_tombstone_writes", [] { return sstables_stats::get_shard_stats().cell_tombstone_writes; },
             sm::description("Number of cell tombstones written")),
         sm::make_counter("single_partition_reads", [] { return sstables_stats::get_shard_stats().single_partition_reads; },
@@ -3145,6 +3458,17 @@ future<> init_metrics() {
         sm::make_counter("row_reads", [] { return sstables_stats::get_shard_stats().row_reads; },
             sm::description("Number of rows read")),
 
+        sm::make_counter("value_log_writes", [] { return sstables_stats::get_shard_stats().value_log_writes; },
+            sm::description("Number of values written to value logs")),
+        sm::make_counter("value_log_write_bytes", [] { return sstables_stats::get_shard_stats().value_log_write_bytes; },
+            sm::description("Number of bytes of values written to value logs")),
+        sm::make_counter("value_log_pointer_writes", [] { return sstables_stats::get_shard_stats().value_log_pointer_writes; },
+            sm::description("Number of values left in value logs by compaction, which wrote a pointer to them instead")),
+        sm::make_counter("value_log_reads", [] { return sstables_stats::get_shard_stats().value_log_reads; },
+            sm::description("Number of values read from value logs")),
+        sm::make_counter("value_log_read_bytes", [] { return sstables_stats::get_shard_stats().value_log_read_bytes; },
+            sm::description("Number of bytes of values read from value logs")),
+
         sm::make_counter("capped_local_deletion_time", [] { return sstables_stats::get_shard_stats().capped_local_deletion_time; },
             sm::description("Was local deletion time capped at maximum allowed value in Statistics")),
         sm::make_counter("capped_tombstone_deletion_time", [] { return sstables_stats::get_shard_stats().capped_tombstone_deletion_time; },
@@ -3265,6 +3589,7 @@ std::ostream& operator<<(std::ostream& out, const sstables::component_type& comp
     case ct::TemporaryTOC: out << "TemporaryTOC"; break;
     case ct::TemporaryStatistics: out << "TemporaryStatistics"; break;
     case ct::Scylla: out << "Scylla"; break;
+    case ct::CompressionDictionary: out << "CompressionDictionary"; break;
     case ct::Unknown: out << "Unknown"; break;
     }
     return out;
@@ -17,6 +17,7 @@
 #include <seastar/core/sstring.hh>
 #include <seastar/core/enum.hh>
 #include <seastar/core/shared_ptr.hh>
+#include <seastar/core/shared_future.hh>
 #include <seastar/core/distributed.hh>
 #include <unordered_set>
 #include <unordered_map>
@@ -44,6 +45,7 @@
 #include "stats.hh"
 #include "utils/observable.hh"
 #include "sstables/shareable_components.hh"
+#include "sstables/summary_learned_index.hh"
 #include "sstables/open_info.hh"
 #include "sstables/generation_type.hh"
 #include "query-request.hh"
@@ -95,12 +97,21 @@ class data_consume_context;
 class index_reader;
 class partition_index_cache;
 class sstables_manager;
+struct value_log_pointer;
+struct value_log_sources;
 
 extern size_t summary_byte_cost(double summary_ratio);
 
 struct sstable_writer_config {
     size_t promoted_index_block_size;
     size_t promoted_index_auto_scale_threshold;
+    // When non-zero, the promoted index of every partition is kept within
+    // this many bytes, by merging its blocks as the partition grows, and the
+    // blocks are sized by the observed row size rather than by
+    // promoted_index_block_size alone. This lets readers resolve a clustering
+    // lookup with a single read of the index file (see
+    // mc::cached_promoted_index::single_read_size).
+    size_t promoted_index_read_budget = 0;
     uint64_t max_sstable_size = std::numeric_limits<uint64_t>::max();
     bool backup = false;
     bool leave_unsealed = false;
@@ -111,6 +122,9 @@ struct sstable_writer_config {
     utils::UUID run_identifier = utils::make_random_uuid();
     size_t summary_byte_cost;
     sstring origin;
+    // The value logs the pointers of which may be written, when passed through
+    // by the reader (see sstables/value_log.hh).
+    lw_shared_ptr<const value_log_sources> value_logs;
 
 private:
     explicit sstable_writer_config() {}
@@ -166,6 +180,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     static component_type component_from_sstring(version_types version, sstring& s);
     static version_types version_from_sstring(sstring& s);
     static format_types format_from_sstring(sstring& s);
+    static const sstring& version_to_sstring(version_types v);
+    static const sstring& format_to_sstring(format_types f);
     static sstring component_basename(const sstring& ks, const sstring& cf, version_types version, generation_type generation,
                                       format_types format, component_type component);
     static sstring component_basename(const sstring& ks, const sstring& cf, version_types version, generation_type generation,
@@ -219,7 +235,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
             tracing::trace_state_ptr trace_state = {},
             streamed_mutation::forwarding fwd = streamed_mutation::forwarding::no,
             mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::yes,
-            read_monitor& monitor = default_read_monitor());
+            read_monitor& monitor = default_read_monitor(),
+            value_log_pointers vl_pointers = {});
 
     // A reader which doesn't use the index at all. It reads everything from the
     // sstable and it doesn't support skipping.
@@ -320,6 +337,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _version;
     }
 
+    format_types get_format() const {
+        return _format;
+    }
+
     // Returns the total bytes of all components.
     uint64_t bytes_on_disk() const;
 
@@ -398,6 +419,22 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     std::vector<std::pair<component_type, sstring>> all_components() const;
 
+    // The value logs which the data file may point into, see sstables/value_log.hh.
+    const std::vector<utils::UUID>& value_logs() const noexcept {
+        return _value_logs;
+    }
+
+    bool has_value_logs() const noexcept {
+        return !_value_logs.empty();
+    }
+
+    sstring value_log_filename(const utils::UUID& id) const;
+
+    // Reads the value the pointer points to, and verifies its checksum.
+    // Throws malformed_sstable_exception if the pointer doesn't point into a
+    // value log of the sstable.
+    future<temporary_buffer<char>> read_value_log(const value_log_pointer& ptr, const io_priority_class& pc, reader_permit permit);
+
     future<> create_links(const sstring& dir, generation_type generation) const;
 
     future<> create_links(const sstring& dir) const {
@@ -412,6 +449,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _large_data_handler;
     }
 
+    const db::large_data_handler& get_large_data_handler() const {
+        return _large_data_handler;
+    }
+
     void assert_large_data_handler_is_running();
 
     /**
@@ -475,6 +516,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     std::unordered_set<component_type, enum_hash<component_type>> _recognized_components;
     std::vector<sstring> _unrecognized_components;
+    std::vector<utils::UUID> _value_logs;
+    // Opened on the first read of a value.
+    std::unordered_map<utils::UUID, shared_future<file>> _value_log_files;
 
     foreign_ptr<lw_shared_ptr<shareable_components>> _components = make_foreign(make_lw_shared<shareable_components>());
     column_translation _column_translation;
@@ -494,6 +538,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     std::vector<unsigned> _shards;
     std::optional<dht::decorated_key> _first;
     std::optional<dht::decorated_key> _last;
+    // Speeds up summary lookups, when enabled by sstable_summary_learned_index_max_error.
+    std::optional<summary_learned_index> _summary_learned_index;
     utils::UUID _run_identifier;
     utils::observable<sstable&> _on_closed;
 
@@ -567,6 +613,18 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     void generate_toc(compressor_ptr c, double filter_fp_chance);
     void write_toc(const io_priority_class& pc);
+    void write_toc_entries(file_writer& w);
+
+    // Adds a value log to the sstable being written, and records it in its
+    // temporary TOC before the file of the value log is created, so that it
+    // is removed along with the sstable if writing it fails.
+    // Must be called in a seastar thread.
+    void add_value_log(const utils::UUID& id, const io_priority_class& pc);
+    // Creates the file of a new value log added with add_value_log().
+    future<file_writer> make_value_log_writer(const utils::UUID& id, file_output_stream_options options);
+    // Links the value log of source, added with add_value_log().
+    future<> link_value_log(const sstable& source, const utils::UUID& id);
+    future<file> open_value_log(const utils::UUID& id);
     future<> seal_sstable();
 
     future<> read_compression(const io_priority_class& pc);
@@ -574,7 +632,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     future<> read_scylla_metadata(const io_priority_class& pc) noexcept;
     void write_scylla_metadata(const io_priority_class& pc, shard_id shard, sstable_enabled_features features, run_identifier identifier,
-            std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin);
+            std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin,
+            std::optional<value_log_metadata> vl_metadata = std::nullopt, std::optional<tombstone_density_metadata> td_metadata = std::nullopt);
 
     future<> read_filter(const io_priority_class& pc);
 
@@ -607,6 +666,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     void validate_partitioner();
 
     void set_first_and_last_keys();
+    future<> build_summary_learned_index();
 
     // Create a position range based on the min/max_column_names metadata of this sstable.
     // It does nothing if schema defines no clustering key, and it's supposed
@@ -627,9 +687,15 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     //
     // When created with `raw_stream::yes`, the sstable data file will be
     // streamed as-is, without decompressing (if compressed).
+    //
+    // When created with `adaptive_readahead::yes`, reads of the data file are
+    // extended with a read-ahead window which grows while the stream reads
+    // sequentially and collapses on skips, see make_adaptive_readahead_file().
     using raw_stream = bool_class<class raw_stream_tag>;
+    using adaptive_readahead = bool_class<class adaptive_readahead_tag>;
     input_stream<char> data_stream(uint64_t pos, size_t len, const io_priority_class& pc,
-            reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history, raw_stream raw = raw_stream::no);
+            reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history, raw_stream raw = raw_stream::no,
+            adaptive_readahead readahead = adaptive_readahead::no);
 
     // Read exactly the specific byte range from the data file (after
     // uncompression, if the file is compressed). This can be used to read
@@ -728,6 +794,11 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _components->filter->is_present(key);
     }
 
+    // Batched filter_has_key(), see utils::i_filter::are_present().
+    void filter_has_keys(std::span<const utils::hashed_key> keys, std::span<bool> present) const {
+        _components->filter->are_present(keys, present);
+    }
+
     bool filter_has_key(const schema& s, partition_key_view key) const {
         return filter_has_key(key::from_partition_key(s, key));
     }
@@ -814,10 +885,19 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _components->summary;
     }
 
+    // Returns the position of the first summary entry which is not smaller
+    // than pos, searching from position start on.
+    uint64_t summary_lower_bound(dht::ring_position_view pos, uint64_t start = 0) const;
+
     // Gets ratio of droppable tombstone. A tombstone is considered droppable here
     // for cells expired before gc_before and regular tombstones older than gc_before.
     double estimate_droppable_tombstone_ratio(gc_clock::time_point gc_before) const;
 
+    // Like estimate_droppable_tombstone_ratio(), but of the token range of the
+    // sstable which is the densest in droppable tombstones, according to its
+    // tombstone density metadata. Returns 0 if it has none.
+    double estimate_droppable_tombstone_ratio_of_densest_range(gc_clock::time_point gc_before) const;
+
     // get sstable open info from a loaded sstable, which can be used to quickly open a sstable
     // at another shard.
     future<foreign_sstable_open_info> get_open_info() &;
@@ -851,6 +931,17 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // Drops all evictable in-memory caches of on-disk content.
     future<> drop_caches();
 
+    // Summary indexes of the partition index pages which are currently loaded.
+    std::vector<uint64_t> get_cached_summary_indexes() const;
+    // Ids of the index file pages which are currently held by the index page cache.
+    std::vector<uint64_t> get_cached_index_pages() const;
+    // Returns the range [first, last] of index file pages spanned by the
+    // partition index page of a given summary entry.
+    std::pair<uint64_t, uint64_t> index_pages_of_summary_entry(uint64_t summary_idx) const;
+    // Reads index file pages [first, first + count) into the index page cache,
+    // skipping those which are already cached.
+    future<> prefetch_index_pages(uint64_t first, uint64_t count, const io_priority_class& pc);
+
     // Allow the test cases from sstable_test.cc to test private methods. We use
     // a placeholder to avoid cluttering this class too much. The sstable_test class
     // will then re-export as public every method it needs.
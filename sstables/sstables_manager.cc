@@ -20,7 +20,7 @@ logging::logger smlogger("sstables_manager");
 
 sstables_manager::sstables_manager(
     db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat, cache_tracker& ct)
-    : _large_data_handler(large_data_handler), _db_config(dbcfg), _features(feat), _cache_tracker(ct) {
+    : _large_data_handler(large_data_handler), _db_config(dbcfg), _features(feat), _cache_tracker(ct), _index_cache_warmup(*this) {
 }
 
 sstables_manager::~sstables_manager() {
@@ -92,9 +92,11 @@ void sstables_manager::maybe_done() {
 }
 
 future<> sstables_manager::close() {
-    _closing = true;
-    maybe_done();
-    return _done.get_future();
+    return _index_cache_warmup.stop().then([this] {
+        _closing = true;
+        maybe_done();
+        return _done.get_future();
+    });
 }
 
 }   // namespace sstables
@@ -21,6 +21,7 @@
 #include "sstables/version.hh"
 #include "sstables/component_type.hh"
 #include "db/cache_tracker.hh"
+#include "sstables/index_cache_warmup.hh"
 
 #include <boost/intrusive/list.hpp>
 
@@ -65,6 +66,7 @@ class sstables_manager {
     bool _closing = false;
     promise<> _done;
     cache_tracker& _cache_tracker;
+    index_cache_warmup _index_cache_warmup;
 public:
     explicit sstables_manager(db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat, cache_tracker&);
     virtual ~sstables_manager();
@@ -88,6 +90,18 @@ class sstables_manager {
 
     const utils::UUID& get_local_host_id() const;
 
+    // Loads the index cache hot set saved by the previous run into the caches
+    // of the sstables managed by this instance and starts saving it
+    // periodically. See index_cache_warmup.
+    future<> warm_up_index_caches(const io_priority_class& pc) {
+        return _index_cache_warmup.warm_up(pc);
+    }
+
+    // Saves the index cache hot set, if warm_up_index_caches() was called before.
+    future<> save_index_caches() {
+        return _index_cache_warmup.save();
+    }
+
     // Wait until all sstables managed by this sstables_manager instance
     // (previously created by make_sstable()) have been disposed of:
     //   - if they were marked for deletion, the files are deleted
@@ -110,6 +124,7 @@ class sstables_manager {
         return _large_data_handler;
     }
     friend class sstable;
+    friend class index_cache_warmup;
 };
 
 }   // namespace sstables
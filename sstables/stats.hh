@@ -10,6 +10,8 @@
 
 #include <cstdint>
 
+#include "utils/estimated_histogram.hh"
+
 namespace sstables {
 
 class sstables_stats {
@@ -21,6 +23,7 @@ class sstables_stats {
         uint64_t range_tombstone_writes = 0;
         uint64_t range_tombstone_reads = 0;
         uint64_t row_tombstone_reads = 0;
+        uint64_t cell_tombstone_reads = 0;
         uint64_t cell_writes = 0;
         uint64_t cell_tombstone_writes = 0;
         uint64_t single_partition_reads = 0;
@@ -36,6 +39,13 @@ class sstables_stats {
         uint64_t closed_for_writing = 0;
         uint64_t deleted = 0;
         uint64_t promoted_index_auto_scale_events = 0;
+        uint64_t value_log_writes = 0;
+        uint64_t value_log_write_bytes = 0;
+        uint64_t value_log_pointer_writes = 0;
+        uint64_t value_log_reads = 0;
+        uint64_t value_log_read_bytes = 0;
+        // Tombstones parsed by each completed mx reader.
+        utils::estimated_histogram tombstones_per_read;
     } _shard_stats;
 
     stats& _stats = _shard_stats;
@@ -73,6 +83,14 @@ class sstables_stats {
         ++_stats.row_tombstone_reads;
     }
 
+    inline void on_cell_tombstone_read() noexcept {
+        ++_stats.cell_tombstone_reads;
+    }
+
+    inline void on_read_completed(uint64_t tombstones) noexcept {
+        _stats.tombstones_per_read.add(tombstones);
+    }
+
     inline void on_cell_write() noexcept {
         ++_stats.cell_writes;
     }
@@ -130,6 +148,20 @@ class sstables_stats {
     inline void on_promoted_index_auto_scale() noexcept {
         ++_stats.promoted_index_auto_scale_events;
     }
+
+    inline void on_value_log_write(uint64_t bytes) noexcept {
+        ++_stats.value_log_writes;
+        _stats.value_log_write_bytes += bytes;
+    }
+
+    inline void on_value_log_pointer_write() noexcept {
+        ++_stats.value_log_pointer_writes;
+    }
+
+    inline void on_value_log_read(uint64_t bytes) noexcept {
+        ++_stats.value_log_reads;
+        _stats.value_log_read_bytes += bytes;
+    }
 };
 
 }
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+
+#include "sstables/summary_learned_index.hh"
+
+#include <algorithm>
+#include <limits>
+
+namespace sstables {
+
+// Token distance between two tokens, as a double.
+// The difference of two int64_t values always fits in uint64_t.
+static double token_distance(int64_t from, int64_t to) {
+    return double(uint64_t(to) - uint64_t(from));
+}
+
+future<summary_learned_index> summary_learned_index::build(const utils::chunked_vector<summary_entry>& entries, uint64_t max_error) {
+    std::vector<segment> segments;
+    const double eps = max_error;
+    // Slopes which keep all entries of the current segment within the error bound.
+    // Negative slopes are excluded so that predictions are monotonic.
+    double slope_lo = 0;
+    double slope_hi = std::numeric_limits<double>::infinity();
+
+    auto close_segment = [&] {
+        if (!segments.empty()) {
+            segments.back().slope = slope_hi == std::numeric_limits<double>::infinity() ? 0 : (slope_lo + slope_hi) / 2;
+        }
+    };
+
+    for (uint64_t idx = 0; idx < entries.size(); ++idx) {
+        auto token = entries[idx].token.raw();
+        if (!segments.empty()) {
+            auto& s = segments.back();
+            auto dx = token_distance(s.first_token, token);
+            auto dy = double(idx - s.first_idx);
+            if (dx == 0) {
+                if (dy <= eps) {
+                    continue;
+                }
+            } else {
+                auto lo = std::max(slope_lo, (dy - eps) / dx);
+                auto hi = std::min(slope_hi, (dy + eps) / dx);
+                if (lo <= hi) {
+                    slope_lo = lo;
+                    slope_hi = hi;
+                    co_await coroutine::maybe_yield();
+                    continue;
+                }
+            }
+        }
+        close_segment();
+        segments.push_back(segment{token, idx, 0});
+        slope_lo = 0;
+        slope_hi = std::numeric_limits<double>::infinity();
+        co_await coroutine::maybe_yield();
+    }
+    close_segment();
+    segments.shrink_to_fit();
+
+    co_return summary_learned_index(std::move(segments), entries.size(), max_error);
+}
+
+std::pair<uint64_t, uint64_t> summary_learned_index::search_window(dht::token t) const {
+    if (t.is_minimum()) {
+        return {0, 0};
+    }
+    if (t.is_maximum()) {
+        return {_size, _size};
+    }
+    auto token = t.raw();
+    // Use the last segment which starts before the token. When a run of equal
+    // tokens spans segments, the first entry of the run belongs to that
+    // segment, or is the first entry of the next one.
+    auto it = std::lower_bound(_segments.begin(), _segments.end(), token, [] (const segment& s, int64_t token) {
+        return s.first_token < token;
+    });
+    if (it == _segments.begin()) {
+        return {0, 0};
+    }
+    uint64_t next_idx = it == _segments.end() ? _size : it->first_idx;
+    auto& s = *std::prev(it);
+    // Beyond its last entry, the segment is extrapolated up to the first entry of the next one.
+    auto predicted = std::clamp(s.first_idx + s.slope * token_distance(s.first_token, token), double(s.first_idx), double(next_idx));
+    // The answer is within max_error positions of the prediction for any token
+    // of the segment, plus one for tokens which fall between two entries.
+    auto pos = uint64_t(predicted);
+    auto lo = pos > _max_error + 1 ? pos - _max_error - 1 : 0;
+    auto hi = std::min(pos + _max_error + 2, _size);
+    return {lo, hi};
+}
+
+}   // namespace sstables
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/future.hh>
+#include "sstables/types.hh"
+#include "dht/token.hh"
+#include "seastarx.hh"
+
+#include <vector>
+
+namespace sstables {
+
+// Learned index over the tokens of the summary entries.
+//
+// Approximates the mapping from a token to the position of the first summary
+// entry with a token not smaller than it with a piecewise linear function,
+// whose error on every entry is at most max_error positions. A lookup thus
+// only has to search a window of about 2 * max_error entries around the
+// predicted position, instead of binary searching the whole summary, which
+// touches log2(n) entries scattered across memory. Tokens of the Murmur3
+// partitioner are close to uniformly distributed, so a handful of segments
+// usually cover the whole summary.
+//
+// The model is built with the greedy "shrinking cone" algorithm: a segment is
+// extended for as long as some slope keeps all of its entries within the
+// error bound.
+class summary_learned_index {
+public:
+    struct segment {
+        int64_t first_token;
+        // Position of the first entry of the segment.
+        uint64_t first_idx;
+        // Positions per token.
+        double slope;
+    };
+private:
+    std::vector<segment> _segments;
+    uint64_t _size = 0;
+    uint64_t _max_error = 0;
+private:
+    summary_learned_index(std::vector<segment> segments, uint64_t size, uint64_t max_error)
+        : _segments(std::move(segments)), _size(size), _max_error(max_error) {}
+public:
+    // Builds the index over the tokens of the given summary entries.
+    static future<summary_learned_index> build(const utils::chunked_vector<summary_entry>& entries, uint64_t max_error);
+
+    // Returns the range [lo, hi] of positions in which the first summary entry
+    // with a token not smaller than t is found. Lookups by key must check the
+    // entries at the boundaries, as the window only accounts for the token:
+    // the key may fall past the window in a long run of entries with t.
+    std::pair<uint64_t, uint64_t> search_window(dht::token t) const;
+
+    const std::vector<segment>& segments() const { return _segments; }
+    uint64_t max_error() const { return _max_error; }
+
+    size_t memory_footprint() const {
+        return sizeof(*this) + _segments.capacity() * sizeof(segment);
+    }
+};
+
+}   // namespace sstables
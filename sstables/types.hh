@@ -484,7 +484,8 @@ enum sstable_feature : uint8_t {
     CorrectStaticCompact = 3, // See #4139
     CorrectEmptyCounters = 4, // See #4363
     CorrectUDTsInCollections = 5, // See #6130
-    End = 6,
+    ValueLogPointers = 6, // Cells with the 0x20 flag hold value log pointers, see sstables/value_log.hh
+    End = 7,
 };
 
 // Scylla-specific features enabled for a particular sstable.
@@ -527,6 +528,79 @@ enum class scylla_metadata_type : uint32_t {
     SSTableOrigin = 6,
     ScyllaBuildId = 7,
     ScyllaVersion = 8,
+    FilterFormat = 9,
+    // 10 is reserved, it was used for column value statistics.
+    ValueLogs = 11,
+    TombstoneDensity = 12,
+};
+
+// Layout of the bloom filter stored in the Filter component.
+//
+// Note: For extensibility, never reuse an identifier,
+// only add new ones, since these are stored on stable storage.
+enum class filter_format_type : uint32_t {
+    classic = 0,        // Cassandra-compatible, murmur3 with k independent probes
+    split_block = 1,    // utils::filter::split_block_bloom_filter
+};
+
+struct filter_format_metadata {
+    filter_format_type format;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(format); }
+};
+
+// A value log referenced by the data file of an sstable, see sstables/value_log.hh.
+struct value_log_entry {
+    utils::UUID id;
+    // Size of the value log, as of the time the sstable was written.
+    uint64_t size;
+    // Total size of the values of the value log which the sstable points to.
+    uint64_t referenced_bytes;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(id, size, referenced_bytes); }
+};
+
+struct value_log_metadata {
+    disk_array<uint32_t, value_log_entry> logs;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(logs); }
+};
+
+// Consecutive partitions of the data file, see tombstone_density_metadata.
+struct tombstone_density_segment {
+    // Tokens of the first and last partition.
+    int64_t first_token;
+    int64_t last_token;
+    // Span of the partitions in the (uncompressed) data file.
+    uint64_t data_offset;
+    uint64_t data_size;
+    uint64_t rows;
+    uint64_t cells;
+    // Partition, row, range and cell tombstones, expiring cells and expiring
+    // row markers, i.e. everything which is purgeable once its deletion time
+    // is old enough.
+    uint64_t tombstones;
+    // Bounds of the deletion times of the tombstones.
+    int32_t min_deletion_time;
+    int32_t max_deletion_time;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) {
+        return f(first_token, last_token, data_offset, data_size, rows, cells, tombstones, min_deletion_time, max_deletion_time);
+    }
+};
+
+// Tombstone density of the token ranges of the data file, which compaction
+// uses to find the ranges dense enough in purgeable tombstones to be worth
+// rewriting. The segments are in token order, and cover the data file.
+struct tombstone_density_metadata {
+    disk_array<uint32_t, tombstone_density_segment> segments;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(segments); }
 };
 
 struct run_identifier {
@@ -573,7 +647,10 @@ struct scylla_metadata {
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::LargeDataStats, large_data_stats>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::SSTableOrigin, sstable_origin>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaBuildId, scylla_build_id>,
-            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaVersion, scylla_version>
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaVersion, scylla_version>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::FilterFormat, filter_format_metadata>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ValueLogs, value_log_metadata>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::TombstoneDensity, tombstone_density_metadata>
             > data;
 
     sstable_enabled_features get_features() const {
@@ -597,6 +674,16 @@ struct scylla_metadata {
         }
         return *ext;
     }
+    filter_format_type get_filter_format() const {
+        auto* m = data.get<scylla_metadata_type::FilterFormat, filter_format_metadata>();
+        return m ? m->format : filter_format_type::classic;
+    }
+    const value_log_metadata* get_value_logs() const {
+        return data.get<scylla_metadata_type::ValueLogs, value_log_metadata>();
+    }
+    const tombstone_density_metadata* get_tombstone_density() const {
+        return data.get<scylla_metadata_type::TombstoneDensity, tombstone_density_metadata>();
+    }
     std::optional<utils::UUID> get_optional_run_identifier() const {
         auto* m = data.get<scylla_metadata_type::RunIdentifier, run_identifier>();
         return m ? std::make_optional(m->id) : std::nullopt;
@@ -750,6 +837,8 @@ class column_flags_m final {
     static const uint8_t HAS_EMPTY_VALUE = 0x04u;
     static const uint8_t USE_ROW_TIMESTAMP = 0x08u;
     static const uint8_t USE_ROW_TTL = 0x10u;
+    // Scylla-specific: the value is a value_log_pointer.
+    static const uint8_t HAS_VALUE_LOG_POINTER = 0x20u;
     uint8_t _flags;
     bool check_flag(const uint8_t flag) const {
         return (_flags & flag) != 0u;
@@ -771,6 +860,9 @@ class column_flags_m final {
     bool has_value() const {
         return !check_flag(HAS_EMPTY_VALUE);
     }
+    bool has_value_log_pointer() const {
+        return check_flag(HAS_VALUE_LOG_POINTER);
+    }
 };
 }
 
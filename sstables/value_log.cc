@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "sstables/value_log.hh"
+#include "sstables/sstables.hh"
+#include "utils/serialization.hh"
+
+namespace sstables {
+
+static constexpr std::string_view value_log_component_prefix = "Values-";
+static constexpr std::string_view value_log_component_suffix = ".db";
+
+bytes value_log_pointer::serialize() const {
+    bytes b(bytes::initialized_later(), serialized_size);
+    auto out = b.begin();
+    id.serialize(out);
+    serialize_int64(out, offset);
+    serialize_int32(out, size);
+    serialize_int32(out, checksum);
+    return b;
+}
+
+sstring value_log_component_name(const utils::UUID& id) {
+    return format("{}{}{}", value_log_component_prefix, id, value_log_component_suffix);
+}
+
+std::optional<utils::UUID> parse_value_log_component_name(std::string_view component) {
+    if (!boost::starts_with(component, value_log_component_prefix) || !boost::ends_with(component, value_log_component_suffix)) {
+        return std::nullopt;
+    }
+    component.remove_prefix(value_log_component_prefix.size());
+    component.remove_suffix(value_log_component_suffix.size());
+    try {
+        return utils::UUID(sstring_view(component.data(), component.size()));
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+value_log_pointer value_log_writer::append(managed_bytes_view value) {
+    value_log_pointer ptr{_id, _out.offset(), uint32_t(value.size_bytes()), value_log_checksum(value)};
+    for (bytes_view frag : fragment_range(value)) {
+        _out.write(frag);
+    }
+    return ptr;
+}
+
+void value_log_writer::close() {
+    _out.flush();
+    _out.close();
+}
+
+std::unordered_map<utils::UUID, double> value_log_garbage_ratios(const sstable_list& sstables) {
+    struct usage {
+        uint64_t size = 0;
+        uint64_t referenced_bytes = 0;
+    };
+    std::unordered_map<utils::UUID, usage> usages;
+    for (auto& sst : sstables) {
+        auto* sm = sst->get_scylla_metadata();
+        auto* m = sm ? sm->get_value_logs() : nullptr;
+        if (!m) {
+            continue;
+        }
+        for (auto& e : m->logs.elements) {
+            auto& u = usages[e.id];
+            // The value log only grows while its writer writes it, so the
+            // sstables which link it all see the same size.
+            u.size = std::max(u.size, e.size);
+            u.referenced_bytes += e.referenced_bytes;
+        }
+    }
+    std::unordered_map<utils::UUID, double> ratios;
+    ratios.reserve(usages.size());
+    for (auto& [id, u] : usages) {
+        ratios.emplace(id, u.size ? 1.0 - std::min(1.0, double(u.referenced_bytes) / u.size) : 0.0);
+    }
+    return ratios;
+}
+
+uint64_t value_log_garbage_referenced_bytes(const sstable& sst, const std::unordered_map<utils::UUID, double>& garbage_ratios, double ratio) {
+    auto* sm = sst.get_scylla_metadata();
+    auto* m = sm ? sm->get_value_logs() : nullptr;
+    if (!m) {
+        return 0;
+    }
+    uint64_t bytes = 0;
+    for (auto& e : m->logs.elements) {
+        auto it = garbage_ratios.find(e.id);
+        if (it != garbage_ratios.end() && it->second >= ratio) {
+            bytes += e.referenced_bytes;
+        }
+    }
+    return bytes;
+}
+
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+
+#include <seastar/core/sstring.hh>
+
+#include "bytes.hh"
+#include "atomic_cell.hh"
+#include "reader_permit.hh"
+#include "utils/UUID.hh"
+#include "utils/fragment_range.hh"
+#include "sstables/shared_sstable.hh"
+#include "sstables/writer.hh"
+#include "sstables/exceptions.hh"
+#include "sstables/checksum_utils.hh"
+
+// Key-value separation for large cell values.
+//
+// Tables with the value_log option (see db::value_log_extension) write large
+// cell values to value logs: append-only files of raw values, written next to
+// the data file. The data file holds a pointer to the value instead, which the
+// mx reader resolves as it reads the cell.
+//
+// A value log is a component of every sstable which points into it, named
+// Values-<id>.db after its unique identifier. The writer of an sstable that
+// moves values out of the data file creates a new value log. Compaction
+// passes the pointers of its inputs through to its output, which hard-links
+// the value logs of the inputs under its own name, so the values aren't
+// copied. The file system reclaims a value log once the last sstable linking
+// it is deleted.
+//
+// Values which compaction drops are garbage which stays in the value logs.
+// Each sstable records the value logs it points into and how many of their
+// bytes it references (see value_log_metadata), from which the garbage of a
+// value log is computed over the sstables of the table. Compaction moves the
+// values out of the value logs with too much garbage, into the new value log
+// of its output, so that the old ones end up unlinked.
+namespace sstables {
+
+// Location of a value in a value log, stored in the data file in its stead.
+struct value_log_pointer {
+    utils::UUID id;
+    uint64_t offset;
+    uint32_t size;
+    // CRC32 of the value.
+    uint32_t checksum;
+
+    static constexpr size_t serialized_size = 16 + 8 + 4 + 4;
+
+    bytes serialize() const;
+
+    // Throws malformed_sstable_exception if value isn't a serialized pointer.
+    template <FragmentedView View>
+    static value_log_pointer deserialize(View value);
+};
+
+template <FragmentedView View>
+value_log_pointer value_log_pointer::deserialize(View value) {
+    if (value.size_bytes() != serialized_size) {
+        throw malformed_sstable_exception(format("value log pointer has {} bytes instead of {}", value.size_bytes(), serialized_size));
+    }
+    auto msb = read_simple<int64_t>(value);
+    auto lsb = read_simple<int64_t>(value);
+    auto offset = read_simple<uint64_t>(value);
+    auto size = read_simple<uint32_t>(value);
+    auto checksum = read_simple<uint32_t>(value);
+    return value_log_pointer{utils::UUID(msb, lsb), offset, size, checksum};
+}
+
+// Name of the component of the value log, e.g. "Values-<id>.db".
+sstring value_log_component_name(const utils::UUID& id);
+
+// Returns the identifier of the value log of the component, or std::nullopt
+// if it isn't a value log.
+std::optional<utils::UUID> parse_value_log_component_name(std::string_view component);
+
+template <FragmentedView View>
+uint32_t value_log_checksum(View value) {
+    auto crc = crc32_utils::init_checksum();
+    for (bytes_view frag : fragment_range(value)) {
+        crc = crc32_utils::checksum(crc, reinterpret_cast<const char*>(frag.data()), frag.size());
+    }
+    return crc;
+}
+
+// Appends values to a new value log.
+class value_log_writer {
+    utils::UUID _id;
+    file_writer _out;
+public:
+    value_log_writer(utils::UUID id, file_writer out) noexcept : _id(id), _out(std::move(out)) {}
+
+    const utils::UUID& id() const noexcept {
+        return _id;
+    }
+
+    uint64_t size() const noexcept {
+        return _out.offset();
+    }
+
+    // Must be called in a seastar thread.
+    value_log_pointer append(managed_bytes_view value);
+
+    // Must be called in a seastar thread.
+    void close();
+};
+
+// A value log of an input of a compaction.
+struct value_log_source {
+    // An sstable which links the value log.
+    shared_sstable sst;
+    // Size of the value log, as recorded by sst.
+    uint64_t size;
+    // Whether the values still referenced should be moved out of the value
+    // log, rather than pointed to by the output.
+    bool relocate;
+};
+
+// The value logs which a compaction can pass the pointers of through to its
+// output, i.e. the ones its inputs point into.
+struct value_log_sources {
+    reader_permit permit;
+    std::unordered_map<utils::UUID, value_log_source> logs;
+
+    explicit value_log_sources(reader_permit permit) : permit(std::move(permit)) {}
+};
+
+// Fraction of the bytes of the value logs which none of the sstables point to.
+// sstables must be all the sstables of the table which may link the value
+// logs, as the value logs not found in them are left out.
+std::unordered_map<utils::UUID, double> value_log_garbage_ratios(const sstable_list& sstables);
+
+// Total size of the values which sst points to in value logs with a garbage
+// ratio (see value_log_garbage_ratios()) of at least ratio.
+uint64_t value_log_garbage_referenced_bytes(const sstable& sst, const std::unordered_map<utils::UUID, double>& garbage_ratios, double ratio);
+
+}
@@ -73,6 +73,18 @@ void sstable_writer::consume_end_of_stream() {
     return _impl->consume_end_of_stream();
 }
 
+stop_iteration sstable_writer::consume_raw_partition(const sstable& source, const dht::decorated_key& dk, temporary_buffer<char> data) {
+    _impl->_validator(dk);
+    _impl->_validator(mutation_fragment::kind::partition_start, position_in_partition_view(position_in_partition_view::partition_start_tag_t{}));
+    _impl->_validator.on_end_of_partition();
+    _impl->_sst.get_stats().on_partition_write();
+    return _impl->consume_raw_partition(source, dk, std::move(data));
+}
+
+bool can_copy_raw_partitions(const sstable& source, const schema& s, const encoding_stats& enc_stats) {
+    return mc::can_copy_raw_partitions(source, s, enc_stats);
+}
+
 sstable_writer::sstable_writer(sstable_writer&& o) = default;
 sstable_writer& sstable_writer::operator=(sstable_writer&& o) = default;
 sstable_writer::~sstable_writer() {
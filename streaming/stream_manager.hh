@@ -10,6 +10,10 @@
 
 #pragma once
 #include "streaming/progress_info.hh"
+#include "streaming/stream_reason.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
+#include "schema_fwd.hh"
+#include "bytes.hh"
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/distributed.hh>
 #include "utils/UUID.hh"
@@ -18,7 +22,9 @@
 #include "gms/endpoint_state.hh"
 #include "gms/application_state.hh"
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/metrics_registration.hh>
+#include <seastar/util/noncopyable_function.hh>
 #include <map>
 
 namespace db {
@@ -96,6 +102,8 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
     uint64_t _total_incoming_bytes{0};
     uint64_t _total_outgoing_bytes{0};
     semaphore _mutation_send_limiter{256};
+    // Held by the handlers of STREAM_SSTABLE_FILES, which outlive the RPC.
+    seastar::gate _sstable_files_gate;
     seastar::metrics::metric_groups _metrics;
 
 public:
@@ -111,6 +119,19 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
 
     semaphore& mutation_send_limiter() { return _mutation_send_limiter; }
 
+    // The commands, component names and data of an sstable sent with
+    // STREAM_SSTABLE_FILES. Returns a disengaged optional once the sender
+    // closed the stream.
+    using sstable_files_source = noncopyable_function<future<std::optional<std::tuple<stream_sstable_files_cmd, sstring, bytes>>>()>;
+
+    // Receives the component files of an sstable of the table and makes it
+    // available on the shard which owns it. Sstables which are owned by
+    // several shards, or whose data must go through the view update path,
+    // are read back and their mutations are distributed like streamed
+    // mutation fragments are. The received files are removed on failure.
+    future<> receive_sstable_files(UUID plan_id, inet_address from, schema_ptr s, sstring sstable_version, sstring sstable_format,
+            stream_reason reason, sstable_files_source source);
+
     void register_sending(shared_ptr<stream_result_future> result);
 
     void register_receiving(shared_ptr<stream_result_future> result);
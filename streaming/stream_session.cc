@@ -34,8 +34,12 @@
 #include "../db/view/view_update_generator.hh"
 #include "mutation_source_metadata.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "consumer.hh"
 #include "readers/generating_v2.hh"
+#include "sstables/sstables.hh"
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
 
 namespace streaming {
 
@@ -49,6 +53,153 @@ static sstables::offstrategy is_offstrategy_supported(streaming::stream_reason r
     return sstables::offstrategy(operations_supported.contains(reason));
 }
 
+// Returns the name of the file to which the received component of the sstable is written.
+static sstring received_component_filename(const sstables::sstable& sst, sstring name) {
+    if (name.empty() || name.find('/') != sstring::npos) {
+        throw std::runtime_error(format("Sender sent invalid sstable component name: {}", name));
+    }
+    auto component = sstables::sstable::component_from_sstring(sst.get_version(), name);
+    if (component == sstables::component_type::TemporaryTOC) {
+        throw std::runtime_error(format("Sender sent invalid sstable component: {}", name));
+    }
+    // The TOC is written as a temporary TOC, which is renamed when the sstable
+    // is sealed, once all of its components are on disk. Until then, the
+    // sstable is removed on restart, like a partially written one.
+    if (component == sstables::component_type::TOC) {
+        return sst.filename(sstables::component_type::TemporaryTOC);
+    }
+    auto s = sst.get_schema();
+    return sstables::sstable::filename(sst.get_dir(), s->ks_name(), s->cf_name(), sst.get_version(), sst.generation(), sst.get_format(), std::move(name));
+}
+
+// Writes the components of an sstable received with STREAM_SSTABLE_FILES to
+// the directory of the table, under a new generation, and seals it.
+static future<sstables::shared_sstable> receive_sstable_components(stream_manager& sm, replica::table& cf, utils::UUID plan_id, gms::inet_address from,
+        sstables::sstable_version_types version, sstables::sstable_format_types format,
+        stream_manager::sstable_files_source& source) {
+    auto sst = cf.make_sstable(cf.dir(), cf.calculate_generation_for_new_table(), version, format);
+    std::vector<sstring> files;
+    std::optional<output_stream<char>> out;
+    sstring current;
+    bool got_end_of_stream = false;
+    std::exception_ptr ex;
+    try {
+        while (auto opt = co_await source()) {
+            auto& [cmd, name, data] = *opt;
+            switch (cmd) {
+            case stream_sstable_files_cmd::file_data:
+                break;
+            case stream_sstable_files_cmd::error:
+                throw std::runtime_error("Sender failed");
+            case stream_sstable_files_cmd::end_of_stream:
+                got_end_of_stream = true;
+                continue;
+            default:
+                throw std::runtime_error("Sender sent wrong cmd");
+            }
+            if (got_end_of_stream) {
+                throw std::runtime_error("Sender sent data after end_of_stream");
+            }
+            if (!out || name != current) {
+                if (out) {
+                    co_await out->close();
+                    out.reset();
+                }
+                files.push_back(received_component_filename(*sst, name));
+                auto f = co_await open_file_dma(files.back(), open_flags::wo | open_flags::create | open_flags::exclusive);
+                file_output_stream_options options;
+                options.io_priority_class = service::get_local_streaming_priority();
+                out = co_await make_file_output_stream(std::move(f), options);
+                current = name;
+            }
+            co_await out->write(reinterpret_cast<const char*>(data.data()), data.size());
+            sm.update_progress(plan_id, from, progress_info::direction::IN, data.size());
+        }
+        if (out) {
+            co_await out->close();
+            out.reset();
+        }
+        if (!got_end_of_stream) {
+            throw std::runtime_error("Sender did not send end_of_stream");
+        }
+        co_await sst->seal_sstable(false);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        if (out) {
+            try {
+                co_await out->close();
+            } catch (...) {
+            }
+        }
+        for (auto& file : files) {
+            try {
+                co_await remove_file(file);
+            } catch (...) {
+            }
+        }
+        std::rethrow_exception(std::move(ex));
+    }
+    co_return sst;
+}
+
+static future<> load_received_sstable(replica::database& db, utils::UUID cf_id, sstring dir, sstables::generation_type generation,
+        sstables::sstable_version_types version, sstables::sstable_format_types format, sstables::offstrategy offstrategy) {
+    auto& cf = db.find_column_family(cf_id);
+    auto sst = cf.make_sstable(std::move(dir), generation, version, format);
+    co_await sst->load(service::get_local_streaming_priority());
+    // Like sstables loaded from upload, the received sstable may overlap with existing sstables on higher levels.
+    sst->set_sstable_level(0);
+    co_await cf.add_sstable_and_update_cache(std::move(sst), offstrategy);
+}
+
+future<> stream_manager::receive_sstable_files(UUID plan_id, inet_address from, schema_ptr s, sstring sstable_version, sstring sstable_format,
+        stream_reason reason, sstable_files_source source) {
+    auto& db = _db;
+    auto& sys_dist_ks = _sys_dist_ks;
+    auto& vug = _view_update_generator;
+    auto& cf = db.local().find_column_family(s->id());
+    // Make sure the table is still present while the sstable is received and loaded.
+    auto op = cf.stream_in_progress();
+    auto v = sstables::sstable::version_from_sstring(sstable_version);
+    auto f = sstables::sstable::format_from_sstring(sstable_format);
+    auto sst = co_await receive_sstable_components(*this, cf, plan_id, from, v, f, source);
+    std::exception_ptr ex;
+    try {
+        co_await sst->load(service::get_local_streaming_priority());
+        auto shards = sst->get_shards_for_this_sstable();
+        auto use_view_update_path = co_await db::view::check_needs_view_update_path(sys_dist_ks.local(), cf, reason);
+        if (shards.size() == 1 && !use_view_update_path) {
+            sslog.debug("[Stream #{}] Loading sstable {} received from {} on shard {}", plan_id, sst->get_filename(), from, shards.front());
+            auto dir = sst->get_dir();
+            auto generation = sst->generation();
+            // The sstable is reopened by the shard which owns it.
+            sst = nullptr;
+            co_await db.invoke_on(shards.front(), [cf_id = s->id(), dir = std::move(dir), generation, v, f, offstrategy = is_offstrategy_supported(reason)] (replica::database& db) {
+                return load_received_sstable(db, cf_id, dir, generation, v, f, offstrategy);
+            });
+        } else {
+            sslog.debug("[Stream #{}] Distributing sstable {} received from {} to shards {}", plan_id, sst->get_filename(), from, fmt::join(shards, ", "));
+            sst->mark_for_deletion();
+            auto permit = co_await db.local().obtain_reader_permit(cf, "stream-sstable-files", db::no_timeout);
+            co_await mutation_writer::distribute_reader_and_consume_on_shards(s,
+                sst->make_reader(s, std::move(permit), query::full_partition_range, s->full_slice(), service::get_local_streaming_priority(),
+                        {}, streamed_mutation::forwarding::no, mutation_reader::forwarding::no),
+                make_streaming_consumer("streaming", db, sys_dist_ks, vug, sst->get_estimated_key_count(), reason, is_offstrategy_supported(reason)),
+                std::move(op));
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        if (sst) {
+            sst->mark_for_deletion();
+        }
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
 void stream_manager::init_messaging_service_handler() {
     auto& ms = _ms.local();
 
@@ -163,6 +314,47 @@ void stream_manager::init_messaging_service_handler() {
         });
       });
     });
+    ms.register_stream_sstable_files([this] (const rpc::client_info& cinfo, UUID plan_id, UUID schema_id, UUID cf_id, sstring sstable_version, sstring sstable_format, stream_reason reason, rpc::source<stream_sstable_files_cmd, sstring, bytes> source) {
+        auto from = netw::messaging_service::get_source(cinfo);
+        sslog.trace("Got stream_sstable_files from {} reason {}", from, int(reason));
+        if (!_sys_dist_ks.local_is_initialized() || !_view_update_generator.local_is_initialized()) {
+            return make_exception_future<rpc::sink<int>>(std::runtime_error(format("Node {} is not fully initialized for streaming, try again later",
+                    utils::fb_utilities::get_broadcast_address())));
+        }
+        return _mm.local().get_schema_for_write(schema_id, from, _ms.local()).then([this, from, plan_id, cf_id, sstable_version = std::move(sstable_version), sstable_format = std::move(sstable_format), reason, source] (schema_ptr s) mutable {
+            auto sink = _ms.local().make_sink_for_stream_sstable_files(source);
+          try {
+            // Make sure the table with cf_id is still present at this point.
+            // Close the sink in case the table is dropped.
+            _db.local().find_column_family(cf_id);
+            // The sstable is received in the background, and the sender is told
+            // about the outcome through the sink. stop() waits for it.
+            (void)with_gate(_sstable_files_gate, [this, s, plan_id, from, sstable_version = std::move(sstable_version), sstable_format = std::move(sstable_format), reason, source, sink] () mutable {
+              return receive_sstable_files(plan_id, from.addr, s, std::move(sstable_version), std::move(sstable_format), reason, [source] () mutable {
+                    return source();
+                }).then_wrapped([s, plan_id, from, sink] (future<> f) mutable {
+                int32_t status = 0;
+                if (f.failed()) {
+                    sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (receive and load phase) for ks={}, cf={}, peer={}: {}",
+                            plan_id, s->ks_name(), s->cf_name(), from.addr, f.get_exception());
+                    status = -1;
+                }
+                return sink(status).finally([sink] () mutable {
+                    return sink.close();
+                });
+            }).handle_exception([s, plan_id, from, sink] (std::exception_ptr ep) {
+                sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (respond phase) for ks={}, cf={}, peer={}: {}",
+                        plan_id, s->ks_name(), s->cf_name(), from.addr, ep);
+            });
+            });
+          } catch (...) {
+            return sink.close().then([sink, eptr = std::current_exception()] () -> future<rpc::sink<int>> {
+                return make_exception_future<rpc::sink<int>>(eptr);
+            });
+          }
+            return make_ready_future<rpc::sink<int>>(sink);
+        });
+    });
     ms.register_stream_mutation_done([this] (const rpc::client_info& cinfo, UUID plan_id, dht::token_range_vector ranges, UUID cf_id, unsigned dst_cpu_id) {
         const auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return container().invoke_on(dst_cpu_id, [ranges = std::move(ranges), plan_id, cf_id, from] (auto& sm) mutable {
@@ -193,6 +385,7 @@ future<> stream_manager::uninit_messaging_service_handler() {
         ms.unregister_prepare_message(),
         ms.unregister_prepare_done_message(),
         ms.unregister_stream_mutation_fragments(),
+        ms.unregister_stream_sstable_files(),
         ms.unregister_stream_mutation_done(),
         ms.unregister_complete_message()).discard_result();
 }
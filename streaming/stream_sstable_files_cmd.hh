@@ -0,0 +1,21 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace streaming {
+
+enum class stream_sstable_files_cmd : uint8_t {
+    error,
+    file_data,
+    end_of_stream,
+};
+
+}
@@ -15,6 +15,7 @@
 #include "streaming/stream_manager.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "readers/mutation_fragment_v1_stream.hh"
 #include "mutation_fragment_stream_validator.hh"
 #include "frozen_mutation.hh"
@@ -25,11 +26,15 @@
 #include "dht/sharder.hh"
 #include "service/priority_manager.hh"
 #include <boost/range/irange.hpp>
+#include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_set.hpp>
 #include "sstables/sstables.hh"
 #include "replica/database.hh"
 #include "gms/feature_service.hh"
+#include "db/config.hh"
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
 
 namespace streaming {
 
@@ -56,11 +61,14 @@ struct send_info {
     replica::column_family& cf;
     dht::token_range_vector ranges;
     dht::partition_range_vector prs;
+    // Sstables sent as files, which the reader skips.
+    lw_shared_ptr<const sstables::sstable_list> sstables_to_send;
     mutation_fragment_v1_stream reader;
     noncopyable_function<void(size_t)> update;
     send_info(netw::messaging_service& ms_, utils::UUID plan_id_, replica::table& tbl_, reader_permit permit_,
               dht::token_range_vector ranges_, netw::messaging_service::msg_addr id_,
-              uint32_t dst_cpu_id_, stream_reason reason_, noncopyable_function<void(size_t)> update_fn)
+              uint32_t dst_cpu_id_, stream_reason reason_, lw_shared_ptr<const sstables::sstable_list> sstables_to_send_,
+              noncopyable_function<void(size_t)> update_fn)
         : ms(ms_)
         , plan_id(plan_id_)
         , cf_id(tbl_.schema()->id())
@@ -70,7 +78,8 @@ struct send_info {
         , cf(tbl_)
         , ranges(std::move(ranges_))
         , prs(dht::to_partition_ranges(ranges))
-        , reader(cf.make_streaming_reader(cf.schema(), std::move(permit_), prs))
+        , sstables_to_send(std::move(sstables_to_send_))
+        , reader(cf.make_streaming_reader(cf.schema(), std::move(permit_), prs, sstables_to_send))
         , update(std::move(update_fn))
     {
     }
@@ -185,6 +194,127 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
  });
 }
 
+// Size of the chunks in which sstable component files are sent.
+static constexpr size_t sstable_file_chunk_size = 128 * 1024;
+
+// Returns the sstables of the table which can be sent as files: the ones
+// which lie entirely within one of the (sorted and merged) ranges and are
+// owned by this shard only, so that each of them is sent by a single shard and
+// only contains data which is streamed. Sstables of tables with views are
+// always streamed as mutations, so that the receiver generates view updates.
+// So are sstables with value logs, which are shared with other sstables.
+static lw_shared_ptr<sstables::sstable_list> select_sstables_to_send(const replica::table& tbl, const dht::token_range_vector& ranges) {
+    auto selected = make_lw_shared<sstables::sstable_list>();
+    if (!tbl.views().empty()) {
+        return selected;
+    }
+    auto sstables = tbl.get_sstables();
+    for (auto& sst : *sstables) {
+        auto& shards = sst->get_shards_for_this_sstable();
+        if (shards.size() != 1 || shards.front() != this_shard_id() || sst->has_value_logs()) {
+            continue;
+        }
+        auto sst_range = dht::token_range::make(sst->get_first_decorated_key().token(), sst->get_last_decorated_key().token());
+        if (boost::algorithm::any_of(ranges, [&] (const dht::token_range& r) { return r.contains(sst_range, dht::token_comparator()); })) {
+            selected->insert(sst);
+        }
+    }
+    return selected;
+}
+
+static future<> send_sstable_components(lw_shared_ptr<send_info> si, sstables::shared_sstable sst,
+        rpc::sink<stream_sstable_files_cmd, sstring, bytes>& sink, lw_shared_ptr<bool> got_error_from_peer) {
+    auto& pc = service::get_local_streaming_priority();
+    for (auto& [type, name] : sst->all_components()) {
+        auto f = co_await open_file_dma(sst->filename(sst->get_dir(), sst->get_schema()->ks_name(), sst->get_schema()->cf_name(),
+                sst->get_version(), sst->generation(), sst->get_format(), name), open_flags::ro);
+        file_input_stream_options options;
+        options.buffer_size = sstable_file_chunk_size;
+        options.io_priority_class = pc;
+        auto in = make_file_input_stream(std::move(f), options);
+        std::exception_ptr ex;
+        try {
+            // Send at least one, possibly empty, chunk, so that the receiver creates empty files too.
+            bool sent = false;
+            while (true) {
+                auto buf = co_await in.read();
+                if (*got_error_from_peer) {
+                    throw std::runtime_error("Got status error code from peer");
+                }
+                if (buf.empty() && sent) {
+                    break;
+                }
+                si->update(buf.size());
+                co_await sink(stream_sstable_files_cmd::file_data, name, bytes(reinterpret_cast<const int8_t*>(buf.get()), buf.size()));
+                sent = true;
+                if (buf.empty()) {
+                    break;
+                }
+            }
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await in.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    }
+}
+
+future<> send_sstable_files(lw_shared_ptr<send_info> si, sstables::shared_sstable sst) {
+    auto s = si->cf.schema();
+    sslog.debug("[Stream #{}] Start sending sstable {} of ks={}, cf={} as files", si->plan_id, sst->get_filename(), s->ks_name(), s->cf_name());
+    auto [sink, source] = co_await si->ms.make_sink_and_source_for_stream_sstable_files(s->version(), si->plan_id, si->cf_id,
+            sstables::sstable::version_to_sstring(sst->get_version()), sstables::sstable::format_to_sstring(sst->get_format()), si->reason, si->id);
+    auto got_error_from_peer = make_lw_shared<bool>(false);
+
+    auto source_op = [] (rpc::source<int32_t> source, lw_shared_ptr<send_info> si, lw_shared_ptr<bool> got_error_from_peer) -> future<> {
+        while (auto status_opt = co_await source()) {
+            auto status = std::get<0>(*status_opt);
+            *got_error_from_peer = status == -1;
+            sslog.debug("Got status code from peer={}, plan_id={}, cf_id={}, status={}", si->id.addr, si->plan_id, si->cf_id, status);
+        }
+    }(source, si, got_error_from_peer);
+
+    auto sink_op = [] (rpc::sink<stream_sstable_files_cmd, sstring, bytes> sink, lw_shared_ptr<send_info> si, sstables::shared_sstable sst,
+            lw_shared_ptr<bool> got_error_from_peer) -> future<> {
+        std::exception_ptr ex;
+        try {
+            co_await send_sstable_components(si, sst, sink, got_error_from_peer);
+            co_await sink(stream_sstable_files_cmd::end_of_stream, sstring(), bytes());
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        if (ex) {
+            // Notify the receiver the sender has failed
+            try {
+                co_await sink(stream_sstable_files_cmd::error, sstring(), bytes());
+            } catch (...) {
+            }
+        }
+        co_await sink.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    }(sink, si, sst, got_error_from_peer);
+
+    co_await when_all_succeed(std::move(source_op), std::move(sink_op)).discard_result();
+    if (*got_error_from_peer) {
+        throw std::runtime_error(format("Peer failed to load sstable files peer={}, plan_id={}, cf_id={}", si->id.addr, si->plan_id, si->cf_id));
+    }
+}
+
+future<> send_sstables_and_mutation_fragments(lw_shared_ptr<send_info> si) {
+    if (!si->sstables_to_send->empty()) {
+        sslog.info("[Stream #{}] Start sending {} sstables of ks={}, cf={} as files", si->plan_id, si->sstables_to_send->size(),
+                si->cf.schema()->ks_name(), si->cf.schema()->cf_name());
+    }
+    for (auto& sst : *si->sstables_to_send) {
+        co_await send_sstable_files(si, sst);
+    }
+    co_await send_mutation_fragments(si);
+}
+
 future<> stream_transfer_task::execute() {
     auto plan_id = session->plan_id();
     auto cf_id = this->cf_id;
@@ -197,7 +327,12 @@ future<> stream_transfer_task::execute() {
     return sm.container().invoke_on_all([plan_id, cf_id, id, dst_cpu_id, ranges=this->_ranges, reason] (stream_manager& sm) mutable {
         auto& tbl = sm.db().find_column_family(cf_id);
       return sm.db().obtain_reader_permit(tbl, "stream-transfer-task", db::no_timeout).then([&sm, &tbl, plan_id, cf_id, id, dst_cpu_id, ranges=std::move(ranges), reason] (reader_permit permit) mutable {
-        auto si = make_lw_shared<send_info>(sm.ms(), plan_id, tbl, std::move(permit), std::move(ranges), id, dst_cpu_id, reason, [&sm, plan_id, addr = id.addr] (size_t sz) {
+        auto use_file_streaming = sm.db().get_config().enable_sstable_file_streaming() && sm.db().features().stream_sstable_files;
+        auto sstables_to_send = make_lw_shared<sstables::sstable_list>();
+        if (use_file_streaming) {
+            sstables_to_send = select_sstables_to_send(tbl, ranges);
+        }
+        auto si = make_lw_shared<send_info>(sm.ms(), plan_id, tbl, std::move(permit), std::move(ranges), id, dst_cpu_id, reason, std::move(sstables_to_send), [&sm, plan_id, addr = id.addr] (size_t sz) {
             sm.update_progress(plan_id, addr, streaming::progress_info::direction::OUT, sz);
         });
         return si->has_relevant_range_on_this_shard().then([&sm, si, plan_id, cf_id] (bool has_relevant_range_on_this_shard) {
@@ -206,7 +341,7 @@ future<> stream_transfer_task::execute() {
                         plan_id, cf_id, this_shard_id());
                 return make_ready_future<>();
             }
-            return send_mutation_fragments(std::move(si));
+            return send_sstables_and_mutation_fragments(std::move(si));
         }).finally([si] {
             return si->reader.close();
         });
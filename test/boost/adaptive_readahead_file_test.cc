@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/file.hh>
+#include <seastar/util/closeable.hh>
+
+#include "reader_concurrency_semaphore.hh"
+#include "test/lib/eventually.hh"
+
+#include "sstables/adaptive_readahead_file.hh"
+
+using namespace seastar;
+
+// Serves reads of a file of the given size, in which each byte holds the low
+// byte of its offset, and records the reads.
+class recording_file_impl : public file_impl {
+    uint64_t _size;
+public:
+    std::vector<std::pair<uint64_t, size_t>> reads;
+
+    explicit recording_file_impl(uint64_t size) : _size(size) { }
+private:
+    [[noreturn]] void unsupported() {
+        throw_with_backtrace<std::logic_error>("unsupported operation");
+    }
+public:
+    // unsupported
+    virtual future<size_t> write_dma(uint64_t pos, const void* buffer, size_t len, const io_priority_class& pc) override { unsupported(); }
+    virtual future<size_t> write_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override { unsupported(); }
+    virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, const io_priority_class& pc) override { unsupported(); }
+    virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override { unsupported(); }
+    virtual future<> flush(void) override { unsupported(); }
+    virtual future<> truncate(uint64_t length) override { unsupported(); }
+    virtual future<> discard(uint64_t offset, uint64_t length) override { unsupported(); }
+    virtual future<> allocate(uint64_t position, uint64_t length) override { unsupported(); }
+    virtual subscription<directory_entry> list_directory(std::function<future<>(directory_entry)>) override { unsupported(); }
+    virtual future<struct stat> stat(void) override { unsupported(); }
+    virtual std::unique_ptr<seastar::file_handle_impl> dup() override { unsupported(); }
+
+    virtual future<uint64_t> size(void) override { return make_ready_future<uint64_t>(_size); }
+    virtual future<> close() override { return make_ready_future<>(); }
+
+    virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, const io_priority_class& pc) override {
+        reads.emplace_back(offset, range_size);
+        temporary_buffer<uint8_t> buf(offset < _size ? std::min<uint64_t>(range_size, _size - offset) : 0);
+        for (size_t i = 0; i < buf.size(); ++i) {
+            buf.get_write()[i] = uint8_t(offset + i);
+        }
+        return make_ready_future<temporary_buffer<uint8_t>>(std::move(buf));
+    }
+};
+
+SEASTAR_THREAD_TEST_CASE(test_adaptive_readahead_file) {
+    constexpr ssize_t memory = 1024 * 1024;
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 100, memory);
+    auto stop_sem = deferred_stop(semaphore);
+    auto permit = semaphore.obtain_permit(nullptr, get_name(), 0, db::no_timeout).get();
+
+    constexpr size_t buffer_size = 1024;
+    auto impl = make_shared<recording_file_impl>(64 * buffer_size);
+    auto& reads = impl->reads;
+
+    {
+        auto f = sstables::make_adaptive_readahead_file(file(shared_ptr<file_impl>(impl)), permit, buffer_size, 4 * buffer_size);
+
+        auto read = [&] (uint64_t offset, size_t size = buffer_size) {
+            auto buf = f.dma_read_bulk<uint8_t>(offset, size).get0();
+            BOOST_REQUIRE_EQUAL(buf.size(), size);
+            for (size_t i = 0; i < buf.size(); ++i) {
+                BOOST_REQUIRE_EQUAL(buf[i], uint8_t(offset + i));
+            }
+        };
+
+        // The first read can't be told apart from a skip.
+        read(0);
+        BOOST_REQUIRE_EQUAL(reads.size(), 1);
+        BOOST_REQUIRE_EQUAL(reads.back().second, buffer_size);
+
+        // Sequential reads are extended with a growing window and the
+        // following reads are served from memory. Only the data which wasn't
+        // handed out yet is accounted to the permit.
+        read(buffer_size);
+        BOOST_REQUIRE_EQUAL(reads.size(), 2);
+        BOOST_REQUIRE_EQUAL(reads.back().second, 2 * buffer_size);
+        BOOST_REQUIRE_EQUAL(semaphore.available_resources().memory, memory - ssize_t(buffer_size));
+        read(2 * buffer_size);
+        BOOST_REQUIRE_EQUAL(reads.size(), 2);
+        BOOST_REQUIRE_EQUAL(semaphore.available_resources().memory, memory);
+
+        read(3 * buffer_size);
+        BOOST_REQUIRE_EQUAL(reads.size(), 3);
+        BOOST_REQUIRE_EQUAL(reads.back().second, 5 * buffer_size);
+        BOOST_REQUIRE_EQUAL(semaphore.available_resources().memory, memory - ssize_t(4 * buffer_size));
+
+        // A skip collapses the window, and drops the read-ahead data.
+        read(32 * buffer_size);
+        BOOST_REQUIRE_EQUAL(reads.size(), 4);
+        BOOST_REQUIRE_EQUAL(reads.back().second, buffer_size);
+        BOOST_REQUIRE_EQUAL(semaphore.available_resources().memory, memory);
+        read(33 * buffer_size);
+        BOOST_REQUIRE_EQUAL(reads.size(), 5);
+        BOOST_REQUIRE_EQUAL(reads.back().second, 2 * buffer_size);
+
+        // A read which goes past the read-ahead data only reads the rest.
+        read(34 * buffer_size + buffer_size / 2);
+        BOOST_REQUIRE_EQUAL(reads.size(), 6);
+        BOOST_REQUIRE_EQUAL(reads.back().first, 35 * buffer_size);
+        BOOST_REQUIRE_EQUAL(reads.back().second, buffer_size / 2 + 2 * buffer_size);
+        BOOST_REQUIRE_EQUAL(semaphore.available_resources().memory, memory - ssize_t(2 * buffer_size));
+
+        // Short reads at the end of the file.
+        auto buf = f.dma_read_bulk<uint8_t>(63 * buffer_size, 2 * buffer_size).get0();
+        BOOST_REQUIRE_EQUAL(buf.size(), buffer_size);
+        buf = f.dma_read_bulk<uint8_t>(64 * buffer_size, buffer_size).get0();
+        BOOST_REQUIRE_EQUAL(buf.size(), 0);
+
+        f.close().get();
+    }
+
+    // All units should have been deposited back.
+    REQUIRE_EVENTUALLY_EQUAL(memory, semaphore.available_resources().memory);
+}
@@ -333,7 +333,7 @@ BOOST_AUTO_TEST_CASE(test_avx_search) {
         }
     };
 
-    using test_tree = tree<int64_t, unsigned long, int64_compare, 4, key_search::linear>;
+    using test_tree = tree<int64_t, unsigned long, int64_compare, 4, key_search::simd>;
 
     test_tree t(int64_compare{});
 
@@ -355,3 +355,37 @@ BOOST_AUTO_TEST_CASE(test_avx_search) {
     t.clear();
     check_conversions();
 }
+
+struct int64_simple_compare {
+    bool operator()(const int64_t& a, const int64_t& b) const noexcept { return a < b; }
+    int64_t simplify_key(int64_t k) const noexcept { return k; }
+};
+
+template <size_t NodeSize>
+static void test_simd_search_with_node_size() {
+    // The both search checks the simd one against the linear one
+    using test_tree = tree<int64_t, unsigned long, int64_simple_compare, NodeSize, key_search::both, with_debug::yes>;
+
+    test_tree t(int64_simple_compare{});
+
+    t.emplace(std::numeric_limits<int64_t>::min() + 1, 0);
+    t.emplace(std::numeric_limits<int64_t>::max(), 0);
+    for (int64_t k = -500; k < 500; k++) {
+        t.emplace(k * 3, 0);
+    }
+
+    for (int64_t k = -1600; k < 1600; k++) {
+        BOOST_REQUIRE_EQUAL(t.find(k) != t.end(), k % 3 == 0 && k >= -1500 && k < 1500);
+    }
+    BOOST_REQUIRE(t.find(std::numeric_limits<int64_t>::min() + 1) != t.end());
+    BOOST_REQUIRE(t.find(std::numeric_limits<int64_t>::max()) != t.end());
+
+    t.clear();
+}
+
+BOOST_AUTO_TEST_CASE(test_simd_search) {
+    test_simd_search_with_node_size<8>();
+    // Not a multiple of 8, the last 4 keys are compared separately
+    test_simd_search_with_node_size<12>();
+    test_simd_search_with_node_size<16>();
+}
@@ -434,3 +434,43 @@ SEASTAR_THREAD_TEST_CASE(test_invalidation) {
     BOOST_REQUIRE_EQUAL(2, metrics.page_populations);
     BOOST_REQUIRE_EQUAL(0, metrics.page_hits);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_prefetch) {
+    auto page_size = cached_file::page_size;
+    auto file_size = page_size * 4 + 12;
+    test_file tf = make_test_file(file_size);
+
+    cached_file::metrics metrics;
+    logalloc::region region;
+    cached_file cf(tf.f, metrics, cf_lru, region, file_size);
+
+    auto cached_pages = [&] {
+        std::vector<cached_file::page_idx_type> pages;
+        cf.for_each_cached_page([&] (cached_file::page_idx_type idx) {
+            pages.push_back(idx);
+        });
+        return pages;
+    };
+
+    BOOST_REQUIRE_EQUAL(tf.contents.substr(page_size * 2, 1), read_to_string(cf, page_size * 2, 1));
+    BOOST_REQUIRE(cached_pages() == std::vector<cached_file::page_idx_type>({2}));
+
+    metrics = {};
+    cf.prefetch(1, 2, default_priority_class()).get();
+    BOOST_REQUIRE(cached_pages() == std::vector<cached_file::page_idx_type>({1, 2}));
+    BOOST_REQUIRE_EQUAL(1, metrics.page_populations);
+    // Prefetching doesn't count as a cache access.
+    BOOST_REQUIRE_EQUAL(0, metrics.page_misses);
+    BOOST_REQUIRE_EQUAL(0, metrics.page_hits);
+
+    // Pages past the end of the file are ignored.
+    metrics = {};
+    cf.prefetch(0, 10, default_priority_class()).get();
+    BOOST_REQUIRE(cached_pages() == std::vector<cached_file::page_idx_type>({0, 1, 2, 3, 4}));
+    BOOST_REQUIRE_EQUAL(3, metrics.page_populations);
+
+    metrics = {};
+    BOOST_REQUIRE_EQUAL(tf.contents, read_to_string(cf, 0));
+    BOOST_REQUIRE_EQUAL(0, metrics.page_misses);
+    BOOST_REQUIRE_EQUAL(5, metrics.page_hits);
+}
@@ -76,3 +76,31 @@ BOOST_AUTO_TEST_CASE(test_libdeflate_matches_zlib) {
 BOOST_AUTO_TEST_CASE(test_default_matches_zlib) {
     test<zlib_crc32_checksummer, crc32_utils>();
 }
+
+BOOST_AUTO_TEST_CASE(test_checksum_many_matches_checksum) {
+    for (size_t count : {0, 1, 2, 3, 4, 5, 7, 8, 13}) {
+        std::vector<sstring> data;
+        for (size_t i = 0; i < count; ++i) {
+            // Mix buffers below, at, and above the folding thresholds,
+            // and of different lengths within a lane group.
+            data.push_back(make_random_string((i * 977 + count * 31) % 9000));
+        }
+        std::vector<const char*> inputs;
+        std::vector<size_t> input_lens;
+        for (auto& d : data) {
+            inputs.push_back(d.data());
+            input_lens.push_back(d.size());
+        }
+
+        std::vector<uint32_t> checksums(count);
+        checksum_many<crc32_utils>(count, inputs.data(), input_lens.data(), checksums.data());
+        for (size_t i = 0; i < count; ++i) {
+            BOOST_REQUIRE_EQUAL(checksums[i], zlib_crc32_checksummer::checksum(data[i].data(), data[i].size()));
+        }
+
+        checksum_many<adler32_utils>(count, inputs.data(), input_lens.data(), checksums.data());
+        for (size_t i = 0; i < count; ++i) {
+            BOOST_REQUIRE_EQUAL(checksums[i], adler32_utils::checksum(data[i].data(), data[i].size()));
+        }
+    }
+}
@@ -35,6 +35,10 @@
 #include "multishard_mutation_query.hh"
 #include "transport/messages/result_message.hh"
 #include "db/snapshot-ctl.hh"
+#include "test/lib/simple_schema.hh"
+#include "test/lib/eventually.hh"
+#include "readers/from_mutations_v2.hh"
+#include "service/priority_manager.hh"
 
 using namespace std::chrono_literals;
 
@@ -877,6 +881,7 @@ SEASTAR_THREAD_TEST_CASE(reader_concurrency_semaphore_selection_test) {
     scheduling_group_and_expected_semaphore.emplace_back(sched_groups.memtable_scheduling_group, system_semaphore);
     scheduling_group_and_expected_semaphore.emplace_back(sched_groups.memtable_to_cache_scheduling_group, system_semaphore);
     scheduling_group_and_expected_semaphore.emplace_back(sched_groups.gossip_scheduling_group, system_semaphore);
+    scheduling_group_and_expected_semaphore.emplace_back(sched_groups.cache_prefetch_scheduling_group, streaming_semaphore);
     scheduling_group_and_expected_semaphore.emplace_back(unknown_scheduling_group, user_semaphore);
 
     do_with_cql_env_thread([&scheduling_group_and_expected_semaphore] (cql_test_env& e) {
@@ -922,6 +927,7 @@ SEASTAR_THREAD_TEST_CASE(max_result_size_for_unlimited_query_selection_test) {
     scheduling_group_and_expected_max_result_size.emplace_back(sched_groups.memtable_scheduling_group, system_max_result_size);
     scheduling_group_and_expected_max_result_size.emplace_back(sched_groups.memtable_to_cache_scheduling_group, system_max_result_size);
     scheduling_group_and_expected_max_result_size.emplace_back(sched_groups.gossip_scheduling_group, system_max_result_size);
+    scheduling_group_and_expected_max_result_size.emplace_back(sched_groups.cache_prefetch_scheduling_group, maintenance_max_result_size);
     scheduling_group_and_expected_max_result_size.emplace_back(unknown_scheduling_group, user_max_result_size);
 
     do_with_cql_env_thread([&scheduling_group_and_expected_max_result_size] (cql_test_env& e) {
@@ -1103,3 +1109,219 @@ SEASTAR_TEST_CASE(database_drop_column_family_clears_querier_cache) {
         BOOST_REQUIRE_EQUAL(qc.get_stats().population, 0);
     });
 }
+
+SEASTAR_THREAD_TEST_CASE(test_hot_partition_cache) {
+    simple_schema ss;
+    auto s = ss.schema();
+    auto pk = ss.make_pkey(0);
+    mutation m(s, pk);
+    ss.add_row(m, ss.make_ckey(0), "v");
+
+    replica::hot_partition_cache cache;
+    auto cfg = cache.get_config();
+    cfg.min_reads = 3;
+    cache.set_config(cfg);
+    auto cmd = query::read_command(s->id(), s->version(), s->full_slice(), query::max_result_size(query::result_memory_limiter::unlimited_result_size));
+    auto opts = query::result_options::only_result();
+    auto key = replica::hot_partition_cache::key(s, pk);
+
+    BOOST_REQUIRE(!cache.record_read(s, pk));
+    BOOST_REQUIRE(!cache.record_read(s, pk));
+    BOOST_REQUIRE(cache.record_read(s, pk));
+    // Already being copied.
+    BOOST_REQUIRE(!cache.record_read(s, pk));
+    BOOST_REQUIRE(!cache.query(s, cmd, opts, pk));
+
+    BOOST_REQUIRE(cache.complete_replication(key, m));
+    auto res = cache.query(s, cmd, opts, pk);
+    BOOST_REQUIRE(res);
+    assert_that(query::result_set::from_raw_result(s, cmd.slice, *res)).has_size(1);
+    BOOST_REQUIRE(!cache.record_read(s, pk));
+
+    cache.invalidate(s->id(), pk);
+    BOOST_REQUIRE(!cache.query(s, cmd, opts, pk));
+    BOOST_REQUIRE_EQUAL(cache.get_stats().invalidations, 1u);
+
+    // A copy invalidated while it's being made is dropped.
+    BOOST_REQUIRE(cache.record_read(s, pk));
+    cache.invalidate(s->id(), pk);
+    BOOST_REQUIRE(!cache.complete_replication(key, m));
+    BOOST_REQUIRE(!cache.query(s, cmd, opts, pk));
+
+    cache.add_replica_shard(key, 1);
+    cache.add_replica_shard(key, 2);
+    BOOST_REQUIRE(cache.has_replica_shards(s->id()));
+    cache.remove_replica_shard(key, 1);
+    BOOST_REQUIRE(cache.take_replica_shards(key) == std::vector<unsigned>{2});
+    BOOST_REQUIRE(!cache.has_replica_shards(s->id()));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hot_partition_replica_invalidated_by_write) {
+    if (smp::count < 2) {
+        std::cerr << "Cannot run test " << get_name() << " with smp::count < 2" << std::endl;
+        return;
+    }
+    cql_test_config cfg;
+    cfg.db_config->enable_hot_partition_replication(true, utils::config_file::config_source::CommandLine);
+    cfg.db_config->hot_partition_replication_min_reads(1, utils::config_file::config_source::CommandLine);
+
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.cf (pk int, ck int, v int, PRIMARY KEY (pk, ck))").get();
+        auto& db = e.local_db();
+        auto s = db.find_schema("ks", "cf");
+
+        int32_t pk = 0;
+        while (dht::shard_of(*s, dht::get_token(*s, partition_key::from_single_value(*s, int32_type->decompose(pk)))) != this_shard_id()) {
+            ++pk;
+        }
+        auto dk = dht::decorate_key(*s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+        auto make_mutation = [&] (int32_t v) {
+            mutation m(s, dk);
+            m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(0)), "v", data_value(v), api::new_timestamp());
+            return m;
+        };
+        db.apply(s, freeze(make_mutation(1)), tracing::trace_state_ptr(), db::commitlog::force_sync::no, db::no_timeout).get();
+
+        // Read the partition from another shard until it's copied there.
+        const auto reader_shard = (this_shard_id() + 1) % smp::count;
+        auto has_replica = [&, gs = global_schema_ptr(s)] (bool record_read) {
+            return e.db().invoke_on(reader_shard, [gs, dk, record_read] (replica::database& db) {
+                auto s = gs.get();
+                auto cmd = query::read_command(s->id(), s->version(), s->full_slice(), query::max_result_size(query::result_memory_limiter::unlimited_result_size));
+                auto opts = query::result_options::only_result();
+                auto res = record_read ? db.query_hot_partition(s, cmd, opts, dk) : db.hot_partitions().query(s, cmd, opts, dk);
+                return bool(res);
+            }).get0();
+        };
+        BOOST_REQUIRE(eventually_true([&] { return has_replica(true); }));
+
+        // The copy is dropped before the write completes.
+        db.apply(s, freeze(make_mutation(2)), tracing::trace_state_ptr(), db::commitlog::force_sync::no, db::no_timeout).get();
+        BOOST_REQUIRE(!has_replica(false));
+        auto invalidations = e.db().invoke_on(reader_shard, [] (replica::database& db) {
+            return db.hot_partitions().get_stats().invalidations;
+        }).get0();
+        BOOST_REQUIRE_EQUAL(invalidations, 1u);
+    }, cfg).get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hot_partition_replica_invalidated_by_sstable_load) {
+    if (smp::count < 2) {
+        std::cerr << "Cannot run test " << get_name() << " with smp::count < 2" << std::endl;
+        return;
+    }
+    cql_test_config cfg;
+    cfg.db_config->enable_hot_partition_replication(true, utils::config_file::config_source::CommandLine);
+    cfg.db_config->hot_partition_replication_min_reads(1, utils::config_file::config_source::CommandLine);
+
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.cf (pk int, ck int, v int, PRIMARY KEY (pk, ck))").get();
+        auto& db = e.local_db();
+        auto s = db.find_schema("ks", "cf");
+        auto& t = db.find_column_family(s);
+
+        int32_t pk = 0;
+        while (dht::shard_of(*s, dht::get_token(*s, partition_key::from_single_value(*s, int32_type->decompose(pk)))) != this_shard_id()) {
+            ++pk;
+        }
+        auto dk = dht::decorate_key(*s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+        auto make_mutation = [&] (int32_t v) {
+            mutation m(s, dk);
+            m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(0)), "v", data_value(v), api::new_timestamp());
+            return m;
+        };
+        db.apply(s, freeze(make_mutation(1)), tracing::trace_state_ptr(), db::commitlog::force_sync::no, db::no_timeout).get();
+
+        const auto reader_shard = (this_shard_id() + 1) % smp::count;
+        auto has_replica = [&, gs = global_schema_ptr(s)] (bool record_read) {
+            return e.db().invoke_on(reader_shard, [gs, dk, record_read] (replica::database& db) {
+                auto s = gs.get();
+                auto cmd = query::read_command(s->id(), s->version(), s->full_slice(), query::max_result_size(query::result_memory_limiter::unlimited_result_size));
+                auto opts = query::result_options::only_result();
+                auto res = record_read ? db.query_hot_partition(s, cmd, opts, dk) : db.hot_partitions().query(s, cmd, opts, dk);
+                return bool(res);
+            }).get0();
+        };
+        BOOST_REQUIRE(eventually_true([&] { return has_replica(true); }));
+
+        // Data loaded from an sstable, as by streaming, repair or refresh,
+        // drops the copy like a write does.
+        auto sst = t.make_streaming_sstable_for_write();
+        auto permit = db.get_reader_concurrency_semaphore().make_tracking_only_permit(s.get(), "test", db::no_timeout);
+        sst->write_components(make_flat_mutation_reader_from_mutations_v2(s, std::move(permit), {make_mutation(2)}), 1ul, s,
+                db.get_user_sstables_manager().configure_writer("test"), {}, service::get_local_streaming_priority()).get();
+        sst->open_data().get();
+        t.add_sstable_and_update_cache(sst).get();
+        BOOST_REQUIRE(!has_replica(false));
+        auto invalidations = e.db().invoke_on(reader_shard, [] (replica::database& db) {
+            return db.hot_partitions().get_stats().invalidations;
+        }).get0();
+        BOOST_REQUIRE_EQUAL(invalidations, 1u);
+    }, cfg).get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cache_prefetch_of_paged_reads) {
+    cql_test_config cfg;
+    cfg.db_config->cache_prefetch_paged_reads(true, utils::config_file::config_source::CommandLine);
+
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.cf (pk int, ck int, v text, PRIMARY KEY (pk, ck))").get();
+        auto& db = e.local_db();
+        auto s = db.find_schema("ks", "cf");
+        auto& t = db.find_column_family(s);
+
+        int32_t pk = 0;
+        while (dht::shard_of(*s, dht::get_token(*s, partition_key::from_single_value(*s, int32_type->decompose(pk)))) != this_shard_id()) {
+            ++pk;
+        }
+        auto dk = dht::decorate_key(*s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+        mutation m(s, dk);
+        // Large rows, so that the read-ahead of the first page doesn't bring
+        // the second one into the cache. The second page is the last one, so
+        // that the prefetch reaches the end of the partition, and reading the
+        // second page doesn't go past what was prefetched.
+        const auto value = sstring(4096, 'v');
+        const uint64_t page_size = 10;
+        const uint64_t rows = 15;
+        auto make_ck = [&] (int32_t ck) {
+            return clustering_key::from_single_value(*s, int32_type->decompose(ck));
+        };
+        for (int32_t ck = 0; ck < int32_t(rows); ++ck) {
+            m.set_clustered_cell(make_ck(ck), "v", data_value(value), api::new_timestamp());
+        }
+        db.apply(s, freeze(m), tracing::trace_state_ptr(), db::commitlog::force_sync::no, db::no_timeout).get();
+        t.flush().get();
+        t.get_row_cache().invalidate(row_cache::external_updater([] {})).get();
+
+        auto& tracker = db.row_cache_tracker();
+        const auto rows_before = tracker.get_stats().rows;
+        const auto query_uuid = utils::make_random_uuid();
+        const auto pr = dht::partition_range::make_singular(dk);
+        auto cmd = query::read_command(s->id(), s->version(), s->full_slice(), query::max_result_size(query::result_memory_limiter::unlimited_result_size),
+                query::row_limit(page_size), query::partition_limit::max, gc_clock::now(), std::nullopt, query_uuid, query::is_first_page::yes);
+        auto [page1, temp1] = db.query(s, cmd, query::result_options::only_result(), {pr}, nullptr, db::no_timeout).get0();
+        assert_that(query::result_set::from_raw_result(s, cmd.slice, *page1)).has_size(page_size);
+
+        BOOST_REQUIRE(eventually_true([&] { return db.get_stats().cache_prefetched_rows == rows - page_size; }));
+        BOOST_REQUIRE_EQUAL(db.get_stats().cache_prefetches, 1u);
+        BOOST_REQUIRE_GE(tracker.get_stats().rows, rows_before + rows);
+
+        // The second page, as the pager asks for it: same query, starting
+        // after the last row of the first page.
+        auto slice = s->full_slice();
+        auto row_ranges = slice.row_ranges(*s, dk.key());
+        query::trim_clustering_row_ranges_to(*s, row_ranges, make_ck(page_size - 1));
+        slice.set_range(*s, dk.key(), std::move(row_ranges));
+        cmd = query::read_command(s->id(), s->version(), std::move(slice), query::max_result_size(query::result_memory_limiter::unlimited_result_size),
+                query::row_limit(page_size), query::partition_limit::max, gc_clock::now(), std::nullopt, query_uuid, query::is_first_page::no);
+
+        const auto row_hits_before = tracker.get_stats().row_hits;
+        const auto sstable_reads_before = sstables::sstables_stats::get_shard_stats().partition_reads;
+        auto [page2, temp2] = db.query(s, cmd, query::result_options::only_result(), {pr}, nullptr, db::no_timeout).get0();
+        assert_that(query::result_set::from_raw_result(s, cmd.slice, *page2)).has_size(rows - page_size);
+
+        // Served from the cache, none of it from the sstables.
+        BOOST_REQUIRE_GE(tracker.get_stats().row_hits, row_hits_before + (rows - page_size));
+        BOOST_REQUIRE_EQUAL(sstables::sstables_stats::get_shard_stats().partition_reads, sstable_reads_before);
+    }, std::move(cfg)).get();
+}
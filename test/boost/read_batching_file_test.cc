@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/file.hh>
+#include <seastar/core/when_all.hh>
+
+#include "test/lib/random_utils.hh"
+
+#include "sstables/read_batching_file.hh"
+
+using namespace seastar;
+
+// A file which serves its contents from memory, and records the reads
+// submitted to it.
+class memory_file_impl : public file_impl {
+    sstring _contents;
+public:
+    std::vector<std::pair<uint64_t, size_t>> reads;
+    bool fail = false;
+
+    explicit memory_file_impl(sstring contents) : _contents(std::move(contents)) { }
+private:
+    [[noreturn]] void unsupported() {
+        throw_with_backtrace<std::logic_error>("unsupported operation");
+    }
+public:
+    // unsupported
+    virtual future<size_t> write_dma(uint64_t pos, const void* buffer, size_t len, const io_priority_class& pc) override { unsupported(); }
+    virtual future<size_t> write_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override { unsupported(); }
+    virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, const io_priority_class& pc) override { unsupported(); }
+    virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override { unsupported(); }
+    virtual future<> flush(void) override { unsupported(); }
+    virtual future<> truncate(uint64_t length) override { unsupported(); }
+    virtual future<> discard(uint64_t offset, uint64_t length) override { unsupported(); }
+    virtual future<> allocate(uint64_t position, uint64_t length) override { unsupported(); }
+    virtual subscription<directory_entry> list_directory(std::function<future<>(directory_entry)>) override { unsupported(); }
+    virtual future<struct stat> stat(void) override { unsupported(); }
+    virtual std::unique_ptr<seastar::file_handle_impl> dup() override { unsupported(); }
+
+    virtual future<uint64_t> size(void) override { return make_ready_future<uint64_t>(_contents.size()); }
+    virtual future<> close() override { return make_ready_future<>(); }
+
+    virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t size, const io_priority_class& pc) override {
+        reads.emplace_back(offset, size);
+        if (fail) {
+            return make_exception_future<temporary_buffer<uint8_t>>(std::runtime_error("read failed"));
+        }
+        auto start = std::min<uint64_t>(offset, _contents.size());
+        auto end = std::min<uint64_t>(offset + size, _contents.size());
+        return make_ready_future<temporary_buffer<uint8_t>>(temporary_buffer<uint8_t>(reinterpret_cast<const uint8_t*>(_contents.data()) + start, end - start));
+    }
+};
+
+struct test_file {
+    sstring contents;
+    shared_ptr<memory_file_impl> impl;
+    file f;
+
+    test_file(size_t size, size_t max_read_size)
+        : contents(tests::random::get_sstring(size))
+        , impl(make_shared<memory_file_impl>(contents))
+        , f(sstables::make_read_batching_file(file(impl), max_read_size)) {
+    }
+
+    // Issues the reads concurrently, so that they are batched together.
+    std::vector<future<temporary_buffer<char>>> read(std::vector<std::pair<uint64_t, size_t>> ranges) {
+        std::vector<future<temporary_buffer<char>>> futs;
+        for (auto [offset, size] : ranges) {
+            futs.push_back(f.dma_read_bulk<char>(offset, size));
+        }
+        return when_all(futs.begin(), futs.end()).get0();
+    }
+
+    sstring expected(uint64_t offset, size_t size) const {
+        return offset < contents.size() ? contents.substr(offset, size) : sstring();
+    }
+};
+
+static sstring to_sstring(temporary_buffer<char> buf) {
+    return sstring(buf.get(), buf.size());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_overlapping_and_adjacent_reads_are_merged) {
+    test_file tf(64 * 1024, 128 * 1024);
+    auto stats = sstables::get_read_batching_stats();
+
+    // Adjacent, overlapping, and apart from the others.
+    std::vector<std::pair<uint64_t, size_t>> ranges = {{4096, 4096}, {32768, 4096}, {0, 4096}, {2048, 4096}};
+    auto results = tf.read(ranges);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(to_sstring(results[i].get0()), tf.expected(ranges[i].first, ranges[i].second));
+    }
+    auto expected_reads = std::vector<std::pair<uint64_t, size_t>>{{0, 8192}, {32768, 4096}};
+    BOOST_REQUIRE(tf.impl->reads == expected_reads);
+    BOOST_REQUIRE_EQUAL(sstables::get_read_batching_stats().requests, stats.requests + ranges.size());
+    BOOST_REQUIRE_EQUAL(sstables::get_read_batching_stats().submissions, stats.submissions + expected_reads.size());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_merged_reads_are_bounded) {
+    test_file tf(64 * 1024, 8192);
+
+    std::vector<std::pair<uint64_t, size_t>> ranges = {{0, 4096}, {4096, 4096}, {8192, 4096}, {12288, 16384}};
+    auto results = tf.read(ranges);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(to_sstring(results[i].get0()), tf.expected(ranges[i].first, ranges[i].second));
+    }
+    // Larger requests are not split.
+    auto expected_reads = std::vector<std::pair<uint64_t, size_t>>{{0, 8192}, {8192, 4096}, {12288, 16384}};
+    BOOST_REQUIRE(tf.impl->reads == expected_reads);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_merged_read_short_at_eof) {
+    test_file tf(10000, 128 * 1024);
+
+    std::vector<std::pair<uint64_t, size_t>> ranges = {{8192, 4096}, {12288, 4096}};
+    auto results = tf.read(ranges);
+    BOOST_REQUIRE_EQUAL(to_sstring(results[0].get0()), tf.expected(8192, 4096));
+    BOOST_REQUIRE_EQUAL(tf.expected(8192, 4096).size(), 10000 - 8192);
+    // Past the end of the file.
+    BOOST_REQUIRE(results[1].get0().empty());
+    auto expected_reads = std::vector<std::pair<uint64_t, size_t>>{{8192, 8192}};
+    BOOST_REQUIRE(tf.impl->reads == expected_reads);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_merged_read_failure_reaches_every_request) {
+    test_file tf(64 * 1024, 128 * 1024);
+    tf.impl->fail = true;
+
+    auto results = tf.read({{0, 4096}, {2048, 4096}, {4096, 4096}, {32768, 4096}});
+    BOOST_REQUIRE_EQUAL(tf.impl->reads.size(), 2);
+    for (auto& f : results) {
+        BOOST_REQUIRE_THROW(f.get(), std::runtime_error);
+    }
+}
@@ -871,6 +871,109 @@ SEASTAR_TEST_CASE(test_eviction) {
     });
 }
 
+SEASTAR_TEST_CASE(test_tinylfu_admission_keeps_hot_partitions_on_scan) {
+    return seastar::async([] {
+        auto s = make_schema();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        auto mt = make_lw_shared<replica::memtable>(s);
+
+        std::vector<dht::decorated_key> keys;
+        for (int i = 0; i < 100; i++) {
+            auto m = make_new_mutation(s);
+            keys.emplace_back(m.decorated_key());
+            mt->apply(m);
+        }
+        std::sort(keys.begin(), keys.end(), dht::decorated_key::less_comparator(s));
+
+        cache_tracker tracker;
+        tracker.set_admission_policy(cache_tracker::admission_policy::tinylfu);
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        // Read twice, the partition is frequent enough to be admitted.
+        auto& hot = keys.front();
+        for (int i = 0; i < 2; i++) {
+            auto rd = cache.make_reader(s, semaphore.make_permit(), dht::partition_range::make_singular(hot));
+            auto close_rd = deferred_close(rd);
+            rd.fill_buffer().get();
+        }
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().probationary_partition_misses, 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().admitted_partition_hits, 1);
+
+        // The scan reads the hot partition first, so with a plain LRU, it
+        // would be the first one evicted.
+        {
+            auto rd = cache.make_reader(s, semaphore.make_permit(), query::full_partition_range);
+            auto close_rd = deferred_close(rd);
+            while (!rd.is_end_of_stream()) {
+                rd.fill_buffer().get();
+                rd.detach_buffer();
+            }
+        }
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().probationary_partition_misses, keys.size());
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().admitted_partition_hits, 2);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), keys.size());
+
+        while (tracker.partitions() > 1) {
+            BOOST_REQUIRE(tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something);
+        }
+        auto hits = tracker.get_stats().partition_hits;
+        verify_has(cache, hot);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_hits, hits + 1);
+    });
+}
+
+SEASTAR_TEST_CASE(test_cold_partitions_are_compressed) {
+    return seastar::async([] {
+        auto s = make_schema();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        auto mt = make_lw_shared<replica::memtable>(s);
+
+        std::vector<mutation> mutations;
+        for (int i = 0; i < 10; i++) {
+            mutation m(s, new_key(s));
+            m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(to_bytes(sstring(4096, 'v'))), next_timestamp++);
+            mt->apply(m);
+            mutations.push_back(std::move(m));
+        }
+        std::sort(mutations.begin(), mutations.end(), mutation_decorated_key_less_comparator());
+
+        cache_tracker tracker;
+        tracker.set_compress_cold_partitions(true);
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        {
+            auto rd = assert_that(cache.make_reader(s, semaphore.make_permit(), query::full_partition_range));
+            for (auto&& m : mutations) {
+                rd.produces(m);
+            }
+            rd.produces_end_of_stream();
+        }
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_compressions, 0);
+
+        // Every read advances the hand, which sweeps over the partitions until
+        // they're all found cold. The cache is continuous, so reads of missing
+        // partitions don't touch any. A read compresses one partition at most.
+        for (int i = 0; i < 100; i++) {
+            auto compressions = tracker.get_stats().partition_compressions;
+            auto rd = cache.make_reader(s, semaphore.make_permit(), dht::partition_range::make_singular(dht::decorate_key(*s, new_key(s))));
+            auto close_rd = deferred_close(rd);
+            rd.fill_buffer().get();
+            BOOST_REQUIRE_LE(tracker.get_stats().partition_compressions, compressions + 1);
+        }
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().compressed_partitions, mutations.size());
+        BOOST_REQUIRE_GT(tracker.get_stats().compressed_bytes_saved, 0);
+
+        // Every partition is inflated back by its first read.
+        auto inflations = tracker.get_stats().partition_inflations;
+        for (auto&& m : mutations) {
+            assert_that(cache.make_reader(s, semaphore.make_permit(), dht::partition_range::make_singular(m.decorated_key())))
+                .produces(m)
+                .produces_end_of_stream();
+        }
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_inflations, inflations + mutations.size());
+    });
+}
+
 #ifndef SEASTAR_DEFAULT_ALLOCATOR // Depends on eviction, which is absent with the std allocator
 
 SEASTAR_TEST_CASE(test_eviction_from_invalidated) {
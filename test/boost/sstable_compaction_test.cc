@@ -55,11 +55,14 @@
 #include "mutation_writer/partition_based_splitting_writer.hh"
 #include "compaction/table_state.hh"
 #include "mutation_rebuilder.hh"
+#include "db/value_log_extension.hh"
+#include "sstables/value_log.hh"
 
 #include <stdio.h>
 #include <ftw.h>
 #include <unistd.h>
 #include <boost/range/algorithm/find_if.hpp>
+#include <boost/range/join.hpp>
 #include <boost/algorithm/cxx11/all_of.hpp>
 #include <boost/algorithm/cxx11/is_sorted.hpp>
 #include <boost/icl/interval_map.hpp>
@@ -172,16 +175,23 @@ static std::unique_ptr<table_state> make_table_state_for_test(column_family_for_
 
 class strategy_control_for_test : public strategy_control {
     bool _has_ongoing_compaction;
+    bool _read_amplification_exceeded;
 public:
-    explicit strategy_control_for_test(bool has_ongoing_compaction) noexcept : _has_ongoing_compaction(has_ongoing_compaction) {}
+    explicit strategy_control_for_test(bool has_ongoing_compaction, bool read_amplification_exceeded) noexcept
+        : _has_ongoing_compaction(has_ongoing_compaction)
+        , _read_amplification_exceeded(read_amplification_exceeded) {}
 
     bool has_ongoing_compaction(table_state& table_s) const noexcept override {
         return _has_ongoing_compaction;
     }
+
+    bool read_amplification_exceeded(table_state& table_s) const noexcept override {
+        return _read_amplification_exceeded;
+    }
 };
 
-static std::unique_ptr<strategy_control> make_strategy_control_for_test(bool has_ongoing_compaction) {
-    return std::make_unique<strategy_control_for_test>(has_ongoing_compaction);
+static std::unique_ptr<strategy_control> make_strategy_control_for_test(bool has_ongoing_compaction, bool read_amplification_exceeded = false) {
+    return std::make_unique<strategy_control_for_test>(has_ongoing_compaction, read_amplification_exceeded);
 }
 
 SEASTAR_TEST_CASE(compaction_manager_basic_test) {
@@ -1451,6 +1461,50 @@ SEASTAR_TEST_CASE(compaction_with_fully_expired_table) {
     });
 }
 
+SEASTAR_TEST_CASE(fully_expired_sstables_job_test) {
+  return test_env::do_with_async([] (test_env& env) {
+    auto key_and_token_pair = token_generation_for_current_shard(4);
+    auto min_key = key_and_token_pair[0].first;
+    auto max_key = key_and_token_pair[key_and_token_pair.size()-1].first;
+
+    auto t0 = gc_clock::from_time_t(1).time_since_epoch().count();
+    auto t1 = gc_clock::from_time_t(10).time_since_epoch().count();
+    auto t2 = gc_clock::from_time_t(15).time_since_epoch().count();
+    auto t3 = gc_clock::from_time_t(20).time_since_epoch().count();
+
+    // Fully expired sstables are dropped whatever the strategy.
+    for (auto type : {compaction_strategy_type::size_tiered, compaction_strategy_type::leveled, compaction_strategy_type::incremental}) {
+        column_family_for_tests cf(env.manager());
+        auto close_cf = deferred_stop(cf);
+
+        auto sst1 = add_sstable_for_overlapping_test(env, cf, /*gen*/1, min_key, key_and_token_pair[1].first, build_stats(t0, t1, t1));
+        auto sst2 = add_sstable_for_overlapping_test(env, cf, /*gen*/2, min_key, max_key, build_stats(t2, t3, std::numeric_limits<int32_t>::max()));
+        std::vector<sstables::shared_sstable> candidates = { sst1, sst2 };
+
+        auto cs = sstables::make_compaction_strategy(type, {});
+        auto desc = cs.get_fully_expired_sstables_job(cf->as_table_state(), candidates);
+        BOOST_REQUIRE(bool(desc.has_only_fully_expired));
+        BOOST_REQUIRE_EQUAL(desc.sstables.size(), 1);
+        BOOST_REQUIRE(desc.sstables.front() == sst1);
+
+        // The check is rate limited.
+        desc = cs.get_fully_expired_sstables_job(cf->as_table_state(), candidates);
+        BOOST_REQUIRE(desc.sstables.empty());
+    }
+
+    // Nothing to drop if no sstable may be expired.
+    {
+        column_family_for_tests cf(env.manager());
+        auto close_cf = deferred_stop(cf);
+
+        auto sst1 = add_sstable_for_overlapping_test(env, cf, /*gen*/1, min_key, max_key, build_stats(t0, t1, std::numeric_limits<int32_t>::max()));
+        auto cs = sstables::make_compaction_strategy(compaction_strategy_type::size_tiered, {});
+        auto desc = cs.get_fully_expired_sstables_job(cf->as_table_state(), { sst1 });
+        BOOST_REQUIRE(desc.sstables.empty());
+    }
+  });
+}
+
 SEASTAR_TEST_CASE(basic_date_tiered_strategy_test) {
   return test_env::do_with([] (test_env& env) {
     schema_builder builder(make_shared_schema({}, some_keyspace, some_column_family,
@@ -1794,6 +1848,78 @@ SEASTAR_TEST_CASE(time_window_strategy_size_tiered_behavior_correctness) {
     });
 }
 
+// Check that TWCS merges late writes back into past windows, so that they stay single-SSTable.
+SEASTAR_TEST_CASE(time_window_strategy_late_merge_correctness) {
+    using namespace std::chrono;
+
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "time_window_strategy")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+
+        std::map<sstring, sstring> options;
+        time_window_compaction_strategy twcs(options);
+        std::map<api::timestamp_type, std::vector<shared_sstable>> buckets;
+        int min_threshold = 4;
+        int max_threshold = 32;
+        auto window_size = duration_cast<seconds>(hours(1));
+
+        api::timestamp_type current_window_ts = api::timestamp_clock::now().time_since_epoch().count();
+        api::timestamp_type past_window_ts = current_window_ts - duration_cast<microseconds>(seconds(2L * 3600L)).count();
+        auto past_bound = time_window_compaction_strategy::get_window_lower_bound(window_size, past_window_ts);
+
+        int key_index = 0;
+        auto add_sstable_to_past_window = [&] (int partitions) {
+            std::vector<mutation> muts;
+            for (int i = 0; i < partitions; i++) {
+                mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(key_index++))}));
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), past_window_ts);
+                muts.push_back(std::move(m));
+            }
+            buckets[past_bound].push_back(make_sstable_containing(sst_gen, std::move(muts)));
+        };
+
+        column_family_for_tests cf(env.manager(), s);
+        auto close_cf = deferred_stop(cf);
+        auto table_s = make_table_state_for_test(cf, env);
+        auto control = make_strategy_control_for_test(false);
+        auto now = time_window_compaction_strategy::get_window_lower_bound(window_size, current_window_ts);
+
+        // A small late write doesn't justify rewriting the window.
+        add_sstable_to_past_window(100);
+        add_sstable_to_past_window(1);
+        BOOST_REQUIRE(twcs.newest_bucket(*table_s, *control, buckets, min_threshold, max_threshold, now).empty());
+
+        // Neither do many small late writes: they're compacted together by
+        // size-tiered compaction, without the large sstable of the window.
+        add_sstable_to_past_window(1);
+        add_sstable_to_past_window(1);
+        add_sstable_to_past_window(1);
+        auto large = buckets[past_bound].front();
+        auto stcs_job = twcs.newest_bucket(*table_s, *control, buckets, min_threshold, max_threshold, now);
+        BOOST_REQUIRE_EQUAL(stcs_job.size(), 4);
+        BOOST_REQUIRE(std::ranges::find(stcs_job, large) == stcs_job.end());
+
+        // Once late writes make up a large enough share of the window, the
+        // whole window is merged, although its sstables are in different tiers.
+        add_sstable_to_past_window(20);
+        BOOST_REQUIRE_EQUAL(twcs.newest_bucket(*table_s, *control, buckets, min_threshold, max_threshold, now).size(), 6);
+
+        // Merging sstables of a single window doesn't need the segregating interposer.
+        mutation_source_metadata ms_meta;
+        ms_meta.min_timestamp = past_window_ts;
+        ms_meta.max_timestamp = past_window_ts;
+        BOOST_REQUIRE(!twcs.use_interposer_consumer(ms_meta));
+        ms_meta.max_timestamp = current_window_ts;
+        BOOST_REQUIRE(twcs.use_interposer_consumer(ms_meta));
+    });
+}
+
 static void check_min_max_column_names(const sstable_ptr& sst, std::vector<bytes> min_components, std::vector<bytes> max_components) {
     const auto& st = sst->get_stats_metadata();
     BOOST_TEST_MESSAGE(fmt::format("min {}/{} max {}/{}", st.min_column_names.elements.size(), min_components.size(), st.max_column_names.elements.size(), max_components.size()));
@@ -3854,6 +3980,125 @@ SEASTAR_TEST_CASE(sstable_needs_cleanup_test) {
   });
 }
 
+SEASTAR_TEST_CASE(sstable_cleanup_reclaimable_bytes_test) {
+  return test_env::do_with([] (test_env& env) {
+    auto s = make_shared_schema({}, some_keyspace, some_column_family,
+        {{"p1", utf8_type}}, {}, {}, {}, utf8_type);
+
+    auto tokens = token_generation_for_current_shard(10);
+
+    static constexpr uint64_t sst_size = 1000;
+    auto sst_gen = [&env, s, gen = make_lw_shared<unsigned>(1)] (sstring first, sstring last) mutable {
+        auto sst = env.make_sstable(s, "", (*gen)++, la, big);
+        sstables::test(sst).set_values_for_leveled_strategy(sst_size, 0, 0, std::move(first), std::move(last));
+        return sst;
+    };
+    auto key_from_token = [&] (size_t index) -> sstring {
+        return tokens[index].first;
+    };
+    auto token_range = [&] (size_t first, size_t last) -> dht::token_range {
+        return dht::token_range::make(tokens[first].second, tokens[last].second);
+    };
+
+    dht::token_range_vector local_ranges = { token_range(0, 1), token_range(3, 4), token_range(5, 6) };
+
+    // Fully owned: nothing to reclaim.
+    auto sst = sst_gen(key_from_token(0), key_from_token(1));
+    BOOST_REQUIRE(!is_fully_unowned(sst, local_ranges, s));
+    BOOST_REQUIRE_EQUAL(cleanup_reclaimable_bytes(sst, local_ranges, s), 0);
+
+    // Between owned ranges, or past them: dropped whole.
+    auto sst2 = sst_gen(key_from_token(2), key_from_token(2));
+    BOOST_REQUIRE(is_fully_unowned(sst2, local_ranges, s));
+    BOOST_REQUIRE_EQUAL(cleanup_reclaimable_bytes(sst2, local_ranges, s), sst_size);
+
+    auto sst3 = sst_gen(key_from_token(7), key_from_token(9));
+    BOOST_REQUIRE(is_fully_unowned(sst3, local_ranges, s));
+    BOOST_REQUIRE_EQUAL(cleanup_reclaimable_bytes(sst3, local_ranges, s), sst_size);
+
+    // Partially owned: rewritten, part of it is reclaimed.
+    auto sst4 = sst_gen(key_from_token(0), key_from_token(9));
+    BOOST_REQUIRE(!is_fully_unowned(sst4, local_ranges, s));
+    auto reclaimable = cleanup_reclaimable_bytes(sst4, local_ranges, s);
+    BOOST_REQUIRE_GT(reclaimable, 0);
+    BOOST_REQUIRE_LT(reclaimable, sst_size);
+
+    return make_ready_future<>();
+  });
+}
+
+SEASTAR_TEST_CASE(sstable_cleanup_drops_unowned_sstables_test) {
+    cql_test_config test_cfg;
+    test_cfg.db_config->enable_commitlog(false);
+
+    return do_with_cql_env([this] (cql_test_env& cql_env) -> future<> {
+        return test_env::do_with_async([this, &cql_env] (test_env& env) {
+            cell_locker_stats cl_stats;
+
+            auto& db = cql_env.local_db();
+            auto& compaction_manager = db.get_compaction_manager();
+
+            auto s = schema_builder("ks", get_name())
+                    .with_column("pk", utf8_type, column_kind::partition_key)
+                    .with_column("v", int32_type).build();
+
+            auto tmp = tmpdir();
+            auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+                return env.make_sstable(s, tmp.path().string(), (*gen)++);
+            };
+
+            constexpr unsigned unowned_keys = 50;
+            auto keys = make_local_keys(unowned_keys + 2, s);
+            auto make_mutation = [&] (unsigned i) {
+                mutation m(s, partition_key::from_exploded(*s, {to_bytes(keys[i])}));
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("v"), data_value(int32_t(i)), api::new_timestamp());
+                return m;
+            };
+            std::vector<mutation> unowned, partially_owned;
+            for (unsigned i = 0; i < unowned_keys; ++i) {
+                unowned.push_back(make_mutation(i));
+            }
+            partially_owned.push_back(make_mutation(unowned_keys));
+            partially_owned.push_back(make_mutation(unowned_keys + 1));
+            auto unowned_sst = make_sstable_containing(sst_gen, unowned);
+            auto partially_owned_sst = make_sstable_containing(sst_gen, partially_owned);
+
+            auto cfg = column_family_test_config(env.semaphore());
+            cfg.datadir = tmp.path().string();
+            auto table = make_lw_shared<replica::column_family>(s, cfg, replica::column_family::no_commitlog(),
+                compaction_manager, env.manager(), cl_stats, db.row_cache_tracker());
+            auto stop_table = defer([table] {
+                table->stop().get();
+            });
+            table->mark_ready_for_writes();
+            table->start();
+            table->add_sstable_and_update_cache(unowned_sst).get();
+            table->add_sstable_and_update_cache(partially_owned_sst).get();
+
+            // Only the last key is owned.
+            auto owned_token = partially_owned.back().decorated_key().token();
+            dht::token_range_vector owned_ranges = { dht::token_range::make(owned_token, owned_token) };
+            BOOST_REQUIRE(is_fully_unowned(unowned_sst, owned_ranges, s));
+            BOOST_REQUIRE(!is_fully_unowned(partially_owned_sst, owned_ranges, s));
+
+            auto partition_reads_before = sstables::sstables_stats::get_shard_stats().partition_reads;
+            compaction_manager.perform_cleanup(table.get(), owned_ranges).get();
+            auto partition_reads = sstables::sstables_stats::get_shard_stats().partition_reads - partition_reads_before;
+
+            // The unowned sstable is dropped without being read, the partially
+            // owned one is rewritten without its unowned partition.
+            BOOST_REQUIRE_LT(partition_reads, unowned_keys);
+            auto sstables = table->in_strategy_sstables();
+            BOOST_REQUIRE_EQUAL(sstables.size(), 1);
+            BOOST_REQUIRE(sstables.front() != unowned_sst);
+            BOOST_REQUIRE(sstables.front() != partially_owned_sst);
+            assert_that(sstable_reader(sstables.front(), s, env.make_reader_permit()))
+                    .produces(partially_owned.back())
+                    .produces_end_of_stream();
+        });
+    }, test_cfg);
+}
+
 SEASTAR_TEST_CASE(test_twcs_partition_estimate) {
     return test_setup::do_with_tmp_directory([] (test_env& env, sstring tmpdir_path) {
         auto builder = schema_builder("tests", "test_bug_6472")
@@ -3950,6 +4195,238 @@ SEASTAR_TEST_CASE(stcs_reshape_test) {
     });
 }
 
+SEASTAR_TEST_CASE(ics_reshape_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto runs_count = s->max_compaction_threshold();
+        auto key_and_token_pair = token_generation_for_current_shard(runs_count * 2);
+        std::sort(key_and_token_pair.begin(), key_and_token_pair.end(), [] (auto& a, auto& b) { return a.second < b.second; });
+
+        // Every run is made of two fragments with disjoint token ranges.
+        std::vector<shared_sstable> sstables;
+        std::unordered_map<utils::UUID, std::vector<shared_sstable>> runs;
+        auto gen = 1;
+        for (auto i = 0; i < runs_count; i++) {
+            auto run_id = utils::make_random_uuid();
+            for (auto f = 0; f < 2; f++) {
+                auto sst = env.make_sstable(s, "", gen++);
+                sstables::test(sst).set_values(key_and_token_pair[f * runs_count].first, key_and_token_pair[(f + 1) * runs_count - 1].first, stats_metadata{});
+                sstables::test(sst).set_data_file_size(1);
+                sstables::test(sst).set_run_identifier(run_id);
+                runs[run_id].push_back(sst);
+                sstables.push_back(std::move(sst));
+            }
+        }
+
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental,
+                                                    s->compaction_strategy_options());
+        BOOST_REQUIRE_EQUAL(cs.name(), "IncrementalCompactionStrategy");
+
+        auto desc = cs.get_reshaping_job(sstables, s, default_priority_class(), reshape_mode::strict);
+        BOOST_REQUIRE_EQUAL(desc.sstables.size(), sstables.size());
+        BOOST_REQUIRE(desc.max_sstable_bytes < compaction_descriptor::default_max_sstable_bytes);
+
+        // Runs are never split, so the job can release input fragments as soon as they're exhausted.
+        std::vector<shared_sstable> few_runs;
+        for (auto& [run_id, fragments] : runs) {
+            if (few_runs.size() >= 2 * 3) {
+                break;
+            }
+            few_runs.insert(few_runs.end(), fragments.begin(), fragments.end());
+        }
+        BOOST_REQUIRE(cs.get_reshaping_job(few_runs, s, default_priority_class(), reshape_mode::strict).sstables.empty());
+        desc = cs.get_reshaping_job(sstables, s, default_priority_class(), reshape_mode::relaxed);
+        BOOST_REQUIRE_EQUAL(desc.sstables.size(), sstables.size());
+        for (auto& [run_id, fragments] : runs) {
+            auto n = std::ranges::count_if(desc.sstables, [run_id = run_id] (const shared_sstable& sst) { return sst->run_identifier() == run_id; });
+            BOOST_REQUIRE_EQUAL(n, 2);
+        }
+    });
+}
+
+// Synthetic fragments of runs of ks.cf, each of fragment_size bytes, covering disjoint token ranges within a run.
+static std::vector<std::vector<shared_sstable>> make_runs_for_ics_test(test_env& env, column_family_for_tests& cf, unsigned& gen,
+        size_t runs_count, size_t fragments_per_run, uint64_t fragment_size) {
+    auto keys = token_generation_for_current_shard(fragments_per_run);
+    std::sort(keys.begin(), keys.end(), [] (auto& a, auto& b) { return a.second < b.second; });
+    std::vector<std::vector<shared_sstable>> runs;
+    for (size_t i = 0; i < runs_count; i++) {
+        auto run_id = utils::make_random_uuid();
+        runs.emplace_back();
+        for (size_t f = 0; f < fragments_per_run; f++) {
+            auto sst = env.make_sstable(cf.schema(), "", gen++, la, big);
+            sstables::test(sst).set_values(keys[f].first, keys[f].first, stats_metadata{});
+            sstables::test(sst).set_data_file_size(fragment_size);
+            sstables::test(sst).set_run_identifier(run_id);
+            column_family_test(cf).add_sstable(sst);
+            runs.back().push_back(std::move(sst));
+        }
+    }
+    return runs;
+}
+
+SEASTAR_TEST_CASE(ics_bucketing_by_run_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "ics_bucketing_by_run_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type)
+                .set_compaction_strategy(sstables::compaction_strategy_type::incremental)
+                .set_compaction_strategy_options({{"sstable_size_in_mb", "100"}})
+                .build();
+        column_family_for_tests cf(env.manager(), s);
+        auto close_cf = deferred_stop(cf);
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, s->compaction_strategy_options());
+        auto table_s = make_table_state_for_test(cf, env);
+        auto strategy_c = make_strategy_control_for_test(false);
+        BOOST_REQUIRE_EQUAL(s->min_compaction_threshold(), 4);
+
+        // Four runs of 400MB made of 100MB fragments, and three runs of a single 200MB fragment.
+        // Runs are tiered on their size, so the small runs are in a tier of their own even though
+        // their fragments are larger.
+        constexpr uint64_t mb = 1024 * 1024;
+        unsigned gen = 1;
+        auto large_runs = make_runs_for_ics_test(env, cf, gen, 4, 4, 100 * mb);
+        auto small_runs = make_runs_for_ics_test(env, cf, gen, 3, 1, 200 * mb);
+        std::vector<shared_sstable> candidates;
+        for (auto& run : boost::range::join(large_runs, small_runs)) {
+            candidates.insert(candidates.end(), run.begin(), run.end());
+        }
+
+        auto desc = cs.get_sstables_for_compaction(*table_s, *strategy_c, candidates);
+        BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, 100 * mb);
+        BOOST_REQUIRE_EQUAL(desc.sstables.size(), 16);
+        for (auto& run : large_runs) {
+            for (auto& sst : run) {
+                BOOST_REQUIRE(std::ranges::find(desc.sstables, sst) != desc.sstables.end());
+            }
+        }
+
+        // A run some fragments of which are not candidates, e.g. because they are being compacted,
+        // is left out as a whole, so the tier of large runs is no longer interesting.
+        auto partial = candidates;
+        partial.erase(std::ranges::find(partial, large_runs.front().front()));
+        BOOST_REQUIRE(cs.get_sstables_for_compaction(*table_s, *strategy_c, partial).sstables.empty());
+
+        // Once reads touch too many sstables, the two tiers are merged, still without the partial run.
+        desc = cs.get_sstables_for_compaction(*table_s, *make_strategy_control_for_test(false, true), partial);
+        BOOST_REQUIRE_EQUAL(desc.sstables.size(), 3 * 4 + 3);
+        for (auto& sst : large_runs.front()) {
+            BOOST_REQUIRE(std::ranges::find(desc.sstables, sst) == desc.sstables.end());
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(ics_backlog_tracker_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "ics_backlog_tracker_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type)
+                .set_compaction_strategy(sstables::compaction_strategy_type::incremental)
+                .build();
+        column_family_for_tests cf(env.manager(), s);
+        auto close_cf = deferred_stop(cf);
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, s->compaction_strategy_options());
+        auto& tracker = cs.get_backlog_tracker();
+        auto fragments = [] (const std::vector<std::vector<shared_sstable>>& runs) {
+            std::vector<shared_sstable> ret;
+            for (auto& run : runs) {
+                ret.insert(ret.end(), run.begin(), run.end());
+            }
+            return ret;
+        };
+
+        constexpr uint64_t mb = 1024 * 1024;
+        unsigned gen = 1;
+
+        // The fragments of a single run don't contribute any backlog, even though
+        // there are more of them than min_threshold.
+        auto large_run = make_runs_for_ics_test(env, cf, gen, 1, 16, 100 * mb);
+        tracker.replace_sstables({}, fragments(large_run));
+        BOOST_REQUIRE_EQUAL(tracker.backlog(), 0);
+
+        // Runs of similar size do.
+        auto runs = make_runs_for_ics_test(env, cf, gen, 4, 4, 100 * mb);
+        tracker.replace_sstables({}, fragments(runs));
+        BOOST_REQUIRE_GT(tracker.backlog(), 0);
+
+        // And they no longer do once compacted into a single run.
+        auto output = make_runs_for_ics_test(env, cf, gen, 1, 16, 100 * mb);
+        tracker.replace_sstables(fragments(runs), fragments(output));
+        BOOST_REQUIRE_EQUAL(tracker.backlog(), 0);
+    });
+}
+
+// Every job of ICS is made of whole runs and writes fragments of sstable_size_in_mb,
+// so input fragments are released as soon as the output covers them, well before the
+// compaction is done.
+SEASTAR_TEST_CASE(ics_exhausted_fragments_released_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "ics_exhausted_fragments_released_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", bytes_type)
+                .set_compressor_params(compression_parameters::no_compression())
+                .set_compaction_strategy(sstables::compaction_strategy_type::incremental)
+                .set_compaction_strategy_options({{"sstable_size_in_mb", "1"}})
+                .build();
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+        column_family_for_tests cf(env.manager(), s);
+        auto close_cf = deferred_stop(cf);
+        cf->mark_ready_for_writes();
+        cf->start();
+
+        // Every partition is larger than a fragment, so the output has a fragment per partition.
+        auto make_insert = [&] (const std::pair<sstring, dht::token>& key) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key.first)}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(tests::random::get_bytes(1024 * 1024)), 1 /* ts */);
+            return m;
+        };
+
+        // Four runs of two fragments. The first fragments of all runs come before their second ones.
+        constexpr size_t runs_count = 4;
+        auto keys = token_generation_for_current_shard(runs_count * 2);
+        std::sort(keys.begin(), keys.end(), [] (auto& a, auto& b) { return a.second < b.second; });
+        std::vector<shared_sstable> candidates;
+        for (size_t i = 0; i < runs_count; i++) {
+            auto run_id = utils::make_random_uuid();
+            for (size_t f = 0; f < 2; f++) {
+                auto sst = make_sstable_containing(sst_gen, {make_insert(keys[f * runs_count + i])});
+                sstables::test(sst).set_run_identifier(run_id);
+                column_family_test(cf).add_sstable(sst);
+                candidates.push_back(std::move(sst));
+            }
+        }
+
+        auto& cs = cf->get_compaction_strategy();
+        auto table_s = make_table_state_for_test(cf, env);
+        auto desc = cs.get_sstables_for_compaction(*table_s, *make_strategy_control_for_test(false), candidates);
+        BOOST_REQUIRE_EQUAL(desc.sstables.size(), candidates.size());
+        BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, 1024 * 1024);
+
+        std::vector<std::vector<shared_sstable>> released;
+        auto replacer = [&] (sstables::compaction_completion_desc desc) {
+            if (!desc.old_sstables.empty()) {
+                released.push_back(std::move(desc.old_sstables));
+            }
+        };
+        auto result = compact_sstables(cf.get_compaction_manager(), std::move(desc), *cf, sst_gen, replacer).get0();
+        BOOST_REQUIRE_EQUAL(result.new_sstables.size(), keys.size());
+
+        // Every input fragment is released once, as soon as the output fragment of its last
+        // partition is sealed.
+        BOOST_REQUIRE_EQUAL(released.size(), candidates.size());
+        std::unordered_set<shared_sstable> all_released;
+        for (size_t i = 0; i < released.size(); i++) {
+            BOOST_REQUIRE_EQUAL(released[i].size(), 1);
+            BOOST_REQUIRE(released[i].front()->get_last_decorated_key().tri_compare(*s, result.new_sstables[i]->get_last_decorated_key()) == 0);
+            BOOST_REQUIRE(all_released.insert(released[i].front()).second);
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(lcs_reshape_test) {
     return test_env::do_with_async([] (test_env& env) {
         simple_schema ss;
@@ -4811,6 +5288,379 @@ SEASTAR_TEST_CASE(test_major_does_not_miss_data_in_memtable) {
     });
 }
 
+SEASTAR_TEST_CASE(test_compaction_raw_partition_copy) {
+    return test_env::do_with_async([] (test_env& env) {
+        test_db_config.compaction_raw_partition_copy(true);
+        auto reset_config = defer([] {
+            test_db_config.compaction_raw_partition_copy(false);
+        });
+
+        auto s = schema_builder("tests", "test_compaction_raw_partition_copy")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("value", bytes_type)
+                .build();
+
+        auto tmp = tmpdir();
+        column_family_for_tests cf(env.manager(), s, tmp.path().string());
+        auto close_cf = deferred_stop(cf);
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+
+        constexpr unsigned keys = 200;
+        auto tokens = token_generation_for_shard(keys, this_shard_id(), test_db_config.murmur3_partitioner_ignore_msb_bits(), smp::count);
+        auto make_mutation = [&] (unsigned i, api::timestamp_type ts) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(tokens[i].first)}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(bytes(2048, int8_t(ts))), ts);
+            return m;
+        };
+
+        // Two disjoint sstables, serialized against the same bases, so their
+        // partitions can be copied verbatim, and a third one which overlaps with
+        // one partition of the first, splitting its partitions into two runs.
+        std::vector<mutation> first, second;
+        for (unsigned i = 0; i < keys / 2; ++i) {
+            first.push_back(make_mutation(i, 1));
+            second.push_back(make_mutation(keys / 2 + i, 1));
+        }
+        auto overlapping = make_mutation(keys / 4, 2);
+
+        std::vector<shared_sstable> sstables = {
+            make_sstable_containing(sst_gen, first),
+            make_sstable_containing(sst_gen, second),
+            make_sstable_containing(sst_gen, {overlapping}),
+        };
+        for (auto& sst : sstables) {
+            column_family_test(cf).add_sstable(sst);
+        }
+
+        auto expected = first;
+        expected.insert(expected.end(), second.begin(), second.end());
+        expected[keys / 4].apply(overlapping);
+
+        auto ret = compact_sstables(cf.get_compaction_manager(), sstables::compaction_descriptor(sstables, default_priority_class()), *cf, sst_gen).get0();
+        BOOST_REQUIRE_EQUAL(ret.new_sstables.size(), 1);
+        // The partitions outside of the overlapping one are copied verbatim.
+        BOOST_REQUIRE_GT(ret.partitions_copied, 0);
+        BOOST_REQUIRE_LT(ret.partitions_copied, expected.size());
+        BOOST_REQUIRE_GT(ret.bytes_copied, 0);
+        auto reader = assert_that(sstable_reader(ret.new_sstables.front(), s, env.make_reader_permit()));
+        for (auto& m : expected) {
+            reader.produces(m);
+        }
+        reader.produces_end_of_stream();
+
+        auto& stats = ret.new_sstables.front()->get_stats_metadata();
+        BOOST_REQUIRE_EQUAL(stats.min_timestamp, 1);
+        BOOST_REQUIRE_EQUAL(stats.max_timestamp, 2);
+    });
+}
+
+SEASTAR_TEST_CASE(test_compaction_value_log) {
+    return test_env::do_with_async([] (test_env& env) {
+        db::value_log_options options;
+        options.enabled = true;
+        options.min_value_size = 1024;
+        auto s = schema_builder("tests", "test_compaction_value_log")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("value", bytes_type)
+                .with_value_log_options(options)
+                .build();
+
+        auto tmp = tmpdir();
+        column_family_for_tests cf(env.manager(), s, tmp.path().string());
+        auto close_cf = deferred_stop(cf);
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+
+        constexpr unsigned keys = 20;
+        auto tokens = token_generation_for_shard(keys, this_shard_id(), test_db_config.murmur3_partitioner_ignore_msb_bits(), smp::count);
+        // Large values go to the value log, small ones stay in the data file.
+        auto make_mutation = [&] (unsigned i, api::timestamp_type ts) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(tokens[i].first)}));
+            auto size = i % 2 ? 4096 : 16;
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(bytes(size, int8_t(i + ts))), ts);
+            return m;
+        };
+
+        // The timestamps of the sstables don't overlap, so none of their cells
+        // can tie with a cell of another one.
+        std::vector<mutation> first, second;
+        for (unsigned i = 0; i < keys / 2; ++i) {
+            first.push_back(make_mutation(i, 1));
+            second.push_back(make_mutation(keys / 2 + i, 2));
+        }
+        // Shadows a large value of the first sstable, leaving garbage in its value log.
+        auto overwrite = make_mutation(1, 3);
+
+        std::vector<shared_sstable> sstables = {
+            make_sstable_containing(sst_gen, first),
+            make_sstable_containing(sst_gen, second),
+            make_sstable_containing(sst_gen, {overwrite}),
+        };
+        std::vector<utils::UUID> value_logs;
+        for (auto& sst : sstables) {
+            BOOST_REQUIRE_EQUAL(sst->value_logs().size(), 1);
+            value_logs.push_back(sst->value_logs().front());
+            column_family_test(cf).add_sstable(sst);
+        }
+        assert_that(sstable_reader(sstables[0], s, env.make_reader_permit())).produces(first).produces_end_of_stream();
+
+        auto expected = first;
+        expected.insert(expected.end(), second.begin(), second.end());
+        expected[1].apply(overwrite);
+
+        // The output points into the value logs of the inputs, rather than
+        // copying their values to a value log of its own.
+        auto ret = compact_sstables(cf.get_compaction_manager(), sstables::compaction_descriptor(sstables, default_priority_class()), *cf, sst_gen).get0();
+        BOOST_REQUIRE_EQUAL(ret.new_sstables.size(), 1);
+        auto out = ret.new_sstables.front();
+        auto out_logs = out->value_logs();
+        std::ranges::sort(out_logs);
+        std::ranges::sort(value_logs);
+        BOOST_REQUIRE(out_logs == value_logs);
+        for (auto& id : out_logs) {
+            BOOST_REQUIRE(file_exists(out->value_log_filename(id)).get0());
+        }
+        assert_that(sstable_reader(out, s, env.make_reader_permit())).produces(expected).produces_end_of_stream();
+
+        // The overwritten value is garbage in the value log of the first sstable.
+        auto garbage_ratios = value_log_garbage_ratios(sstable_list{out});
+        BOOST_REQUIRE_CLOSE(garbage_ratios.at(sstables[0]->value_logs().front()), 0.2, 0.001);
+        BOOST_REQUIRE_EQUAL(garbage_ratios.at(sstables[2]->value_logs().front()), 0);
+    });
+}
+
+SEASTAR_TEST_CASE(test_compaction_value_log_timestamp_tie) {
+    return test_env::do_with_async([] (test_env& env) {
+        db::value_log_options options;
+        options.enabled = true;
+        options.min_value_size = 1024;
+        auto s = schema_builder("tests", "test_compaction_value_log_timestamp_tie")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("value", bytes_type)
+                .with_value_log_options(options)
+                .build();
+
+        auto tmp = tmpdir();
+        column_family_for_tests cf(env.manager(), s, tmp.path().string());
+        auto close_cf = deferred_stop(cf);
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+
+        auto key = partition_key::from_exploded(*s, {to_bytes(make_local_key(s))});
+        auto make_mutation = [&] (int8_t fill) {
+            mutation m(s, key);
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(bytes(4096, fill)), 1);
+            return m;
+        };
+        // Cells with the same timestamp are reconciled by their values, which
+        // the pointers into the value logs don't order the same way for
+        // every pair of sstables.
+        for (int8_t fill = 1; fill < 8; ++fill) {
+            auto lower = make_mutation(fill);
+            auto greater = make_mutation(fill + 1);
+            std::vector<shared_sstable> sstables = {
+                make_sstable_containing(sst_gen, {lower}),
+                make_sstable_containing(sst_gen, {greater}),
+            };
+            for (auto& sst : sstables) {
+                column_family_test(cf).add_sstable(sst);
+            }
+            auto ret = compact_sstables(cf.get_compaction_manager(), sstables::compaction_descriptor(sstables, default_priority_class()), *cf, sst_gen).get0();
+            BOOST_REQUIRE_EQUAL(ret.new_sstables.size(), 1);
+            assert_that(sstable_reader(ret.new_sstables.front(), s, env.make_reader_permit())).produces(greater).produces_end_of_stream();
+            column_family_test(cf).rebuild_sstable_list({}, sstables);
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_tombstone_density_compaction) {
+    return test_env::do_with_async([] (test_env& env) {
+        test_db_config.compaction_raw_partition_copy(true);
+        auto reset_config = defer([] {
+            test_db_config.compaction_raw_partition_copy(false);
+        });
+
+        auto s = schema_builder("tests", "test_tombstone_density_compaction")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("value", bytes_type)
+                .build();
+
+        auto tmp = tmpdir();
+        column_family_for_tests cf(env.manager(), s, tmp.path().string());
+        auto close_cf = deferred_stop(cf);
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+
+        // The first partitions are deleted long ago, the others are live, so
+        // the tombstones are concentrated in the first token range.
+        constexpr unsigned keys = 400;
+        constexpr unsigned deleted = 100;
+        auto tokens = token_generation_for_shard(keys, this_shard_id(), test_db_config.murmur3_partitioner_ignore_msb_bits(), smp::count);
+        auto deletion_time = gc_clock::now() - s->gc_grace_seconds() * 2;
+        std::vector<mutation> mutations, live;
+        for (unsigned i = 0; i < keys; ++i) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(tokens[i].first)}));
+            if (i < deleted) {
+                m.partition().apply(tombstone(1, deletion_time));
+            } else {
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(bytes(2048, int8_t(i))), 1);
+                live.push_back(m);
+            }
+            mutations.push_back(std::move(m));
+        }
+        auto sst = make_sstable_containing(sst_gen, mutations);
+        column_family_test(cf).add_sstable(sst);
+
+        auto* td = sst->get_scylla_metadata()->get_tombstone_density();
+        BOOST_REQUIRE(td);
+        auto& segments = td->segments.elements;
+        BOOST_REQUIRE_GT(segments.size(), 1);
+        BOOST_REQUIRE_EQUAL(segments.front().first_token, mutations.front().token().raw());
+        BOOST_REQUIRE_EQUAL(segments.back().last_token, mutations.back().token().raw());
+        BOOST_REQUIRE_EQUAL(segments.front().tombstones, deleted);
+        uint64_t data_size = 0;
+        for (auto& seg : segments) {
+            BOOST_REQUIRE_EQUAL(seg.data_offset, data_size);
+            data_size += seg.data_size;
+        }
+        BOOST_REQUIRE_EQUAL(data_size, sst->data_size());
+
+        // The droppable tombstones are diluted by the live data of the whole
+        // sstable, but not by the one of their token range.
+        auto gc_before = sst->get_gc_before_for_drop_estimation(gc_clock::now());
+        BOOST_REQUIRE_LT(sst->estimate_droppable_tombstone_ratio(gc_before), 0.5);
+        BOOST_REQUIRE_GT(sst->estimate_droppable_tombstone_ratio_of_densest_range(gc_before), 0.5);
+
+        sstables::test(sst).set_data_file_write_time(db_clock::time_point::min());
+        auto table_s = make_table_state_for_test(cf, env);
+        auto strategy_c = make_strategy_control_for_test(false);
+        auto get_job = [&] (sstring density_threshold) {
+            std::map<sstring, sstring> options;
+            options.emplace("tombstone_threshold", "0.5");
+            options.emplace("tombstone_density_threshold", density_threshold);
+            auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, options);
+            return cs.get_sstables_for_compaction(*table_s, *strategy_c, { sst });
+        };
+        BOOST_REQUIRE(get_job("1.5").sstables.empty());
+        auto descriptor = get_job("0.5");
+        BOOST_REQUIRE_EQUAL(descriptor.sstables.size(), 1);
+        BOOST_REQUIRE(descriptor.sstables.front() == sst);
+
+        // Only the dense range is compacted, the partitions of the others are
+        // copied, and the output keeps no tombstone.
+        auto ret = compact_sstables(cf.get_compaction_manager(), sstables::compaction_descriptor({ sst }, default_priority_class()), *cf, sst_gen).get0();
+        BOOST_REQUIRE_EQUAL(ret.new_sstables.size(), 1);
+        auto out = ret.new_sstables.front();
+        assert_that(sstable_reader(out, s, env.make_reader_permit())).produces(live).produces_end_of_stream();
+        for (auto& seg : out->get_scylla_metadata()->get_tombstone_density()->segments.elements) {
+            BOOST_REQUIRE_EQUAL(seg.tombstones, 0);
+        }
+        BOOST_REQUIRE_EQUAL(out->estimate_droppable_tombstone_ratio_of_densest_range(gc_before), 0);
+    });
+}
+
+SEASTAR_TEST_CASE(test_token_range_restricted_compaction) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "test_token_range_restricted_compaction")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type)
+                .build();
+
+        auto tmp = tmpdir();
+        column_family_for_tests cf(env.manager(), s, tmp.path().string());
+        auto close_cf = deferred_stop(cf);
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+
+        // Two overlapping sstables, the second one overwrites every other key
+        // of the first.
+        constexpr unsigned keys = 100;
+        auto tokens = token_generation_for_current_shard(keys);
+        std::vector<mutation> older, newer, merged;
+        for (unsigned i = 0; i < keys; ++i) {
+            auto make = [&] (int32_t value, api::timestamp_type ts) {
+                mutation m(s, partition_key::from_exploded(*s, {to_bytes(tokens[i].first)}));
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(value), ts);
+                return m;
+            };
+            older.push_back(make(i, 1));
+            if (i % 2) {
+                newer.push_back(make(-i, 2));
+            }
+            merged.push_back(i % 2 ? make(-i, 2) : make(i, 1));
+        }
+        auto sst1 = make_sstable_containing(sst_gen, older);
+        auto sst2 = make_sstable_containing(sst_gen, newer);
+        column_family_test(cf).add_sstable(sst1);
+        column_family_test(cf).add_sstable(sst2);
+
+        // Compact the sstables in two disjoint token ranges, which together
+        // cover the ring. Each sub-job only sees the partitions of its range,
+        // and passes the inputs to the replacer only once done.
+        auto mid = merged[keys / 2].token();
+        auto ranges = dht::token_range_vector{
+            dht::token_range::make_ending_with({mid, false}),
+            dht::token_range::make_starting_with({mid, true}),
+        };
+        std::vector<shared_sstable> outputs;
+        for (unsigned i = 0; i < ranges.size(); ++i) {
+            auto descriptor = sstables::compaction_descriptor({ sst1, sst2 }, default_priority_class());
+            descriptor.token_range = ranges[i];
+            unsigned replacements = 0;
+            auto replacer = [&] (sstables::compaction_completion_desc desc) {
+                ++replacements;
+                BOOST_REQUIRE_EQUAL(desc.old_sstables.size(), 2);
+            };
+            auto ret = compact_sstables(cf.get_compaction_manager(), std::move(descriptor), *cf, sst_gen, replacer).get0();
+            BOOST_REQUIRE_EQUAL(replacements, 1);
+            BOOST_REQUIRE_EQUAL(ret.new_sstables.size(), 1);
+            auto out = ret.new_sstables.front();
+            auto begin = i ? merged.begin() + keys / 2 : merged.begin();
+            auto end = i ? merged.end() : merged.begin() + keys / 2;
+            assert_that(sstable_reader(out, s, env.make_reader_permit())).produces(std::vector<mutation>(begin, end)).produces_end_of_stream();
+            outputs.push_back(std::move(out));
+        }
+        BOOST_REQUIRE(outputs[0]->get_last_decorated_key().token() < outputs[1]->get_first_decorated_key().token());
+
+        // Scrub can't be restricted to a token range.
+        auto scrub = sstables::compaction_descriptor({ sst1 }, default_priority_class(), 0, sstables::compaction_descriptor::default_max_sstable_bytes,
+                utils::make_random_uuid(), sstables::compaction_type_options::make_scrub(sstables::compaction_type_options::scrub::mode::abort));
+        scrub.token_range = ranges[0];
+        BOOST_REQUIRE_THROW(compact_sstables(cf.get_compaction_manager(), std::move(scrub), *cf, sst_gen).get(), std::runtime_error);
+    });
+}
+
+SEASTAR_TEST_CASE(test_size_tiered_read_amplification_control) {
+    return test_env::do_with_async([] (test_env& env) {
+        column_family_for_tests cf(env.manager());
+        auto close_cf = deferred_stop(cf);
+        auto keys = token_generation_for_current_shard(2);
+
+        // Two tiers of two sstables, neither of which reaches min_threshold.
+        constexpr uint64_t mb = 1024 * 1024;
+        std::vector<shared_sstable> candidates;
+        for (auto size : {100 * mb, 100 * mb, 250 * mb, 250 * mb}) {
+            candidates.push_back(sstable_for_overlapping_test(env, cf->schema(), candidates.size() + 1, keys[0].first, keys[1].first));
+            sstables::test(candidates.back()).set_values_for_leveled_strategy(size, 0, 0, keys[0].first, keys[1].first);
+        }
+
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {});
+        auto table_s = make_table_state_for_test(cf, env);
+        BOOST_REQUIRE_EQUAL(cf->schema()->min_compaction_threshold(), 4);
+        BOOST_REQUIRE(cs.get_sstables_for_compaction(*table_s, *make_strategy_control_for_test(false), candidates).sstables.empty());
+
+        // Once reads touch too many sstables, the neighbouring tiers are merged.
+        auto descriptor = cs.get_sstables_for_compaction(*table_s, *make_strategy_control_for_test(false, true), candidates);
+        BOOST_REQUIRE_EQUAL(descriptor.sstables.size(), candidates.size());
+    });
+}
+
 SEASTAR_TEST_CASE(simple_backlog_controller_test) {
     auto run_controller_test = [] (sstables::compaction_strategy_type compaction_strategy_type, test_env& env) {
         /////////////
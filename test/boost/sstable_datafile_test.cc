@@ -3149,3 +3149,79 @@ SEASTAR_TEST_CASE(test_index_fast_forwarding_after_eof) {
         return make_ready_future<>();
     });
 }
+
+SEASTAR_TEST_CASE(test_zstd_dictionary_compression) {
+    return test_setup::do_with_tmp_directory([] (test_env& env, sstring tmpdir_path) {
+        simple_schema ss;
+        auto s = schema_builder(ss.schema()).set_compressor_params(compression_parameters({
+            {compression_parameters::SSTABLE_COMPRESSION, "ZstdDictionaryCompressor"},
+            {compression_parameters::CHUNK_LENGTH_KB, "4"},
+            {"dictionary_size_in_kb", "4"},
+        })).build();
+        auto& v_def = *s->get_column_definition(to_bytes("v"));
+
+        std::vector<mutation> muts;
+        for (auto& pk : ss.make_pkeys(1000)) {
+            mutation m(s, pk);
+            auto value = format("{{\"id\": {}, \"name\": \"user-{}\", \"status\": \"active\", \"tags\": [\"a\", \"b\"]}}",
+                    muts.size(), muts.size());
+            m.set_clustered_cell(ss.make_ckey(0), v_def, atomic_cell::make_live(*v_def.type, 1, serialized(value)));
+            muts.push_back(std::move(m));
+        }
+
+        auto sst = make_sstable_containing([&] {
+            return env.make_sstable(s, tmpdir_path, 1, sstables::get_highest_sstable_version(), big);
+        }, muts);
+        BOOST_REQUIRE(sst->has_component(component_type::CompressionDictionary));
+
+        auto loaded = env.reusable_sst(s, tmpdir_path, 1).get0();
+        BOOST_REQUIRE(loaded->has_component(component_type::CompressionDictionary));
+        BOOST_REQUIRE(!loaded->get_compression().dictionary.value.empty());
+
+        auto rd = assert_that(loaded->as_mutation_source().make_reader_v2(s, env.make_reader_permit()));
+        for (auto& m : muts) {
+            rd.produces(m);
+        }
+        rd.produces_end_of_stream();
+
+        return make_ready_future<>();
+    });
+}
+
+SEASTAR_TEST_CASE(test_split_block_bloom_filter) {
+    return test_setup::do_with_tmp_directory([] (test_env& env, sstring tmpdir_path) {
+        simple_schema ss;
+        auto s = schema_builder(ss.schema()).set_bloom_filter_format("split_block").build();
+        BOOST_REQUIRE(s->split_block_bloom_filter());
+
+        std::vector<mutation> muts;
+        for (auto& pk : ss.make_pkeys(100)) {
+            mutation m(s, pk);
+            ss.add_row(m, ss.make_ckey(0), "v");
+            muts.push_back(std::move(m));
+        }
+
+        auto sst = make_sstable_containing([&] {
+            return env.make_sstable(s, tmpdir_path, 1, sstables::get_highest_sstable_version(), big);
+        }, muts);
+        BOOST_REQUIRE(sst->get_scylla_metadata()->get_filter_format() == sstables::filter_format_type::split_block);
+
+        auto loaded = env.reusable_sst(s, tmpdir_path, 1).get0();
+        BOOST_REQUIRE(loaded->get_scylla_metadata()->get_filter_format() == sstables::filter_format_type::split_block);
+        size_t absent_hits = 0;
+        for (auto& m : muts) {
+            BOOST_REQUIRE(loaded->filter_has_key(*s, m.decorated_key()));
+        }
+        for (int i = 0; i < 1000; ++i) {
+            absent_hits += loaded->filter_has_key(*s, ss.make_pkey(format("absent-{}", i)));
+        }
+        // About 10 are expected at the default 1% false-positive chance.
+        BOOST_REQUIRE_LT(absent_hits, 50);
+
+        assert_that(loaded->as_mutation_source().make_reader_v2(s, env.make_reader_permit()))
+            .produces(muts)
+            .produces_end_of_stream();
+
+        return make_ready_future<>();
+    });
+}
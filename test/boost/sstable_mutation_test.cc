@@ -1002,6 +1002,69 @@ SEASTAR_TEST_CASE(test_promoted_index_blocks_are_monotonic_with_auto_scaling) {
     });
 }
 
+SEASTAR_TEST_CASE(test_promoted_index_within_read_budget) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto dir = tmpdir();
+        schema_builder builder("ks", "cf");
+        builder.with_column("p", utf8_type, column_kind::partition_key);
+        builder.with_column("c1", int32_type, column_kind::clustering_key);
+        builder.with_column("c2", int32_type, column_kind::clustering_key);
+        builder.with_column("v", int32_type);
+        auto s = builder.build();
+
+        auto dk = dht::decorate_key(*s, partition_key::from_exploded(*s, {to_bytes(make_local_key(s))}));
+        auto cell = atomic_cell::make_live(*int32_type, 1, int32_type->decompose(88), { });
+        mutation m(s, dk);
+
+        for (int i = 1; i <= 1024; i++) {
+          auto ck = clustering_key::from_exploded(*s, {int32_type->decompose(i), int32_type->decompose(i*2)});
+          m.set_clustered_cell(ck, *s->get_column_definition("v"), atomic_cell(*int32_type, cell));
+        }
+
+        m.partition().apply_row_tombstone(*s, range_tombstone(
+                clustering_key_prefix::from_exploded(*s, {int32_type->decompose(100)}),
+                bound_kind::excl_start,
+                clustering_key_prefix::from_exploded(*s, {int32_type->decompose(200)}),
+                bound_kind::incl_end,
+                {1, gc_clock::now()}));
+
+        auto mt = make_lw_shared<replica::memtable>(s);
+        mt->apply(m);
+        sstable_writer_config cfg = env.manager().configure_writer();
+        cfg.promoted_index_block_size = 1;
+        cfg.promoted_index_read_budget = 1024;
+
+        auto sst = make_sstable_easy(env, dir.path(), mt, cfg);
+        assert_that(get_index_reader(sst, env.make_reader_permit())).has_monotonic_positions(*s);
+
+        // One block per row would take well over the budget, merging keeps
+        // it within it.
+        auto entries = sstables::test(sst).read_indexes(env.make_reader_permit()).get0();
+        BOOST_REQUIRE_EQUAL(entries.size(), 1);
+        BOOST_REQUIRE_GT(entries[0].promoted_index_size, 0);
+        BOOST_REQUIRE_LE(entries[0].promoted_index_size, cfg.promoted_index_read_budget);
+
+        // A clustering lookup reads the whole promoted index at once.
+        auto single_reads = promoted_index_cache_metrics.single_reads;
+        auto ck = clustering_key::from_exploded(*s, {int32_type->decompose(150), int32_type->decompose(300)});
+        auto slice = partition_slice_builder(*s).with_range(query::clustering_range::make_singular(ck)).build();
+        assert_that(sst->as_mutation_source().make_reader_v2(s, env.make_reader_permit(), dht::partition_range::make_singular(dk), slice))
+                .produces(m, slice.get_all_ranges())
+                .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(promoted_index_cache_metrics.single_reads, single_reads + 1);
+
+        // Even a budget which no two blocks fit in leaves a promoted index,
+        // rather than merging its blocks down to one.
+        auto tiny_dir = tmpdir();
+        cfg.promoted_index_read_budget = 1;
+        auto tiny_sst = make_sstable_easy(env, tiny_dir.path(), mt, cfg);
+        assert_that(get_index_reader(tiny_sst, env.make_reader_permit())).has_monotonic_positions(*s);
+        entries = sstables::test(tiny_sst).read_indexes(env.make_reader_permit()).get0();
+        BOOST_REQUIRE_EQUAL(entries.size(), 1);
+        BOOST_REQUIRE_GT(entries[0].promoted_index_size, 0);
+    });
+}
+
 SEASTAR_TEST_CASE(test_promoted_index_blocks_are_monotonic_compound_dense) {
    return test_env::do_with_async([] (test_env& env) {
       for (const auto version : writable_sstable_versions) {
@@ -9,6 +9,9 @@
 
 #include <seastar/testing/test_case.hh>
 
+#include <boost/algorithm/cxx11/any_of.hpp>
+#include <boost/range/algorithm/sort.hpp>
+
 #include "sstables/sstable_set_impl.hh"
 #include "sstables/sstable_set.hh"
 #include "sstables/sstables.hh"
@@ -81,3 +84,54 @@ SEASTAR_TEST_CASE(test_time_series_sstable_set_read_modify_write) {
         return make_ready_future<>();
     });
 }
+
+SEASTAR_TEST_CASE(test_sstable_set_select_by_pk) {
+    return test_setup::do_with_tmp_directory([] (test_env& env, sstring tmpdir_path) {
+        simple_schema ss;
+        auto s = ss.schema();
+        fs::path tmp(tmpdir_path);
+        sstable_writer_config cfg = env.manager().configure_writer("");
+
+        // Interleave the keys between two sstables with overlapping ranges.
+        auto pks = ss.make_pkeys(40);
+        std::vector<mutation> muts[2];
+        for (size_t i = 0; i < pks.size(); ++i) {
+            auto mut = mutation(s, pks[i]);
+            ss.add_row(mut, ss.make_ckey(0), "val");
+            muts[i % 2].push_back(std::move(mut));
+        }
+        std::vector<shared_sstable> ssts;
+        for (int i = 0; i < 2; ++i) {
+            auto mr = make_flat_mutation_reader_from_mutations_v2(s, env.make_reader_permit(), std::move(muts[i]));
+            ssts.push_back(make_sstable_easy(env, tmp, std::move(mr), cfg, i + 1));
+        }
+        auto set = make_sstable_set(s, make_lw_shared<sstable_list>({ssts[0], ssts[1]}));
+
+        auto keys = pks;
+        for (int i = 0; i < 10; ++i) {
+            keys.push_back(ss.make_pkey(format("absent-{}", i)));
+        }
+        auto selected = set.select_by_pk(keys);
+        BOOST_REQUIRE_EQUAL(selected.size(), keys.size());
+
+        auto cmp = dht::ring_position_comparator(*s);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            // Must agree with probing the sstables one key at a time.
+            std::vector<shared_sstable> expected;
+            for (auto& sst : set.select(dht::partition_range::make_singular(keys[i]))) {
+                if (cmp(keys[i], sst->get_first_decorated_key()) >= 0 && cmp(keys[i], sst->get_last_decorated_key()) <= 0
+                        && sst->filter_has_key(*s, keys[i].key())) {
+                    expected.push_back(sst);
+                }
+            }
+            boost::sort(expected);
+            boost::sort(selected[i]);
+            BOOST_REQUIRE(selected[i] == expected);
+            if (i < pks.size()) {
+                BOOST_REQUIRE(boost::algorithm::any_of_equal(selected[i], ssts[i % 2]));
+            }
+        }
+
+        return make_ready_future<>();
+    });
+}
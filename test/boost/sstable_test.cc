@@ -19,18 +19,22 @@
 #include "sstables/key.hh"
 #include "test/lib/sstable_utils.hh"
 #include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
 #include "schema.hh"
 #include "compress.hh"
 #include "replica/database.hh"
 #include <memory>
 #include "test/boost/sstable_test.hh"
 #include "test/lib/tmpdir.hh"
+#include "test/lib/log.hh"
 #include "partition_slice_builder.hh"
 #include "test/lib/test_services.hh"
 #include "cell_locking.hh"
 #include "sstables/sstable_mutation_reader.hh"
+#include "sstables/summary_learned_index.hh"
 
 #include <boost/range/combine.hpp>
+#include <random>
 
 using namespace sstables;
 
@@ -872,3 +876,48 @@ BOOST_AUTO_TEST_CASE(test_empty_key_view_comparison) {
     BOOST_CHECK_EQUAL(0, lf.size());
     BOOST_CHECK(lf.begin() == lf.end());
 }
+
+SEASTAR_THREAD_TEST_CASE(test_summary_learned_index) {
+    std::mt19937_64 rng(std::random_device{}());
+    auto make_entries = [&] (size_t n, auto token_gen) {
+        std::vector<int64_t> tokens(n);
+        std::generate(tokens.begin(), tokens.end(), token_gen);
+        std::sort(tokens.begin(), tokens.end());
+        utils::chunked_vector<summary_entry> entries;
+        for (auto t : tokens) {
+            entries.push_back(summary_entry{dht::token(dht::token::kind::key, t), bytes_view(), 0});
+        }
+        return entries;
+    };
+    std::vector<utils::chunked_vector<summary_entry>> inputs;
+    // Murmur3-like, uniformly distributed tokens.
+    inputs.push_back(make_entries(100000, [&] { return int64_t(rng()); }));
+    // Clustered tokens with many duplicates.
+    inputs.push_back(make_entries(100000, [&] { return int64_t(rng() % 1000) * (rng() % 2 ? 1 : 1000000); }));
+    inputs.push_back(make_entries(1, [&] { return int64_t(rng()); }));
+    inputs.push_back(make_entries(0, [&] { return int64_t(0); }));
+
+    for (auto& entries : inputs) {
+        for (uint64_t max_error : {1, 16, 64}) {
+            auto index = summary_learned_index::build(entries, max_error).get0();
+            testlog.info("{} entries, max_error={}: {} segments", entries.size(), max_error, index.segments().size());
+            auto check = [&] (int64_t t) {
+                auto token = dht::token(dht::token::kind::key, t);
+                uint64_t expected = std::distance(entries.begin(), std::lower_bound(entries.begin(), entries.end(), token,
+                        [] (const summary_entry& e, const dht::token& t) { return e.token < t; }));
+                auto [lo, hi] = index.search_window(token);
+                BOOST_REQUIRE_LE(lo, expected);
+                BOOST_REQUIRE_GE(hi, expected);
+                BOOST_REQUIRE_LE(hi - lo, 2 * max_error + 3);
+            };
+            for (auto& e : entries) {
+                check(e.token.raw());
+            }
+            for (int i = 0; i < 100000; ++i) {
+                check(int64_t(rng()));
+            }
+            check(std::numeric_limits<int64_t>::max());
+            check(std::numeric_limits<int64_t>::min() + 1);
+        }
+    }
+}
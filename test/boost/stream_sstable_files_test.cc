@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <filesystem>
+#include <deque>
+#include <set>
+
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "test/lib/cql_test_env.hh"
+#include "test/lib/cql_assertions.hh"
+#include "test/lib/eventually.hh"
+
+#include "replica/database.hh"
+#include "sstables/sstables.hh"
+#include "streaming/stream_manager.hh"
+#include "transport/messages/result_message.hh"
+
+using namespace streaming;
+
+using sstable_file_chunk = std::tuple<stream_sstable_files_cmd, sstring, bytes>;
+
+static constexpr size_t keys = 10;
+
+// Creates ks.src and ks.dst, with the same columns, and fills ks.src with
+// keys owned by this shard, so that its sstable here holds all of them.
+static std::vector<int32_t> populate_source(cql_test_env& e) {
+    e.execute_cql("create table ks.src (pk int primary key, v int)").get();
+    e.execute_cql("create table ks.dst (pk int primary key, v int)").get();
+    auto s = e.local_db().find_schema("ks", "src");
+    std::vector<int32_t> pks;
+    for (int32_t pk = 0; pks.size() < keys; ++pk) {
+        if (dht::shard_of(*s, dht::get_token(*s, partition_key::from_single_value(*s, int32_type->decompose(pk)))) != this_shard_id()) {
+            continue;
+        }
+        e.execute_cql(format("insert into ks.src (pk, v) values ({}, {})", pk, pk)).get();
+        pks.push_back(pk);
+    }
+    e.local_db().find_column_family("ks", "src").flush().get();
+    return pks;
+}
+
+// Returns the commands which send the component files of the sstable of
+// ks.src on this shard, like send_sstable_components() does.
+static std::deque<sstable_file_chunk> read_source_sstable(cql_test_env& e) {
+    auto ssts = e.local_db().find_column_family("ks", "src").get_sstables();
+    BOOST_REQUIRE_EQUAL(ssts->size(), 1);
+    auto sst = *ssts->begin();
+    std::deque<sstable_file_chunk> chunks;
+    for (auto& [type, name] : sst->all_components()) {
+        auto f = open_file_dma(sst->filename(sst->get_dir(), sst->get_schema()->ks_name(), sst->get_schema()->cf_name(),
+                sst->get_version(), sst->generation(), sst->get_format(), name), open_flags::ro).get0();
+        auto size = f.size().get0();
+        auto in = make_file_input_stream(std::move(f));
+        auto buf = in.read_exactly(size).get0();
+        in.close().get();
+        chunks.emplace_back(stream_sstable_files_cmd::file_data, name, bytes(reinterpret_cast<const int8_t*>(buf.get()), buf.size()));
+    }
+    chunks.emplace_back(stream_sstable_files_cmd::end_of_stream, sstring(), bytes());
+    return chunks;
+}
+
+static future<> receive(cql_test_env& e, std::deque<sstable_file_chunk> chunks, stream_reason reason) {
+    auto sst = *e.local_db().find_column_family("ks", "src").get_sstables()->begin();
+    auto s = e.local_db().find_schema("ks", "dst");
+    return e.stream_manager().local().receive_sstable_files(utils::make_random_uuid(), gms::inet_address("127.0.0.2"), s,
+            sstables::sstable::version_to_sstring(sst->get_version()), sstables::sstable::format_to_sstring(sst->get_format()), reason,
+            [chunks = std::move(chunks)] () mutable {
+        std::optional<sstable_file_chunk> chunk;
+        if (!chunks.empty()) {
+            chunk = std::move(chunks.front());
+            chunks.pop_front();
+        }
+        return make_ready_future<std::optional<sstable_file_chunk>>(std::move(chunk));
+    });
+}
+
+static std::set<std::string> table_files(cql_test_env& e) {
+    std::set<std::string> files;
+    for (auto& entry : std::filesystem::directory_iterator(std::string(e.local_db().find_column_family("ks", "dst").dir()))) {
+        if (entry.is_regular_file()) {
+            files.insert(entry.path().filename().native());
+        }
+    }
+    return files;
+}
+
+// The files of the sstables of ks.dst which were moved out of staging.
+static std::set<std::string> loaded_sstable_files(cql_test_env& e) {
+    std::set<std::string> files;
+    for (auto& sst : *e.local_db().find_column_family("ks", "dst").get_sstables()) {
+        if (sst->requires_view_building()) {
+            continue;
+        }
+        for (auto& [type, name] : sst->all_components()) {
+            files.insert(std::filesystem::path(std::string(sst->filename(type))).filename().native());
+        }
+    }
+    return files;
+}
+
+static void require_rows(cql_test_env& e, const sstring& table, const std::vector<int32_t>& pks) {
+    std::vector<std::vector<bytes_opt>> rows;
+    for (auto pk : pks) {
+        rows.push_back({int32_type->decompose(pk), int32_type->decompose(pk)});
+    }
+    assert_that(e.execute_cql(format("select pk, v from ks.{}", table)).get0()).is_rows().with_rows_ignore_order(std::move(rows));
+}
+
+// An sstable owned by a single shard is loaded as is.
+SEASTAR_TEST_CASE(test_receive_sstable_files_loads_sstable) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto pks = populate_source(e);
+        receive(e, read_source_sstable(e), stream_reason::rebuild).get();
+
+        require_rows(e, "dst", pks);
+        auto ssts = e.local_db().find_column_family("ks", "dst").get_sstables();
+        BOOST_REQUIRE_EQUAL(ssts->size(), 1);
+        // Written by the memtable flush of ks.src, not rewritten by streaming.
+        BOOST_REQUIRE_EQUAL((*ssts->begin())->get_origin(), "memtable");
+    });
+}
+
+// The data of an sstable which must go through the view update path is
+// distributed like streamed mutation fragments, and the received sstable
+// is removed.
+SEASTAR_TEST_CASE(test_receive_sstable_files_distributes_sstable) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto pks = populate_source(e);
+        e.execute_cql("create materialized view ks.dst_by_v as select * from ks.dst where v is not null and pk is not null primary key (v, pk)").get();
+        auto files = table_files(e);
+        receive(e, read_source_sstable(e), stream_reason::repair).get();
+
+        require_rows(e, "dst", pks);
+        auto ssts = e.local_db().find_column_family("ks", "dst").get_sstables();
+        BOOST_REQUIRE_EQUAL(ssts->size(), 1);
+        BOOST_REQUIRE_EQUAL((*ssts->begin())->get_origin(), "streaming");
+        // The received sstable is removed, only the one written by
+        // streaming remains, in staging until the view is updated.
+        eventually([&] {
+            auto expected = files;
+            expected.merge(loaded_sstable_files(e));
+            BOOST_REQUIRE(table_files(e) == expected);
+        });
+        eventually([&] {
+            require_rows(e, "dst_by_v", pks);
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_receive_sstable_files_rejects_invalid_component) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        populate_source(e);
+        auto files = table_files(e);
+        for (auto name : {"../x-Data.db", "", "TemporaryTOC.txt"}) {
+            auto chunks = read_source_sstable(e);
+            // Preceded by a valid component, which must be removed too.
+            chunks.emplace(chunks.begin() + 1, stream_sstable_files_cmd::file_data, name, bytes(1, int8_t(0)));
+            BOOST_REQUIRE_THROW(receive(e, std::move(chunks), stream_reason::rebuild).get(), std::runtime_error);
+            BOOST_REQUIRE(table_files(e) == files);
+        }
+        BOOST_REQUIRE(e.local_db().find_column_family("ks", "dst").get_sstables()->empty());
+    });
+}
+
+SEASTAR_TEST_CASE(test_receive_sstable_files_removes_partial_files) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        populate_source(e);
+        auto files = table_files(e);
+
+        // The sender fails half way.
+        auto chunks = read_source_sstable(e);
+        chunks.resize(chunks.size() / 2);
+        chunks.emplace_back(stream_sstable_files_cmd::error, sstring(), bytes());
+        BOOST_REQUIRE_THROW(receive(e, std::move(chunks), stream_reason::rebuild).get(), std::runtime_error);
+        BOOST_REQUIRE(table_files(e) == files);
+
+        // The stream is closed without end_of_stream.
+        chunks = read_source_sstable(e);
+        chunks.pop_back();
+        BOOST_REQUIRE_THROW(receive(e, std::move(chunks), stream_reason::rebuild).get(), std::runtime_error);
+        BOOST_REQUIRE(table_files(e) == files);
+
+        BOOST_REQUIRE(e.local_db().find_column_family("ks", "dst").get_sstables()->empty());
+    });
+}
@@ -108,6 +108,23 @@ BOOST_AUTO_TEST_CASE(test_top_k_single_value) {
 
 //---------------------------------------------------------------------------------------------
 
+BOOST_AUTO_TEST_CASE(test_top_k_guaranteed_count) {
+    top_k_t top(2);
+
+    top.append(1, 5);
+    top.append(2, 3);
+    BOOST_REQUIRE_EQUAL(top.guaranteed_count(1), 5u);
+    BOOST_REQUIRE_EQUAL(top.guaranteed_count(2), 3u);
+    BOOST_REQUIRE_EQUAL(top.guaranteed_count(3), 0u);
+
+    // 3 takes the place of 2, and inherits its count as error
+    top.append(3);
+    BOOST_REQUIRE_EQUAL(top.guaranteed_count(2), 0u);
+    BOOST_REQUIRE_EQUAL(top.guaranteed_count(3), 1u);
+}
+
+//---------------------------------------------------------------------------------------------
+
 struct bad_boy {
     unsigned n;
     bad_boy(unsigned n) : n(n) {}
@@ -84,6 +84,7 @@ future<scheduling_groups> get_scheduling_groups() {
         _scheduling_groups->memtable_scheduling_group = co_await create_scheduling_group("memtable", 1000);
         _scheduling_groups->memtable_to_cache_scheduling_group = co_await create_scheduling_group("memtable_to_cache", 200);
         _scheduling_groups->gossip_scheduling_group = co_await create_scheduling_group("gossip", 1000);
+        _scheduling_groups->cache_prefetch_scheduling_group = co_await create_scheduling_group("cache_prefetch", 100);
     }
     co_return *_scheduling_groups;
 }
@@ -132,6 +133,7 @@ class single_node_cql_env : public cql_test_env {
     sharded<service::migration_manager>& _mm;
     sharded<db::batchlog_manager>& _batchlog_manager;
     sharded<gms::gossiper>& _gossiper;
+    sharded<streaming::stream_manager>& _stream_manager;
     service::raft_group0_client& _group0_client;
 
 private:
@@ -184,6 +186,7 @@ class single_node_cql_env : public cql_test_env {
             sharded<qos::service_level_controller> &sl_controller,
             sharded<db::batchlog_manager>& batchlog_manager,
             sharded<gms::gossiper>& gossiper,
+            sharded<streaming::stream_manager>& stream_manager,
             service::raft_group0_client& client)
             : _db(db)
             , _qp(qp)
@@ -195,6 +198,7 @@ class single_node_cql_env : public cql_test_env {
             , _mm(mm)
             , _batchlog_manager(batchlog_manager)
             , _gossiper(gossiper)
+            , _stream_manager(stream_manager)
             , _group0_client(client)
     {
         adjust_rlimit();
@@ -411,6 +415,10 @@ class single_node_cql_env : public cql_test_env {
         return _gossiper;
     }
 
+    virtual sharded<streaming::stream_manager>& stream_manager() override {
+        return _stream_manager;
+    }
+
     virtual service::raft_group0_client& get_raft_group0_client() override {
         return _group0_client;
     }
@@ -643,6 +651,7 @@ class single_node_cql_env : public cql_test_env {
             dbcfg.memtable_scheduling_group = scheduling_groups.memtable_scheduling_group;
             dbcfg.memtable_to_cache_scheduling_group = scheduling_groups.memtable_to_cache_scheduling_group;
             dbcfg.gossip_scheduling_group = scheduling_groups.gossip_scheduling_group;
+            dbcfg.cache_prefetch_scheduling_group = scheduling_groups.cache_prefetch_scheduling_group;
             dbcfg.sstables_format = sstables::from_string(cfg->sstable_format());
 
             db.start(std::ref(*cfg), dbcfg, std::ref(mm_notif), std::ref(feature_service), std::ref(token_metadata), std::ref(abort_sources), std::ref(sst_dir_semaphore), utils::cross_shard_barrier()).get();
@@ -838,7 +847,7 @@ class single_node_cql_env : public cql_test_env {
                 // The default user may already exist if this `cql_test_env` is starting with previously populated data.
             }
 
-            single_node_cql_env env(db, qp, auth_service, view_builder, view_update_generator, mm_notif, mm, std::ref(sl_controller), bm, gossiper, group0_client);
+            single_node_cql_env env(db, qp, auth_service, view_builder, view_update_generator, mm_notif, mm, std::ref(sl_controller), bm, gossiper, stream_manager, group0_client);
             env.start().get();
             auto stop_env = defer([&env] { env.stop().get(); });
 
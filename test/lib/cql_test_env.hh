@@ -46,6 +46,10 @@ namespace cql3 {
     class query_processor;
 }
 
+namespace streaming {
+class stream_manager;
+}
+
 namespace service {
 
 class client_state;
@@ -71,6 +75,7 @@ struct scheduling_groups {
     scheduling_group memtable_scheduling_group;
     scheduling_group memtable_to_cache_scheduling_group;
     scheduling_group gossip_scheduling_group;
+    scheduling_group cache_prefetch_scheduling_group;
 };
 
 // Creating and destroying scheduling groups on each env setup and teardown
@@ -162,6 +167,8 @@ class cql_test_env {
 
     virtual sharded<gms::gossiper>& gossiper() = 0;
 
+    virtual sharded<streaming::stream_manager>& stream_manager() = 0;
+
     virtual future<> refresh_client_state() = 0;
 
     virtual service::raft_group0_client& get_raft_group0_client() = 0;
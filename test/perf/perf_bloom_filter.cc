@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "utils/bloom_filter.hh"
+#include "utils/bloom_calculations.hh"
+#include "bytes.hh"
+
+#include <seastar/core/align.hh>
+#include <seastar/testing/perf_tests.hh>
+
+#include <array>
+#include <iostream>
+#include <span>
+#include <vector>
+
+// Lookup cost and false-positive rate of the classic and the split block
+// bloom filter layouts at equal memory. The filters are sized for the
+// classic layout at the given false-positive chance, and are large enough
+// not to fit in the CPU caches, which is where the single cache line probed
+// by the split block layout pays off.
+struct bloom_filter_test {
+    static constexpr int64_t nr_keys = 4 * 1024 * 1024;
+    static constexpr size_t nr_probes = 64 * 1024;
+    static constexpr int64_t nr_fp_probes = 1024 * 1024;
+    static constexpr double fp_chance = 0.01;
+
+    utils::filter_ptr classic;
+    utils::filter_ptr split_block;
+    std::vector<utils::hashed_key> present_keys;
+    std::vector<utils::hashed_key> absent_keys;
+    size_t next = 0;
+
+    static utils::hashed_key key(int64_t i) {
+        return utils::make_hashed_key(bytes_view(reinterpret_cast<const int8_t*>(&i), sizeof(i)));
+    }
+
+    // Bypasses large_bitset's allocation path, which requires a seastar thread.
+    static large_bitset make_bitset(size_t nr_bits) {
+        utils::chunked_vector<uint64_t> storage;
+        storage.resize(nr_bits / 64);
+        return large_bitset(nr_bits, std::move(storage));
+    }
+
+    static double false_positive_rate(utils::i_filter& f, const std::vector<utils::hashed_key>& keys) {
+        size_t fp = 0;
+        for (auto& k : keys) {
+            fp += f.is_present(k);
+        }
+        return double(fp) / keys.size();
+    }
+
+    bloom_filter_test() {
+        auto spec = utils::bloom_calculations::compute_bloom_spec(
+                utils::bloom_calculations::max_buckets_per_element(nr_keys), fp_chance);
+        auto nr_bits = align_up<int64_t>(nr_keys * spec.buckets_per_element + utils::bloom_calculations::EXCESS, 64);
+        classic = utils::filter::create_filter(spec.K, make_bitset(nr_bits), utils::filter_format::m_format);
+        auto split_block_bits = align_down<int64_t>(nr_bits, utils::filter::split_block_bloom_filter::bits_per_block);
+        split_block = utils::filter::create_filter(0, make_bitset(split_block_bits), utils::filter_format::split_block_format);
+
+        for (int64_t i = 0; i < nr_keys; ++i) {
+            int64_t k = i * 2;
+            auto kv = bytes_view(reinterpret_cast<const int8_t*>(&k), sizeof(k));
+            classic->add(kv);
+            split_block->add(kv);
+        }
+        for (size_t i = 0; i < nr_probes; ++i) {
+            present_keys.push_back(key(2 * ((i * 7919) % nr_keys)));
+        }
+        // Odd numbers were never inserted.
+        std::vector<utils::hashed_key> fp_keys;
+        for (int64_t i = 0; i < nr_fp_probes; ++i) {
+            fp_keys.push_back(key(2 * i + 1));
+        }
+        absent_keys.assign(fp_keys.begin(), fp_keys.begin() + nr_probes);
+
+        std::cout << "classic: " << nr_bits / 8 << " bytes, " << spec.K << " hashes, false positive rate "
+                << false_positive_rate(*classic, fp_keys) << "\n";
+        std::cout << "split_block: " << split_block_bits / 8 << " bytes, false positive rate "
+                << false_positive_rate(*split_block, fp_keys) << "\n";
+        std::cout << "split_block sized for " << fp_chance << ": "
+                << utils::filter::split_block_bloom_filter::num_bits(nr_keys, fp_chance) / 8 << " bytes\n";
+    }
+
+    bool probe(utils::i_filter& f, const std::vector<utils::hashed_key>& keys) {
+        auto& k = keys[next++ % keys.size()];
+        return f.is_present(k);
+    }
+
+    // Probes batch_size keys with a single i_filter::are_present() call, so
+    // the reported time is for batch_size lookups.
+    static constexpr size_t batch_size = 64;
+    std::array<bool, batch_size> batch_present;
+
+    void probe_batch(utils::i_filter& f, const std::vector<utils::hashed_key>& keys) {
+        auto first = (next++ * batch_size) % keys.size();
+        f.are_present(std::span(keys).subspan(first, batch_size), batch_present);
+        perf_tests::do_not_optimize(batch_present);
+    }
+};
+
+PERF_TEST_F(bloom_filter_test, perf_classic_present) {
+    perf_tests::do_not_optimize(probe(*classic, present_keys));
+}
+
+PERF_TEST_F(bloom_filter_test, perf_split_block_present) {
+    perf_tests::do_not_optimize(probe(*split_block, present_keys));
+}
+
+PERF_TEST_F(bloom_filter_test, perf_classic_absent) {
+    perf_tests::do_not_optimize(probe(*classic, absent_keys));
+}
+
+PERF_TEST_F(bloom_filter_test, perf_split_block_absent) {
+    perf_tests::do_not_optimize(probe(*split_block, absent_keys));
+}
+
+PERF_TEST_F(bloom_filter_test, perf_classic_absent_batched) {
+    probe_batch(*classic, absent_keys);
+}
+
+PERF_TEST_F(bloom_filter_test, perf_split_block_absent_batched) {
+    probe_batch(*split_block, absent_keys);
+}
@@ -53,3 +53,64 @@ PERF_TEST_F(crc_test, perf_zlib_crc32_checksum) {
     perf_tests::do_not_optimize(
         zlib_crc32_checksummer::checksum(data.data(), data.size()));
 }
+
+// Throughput comparison of checksumming a batch of sstable-sized chunks one
+// by one against checksumming them together with checksum_many(). Each test
+// processes the same 64 KiB, so the iteration times compare directly.
+template <size_t ChunkSize>
+struct crc_chunks_test {
+    static constexpr size_t total_size = 64 * 1024;
+    static constexpr size_t chunk_count = total_size / ChunkSize;
+
+    const sstring data = make_random_string(total_size);
+    std::array<const char*, chunk_count> inputs;
+    std::array<size_t, chunk_count> input_lens;
+    std::array<uint32_t, chunk_count> checksums;
+
+    crc_chunks_test() {
+        for (size_t i = 0; i < chunk_count; ++i) {
+            inputs[i] = data.data() + i * ChunkSize;
+            input_lens[i] = ChunkSize;
+        }
+    }
+
+    void checksum_serially() {
+        for (size_t i = 0; i < chunk_count; ++i) {
+            checksums[i] = crc32_utils::checksum(inputs[i], input_lens[i]);
+        }
+        perf_tests::do_not_optimize(checksums);
+    }
+
+    void checksum_together() {
+        checksum_many<crc32_utils>(chunk_count, inputs.data(), input_lens.data(), checksums.data());
+        perf_tests::do_not_optimize(checksums);
+    }
+};
+
+using crc_1k_chunks_test = crc_chunks_test<1024>;
+using crc_4k_chunks_test = crc_chunks_test<4 * 1024>;
+using crc_16k_chunks_test = crc_chunks_test<16 * 1024>;
+
+PERF_TEST_F(crc_1k_chunks_test, perf_crc32_1k_chunks_serial) {
+    checksum_serially();
+}
+
+PERF_TEST_F(crc_1k_chunks_test, perf_crc32_1k_chunks_multibuffer) {
+    checksum_together();
+}
+
+PERF_TEST_F(crc_4k_chunks_test, perf_crc32_4k_chunks_serial) {
+    checksum_serially();
+}
+
+PERF_TEST_F(crc_4k_chunks_test, perf_crc32_4k_chunks_multibuffer) {
+    checksum_together();
+}
+
+PERF_TEST_F(crc_16k_chunks_test, perf_crc32_16k_chunks_serial) {
+    checksum_serially();
+}
+
+PERF_TEST_F(crc_16k_chunks_test, perf_crc32_16k_chunks_multibuffer) {
+    checksum_together();
+}
@@ -34,7 +34,7 @@ struct key_tri_compare {
 using namespace seastar;
 
 /* On node size 32 and less linear search works better */
-using test_bplus_tree = bplus::tree<per_key_t, unsigned long, key_compare, 4, bplus::key_search::linear>;
+using test_bplus_tree = bplus::tree<per_key_t, unsigned long, key_compare, 4, bplus::key_search::simd>;
 
 static_assert(bplus::SimpleLessCompare<int64_t, key_compare>);
 
@@ -90,7 +90,7 @@ void scan_collection(Col& c, int batch) {
 
 class bptree_tester : public collection_tester {
     /* On node size 32 (this test) linear search works better */
-    using test_tree = bplus::tree<per_key_t, unsigned long, key_compare, 4, bplus::key_search::linear>;
+    using test_tree = bplus::tree<per_key_t, unsigned long, key_compare, 4, bplus::key_search::simd>;
 
     test_tree _t;
 public:
@@ -221,6 +221,60 @@ void test_scan_with_range_delete_over_rows() {
     tracker.cleaner().drain().get();
 }
 
+void test_partition_lookups() {
+    std::cout << __FUNCTION__<< std::endl;
+
+    simple_schema ss;
+    auto s = ss.schema();
+
+    cache_tracker tracker;
+    memtable_snapshot_source mss(s);
+    row_cache cache(s, snapshot_source([&] { return mss(); }), tracker);
+
+    std::cout << "Populating with partitions" << std::endl;
+
+    const size_t cache_size = seastar::memory::stats().total_memory() / 4;
+    std::vector<dht::decorated_key> keys;
+    while (tracker.region().occupancy().total_space() < cache_size) {
+        auto pk = ss.make_pkey(keys.size());
+        mutation m(s, pk);
+        m.partition().apply(ss.new_tombstone());
+        cache.populate(m);
+        keys.push_back(std::move(pk));
+        if (keys.size() % 1000 == 0) {
+            seastar::thread::maybe_yield();
+        }
+
+        if (cancelled) {
+            return;
+        }
+    }
+
+    std::cout << "Partitions: " << keys.size() << std::endl;
+    std::cout << "Looking up..." << std::endl;
+
+    std::shuffle(keys.begin(), keys.end(), tests::random::gen());
+    const size_t lookups = std::min<size_t>(keys.size(), 1000000);
+
+    auto test_lookups = [&] {
+        auto d = duration_in_seconds([&] {
+            for (size_t i = 0; i < lookups; i++) {
+                cache.lookup(keys[i]);
+            }
+        });
+        std::cout << format("lookup: {:.2f} [ns]\n", d.count() * 1e9 / lookups);
+    };
+
+    for (int i = 0; i < 5 && !cancelled; i++) {
+        test_lookups();
+        seastar::thread::maybe_yield();
+    }
+
+    // Clean gently to avoid reactor stalls in destructors
+    cache.invalidate(row_cache::external_updater([]{})).get();
+    tracker.cleaner().drain().get();
+}
+
 int main(int argc, char** argv) {
     app_template app;
     return app.run(argc, argv, [&app] {
@@ -232,6 +286,7 @@ int main(int argc, char** argv) {
             logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory()).get();
             test_scans_with_dummy_entries();
             test_scan_with_range_delete_over_rows();
+            test_partition_lookups();
         });
     });
 }
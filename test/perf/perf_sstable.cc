@@ -18,6 +18,7 @@
 #define BOOST_CHECK_NO_THROW(x) (void)(x)
 
 #include "test/perf/perf_sstable.hh"
+#include "sstables/read_batching_file.hh"
 
 using namespace sstables;
 
@@ -52,8 +53,18 @@ future<> test_sequential_read(distributed<perf_sstable_test_env>& dt) {
     return time_runs(iterations, parallelism, dt, &perf_sstable_test_env::read_sequential_partitions);
 }
 
+future<> test_random_read(distributed<perf_sstable_test_env>& dt) {
+    return time_runs(iterations, parallelism, dt, &perf_sstable_test_env::read_random_partitions).then([] {
+        auto& stats = sstables::get_read_batching_stats();
+        if (stats.requests) {
+            std::cout << format("read batching: {} requests, {} submissions (shard 0)\n", stats.requests, stats.submissions);
+        }
+    });
+}
+
 enum class test_modes {
     sequential_read,
+    random_read,
     index_read,
     write,
     index_write,
@@ -62,6 +73,7 @@ enum class test_modes {
 
 static std::unordered_map<sstring, test_modes> test_mode = {
     {"sequential_read", test_modes::sequential_read },
+    {"random_read", test_modes::random_read },
     {"index_read", test_modes::index_read },
     {"write", test_modes::write },
     {"index_write", test_modes::index_write },
@@ -80,7 +92,8 @@ int main(int argc, char** argv) {
         ("num_columns", bpo::value<unsigned>()->default_value(5), "number of columns per row")
         ("column_size", bpo::value<unsigned>()->default_value(64), "size in bytes for each column")
         ("sstables", bpo::value<unsigned>()->default_value(1), "number of sstables (valid only for compaction mode)")
-        ("mode", bpo::value<sstring>()->default_value("index_write"), "one of: sequential_read, index_read, write, compaction, index_write (default)")
+        ("mode", bpo::value<sstring>()->default_value("index_write"), "one of: sequential_read, random_read, index_read, write, compaction, index_write (default)")
+        ("read-batching", bpo::value<bool>()->default_value(false), "batch the reads of concurrent readers (sstable_read_batching), for read modes")
         ("testdir", bpo::value<sstring>()->default_value("/var/lib/scylla/perf-tests"), "directory in which to store the sstables")
         ("compaction-strategy", bpo::value<sstring>()->default_value("SizeTieredCompactionStrategy"), "compaction strategy to use, one of "
              "(SizeTieredCompactionStrategy, LeveledCompactionStrategy, DateTieredCompactionStrategy, TimeWindowCompactionStrategy)")
@@ -108,12 +121,16 @@ int main(int argc, char** argv) {
         }
         cfg.compaction_strategy = sstables::compaction_strategy::type(app.configuration()["compaction-strategy"].as<sstring>());
         cfg.timestamp_range = app.configuration()["timestamp-range"].as<api::timestamp_type>();
+        test_db_config.sstable_read_batching.set(app.configuration()["read-batching"].as<bool>());
         return test->start(std::move(cfg)).then([mode, dir, test] {
             engine().at_exit([test] { return test->stop(); });
             if ((mode == test_modes::index_read) ||
-               (mode == test_modes::sequential_read)) {
-                return test->invoke_on_all([] (perf_sstable_test_env &t) {
-                    return t.load_sstables(iterations);
+               (mode == test_modes::sequential_read) ||
+               (mode == test_modes::random_read)) {
+                return test->invoke_on_all([mode] (perf_sstable_test_env &t) {
+                    return t.load_sstables(iterations).then([&t, mode] {
+                        return mode == test_modes::random_read ? t.load_keys() : make_ready_future<>();
+                    });
                 }).then_wrapped([] (future<> f) {
                     try {
                         f.get();
@@ -132,6 +149,8 @@ int main(int argc, char** argv) {
                 return test_index_read(*test).then([test] {});
             } else if (mode == test_modes::sequential_read) {
                 return test_sequential_read(*test).then([test] {});
+            } else if (mode == test_modes::random_read) {
+                return test_random_read(*test).then([test] {});
             } else if ((mode == test_modes::index_write) || (mode == test_modes::write)) {
                 return test_write(*test).then([test] {});
             } else if (mode == test_modes::compaction) {
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/util/closeable.hh>
 
 #include "sstables/sstables.hh"
@@ -68,6 +69,7 @@ class perf_sstable_test_env {
     std::uniform_int_distribution<char> _distribution;
     lw_shared_ptr<replica::memtable> _mt;
     std::vector<shared_sstable> _sst;
+    std::vector<dht::decorated_key> _keys;
 
     schema_ptr create_schema(sstables::compaction_strategy_type type) {
         std::vector<schema::column> columns;
@@ -126,6 +128,13 @@ class perf_sstable_test_env {
         return _sst.back()->load();
     }
 
+    future<> load_keys() {
+        auto entries = co_await test(_sst[0]).read_indexes(_env.make_reader_permit());
+        for (auto& e : entries) {
+            _keys.push_back(dht::decorate_key(*s, std::move(e.key)));
+        }
+    }
+
     using clk = std::chrono::steady_clock;
     static auto now() {
         return clk::now();
@@ -211,6 +220,35 @@ class perf_sstable_test_env {
         });
     }
 
+    // Point reads of random partitions. Concurrency comes from running
+    // several of these at the same time (--parallelism).
+    future<double> read_random_partitions(int idx) {
+        static constexpr unsigned reads = 1000;
+        const auto start = perf_sstable_test_env::now();
+        for (unsigned i = 0; i < reads; ++i) {
+            auto& dk = _keys[tests::random::get_int<size_t>(0, _keys.size() - 1)];
+            auto pr = dht::partition_range::make_singular(dk);
+            auto rd = _sst[0]->make_reader(s, _env.make_reader_permit(), pr, s->full_slice());
+            mutation_opt m;
+            std::exception_ptr ex;
+            try {
+                m = co_await read_mutation_from_flat_mutation_reader(rd);
+            } catch (...) {
+                ex = std::current_exception();
+            }
+            co_await rd.close();
+            if (ex) {
+                std::rethrow_exception(std::move(ex));
+            }
+            if (!m) {
+                throw std::invalid_argument("Partition not found. Maybe the sstable was modified since it was written?");
+            }
+        }
+        auto end = perf_sstable_test_env::now();
+        auto duration = std::chrono::duration<double>(end - start).count();
+        co_return reads / duration;
+    }
+
     future<double> read_sequential_partitions(int idx) {
         return with_closeable(_sst[0]->make_reader(s, _env.make_reader_permit(), query::full_partition_range, s->full_slice()), [this] (auto& r) {
             auto start = perf_sstable_test_env::now();
@@ -1298,6 +1298,17 @@ const char* to_string(sstables::scylla_metadata_type t) {
         case sstables::scylla_metadata_type::SSTableOrigin: return "sstable_origin";
         case sstables::scylla_metadata_type::ScyllaVersion: return "scylla_version";
         case sstables::scylla_metadata_type::ScyllaBuildId: return "scylla_build_id";
+        case sstables::scylla_metadata_type::FilterFormat: return "filter_format";
+        case sstables::scylla_metadata_type::ValueLogs: return "value_logs";
+        case sstables::scylla_metadata_type::TombstoneDensity: return "tombstone_density";
+    }
+    std::abort();
+}
+
+const char* to_string(sstables::filter_format_type t) {
+    switch (t) {
+        case sstables::filter_format_type::classic: return "classic";
+        case sstables::filter_format_type::split_block: return "split_block";
     }
     std::abort();
 }
@@ -1351,6 +1362,7 @@ class scylla_metadata_visitor : public boost::static_visitor<> {
                 {sstables::sstable_feature::CorrectStaticCompact, "CorrectStaticCompact"},
                 {sstables::sstable_feature::CorrectEmptyCounters, "CorrectEmptyCounters"},
                 {sstables::sstable_feature::CorrectUDTsInCollections, "CorrectUDTsInCollections"},
+                {sstables::sstable_feature::ValueLogPointers, "ValueLogPointers"},
         };
         _writer.StartObject();
         _writer.Key("mask");
@@ -1391,6 +1403,48 @@ class scylla_metadata_visitor : public boost::static_visitor<> {
         }
         _writer.EndObject();
     }
+    void operator()(const sstables::filter_format_metadata& val) const {
+        _writer.String(to_string(val.format));
+    }
+    void operator()(const sstables::value_log_metadata& val) const {
+        _writer.StartObject();
+        for (const auto& e : val.logs.elements) {
+            _writer.Key(e.id.to_sstring());
+            _writer.StartObject();
+            _writer.Key("size");
+            _writer.Uint64(e.size);
+            _writer.Key("referenced_bytes");
+            _writer.Uint64(e.referenced_bytes);
+            _writer.EndObject();
+        }
+        _writer.EndObject();
+    }
+    void operator()(const sstables::tombstone_density_metadata& val) const {
+        _writer.StartArray();
+        for (const auto& s : val.segments.elements) {
+            _writer.StartObject();
+            _writer.Key("first_token");
+            _writer.Int64(s.first_token);
+            _writer.Key("last_token");
+            _writer.Int64(s.last_token);
+            _writer.Key("data_offset");
+            _writer.Uint64(s.data_offset);
+            _writer.Key("data_size");
+            _writer.Uint64(s.data_size);
+            _writer.Key("rows");
+            _writer.Uint64(s.rows);
+            _writer.Key("cells");
+            _writer.Uint64(s.cells);
+            _writer.Key("tombstones");
+            _writer.Uint64(s.tombstones);
+            _writer.Key("min_deletion_time");
+            _writer.Int(s.min_deletion_time);
+            _writer.Key("max_deletion_time");
+            _writer.Int(s.max_deletion_time);
+            _writer.EndObject();
+        }
+        _writer.EndArray();
+    }
     template <typename Size>
     void operator()(const sstables::disk_string<Size>& val) const {
         _writer.String(disk_string_to_string(val));
@@ -1866,6 +1920,8 @@ The content is dumped in JSON, using the following schema:
     "run_identifier": String, // UUID
     "large_data_stats": {"$key": $LARGE_DATA_STATS_METADATA, ...}
     "sstable_origin": String
+    "value_logs": {"$id": $VALUE_LOG_METADATA, ...}
+    "tombstone_density": [$TOMBSTONE_DENSITY_SEGMENT, ...]
 }
 
 $SHARDING_METADATA := {
@@ -1889,6 +1945,23 @@ The content is dumped in JSON, using the following schema:
     "threshold": Uint64,
     "above_threshold": Uint
 }
+
+$VALUE_LOG_METADATA := {
+    "size": Uint64,
+    "referenced_bytes": Uint64
+}
+
+$TOMBSTONE_DENSITY_SEGMENT := {
+    "first_token": Int64,
+    "last_token": Int64,
+    "data_offset": Uint64,
+    "data_size": Uint64,
+    "rows": Uint64,
+    "cells": Uint64,
+    "tombstones": Uint64,
+    "min_deletion_time": Int,
+    "max_deletion_time": Int
+}
 )",
             dump_scylla_metadata_operation},
 /* writetime-histogram */
@@ -100,6 +100,28 @@ arch_target("avx2") int array_search_gt_impl(int64_t val, const int64_t* array,
     return size - cnt;
 }
 
+/*
+ * AVX-512 version, same as the AVX2 one, but it compares 8 elements in
+ * one go and the comparison yields a bit mask right away. The tail of
+ * the array, if capacity isn't a multiple of 8, is compared with AVX2.
+ */
+
+arch_target("avx512f") int array_search_gt_impl(int64_t val, const int64_t* array, const int capacity, const int size) {
+    int cnt = 0;
+    int i = 0;
+
+    __m512i k = _mm512_set1_epi64(val);
+    for (; i + 8 <= capacity; i += 8) {
+        cnt += __builtin_popcount(_mm512_cmpgt_epi64_mask(_mm512_loadu_si512(&array[i]), k));
+    }
+    if (i < capacity) {
+        __m256i gt = _mm256_cmpgt_epi64(_mm256_lddqu_si256((__m256i*)&array[i]), _mm512_castsi512_si256(k));
+        cnt += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(gt)));
+    }
+
+    return size - cnt;
+}
+
 /*
  * SSE4 version of searching in array for an exact match.
  */
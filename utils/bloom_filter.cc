@@ -17,9 +17,17 @@
 #include <seastar/core/loop.hh>
 #include "utils/large_bitset.hh"
 #include <array>
+#include <cmath>
 #include <cstdlib>
 #include "bloom_filter.hh"
 
+#ifdef __x86_64__
+#include <x86intrin.h>
+#define arch_target(name) [[gnu::target(name)]]
+#else
+#define arch_target(name)
+#endif
+
 namespace utils {
 namespace filter {
 
@@ -62,6 +70,37 @@ bool bloom_filter::is_present(hashed_key key) {
     return result;
 }
 
+// How many keys ahead of the one being tested are prefetched by the batched
+// lookups; enough to keep a few cache misses in flight.
+static constexpr size_t prefetch_distance = 4;
+
+template<typename Prefetch, typename Test>
+static void for_each_prefetched(std::span<const hashed_key> keys, std::span<bool> present, Prefetch&& prefetch, Test&& test) {
+    for (size_t i = 0; i < std::min(keys.size(), prefetch_distance); ++i) {
+        prefetch(keys[i]);
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (i + prefetch_distance < keys.size()) {
+            prefetch(keys[i + prefetch_distance]);
+        }
+        present[i] = test(keys[i]);
+    }
+}
+
+void bloom_filter::are_present(std::span<const hashed_key> keys, std::span<bool> present) {
+    // Only the first word of each key is prefetched: absent keys are mostly
+    // rejected by their first probes, and computing all the indexes twice
+    // costs more than what it would save on present keys.
+    for_each_prefetched(keys, present, [this] (hashed_key hk) {
+        for_each_index(hk, 1, _bitset.size(), _format, [this] (auto i) {
+            _bitset.prefetch(i);
+            return stop_iteration::yes;
+        });
+    }, [this] (hashed_key hk) {
+        return bloom_filter::is_present(hk);
+    });
+}
+
 void bloom_filter::add(const bytes_view& key) {
     for_each_index(make_hashed_key(key), _hash_count, _bitset.size(), _format, [this] (auto i) {
         _bitset.set(i);
@@ -73,7 +112,132 @@ bool bloom_filter::is_present(const bytes_view& key) {
     return is_present(make_hashed_key(key));
 }
 
+// Odd multipliers used to derive the bit set in each word of a block from
+// a single 32-bit hash (the same ones used by the Parquet and Impala
+// split block filters).
+static constexpr std::array<uint32_t, 8> split_block_salt = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+static inline uint32_t split_block_bit(uint32_t key, unsigned word) {
+    return (key * split_block_salt[word]) >> 27;
+}
+
+static inline uint32_t split_block_key(hashed_key hk) {
+    return static_cast<uint32_t>(hk.hash()[1]);
+}
+
+arch_target("default") bool split_block_contains(const uint64_t* block, uint32_t key) {
+    for (unsigned i = 0; i < split_block_salt.size(); i++) {
+        uint32_t word = block[i / 2] >> (32 * (i % 2));
+        if (!((word >> split_block_bit(key, i)) & 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef __x86_64__
+
+/*
+ * AVX2 version: computes all eight bit positions at once and checks them
+ * against the block with a single test. Relies on the block's words being
+ * laid out in little-endian order, which is what the default version reads
+ * out of the 64-bit storage elements.
+ */
+arch_target("avx2") bool split_block_contains(const uint64_t* block, uint32_t key) {
+    const auto salt = _mm256_setr_epi32(split_block_salt[0], split_block_salt[1], split_block_salt[2], split_block_salt[3],
+            split_block_salt[4], split_block_salt[5], split_block_salt[6], split_block_salt[7]);
+    auto bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(key), salt), 27);
+    auto mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+    auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    return _mm256_testc_si256(b, mask);
+}
+
+#endif
+
+split_block_bloom_filter::split_block_bloom_filter(bitmap&& bs) noexcept
+    : bloom_filter(0, std::move(bs), filter_format::split_block_format)
+    , _nr_blocks(bits().size() / bits_per_block)
+{
+}
+
+uint64_t split_block_bloom_filter::block_index(hashed_key hk) const noexcept {
+    // Maps the hash onto [0, _nr_blocks) without a division.
+    return (static_cast<unsigned __int128>(hk.hash()[0]) * _nr_blocks) >> 64;
+}
+
+void split_block_bloom_filter::add(const bytes_view& key) {
+    auto hk = make_hashed_key(key);
+    auto base = block_index(hk) * bits_per_block;
+    auto k = split_block_key(hk);
+    for (unsigned i = 0; i < split_block_salt.size(); i++) {
+        bits().set(base + 32 * i + split_block_bit(k, i));
+    }
+}
+
+bool split_block_bloom_filter::is_present(hashed_key key) {
+    if (!_nr_blocks) {
+        return true;
+    }
+    // Blocks never straddle a chunk of the bitset's storage since the
+    // chunk capacity is a power of two larger than words_per_block.
+    const uint64_t* block = &bits().get_storage()[block_index(key) * words_per_block];
+    return split_block_contains(block, split_block_key(key));
+}
+
+void split_block_bloom_filter::are_present(std::span<const hashed_key> keys, std::span<bool> present) {
+    if (!_nr_blocks) {
+        std::fill(present.begin(), present.end(), true);
+        return;
+    }
+    for_each_prefetched(keys, present, [this] (hashed_key hk) {
+        bits().prefetch(block_index(hk) * bits_per_block);
+    }, [this] (hashed_key hk) {
+        return split_block_bloom_filter::is_present(hk);
+    });
+}
+
+// Expected false-positive rate of a split block filter with the given
+// average number of keys per block. Block loads follow a Poisson
+// distribution, and a block holding l keys has each bit of a word set with
+// probability 1 - (31/32)^l.
+static double split_block_false_positive_rate(double keys_per_block) {
+    double fp = 0;
+    double p_load = std::exp(-keys_per_block);
+    auto max_load = keys_per_block + 10 * std::sqrt(keys_per_block) + 10;
+    for (int load = 0; load < max_load; ++load) {
+        fp += p_load * std::pow(1 - std::pow(31.0 / 32, load), 8);
+        p_load *= keys_per_block / (load + 1);
+    }
+    return fp;
+}
+
+uint64_t split_block_bloom_filter::num_bits(int64_t num_elements, double max_false_pos_prob) {
+    // The rate only grows with the load, so bisect for the highest load
+    // that still satisfies the requested probability.
+    double lo = 0;
+    double hi = bits_per_block;
+    for (int i = 0; i < 64; ++i) {
+        auto mid = (lo + hi) / 2;
+        if (split_block_false_positive_rate(mid) <= max_false_pos_prob) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        throw exceptions::unsupported_operation_exception(format("Unable to satisfy {:f} with a split block filter", max_false_pos_prob));
+    }
+    num_elements = std::max(int64_t(1), num_elements);
+    return uint64_t(std::ceil(num_elements / lo)) * bits_per_block;
+}
+
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format) {
+    if (format == filter_format::split_block_format) {
+        return std::make_unique<split_block_bloom_filter>(std::move(bitset));
+    }
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
 
@@ -24,14 +24,18 @@ enum class with_debug { no, yes };
  * Linear search in a sorted array of keys slightly beats the
  * binary one on small sizes. For debugging purposes both methods
  * should be used (and the result must coincide).
+ *
+ * The simd search compares the lookup key with all the keys of a
+ * node at once, see array_search_gt(). It needs int64_t keys, a
+ * SimpleLessCompare comparator and a node size multiple of 4.
  */
-enum class key_search { linear, binary, both };
+enum class key_search { linear, binary, simd, both };
 
 /*
  * The less-comparator can be any, but in trivial case when it is
  * literally 'a < b' it may define the conversion of a lookup Key
- * into a 64-bit integer type. Then the intra-node keys scan will
- * use simd instructions.
+ * into a 64-bit integer type. Then the intra-node keys scan can
+ * use simd instructions (see key_search::simd).
  */
 
 template <typename Key, typename Less>
@@ -215,6 +219,9 @@ class tree {
 
     // Sanity not to allow slow key-search in non-debug mode
     static_assert(Debug == with_debug::yes || Search != key_search::both);
+    static_assert(Search != key_search::simd ||
+            (std::is_same_v<Key, int64_t> && SimpleLessCompare<Key, Less> && NodeSize % 4 == 0),
+            "simd key search needs int64_t keys, a simple comparator and a node size multiple of 4");
 
     using node = class node<Key, T, Less, NodeSize, Search, Debug>;
     using data = class data<Key, T, Less, NodeSize, Search, Debug>;
@@ -893,7 +900,7 @@ struct searcher<K, Key, Less, Size, key_search::linear> {
 
 template <typename K, typename Less, size_t Size>
 requires SimpleLessCompare<K, Less>
-struct searcher<K, int64_t, Less, Size, key_search::linear> {
+struct searcher<K, int64_t, Less, Size, key_search::simd> {
     static_assert(sizeof(maybe_key<int64_t, Less>) == sizeof(int64_t));
     static size_t gt(const K& k, const maybe_key<int64_t, Less>* keys, size_t nr, Less less) noexcept {
         return utils::array_search_gt(less.simplify_key(k), reinterpret_cast<const int64_t*>(keys), Size, nr);
@@ -924,6 +931,10 @@ struct searcher<K, Key, Less, Size, key_search::both> {
         size_t rl = searcher<K, Key, Less, Size, key_search::linear>::gt(k, keys, nr, less);
         size_t rb = searcher<K, Key, Less, Size, key_search::binary>::gt(k, keys, nr, less);
         assert(rl == rb);
+        if constexpr (std::is_same_v<Key, int64_t> && SimpleLessCompare<K, Less> && Size % 4 == 0) {
+            size_t rs = searcher<K, Key, Less, Size, key_search::simd>::gt(k, keys, nr, less);
+            assert(rl == rs);
+        }
         assert(rl <= nr);
         return rl;
     }
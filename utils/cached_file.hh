@@ -168,6 +168,13 @@ class cached_file {
         }
         tracing::trace(trace_state, "page cache miss: file={}, page={}, readahead={}", _file_name, idx, read_ahead);
         ++_metrics.page_misses;
+        return load_pages(idx, read_ahead, pc);
+    }
+    // Reads pages [idx, idx + read_ahead) from the file and inserts those which are not cached yet.
+    // Returns a pointer to the first page.
+    future<cached_page::ptr_type> load_pages(page_idx_type idx,
+            page_count_type read_ahead,
+            const io_priority_class& pc) {
         size_t size = (idx + read_ahead) > _last_page
                 ? (_last_page_size + (_last_page - idx) * page_size)
                 : read_ahead * page_size;
@@ -424,6 +431,36 @@ class cached_file {
         return stream(*this, pc, std::move(permit), std::move(trace_state), page_idx, offset, size_hint);
     }
 
+    /// \brief Populates the cache with those pages of [idx, idx + count) which are not cached yet.
+    ///
+    /// Consecutive missing pages are read with a single I/O. Pages past the end of the area are ignored.
+    /// Meant for warming up the cache, so it counts neither as hits nor as misses.
+    future<> prefetch(page_idx_type idx, page_count_type count, const io_priority_class& pc) {
+        if (!_size) {
+            co_return;
+        }
+        auto end = std::min(idx + count, _last_page + 1);
+        while (idx < end) {
+            auto i = _cache.lower_bound(idx);
+            if (i != _cache.end() && i->idx == idx) {
+                ++idx;
+                continue;
+            }
+            auto missing_end = i != _cache.end() ? std::min(i->idx, end) : end;
+            co_await load_pages(idx, missing_end - idx, pc).discard_result();
+            idx = missing_end;
+        }
+    }
+
+    /// \brief Calls func with the index of every page which is currently cached, in increasing order.
+    template <typename Func>
+    requires std::invocable<Func, page_idx_type>
+    void for_each_cached_page(Func&& func) const {
+        for (auto&& cp : _cache) {
+            func(cp.idx);
+        }
+    }
+
     /// \brief Returns the number of bytes in the area managed by this instance.
     offset_type size() const {
         return _size;
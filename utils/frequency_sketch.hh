@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+// Estimates how often keys were accessed recently, in constant memory.
+//
+// A count-min sketch: every key maps to one 4-bit counter in each of four
+// rows, and its frequency is the smallest of them. Counters saturate at 15.
+// Once the number of recorded accesses reaches ten times the number of
+// counters of a row, all counters are halved, so that the frequencies of
+// keys which aren't accessed anymore decay (see TinyLFU).
+//
+// Keys are given as 64-bit hashes, which must be well mixed.
+class frequency_sketch {
+    static constexpr unsigned rows = 4;
+    static constexpr unsigned counters_per_word = 16;
+    static constexpr uint64_t max_count = 15;
+    static constexpr std::array<uint64_t, rows> seeds = {
+        0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL,
+    };
+
+    // The rows are interleaved, a word holds 16 counters of a single row.
+    std::vector<uint64_t> _table;
+    uint64_t _word_mask = 0;
+    uint64_t _additions = 0;
+    uint64_t _sample_size = 0;
+private:
+    size_t word_of(uint64_t hash, unsigned row) const noexcept {
+        auto h = (hash + seeds[row]) * seeds[row];
+        h ^= h >> 32;
+        return (h & _word_mask) * rows + row;
+    }
+
+    static unsigned shift_of(uint64_t hash, unsigned row) noexcept {
+        return ((hash >> (row * 8)) & (counters_per_word - 1)) * 4;
+    }
+
+    void age() noexcept {
+        for (auto& w : _table) {
+            w = (w >> 1) & 0x7777777777777777ULL;
+        }
+        _additions /= 2;
+    }
+public:
+    frequency_sketch() = default;
+
+    // Sizes the sketch for about capacity keys, rounded up to a power of two.
+    explicit frequency_sketch(size_t capacity) {
+        size_t words = 1;
+        while (words * counters_per_word < capacity) {
+            words *= 2;
+        }
+        _table.resize(words * rows);
+        _word_mask = words - 1;
+        _sample_size = 10 * words * counters_per_word;
+    }
+
+    bool empty() const noexcept {
+        return _table.empty();
+    }
+
+    // Records an access to the key.
+    void increment(uint64_t hash) noexcept {
+        if (empty()) {
+            return;
+        }
+        bool added = false;
+        for (unsigned row = 0; row < rows; ++row) {
+            auto& w = _table[word_of(hash, row)];
+            auto shift = shift_of(hash, row);
+            if (((w >> shift) & max_count) != max_count) {
+                w += uint64_t(1) << shift;
+                added = true;
+            }
+        }
+        if (added && ++_additions == _sample_size) {
+            age();
+        }
+    }
+
+    // Returns the estimated number of recent accesses to the key, at most 15.
+    unsigned frequency(uint64_t hash) const noexcept {
+        if (empty()) {
+            return 0;
+        }
+        uint64_t f = max_count;
+        for (unsigned row = 0; row < rows; ++row) {
+            f = std::min(f, (_table[word_of(hash, row)] >> shift_of(hash, row)) & max_count);
+        }
+        return f;
+    }
+
+    void clear() noexcept {
+        std::fill(_table.begin(), _table.end(), 0);
+        _additions = 0;
+    }
+};
+
+}
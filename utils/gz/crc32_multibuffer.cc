@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ */
+
+/*
+ * The folding and reduction below follow "Fast CRC Computation for Generic
+ * Polynomials Using PCLMULQDQ Instruction" (Intel, 2009), using the
+ * bit-reflected constants for the gzip polynomial also found in libdeflate
+ * and zlib. See crc_combine.cc for the representation of polynomials.
+ *
+ * Each buffer is folded 128 bits at a time:
+ *
+ *   X'(x) = X_hi(x) * (x^(128+64) mod G(x)) + X_lo(x) * (x^128 mod G(x)) + next 128 bits
+ *
+ * Folding a single buffer like this is bound by the latency of the
+ * carry-less multiplication. We fold up to max_lanes buffers in lockstep
+ * instead, which gives the CPU independent work to overlap.
+ */
+
+#include "crc32_multibuffer.hh"
+#include "libdeflate/libdeflate.h"
+
+#include <algorithm>
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <wmmintrin.h>
+#include <smmintrin.h>
+
+static constexpr size_t max_lanes = 4;
+
+// Below this, the setup and reduction dominate and there is
+// nothing to gain over the single-buffer implementation.
+static constexpr size_t min_folded_length = 64;
+
+// Reduces the 128-bit folded remainder to the 32-bit CRC value
+// (still in the pre- and post-inverted form).
+static inline
+u32 crc32_reduce_m128(__m128i x1) {
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i x2;
+
+    // Fold 128 => 96 bits.
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Fold 96 => 64 bits.
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction 64 => 32 bits.
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return _mm_extract_epi32(x1, 1);
+}
+
+// Computes the CRC32 of the first len bytes of each of the N buffers.
+// len must be a multiple of 16 and at least 16.
+template <size_t N>
+static
+void crc32_fold_lanes(const char* const bufs[], size_t len, u32 crcs[]) {
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    __m128i x[N];
+
+    for (size_t i = 0; i < N; ++i) {
+        x[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bufs[i]));
+        x[i] = _mm_xor_si128(x[i], _mm_cvtsi32_si128(~u32(0)));
+    }
+
+    for (size_t off = 16; off < len; off += 16) {
+        for (size_t i = 0; i < N; ++i) {
+            auto lo = _mm_clmulepi64_si128(x[i], k3k4, 0x00);
+            auto hi = _mm_clmulepi64_si128(x[i], k3k4, 0x11);
+            auto next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bufs[i] + off));
+            x[i] = _mm_xor_si128(_mm_xor_si128(lo, hi), next);
+        }
+    }
+
+    for (size_t i = 0; i < N; ++i) {
+        crcs[i] = ~crc32_reduce_m128(x[i]);
+    }
+}
+
+template <size_t N>
+static
+void crc32_lanes(const char* const bufs[], const size_t lens[], u32 crcs[]) {
+    auto folded = *std::min_element(lens, lens + N) & ~size_t(15);
+    if (folded < min_folded_length) {
+        for (size_t i = 0; i < N; ++i) {
+            crcs[i] = libdeflate_crc32(0, bufs[i], lens[i]);
+        }
+        return;
+    }
+
+    crc32_fold_lanes<N>(bufs, folded, crcs);
+
+    // Whatever is left beyond the common length is finished one buffer at a time.
+    for (size_t i = 0; i < N; ++i) {
+        if (lens[i] > folded) {
+            crcs[i] = libdeflate_crc32(crcs[i], bufs[i] + folded, lens[i] - folded);
+        }
+    }
+}
+
+void crc32_multibuffer(size_t count, const char* const bufs[], const size_t lens[], u32 crcs[]) {
+    while (count >= max_lanes) {
+        crc32_lanes<max_lanes>(bufs, lens, crcs);
+        bufs += max_lanes;
+        lens += max_lanes;
+        crcs += max_lanes;
+        count -= max_lanes;
+    }
+    switch (count) {
+    case 3:
+        crc32_lanes<3>(bufs, lens, crcs);
+        break;
+    case 2:
+        crc32_lanes<2>(bufs, lens, crcs);
+        break;
+    case 1:
+        crcs[0] = libdeflate_crc32(0, bufs[0], lens[0]);
+        break;
+    }
+}
+
+#else
+
+void crc32_multibuffer(size_t count, const char* const bufs[], const size_t lens[], u32 crcs[]) {
+    for (size_t i = 0; i < count; ++i) {
+        crcs[i] = libdeflate_crc32(0, bufs[i], lens[i]);
+    }
+}
+
+#endif
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Computes CRC32 (gzip format, RFC 1952) of count independent buffers:
+ *
+ *   crcs[i] = CRC32(bufs[i][0 .. lens[i]))
+ *
+ * Where the hardware allows it, the buffers are folded in lockstep, so that
+ * the latency of the carry-less multiplications of one buffer is hidden
+ * behind the work on the others. This pays off for the small (a few KiB)
+ * chunks sstables are checksummed in, where a single-buffer implementation
+ * spends a good part of its time waiting on its own dependency chain and
+ * on the final reduction.
+ */
+void crc32_multibuffer(size_t count, const char* const bufs[], const size_t lens[], uint32_t crcs[]);
+
+static constexpr bool crc32_multibuffer_optimized() {
+#if defined(__x86_64__) || defined(__i386__)
+    return true;
+#else
+    return false;
+#endif
+}
@@ -12,6 +12,8 @@
 #include "bytes.hh"
 #include "bloom_calculations.hh"
 
+#include <span>
+
 namespace utils {
 
 struct i_filter;
@@ -20,6 +22,8 @@ using filter_ptr = std::unique_ptr<i_filter>;
 enum class filter_format {
     k_l_format,
     m_format,
+    // Cache-line blocked layout, see filter::split_block_bloom_filter.
+    split_block_format,
 };
 
 class hashed_key {
@@ -40,6 +44,13 @@ struct i_filter {
     virtual void add(const bytes_view& key) = 0;
     virtual bool is_present(const bytes_view& key) = 0;
     virtual bool is_present(hashed_key) = 0;
+    // Sets present[i] to is_present(keys[i]). Implementations may overlap the
+    // memory accesses of the different keys, so prefer it over a loop.
+    virtual void are_present(std::span<const hashed_key> keys, std::span<bool> present) {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            present[i] = is_present(keys[i]);
+        }
+    }
     virtual void clear() = 0;
     virtual void close() = 0;
 
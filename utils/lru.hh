@@ -46,23 +46,36 @@ class lru {
         boost::intrusive::member_hook<evictable, evictable::lru_link_type, &evictable::_lru_link>,
         boost::intrusive::constant_time_size<false>>; // we need this to have bi::auto_unlink on hooks.
     lru_type _list;
+    // Entries which are evicted before the ones of _list, see add_probationary().
+    lru_type _probation;
 public:
     using reclaiming_result = seastar::memory::reclaiming_result;
 
     ~lru() {
+        _probation.clear_and_dispose([] (evictable* e) {
+            e->on_evicted();
+        });
         _list.clear_and_dispose([] (evictable* e) {
             e->on_evicted();
         });
     }
 
     void remove(evictable& e) noexcept {
-        _list.erase(_list.iterator_to(e));
+        e.unlink_from_lru();
     }
 
     void add(evictable& e) noexcept {
         _list.push_back(e);
     }
 
+    // Adds an entry which is evicted before all the entries added with add(),
+    // unless it's touched before. Lets the user of the LRU keep entries which
+    // are unlikely to be used again, like the ones of a scan, from evicting the
+    // ones which are.
+    void add_probationary(evictable& e) noexcept {
+        _probation.push_back(e);
+    }
+
     void touch(evictable& e) noexcept {
         remove(e);
         add(e);
@@ -70,11 +83,12 @@ class lru {
 
     // Evicts a single element from the LRU
     reclaiming_result evict() noexcept {
-        if (_list.empty()) {
+        auto& list = _probation.empty() ? _list : _probation;
+        if (list.empty()) {
             return reclaiming_result::reclaimed_nothing;
         }
-        evictable& e = _list.front();
-        _list.pop_front();
+        evictable& e = list.front();
+        list.pop_front();
         e.on_evicted();
         return reclaiming_result::reclaimed_something;
     }
@@ -118,6 +118,17 @@ class space_saving_top_k {
 
     bool valid() const { return _valid; }
 
+    // returns the number of appends of item which are certain, i.e. its count minus its error,
+    // or 0 if item isn't tracked
+    unsigned guaranteed_count(const T& item) const {
+        auto it = _counters_map.find(item);
+        if (it == _counters_map.end()) {
+            return 0;
+        }
+        const counter& c = **it->second;
+        return c.count - c.error;
+    }
+
     // returns true if item is a new one
     bool append(T item, unsigned inc = 1, unsigned err = 0) {
         return std::get<0>(append_return_all(std::move(item), inc, err));
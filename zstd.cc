@@ -12,12 +12,49 @@
 // which are available only when the library is linked statically.
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstd.h"
+#define ZDICT_STATIC_LINKING_ONLY
+#include "zdict.h"
 
 #include "compress.hh"
 #include "utils/class_registrator.hh"
 
 static const sstring COMPRESSION_LEVEL = "compression_level";
+static const sstring DICTIONARY_SIZE_KB = "dictionary_size_in_kb";
 static const sstring COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdCompressor";
+static const sstring DICTIONARY_COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdDictionaryCompressor";
+
+static int parse_compression_level(const compressor::opt_getter& opts) {
+    auto level = opts(COMPRESSION_LEVEL);
+    if (!level) {
+        return 3;
+    }
+    int compression_level;
+    try {
+        compression_level = std::stoi(*level);
+    } catch (const std::exception& e) {
+        throw exceptions::syntax_exception(
+            format("Invalid integer value {} for {}", *level, COMPRESSION_LEVEL));
+    }
+
+    auto min_level = ZSTD_minCLevel();
+    auto max_level = ZSTD_maxCLevel();
+    if (min_level > compression_level || compression_level > max_level) {
+        throw exceptions::configuration_exception(
+            format("{} must be between {} and {}, got {}", COMPRESSION_LEVEL, min_level, max_level, compression_level));
+    }
+    return compression_level;
+}
+
+static int parse_chunk_length(const compressor::opt_getter& opts) {
+    auto chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB);
+    if (!chunk_len_kb) {
+        chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB_ERR);
+    }
+    return chunk_len_kb
+       // This parameter has already been validated.
+       ? std::stoi(*chunk_len_kb) * 1024
+       : compression_parameters::DEFAULT_CHUNK_LENGTH;
+}
 
 class zstd_processor : public compressor {
     int _compression_level = 3;
@@ -45,32 +82,9 @@ class zstd_processor : public compressor {
 };
 
 zstd_processor::zstd_processor(const opt_getter& opts)
-    : compressor(COMPRESSOR_NAME) {
-    auto level = opts(COMPRESSION_LEVEL);
-    if (level) {
-        try {
-            _compression_level = std::stoi(*level);
-        } catch (const std::exception& e) {
-            throw exceptions::syntax_exception(
-                format("Invalid integer value {} for {}", *level, COMPRESSION_LEVEL));
-        }
-
-        auto min_level = ZSTD_minCLevel();
-        auto max_level = ZSTD_maxCLevel();
-        if (min_level > _compression_level || _compression_level > max_level) {
-            throw exceptions::configuration_exception(
-                format("{} must be between {} and {}, got {}", COMPRESSION_LEVEL, min_level, max_level, _compression_level));
-        }
-    }
-
-    auto chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB);
-    if (!chunk_len_kb) {
-        chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB_ERR);
-    }
-    auto chunk_len = chunk_len_kb
-       // This parameter has already been validated.
-       ? std::stoi(*chunk_len_kb) * 1024
-       : compression_parameters::DEFAULT_CHUNK_LENGTH;
+    : compressor(COMPRESSOR_NAME)
+    , _compression_level(parse_compression_level(opts)) {
+    auto chunk_len = parse_chunk_length(opts);
 
     // We assume that the uncompressed input length is always <= chunk_len.
     auto cparams = ZSTD_getCParams(_compression_level, chunk_len, 0);
@@ -121,3 +135,217 @@ std::map<sstring, sstring> zstd_processor::options() const {
 
 static const class_registrator<compressor, zstd_processor, const compressor::opt_getter&>
     registrator(COMPRESSOR_NAME);
+
+// Like zstd_processor, but compresses all chunks of an sstable with a
+// dictionary trained on the first chunks of that same sstable. Small chunks
+// of similar data (e.g. 4k chunks of JSON-like blobs) compress poorly on
+// their own, because every chunk has to rediscover the same repeated strings;
+// the dictionary captures them once per sstable and is stored alongside
+// CompressionInfo.
+//
+// The instance created from the schema has no dictionary and only drives
+// training. Sstable readers and writers use the instance returned by
+// with_dictionary().
+class zstd_dictionary_processor : public compressor {
+    static constexpr size_t default_dictionary_size = 32 * 1024;
+    static constexpr size_t max_dictionary_size = 1024 * 1024;
+    // zstd recommends training on ~100 times the dictionary size. We settle
+    // for less, because the chunks are held back until training is done.
+    static constexpr size_t samples_per_dictionary_byte = 32;
+    // Below this, the dictionary is unlikely to pay for itself.
+    static constexpr size_t min_samples_per_dictionary_byte = 8;
+
+    struct cctx_deleter {
+        void operator()(ZSTD_CCtx* p) const noexcept { ZSTD_freeCCtx(p); }
+    };
+    struct dctx_deleter {
+        void operator()(ZSTD_DCtx* p) const noexcept { ZSTD_freeDCtx(p); }
+    };
+    struct cdict_deleter {
+        void operator()(ZSTD_CDict* p) const noexcept { ZSTD_freeCDict(p); }
+    };
+    struct ddict_deleter {
+        void operator()(ZSTD_DDict* p) const noexcept { ZSTD_freeDDict(p); }
+    };
+
+    int _compression_level;
+    int _chunk_length;
+    size_t _dictionary_size = default_dictionary_size;
+    // Disengaged for the schema-level instance. Engaged, but possibly empty
+    // (if training failed), for instances bound to an sstable.
+    std::optional<bytes_view> _dictionary;
+
+    // Created on first use, since readers only ever uncompress and writers
+    // only ever compress.
+    mutable std::unique_ptr<ZSTD_CCtx, cctx_deleter> _cctx;
+    mutable std::unique_ptr<ZSTD_DCtx, dctx_deleter> _dctx;
+    mutable std::unique_ptr<ZSTD_CDict, cdict_deleter> _cdict;
+    mutable std::unique_ptr<ZSTD_DDict, ddict_deleter> _ddict;
+
+    bool has_dictionary() const {
+        return _dictionary && !_dictionary->empty();
+    }
+public:
+    zstd_dictionary_processor(const opt_getter&);
+    zstd_dictionary_processor(const zstd_dictionary_processor& untrained, bytes_view dictionary);
+
+    size_t uncompress(const char* input, size_t input_len, char* output,
+                    size_t output_len) const override;
+    size_t compress(const char* input, size_t input_len, char* output,
+                    size_t output_len) const override;
+    size_t compress_max_size(size_t input_len) const override;
+
+    size_t dictionary_training_sample_size() const override;
+    size_t dictionary_size() const override;
+    size_t train_dictionary(const std::vector<temporary_buffer<char>>& samples, bytes_mutable_view dictionary) const override;
+    shared_ptr<compressor> with_dictionary(bytes_view dictionary) const override;
+
+    std::set<sstring> option_names() const override;
+    std::map<sstring, sstring> options() const override;
+};
+
+zstd_dictionary_processor::zstd_dictionary_processor(const opt_getter& opts)
+    : compressor(DICTIONARY_COMPRESSOR_NAME)
+    , _compression_level(parse_compression_level(opts))
+    , _chunk_length(parse_chunk_length(opts)) {
+    auto dictionary_size_kb = opts(DICTIONARY_SIZE_KB);
+    if (dictionary_size_kb) {
+        try {
+            _dictionary_size = std::stoul(*dictionary_size_kb) * 1024;
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(
+                format("Invalid integer value {} for {}", *dictionary_size_kb, DICTIONARY_SIZE_KB));
+        }
+        if (_dictionary_size == 0 || _dictionary_size > max_dictionary_size) {
+            throw exceptions::configuration_exception(
+                format("{} must be between 1 and {}, got {}", DICTIONARY_SIZE_KB, max_dictionary_size / 1024, *dictionary_size_kb));
+        }
+    }
+}
+
+zstd_dictionary_processor::zstd_dictionary_processor(const zstd_dictionary_processor& untrained, bytes_view dictionary)
+    : compressor(DICTIONARY_COMPRESSOR_NAME)
+    , _compression_level(untrained._compression_level)
+    , _chunk_length(untrained._chunk_length)
+    , _dictionary_size(untrained._dictionary_size)
+    , _dictionary(dictionary)
+{}
+
+size_t zstd_dictionary_processor::uncompress(const char* input, size_t input_len, char* output, size_t output_len) const {
+    if (!_dctx) {
+        _dctx.reset(ZSTD_createDCtx());
+        if (!_dctx) {
+            throw std::runtime_error("Unable to initialize ZSTD decompression context");
+        }
+    }
+    size_t ret;
+    if (has_dictionary()) {
+        if (!_ddict) {
+            _ddict.reset(ZSTD_createDDict_advanced(_dictionary->data(), _dictionary->size(),
+                    ZSTD_dlm_byRef, ZSTD_dct_auto, ZSTD_defaultCMem));
+            if (!_ddict) {
+                throw std::runtime_error("Unable to load ZSTD decompression dictionary");
+            }
+        }
+        ret = ZSTD_decompress_usingDDict(_dctx.get(), output, output_len, input, input_len, _ddict.get());
+    } else {
+        ret = ZSTD_decompressDCtx(_dctx.get(), output, output_len, input, input_len);
+    }
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error( format("ZSTD decompression failure: {}", ZSTD_getErrorName(ret)));
+    }
+    return ret;
+}
+
+size_t zstd_dictionary_processor::compress(const char* input, size_t input_len, char* output, size_t output_len) const {
+    if (!_cctx) {
+        _cctx.reset(ZSTD_createCCtx());
+        if (!_cctx) {
+            throw std::runtime_error("Unable to initialize ZSTD compression context");
+        }
+    }
+    size_t ret;
+    if (has_dictionary()) {
+        if (!_cdict) {
+            // We assume that the uncompressed input length is always <= chunk_len.
+            auto cparams = ZSTD_getCParams(_compression_level, _chunk_length, _dictionary->size());
+            _cdict.reset(ZSTD_createCDict_advanced(_dictionary->data(), _dictionary->size(),
+                    ZSTD_dlm_byRef, ZSTD_dct_auto, cparams, ZSTD_defaultCMem));
+            if (!_cdict) {
+                throw std::runtime_error("Unable to load ZSTD compression dictionary");
+            }
+        }
+        ret = ZSTD_compress_usingCDict(_cctx.get(), output, output_len, input, input_len, _cdict.get());
+    } else {
+        ret = ZSTD_compressCCtx(_cctx.get(), output, output_len, input, input_len, _compression_level);
+    }
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error( format("ZSTD compression failure: {}", ZSTD_getErrorName(ret)));
+    }
+    return ret;
+}
+
+size_t zstd_dictionary_processor::compress_max_size(size_t input_len) const {
+    return ZSTD_compressBound(input_len);
+}
+
+size_t zstd_dictionary_processor::dictionary_training_sample_size() const {
+    return _dictionary ? 0 : _dictionary_size * samples_per_dictionary_byte;
+}
+
+size_t zstd_dictionary_processor::dictionary_size() const {
+    return _dictionary_size;
+}
+
+size_t zstd_dictionary_processor::train_dictionary(const std::vector<temporary_buffer<char>>& samples, bytes_mutable_view dictionary) const {
+    size_t total_size = 0;
+    std::vector<size_t> sample_sizes;
+    sample_sizes.reserve(samples.size());
+    for (auto& sample : samples) {
+        sample_sizes.push_back(sample.size());
+        total_size += sample.size();
+    }
+    if (total_size < dictionary.size() * min_samples_per_dictionary_byte) {
+        return 0;
+    }
+
+    auto samples_buffer = std::make_unique<char[]>(total_size);
+    auto out = samples_buffer.get();
+    for (auto& sample : samples) {
+        out = std::copy_n(sample.get(), sample.size(), out);
+    }
+
+    // Use fixed fastCover parameters rather than ZDICT_trainFromBuffer(),
+    // whose parameter search multiplies the training time.
+    ZDICT_fastCover_params_t params = {};
+    params.k = 1024;
+    params.d = 8;
+    params.f = 20;
+    params.accel = 1;
+    params.zParams.compressionLevel = _compression_level;
+
+    auto ret = ZDICT_trainFromBuffer_fastCover(dictionary.data(), dictionary.size(),
+            samples_buffer.get(), sample_sizes.data(), sample_sizes.size(), params);
+    if (ZDICT_isError(ret)) {
+        return 0;
+    }
+    return ret;
+}
+
+shared_ptr<compressor> zstd_dictionary_processor::with_dictionary(bytes_view dictionary) const {
+    return ::make_shared<zstd_dictionary_processor>(*this, dictionary);
+}
+
+std::set<sstring> zstd_dictionary_processor::option_names() const {
+    return {COMPRESSION_LEVEL, DICTIONARY_SIZE_KB};
+}
+
+std::map<sstring, sstring> zstd_dictionary_processor::options() const {
+    return {
+        {COMPRESSION_LEVEL, std::to_string(_compression_level)},
+        {DICTIONARY_SIZE_KB, std::to_string(_dictionary_size / 1024)},
+    };
+}
+
+static const class_registrator<compressor, zstd_dictionary_processor, const compressor::opt_getter&>
+    dictionary_registrator(DICTIONARY_COMPRESSOR_NAME);